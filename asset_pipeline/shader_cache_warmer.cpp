@@ -0,0 +1,89 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <fstream>
+#include <set>
+#include <string>
+
+#include "vox.base/logging.h"
+#include "vox.render/platform/platform.h"
+#include "vox.render/shader/shader_cache.h"
+#include "vox.render/strings.h"
+
+// Compiles every variant listed in a shader cache manifest into the persistent
+// shader cache, so that a scene recorded once starts without compiling shaders.
+//
+// Usage: shader_cache_warmer [working directory] [manifest]
+// The working directory holds the "shaders/" and "output/" folders, and the
+// manifest defaults to the one written while running the scene.
+int main(int _argc, const char** _argv) {
+    if (_argc > 1) {
+        vox::Platform::SetExternalStorageDirectory(_argv[1]);
+    }
+    const std::string manifest_path = _argc > 2 ? _argv[2] : vox::ShaderCache::GetManifestPath();
+
+    std::ifstream manifest(manifest_path);
+    if (!manifest.is_open()) {
+        LOGE("Failed to open shader cache manifest \"{}\"", manifest_path)
+        return EXIT_FAILURE;
+    }
+
+    // The manifest may list a variant several times, e.g. once per shader edit
+    std::set<std::string> lines;
+    for (std::string line; std::getline(manifest, line);) {
+        if (!line.empty()) {
+            lines.insert(line);
+        }
+    }
+
+    size_t failures = 0;
+    for (const std::string& line : lines) {
+        auto fields = vox::Split(line, "\t");
+        if (fields.size() < 3) {
+            LOGE("Malformed manifest line \"{}\"", line)
+            ++failures;
+            continue;
+        }
+
+        auto stage = static_cast<wgpu::ShaderStage>(std::stoul(fields[0]));
+        vox::ShaderVariant variant;
+        bool is_malformed = false;
+        for (size_t i = 3; i < fields.size(); ++i) {
+            const std::string& field = fields[i];
+            const size_t separator = field.rfind('=');
+            const bool has_size = separator != std::string::npos && separator > 1 && separator + 1 < field.size() &&
+                                  field.find_first_not_of("0123456789", separator + 1) == std::string::npos;
+            if (field.size() > 1 && field[0] == 'D') {
+                variant.AddDefine(field.substr(1));
+            } else if (field[0] == 'R' && has_size) {
+                variant.AddRuntimeArraySize(field.substr(1, separator - 1), std::stoul(field.substr(separator + 1)));
+            } else {
+                is_malformed = true;
+            }
+        }
+        if (is_malformed) {
+            LOGE("Malformed manifest line \"{}\"", line)
+            ++failures;
+            continue;
+        }
+
+        std::vector<uint32_t> spirv;
+        std::unordered_map<std::string, vox::ShaderResource> resources;
+        std::string info_log;
+        try {
+            vox::ShaderSource source(fields[1]);
+            if (!vox::ShaderModule::Compile(stage, source, fields[2], variant, spirv, resources, info_log)) {
+                ++failures;
+            }
+        } catch (const std::exception& e) {
+            LOGE("Failed to compile \"{}\": {}", fields[1], e.what())
+            ++failures;
+        }
+    }
+
+    LOGI("Warmed the shader cache with {} variants, {} failed", lines.size() - failures, failures)
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
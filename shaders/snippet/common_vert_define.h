@@ -17,7 +17,8 @@ layout(location = Position) in vec3 POSITION;
         layout(set = 0, binding = Joint_Sampler_Location) uniform sampler u_jointSampler;
         layout(set = 0, binding = Joint_Count_Location) uniform float u_jointCount;
 
-        mat4 getJointMatrix(sampler2D smp, float index) {
+        // Returns the 3 first rows of the skinning matrix, see joint_matrix.
+        mat3x4 getJointMatrix(sampler2D smp, float index) {
             float base = index / u_jointCount;
             float hf = 0.5 / u_jointCount;
             float v = base + hf;
@@ -27,12 +28,14 @@ layout(location = Position) in vec3 POSITION;
             vec4 m2 = texture(smp, vec2(0.625, v ));
             vec4 m3 = texture(smp, vec2(0.875, v ));
 
-            return mat4(m0, m1, m2, m3);
+            return mat3x4(transpose(mat4(m0, m1, m2, m3)));
         }
 
     #else
+        // Skinning matrices are affine, each column of joint_matrix holds one
+        // of their 3 first rows, so v * joint_matrix[i] transforms v.
         layout(set = 0, binding = Joint_Matrix_Location) uniform u_jointMatrix {
-            mat4 joint_matrix[JOINTS_COUNT];
+            mat3x4 joint_matrix[JOINTS_COUNT];
         };
     #endif
 #endif
@@ -4,6 +4,10 @@
 //  personal capacity and am not conveying any rights to any intellectual
 //  property of any third parties.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "test.animation/gtest_math_helper.h"
 #include "vox.animation/offline/animation_builder.h"
@@ -335,3 +339,151 @@ TEST(Sort, AnimationBuilder) {
         }
     }
 }
+
+TEST(Quantization, AnimationBuilder) {
+    RawAnimation raw_animation;
+    raw_animation.duration = 1.f;
+    raw_animation.tracks.resize(5);
+
+    // Large translations, whose fractional part can't be stored as half floats.
+    const RawAnimation::TranslationKey t_key0 = {0.f, vox::Vector3F(1000.3f, -2000.7f, 0.1f)};
+    raw_animation.tracks[4].translations.push_back(t_key0);
+    const RawAnimation::TranslationKey t_key1 = {1.f, vox::Vector3F(1010.6f, -2010.2f, 0.2f)};
+    raw_animation.tracks[4].translations.push_back(t_key1);
+    const RawAnimation::ScaleKey s_key = {0.f, vox::Vector3F(1.f, 2.f, 3.f)};
+    raw_animation.tracks[4].scales.push_back(s_key);
+    ASSERT_TRUE(raw_animation.Validate());
+
+    AnimationBuilder builder;
+    EXPECT_EQ(builder.translation_bits, 0);
+    EXPECT_EQ(builder.scale_bits, 0);
+
+    {  // Invalid number of bits.
+        builder.translation_bits = AnimationBuilder::kMaxQuantizationBits + 1;
+        EXPECT_TRUE(!builder(raw_animation));
+        builder.translation_bits = -1;
+        EXPECT_TRUE(!builder(raw_animation));
+        builder.translation_bits = 0;
+        builder.scale_bits = AnimationBuilder::kMaxQuantizationBits + 1;
+        EXPECT_TRUE(!builder(raw_animation));
+        builder.scale_bits = 0;
+    }
+
+    vox::unique_ptr<Animation> half_animation(builder(raw_animation));
+    ASSERT_TRUE(half_animation);
+    EXPECT_EQ(half_animation->quantized_translations().bits, 0);
+    EXPECT_EQ(half_animation->quantized_translations().size(), 0u);
+    EXPECT_EQ(half_animation->quantized_scales().size(), 0u);
+
+    builder.translation_bits = 16;
+    vox::unique_ptr<Animation> quantized_animation(builder(raw_animation));
+    ASSERT_TRUE(quantized_animation);
+    EXPECT_EQ(quantized_animation->quantized_translations().bits, 16);
+    EXPECT_EQ(quantized_animation->quantized_translations().size(), half_animation->translations().size());
+    EXPECT_EQ(quantized_animation->quantized_translations().ranges.size(), 2u);
+    EXPECT_EQ(quantized_animation->translations().size(), 0u);
+    EXPECT_EQ(quantized_animation->quantized_scales().size(), 0u);
+    EXPECT_EQ(quantized_animation->scales().size(), half_animation->scales().size());
+
+    vox::animation::SamplingJob::Context context(5);
+    vox::simd_math::SoaTransform output[2];
+    vox::animation::SamplingJob job;
+    job.context = &context;
+    job.output = output;
+
+    for (float ratio : {0.f, .3f, 1.f}) {
+        const vox::Vector3F expected = vox::lerp(t_key0.value, t_key1.value, ratio);
+        job.ratio = ratio;
+
+        job.animation = half_animation.get();
+        ASSERT_TRUE(job.Run());
+        float values[4];
+        vox::simd_math::StorePtrU(output[1].translation.x, values);
+        const float half_error = std::abs(values[0] - expected.x);
+
+        job.animation = quantized_animation.get();
+        ASSERT_TRUE(job.Run());
+        vox::simd_math::StorePtrU(output[1].translation.x, values);
+        EXPECT_NEAR(values[0], expected.x, 5e-3f);
+        EXPECT_LT(std::abs(values[0] - expected.x), half_error);
+        vox::simd_math::StorePtrU(output[1].translation.y, values);
+        EXPECT_NEAR(values[0], expected.y, 5e-3f);
+        vox::simd_math::StorePtrU(output[1].translation.z, values);
+        EXPECT_NEAR(values[0], expected.z, 5e-3f);
+
+        // Padding tracks still sample to identity.
+        EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+        EXPECT_SOAFLOAT3_EQ_EST(output[1].scale, 1.f, 1.f, 1.f, 1.f, 2.f, 1.f, 1.f, 1.f, 3.f, 1.f, 1.f, 1.f);
+    }
+}
+
+TEST(QuantizationError, AnimationBuilder) {
+    // Tracks of 50 keys, with ranges of very different sizes.
+    const int kNumKeys = 50;
+    RawAnimation raw_animation;
+    raw_animation.duration = 1.f;
+    raw_animation.tracks.resize(3);
+    for (int k = 0; k < kNumKeys; ++k) {
+        const float time = static_cast<float>(k) / (kNumKeys - 1);
+        const auto f = static_cast<float>((k * 37) % kNumKeys) / (kNumKeys - 1);
+        raw_animation.tracks[0].translations.push_back({time, vox::Vector3F(-500.f + f * 2000.f, f * .01f, 7.f)});
+        raw_animation.tracks[1].translations.push_back({time, vox::Vector3F(f, -f, 1.f - f)});
+        raw_animation.tracks[2].scales.push_back({time, vox::Vector3F(.5f + f * 1.5f, 1.f, 2.f - f)});
+    }
+    ASSERT_TRUE(raw_animation.Validate());
+
+    AnimationBuilder builder;
+    vox::unique_ptr<Animation> half_animation(builder(raw_animation));
+    ASSERT_TRUE(half_animation);
+
+    for (int bits : {4, 8, 12, 16}) {
+        SCOPED_TRACE(bits);
+        builder.translation_bits = bits;
+        builder.scale_bits = bits;
+        vox::unique_ptr<Animation> animation(builder(raw_animation));
+        ASSERT_TRUE(animation);
+
+        // Packed values make keys smaller than half float ones, despite ranges.
+        if (bits <= 12) {
+            EXPECT_LT(animation->size(), half_animation->size());
+        }
+
+        vox::animation::SamplingJob::Context context(3);
+        vox::simd_math::SoaTransform output[1];
+        vox::animation::SamplingJob job;
+        job.animation = animation.get();
+        job.context = &context;
+        job.output = output;
+
+        // Sampled exactly at key times, values only have the quantization error,
+        // which is at most half a quantization step of the track range.
+        const auto max_quantized = static_cast<float>((1 << bits) - 1);
+        for (int k = 0; k < kNumKeys - 1; ++k) {
+            job.ratio = raw_animation.tracks[0].translations[k].time;
+            ASSERT_TRUE(job.Run());
+
+            for (int track = 0; track < 3; ++track) {
+                const bool is_scale = track == 2;
+                const auto& keys = raw_animation.tracks[track];
+                const vox::simd_math::SoaFloat3& sampled = is_scale ? output[0].scale : output[0].translation;
+                const vox::simd_math::SimdFloat4 sampled_cpnts[3] = {sampled.x, sampled.y, sampled.z};
+                for (int c = 0; c < 3; ++c) {
+                    float min = std::numeric_limits<float>::max();
+                    float max = -min;
+                    for (int j = 0; j < kNumKeys; ++j) {
+                        const float value = is_scale ? keys.scales[j].value[c] : keys.translations[j].value[c];
+                        min = std::min(min, value);
+                        max = std::max(max, value);
+                    }
+                    const float expected = is_scale ? keys.scales[k].value[c] : keys.translations[k].value[c];
+                    const float tolerance = (max - min) / max_quantized * .5f +
+                                            4.f * std::numeric_limits<float>::epsilon() *
+                                                    std::max(std::abs(min), std::abs(max));
+                    float values[4];
+                    vox::simd_math::StorePtrU(sampled_cpnts[c], values);
+                    EXPECT_NEAR(values[track], expected, tolerance);
+                }
+            }
+        }
+    }
+}
@@ -4,6 +4,8 @@
 //  personal capacity and am not conveying any rights to any intellectual
 //  property of any third parties.
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 #include "test.animation/gtest_math_helper.h"
 #include "vox.animation/offline/animation_builder.h"
@@ -149,3 +151,147 @@ TEST(AlreadyInitialized, AnimationSerialize) {
         ASSERT_EQ(i_animation.num_tracks(), 2);
     }
 }
+
+TEST(Quantized, AnimationSerialize) {
+    // Builds a valid animation with quantized translations and scales.
+    vox::unique_ptr<Animation> o_animation;
+    {
+        RawAnimation raw_animation;
+        raw_animation.duration = 1.f;
+        raw_animation.tracks.resize(1);
+
+        RawAnimation::TranslationKey t_key0 = {0.f, vox::Vector3F(1093.f, 58.f, -46.f)};
+        raw_animation.tracks[0].translations.push_back(t_key0);
+        RawAnimation::TranslationKey t_key1 = {1.f, vox::Vector3F(1094.f, 58.f, -45.f)};
+        raw_animation.tracks[0].translations.push_back(t_key1);
+
+        RawAnimation::ScaleKey s_key = {0.f, vox::Vector3F(2.f, 3.f, 4.f)};
+        raw_animation.tracks[0].scales.push_back(s_key);
+
+        AnimationBuilder builder;
+        builder.translation_bits = 11;
+        builder.scale_bits = 5;
+        o_animation = builder(raw_animation);
+        ASSERT_TRUE(o_animation);
+        EXPECT_EQ(o_animation->quantized_translations().ranges.size(), 1u);
+        EXPECT_EQ(o_animation->quantized_scales().ranges.size(), 1u);
+    }
+
+    for (int e = 0; e < 2; ++e) {
+        vox::Endianness endianess = e == 0 ? vox::kBigEndian : vox::kLittleEndian;
+        vox::io::MemoryStream stream;
+
+        // Streams out.
+        vox::io::OArchive o(&stream, endianess);
+        o << *o_animation;
+
+        // Streams in.
+        stream.Seek(0, vox::io::Stream::kSet);
+        vox::io::IArchive i(&stream);
+
+        Animation i_animation;
+        i >> i_animation;
+
+        ASSERT_EQ(o_animation->num_tracks(), i_animation.num_tracks());
+        EXPECT_EQ(o_animation->size(), i_animation.size());
+        const vox::animation::QuantizedFloat3Keys& o_keys = o_animation->quantized_translations();
+        const vox::animation::QuantizedFloat3Keys& i_keys = i_animation.quantized_translations();
+        ASSERT_EQ(i_keys.bits, 11);
+        ASSERT_EQ(i_keys.size(), o_keys.size());
+        EXPECT_TRUE(std::equal(o_keys.ratios.begin(), o_keys.ratios.end(), i_keys.ratios.begin()));
+        EXPECT_TRUE(std::equal(o_keys.tracks.begin(), o_keys.tracks.end(), i_keys.tracks.begin()));
+        EXPECT_TRUE(std::equal(o_keys.values.begin(), o_keys.values.end(), i_keys.values.begin()));
+        ASSERT_EQ(i_animation.quantized_scales().bits, 5);
+
+        // Samples the loaded animation.
+        vox::animation::SamplingJob job;
+        vox::animation::SamplingJob::Context context(1);
+        vox::simd_math::SoaTransform output[1];
+        job.animation = &i_animation;
+        job.context = &context;
+        job.output = output;
+
+        {  // Samples at t = 0
+            job.ratio = 0.f;
+            ASSERT_TRUE(job.Run());
+            EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 1093.f, 0.f, 0.f, 0.f, 58.f, 0.f, 0.f, 0.f, -46.f, 0.f,
+                                    0.f, 0.f);
+            EXPECT_SOAFLOAT3_EQ_EST(output[0].scale, 2.f, 1.f, 1.f, 1.f, 3.f, 1.f, 1.f, 1.f, 4.f, 1.f, 1.f, 1.f);
+        }
+        {  // Samples at t = 1
+            job.ratio = 1.f;
+            ASSERT_TRUE(job.Run());
+            EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 1094.f, 0.f, 0.f, 0.f, 58.f, 0.f, 0.f, 0.f, -45.f, 0.f,
+                                    0.f, 0.f);
+        }
+    }
+}
+
+TEST(Version6, AnimationSerialize) {
+    // Writes by hand an archive of the previous version, which has no quantized
+    // keys.
+    vox::io::MemoryStream stream;
+    {
+        vox::io::OArchive o(&stream);
+        typedef vox::io::internal::Tag<const Animation> Tag;
+        o.SaveBinary(Tag::Get(), Tag::kTagLength);
+        o << static_cast<uint32_t>(6);
+
+        o << 1.f;                      // Duration.
+        o << static_cast<int32_t>(1);  // Number of tracks.
+        o << static_cast<int32_t>(0);  // Name length.
+        o << static_cast<int32_t>(8);  // Translation keys.
+        o << static_cast<int32_t>(8);  // Rotation keys.
+        o << static_cast<int32_t>(8);  // Scale keys.
+
+        // Two keys for each of the 4 tracks of the soa track, first keys first.
+        for (int k = 0; k < 8; ++k) {
+            const float ratio = k < 4 ? 0.f : 1.f;
+            const auto track = static_cast<uint16_t>(k % 4);
+            const float value = track == 0 ? (k < 4 ? 2.f : 4.f) : 0.f;
+            o << ratio;
+            o << track;
+            const uint16_t half[3] = {vox::simd_math::FloatToHalf(value), vox::simd_math::FloatToHalf(1.f),
+                                      vox::simd_math::FloatToHalf(-value)};
+            o << vox::io::MakeArray(half);
+        }
+        for (int k = 0; k < 8; ++k) {
+            o << (k < 4 ? 0.f : 1.f);
+            o << static_cast<uint16_t>(k % 4);
+            o << static_cast<uint8_t>(3);  // Identity, w is the largest.
+            o << false;
+            const int16_t value[3] = {0, 0, 0};
+            o << vox::io::MakeArray(value);
+        }
+        for (int k = 0; k < 8; ++k) {
+            o << (k < 4 ? 0.f : 1.f);
+            o << static_cast<uint16_t>(k % 4);
+            const uint16_t half[3] = {vox::simd_math::FloatToHalf(1.f), vox::simd_math::FloatToHalf(1.f),
+                                      vox::simd_math::FloatToHalf(1.f)};
+            o << vox::io::MakeArray(half);
+        }
+    }
+
+    stream.Seek(0, vox::io::Stream::kSet);
+    vox::io::IArchive i(&stream);
+
+    Animation i_animation;
+    i >> i_animation;
+    ASSERT_EQ(i_animation.num_tracks(), 1);
+    EXPECT_EQ(i_animation.translations().size(), 8u);
+    EXPECT_EQ(i_animation.quantized_translations().bits, 0);
+    EXPECT_EQ(i_animation.quantized_scales().bits, 0);
+
+    vox::animation::SamplingJob job;
+    vox::animation::SamplingJob::Context context(1);
+    vox::simd_math::SoaTransform output[1];
+    job.animation = &i_animation;
+    job.context = &context;
+    job.output = output;
+    job.ratio = .5f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 3.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f, -3.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAQUATERNION_EQ_EST(output[0].rotation, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f,
+                                1.f, 1.f, 1.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].scale, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f);
+}
@@ -0,0 +1,251 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.animation/runtime/local_to_model_tracker.h"
+
+#include "gtest/gtest.h"
+#include "test.animation/gtest_math_helper.h"
+#include "vox.animation/offline/raw_skeleton.h"
+#include "vox.animation/offline/skeleton_builder.h"
+#include "vox.animation/runtime/local_to_model_job.h"
+#include "vox.animation/runtime/skeleton.h"
+#include "vox.simd_math/soa_transform.h"
+
+using vox::animation::LocalToModelJob;
+using vox::animation::LocalToModelTracker;
+using vox::animation::Skeleton;
+using vox::animation::offline::RawSkeleton;
+using vox::animation::offline::SkeletonBuilder;
+
+namespace {
+// Builds a 6 joints skeleton:
+// root (0)
+// |- j1 (1)
+// |  |- j2 (2)
+// |- j3 (3)
+//    |- j4 (4)
+//    |- j5 (5)
+vox::unique_ptr<Skeleton> BuildSkeleton() {
+    RawSkeleton raw_skeleton;
+    raw_skeleton.roots.resize(1);
+    RawSkeleton::Joint& root = raw_skeleton.roots[0];
+    root.name = "root";
+    root.children.resize(2);
+    root.children[0].name = "j1";
+    root.children[0].children.resize(1);
+    root.children[0].children[0].name = "j2";
+    root.children[1].name = "j3";
+    root.children[1].children.resize(2);
+    root.children[1].children[0].name = "j4";
+    root.children[1].children[1].name = "j5";
+
+    SkeletonBuilder builder;
+    return builder(raw_skeleton);
+}
+}  // namespace
+
+TEST(Validity, LocalToModelTracker) {
+    vox::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+    ASSERT_TRUE(skeleton);
+
+    vox::simd_math::SoaTransform input[2] = {vox::simd_math::SoaTransform::identity(),
+                                             vox::simd_math::SoaTransform::identity()};
+    vox::simd_math::Float4x4 output[6];
+
+    // Default tracker has no joint.
+    {
+        LocalToModelTracker tracker;
+        EXPECT_EQ(tracker.num_joints(), 0);
+        EXPECT_FALSE(tracker.HasDirty());
+    }
+
+    // Everything is dirty after a resize.
+    LocalToModelTracker tracker(*skeleton);
+    EXPECT_EQ(tracker.num_joints(), 6);
+    EXPECT_TRUE(tracker.HasDirty());
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_TRUE(tracker.IsOutdated(i));
+    }
+
+    // Invalid job.
+    {
+        LocalToModelJob job;
+        EXPECT_FALSE(tracker.Update(job));
+        EXPECT_FALSE(tracker.Update(job, 0));
+        EXPECT_TRUE(tracker.HasDirty());
+    }
+
+    // Job for a different skeleton.
+    {
+        RawSkeleton raw_skeleton;
+        raw_skeleton.roots.resize(1);
+        raw_skeleton.roots[0].name = "root";
+        SkeletonBuilder builder;
+        vox::unique_ptr<Skeleton> other(builder(raw_skeleton));
+        ASSERT_TRUE(other);
+
+        LocalToModelJob job;
+        job.skeleton = other.get();
+        job.input = input;
+        job.output = output;
+        EXPECT_FALSE(tracker.Update(job));
+        EXPECT_TRUE(tracker.HasDirty());
+    }
+
+    // Valid job.
+    {
+        LocalToModelJob job;
+        job.skeleton = skeleton.get();
+        job.input = input;
+        job.output = output;
+        EXPECT_TRUE(tracker.Update(job));
+        EXPECT_EQ(tracker.num_jobs(), 1);
+        EXPECT_FALSE(tracker.HasDirty());
+
+        // Nothing to update.
+        EXPECT_TRUE(tracker.Update(job));
+        EXPECT_EQ(tracker.num_jobs(), 0);
+    }
+}
+
+TEST(Dirty, LocalToModelTracker) {
+    vox::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+    ASSERT_TRUE(skeleton);
+
+    LocalToModelTracker tracker(*skeleton);
+    tracker.Clear();
+    EXPECT_FALSE(tracker.HasDirty());
+
+    // Dirty joints outdate their hierarchy only.
+    tracker.SetDirty(1);
+    EXPECT_TRUE(tracker.HasDirty());
+    EXPECT_FALSE(tracker.IsOutdated(0));
+    EXPECT_TRUE(tracker.IsOutdated(1));
+    EXPECT_TRUE(tracker.IsOutdated(2));
+    EXPECT_FALSE(tracker.IsOutdated(3));
+    EXPECT_FALSE(tracker.IsOutdated(4));
+    EXPECT_FALSE(tracker.IsOutdated(5));
+
+    tracker.SetDirty(4);
+    EXPECT_FALSE(tracker.IsOutdated(3));
+    EXPECT_TRUE(tracker.IsOutdated(4));
+    EXPECT_FALSE(tracker.IsOutdated(5));
+
+    tracker.SetAllDirty();
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_TRUE(tracker.IsOutdated(i));
+    }
+
+    tracker.Clear();
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_FALSE(tracker.IsOutdated(i));
+    }
+}
+
+TEST(Update, LocalToModelTracker) {
+    vox::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+    ASSERT_TRUE(skeleton);
+
+    // All joints are translated by 1 on x, so model-space x translation is the
+    // depth of the joint + 1.
+    vox::simd_math::SoaTransform input[2] = {vox::simd_math::SoaTransform::identity(),
+                                             vox::simd_math::SoaTransform::identity()};
+    input[0].translation.x = vox::simd_math::simd_float4::Load1(1.f);
+    input[1].translation.x = vox::simd_math::simd_float4::Load1(1.f);
+    vox::simd_math::Float4x4 output[6];
+
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+
+    LocalToModelTracker tracker(*skeleton);
+    EXPECT_TRUE(tracker.Update(job));
+    EXPECT_EQ(tracker.num_jobs(), 1);
+    EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 1.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[1], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 2.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[2], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[3], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 2.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[4], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[5], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f);
+
+    // A dirty joint and its child are updated by a single job. Other joints
+    // don't see local-space changes.
+    {
+        input[0].translation.x = vox::simd_math::simd_float4::Load1(2.f);
+        input[1].translation.x = vox::simd_math::simd_float4::Load1(2.f);
+        tracker.SetDirty(2);
+        tracker.SetDirty(1);
+        EXPECT_TRUE(tracker.Update(job));
+        EXPECT_EQ(tracker.num_jobs(), 1);
+        EXPECT_FALSE(tracker.HasDirty());
+        EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 1.f, 0.f, 0.f, 1.f);
+        EXPECT_FLOAT4x4_EQ(output[1], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f);
+        EXPECT_FLOAT4x4_EQ(output[2], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 5.f, 0.f, 0.f, 1.f);
+        EXPECT_FLOAT4x4_EQ(output[3], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 2.f, 0.f, 0.f, 1.f);
+    }
+
+    // Disjoint hierarchies require a job each.
+    {
+        input[0].translation.x = vox::simd_math::simd_float4::Load1(3.f);
+        input[1].translation.x = vox::simd_math::simd_float4::Load1(3.f);
+        tracker.SetDirty(2);
+        tracker.SetDirty(4);
+        EXPECT_TRUE(tracker.Update(job));
+        EXPECT_EQ(tracker.num_jobs(), 2);
+        EXPECT_FLOAT4x4_EQ(output[1], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f);
+        EXPECT_FLOAT4x4_EQ(output[2], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 6.f, 0.f, 0.f, 1.f);
+        EXPECT_FLOAT4x4_EQ(output[3], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 2.f, 0.f, 0.f, 1.f);
+        EXPECT_FLOAT4x4_EQ(output[4], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 5.f, 0.f, 0.f, 1.f);
+        EXPECT_FLOAT4x4_EQ(output[5], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f);
+    }
+
+    // Everything is recomputed once all joints are dirty.
+    {
+        tracker.SetAllDirty();
+        EXPECT_TRUE(tracker.Update(job));
+        EXPECT_EQ(tracker.num_jobs(), 1);
+        EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f);
+        EXPECT_FLOAT4x4_EQ(output[5], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 9.f, 0.f, 0.f, 1.f);
+    }
+}
+
+TEST(UpdateJoint, LocalToModelTracker) {
+    vox::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+    ASSERT_TRUE(skeleton);
+
+    vox::simd_math::SoaTransform input[2] = {vox::simd_math::SoaTransform::identity(),
+                                             vox::simd_math::SoaTransform::identity()};
+    vox::simd_math::Float4x4 output[6];
+
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+
+    LocalToModelTracker tracker(*skeleton);
+    EXPECT_TRUE(tracker.Update(job));
+
+    // Only the hierarchy of the top-most dirty parent of the joint is updated.
+    tracker.SetDirty(2);
+    tracker.SetDirty(1);
+    tracker.SetDirty(5);
+    EXPECT_TRUE(tracker.Update(job, 2));
+    EXPECT_EQ(tracker.num_jobs(), 1);
+    EXPECT_FALSE(tracker.IsOutdated(1));
+    EXPECT_FALSE(tracker.IsOutdated(2));
+    EXPECT_TRUE(tracker.IsOutdated(5));
+    EXPECT_TRUE(tracker.HasDirty());
+
+    // Joint is already up to date.
+    EXPECT_TRUE(tracker.Update(job, 4));
+    EXPECT_EQ(tracker.num_jobs(), 0);
+    EXPECT_TRUE(tracker.IsOutdated(5));
+
+    EXPECT_TRUE(tracker.Update(job, 5));
+    EXPECT_EQ(tracker.num_jobs(), 1);
+    EXPECT_FALSE(tracker.HasDirty());
+}
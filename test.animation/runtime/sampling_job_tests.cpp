@@ -4,18 +4,31 @@
 //  personal capacity and am not conveying any rights to any intellectual
 //  property of any third parties.
 
+#include <cstring>
+#include <deque>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "test.animation/gtest_math_helper.h"
 #include "vox.animation/offline/animation_builder.h"
 #include "vox.animation/offline/raw_animation.h"
+#include "vox.animation/offline/raw_skeleton.h"
+#include "vox.animation/offline/skeleton_builder.h"
 #include "vox.animation/runtime/animation.h"
+#include "vox.animation/runtime/local_to_model_job.h"
 #include "vox.animation/runtime/sampling_job.h"
+#include "vox.animation/runtime/skeleton.h"
+#include "vox.base/parallel.h"
 #include "vox.simd_math/soa_transform.h"
 
 using vox::animation::Animation;
+using vox::animation::LocalToModelJob;
 using vox::animation::SamplingJob;
+using vox::animation::Skeleton;
 using vox::animation::offline::AnimationBuilder;
 using vox::animation::offline::RawAnimation;
+using vox::animation::offline::RawSkeleton;
+using vox::animation::offline::SkeletonBuilder;
 
 TEST(JobValidity, SamplingJob) {
     RawAnimation raw_animation;
@@ -572,3 +585,141 @@ TEST(CacheResize, SamplingJob) {
     context.Resize(1);
     EXPECT_FALSE(job.Validate());
 }
+
+TEST(SampledSoaTracks, SamplingJob) {
+    RawAnimation raw_animation;
+    raw_animation.duration = 1.f;
+    raw_animation.tracks.resize(5);  // 2 soa tracks.
+
+    const RawAnimation::TranslationKey tkey00 = {0.f, vox::Vector3F(1.f, 2.f, 4.f)};
+    raw_animation.tracks[0].translations.push_back(tkey00);
+    const RawAnimation::TranslationKey tkey01 = {1.f, vox::Vector3F(2.f, 4.f, 8.f)};
+    raw_animation.tracks[0].translations.push_back(tkey01);
+
+    const RawAnimation::TranslationKey tkey40 = {0.f, vox::Vector3F(-1.f, -2.f, -4.f)};
+    raw_animation.tracks[4].translations.push_back(tkey40);
+    const RawAnimation::TranslationKey tkey41 = {1.f, vox::Vector3F(-2.f, -4.f, -8.f)};
+    raw_animation.tracks[4].translations.push_back(tkey41);
+
+    AnimationBuilder builder;
+    vox::unique_ptr<Animation> animation(builder(raw_animation));
+    ASSERT_TRUE(animation);
+
+    SamplingJob::Context context(5);
+    vox::simd_math::SoaTransform output[2];
+    memset(output, 0, sizeof(output));
+
+    // Only the first soa track is sampled.
+    const uint8_t sampled[1] = {1};
+
+    SamplingJob job;
+    job.animation = animation.get();
+    job.context = &context;
+    job.output = output;
+    job.sampled_soa_tracks = sampled;
+
+    job.ratio = 0.f;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 1.f, 0.f, 0.f, 0.f, 2.f, 0.f, 0.f, 0.f, 4.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+
+    // The second soa track is left unchanged while disabled.
+    job.ratio = .25f;
+    EXPECT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 1.25f, 0.f, 0.f, 0.f, 2.5f, 0.f, 0.f, 0.f, 5.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+
+    // Enabling it again decompresses its keys, even though the context cursor
+    // went past them.
+    job.sampled_soa_tracks = {};
+    job.ratio = .5f;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 1.5f, 0.f, 0.f, 0.f, 3.f, 0.f, 0.f, 0.f, 6.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, -1.5f, 0.f, 0.f, 0.f, -3.f, 0.f, 0.f, 0.f, -6.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAQUATERNION_EQ_EST(output[1].rotation, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f,
+                                1.f, 1.f, 1.f);
+}
+
+TEST(ParallelCharacters, SamplingJob) {
+    // Characters sharing a skeleton but owning their sampling context and buffers, like animators do. Evaluating
+    // them concurrently must give bit-identical results to the serial loop.
+    RawSkeleton raw_skeleton;
+    raw_skeleton.roots.resize(1);
+    RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+    for (int i = 0; i < 9; ++i) {
+        joint->name = "j" + std::to_string(i);
+        joint->transform.translation = vox::Vector3F(0.f, 1.f, 0.f);
+        joint->children.resize(1);
+        joint = &joint->children[0];
+    }
+    joint->name = "j9";
+    vox::unique_ptr<Skeleton> skeleton(SkeletonBuilder()(raw_skeleton));
+    ASSERT_TRUE(skeleton);
+    const int num_joints = skeleton->num_joints();
+
+    const size_t num_characters = 64;
+    std::vector<vox::unique_ptr<Animation>> animations;
+    for (size_t c = 0; c < num_characters; ++c) {
+        RawAnimation raw_animation;
+        raw_animation.duration = 1.f + static_cast<float>(c % 7) * .1f;
+        raw_animation.tracks.resize(num_joints);
+        for (int t = 0; t < num_joints; ++t) {
+            for (int k = 0; k <= 4; ++k) {
+                const float time = raw_animation.duration * static_cast<float>(k) / 4.f;
+                const float value = static_cast<float>(c + t * k) * .01f;
+                raw_animation.tracks[t].translations.push_back({time, vox::Vector3F(value, 1.f, -value)});
+                raw_animation.tracks[t].rotations.push_back(
+                        {time, vox::QuaternionF(vox::Vector3F(0.f, 0.f, 1.f), value)});
+            }
+        }
+        animations.emplace_back(AnimationBuilder()(raw_animation));
+        ASSERT_TRUE(animations.back());
+    }
+
+    struct Character {
+        explicit Character(const Skeleton& skeleton)
+            : context(skeleton.num_joints()), locals(skeleton.num_soa_joints()), models(skeleton.num_joints()) {}
+
+        SamplingJob::Context context;
+        std::vector<vox::simd_math::SoaTransform> locals;
+        std::vector<vox::simd_math::Float4x4> models;
+    };
+
+    auto evaluate = [&](Character& character, size_t c, float ratio) {
+        SamplingJob sampling_job;
+        sampling_job.animation = animations[c].get();
+        sampling_job.context = &character.context;
+        sampling_job.ratio = ratio;
+        sampling_job.output = vox::make_span(character.locals);
+        LocalToModelJob ltm_job;
+        ltm_job.skeleton = skeleton.get();
+        ltm_job.input = vox::make_span(character.locals);
+        ltm_job.output = vox::make_span(character.models);
+        return sampling_job.Run() && ltm_job.Run();
+    };
+
+    // Contexts can't be copied or moved.
+    std::deque<Character> serial;
+    std::deque<Character> parallel;
+    for (size_t c = 0; c < num_characters; ++c) {
+        serial.emplace_back(*skeleton);
+        parallel.emplace_back(*skeleton);
+    }
+    std::vector<int> succeeded(num_characters, 0);
+    for (int frame = 0; frame < 30; ++frame) {
+        const float ratio = static_cast<float>(frame) / 29.f;
+        for (size_t c = 0; c < num_characters; ++c) {
+            ASSERT_TRUE(evaluate(serial[c], c, ratio));
+        }
+        vox::parallelFor(vox::kZeroSize, num_characters,
+                         [&](size_t c) { succeeded[c] = evaluate(parallel[c], c, ratio) ? 1 : 0; });
+
+        for (size_t c = 0; c < num_characters; ++c) {
+            ASSERT_EQ(1, succeeded[c]);
+            EXPECT_EQ(0, std::memcmp(serial[c].models.data(), parallel[c].models.data(),
+                                     serial[c].models.size() * sizeof(vox::simd_math::Float4x4)));
+        }
+    }
+}
@@ -0,0 +1,324 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "vox.animation/runtime/skinning_job.h"
+#include "vox.base/parallel.h"
+#include "vox.simd_math/simd_math.h"
+
+using vox::make_span;
+using vox::animation::SkinningJob;
+using vox::simd_math::Float4x4;
+using vox::simd_math::simd_float4::Load;
+
+namespace {
+std::vector<Float4x4> BuildMatrices(int _count) {
+    std::vector<Float4x4> matrices;
+    for (int i = 0; i < _count; ++i) {
+        const auto f = static_cast<float>(i);
+        matrices.push_back(Float4x4::Translation(Load(f, 2.f * f, -f, 0.f)) *
+                           Float4x4::FromEuler(Load(.3f * f, -.2f * f, .1f, 0.f)) *
+                           Float4x4::Scaling(Load(1.f + .5f * f, 1.f, 2.f - .1f * f, 0.f)));
+    }
+    return matrices;
+}
+
+// Skinning data of _vertex_count vertices, influenced by _influences joints.
+struct Vertices {
+    Vertices(int _vertex_count, int _influences, int _num_joints)
+        : vertex_count(_vertex_count), influences(_influences) {
+        for (int i = 0; i < _vertex_count; ++i) {
+            // Bounded coordinates to keep float precision comparable.
+            const auto f = static_cast<float>(i % 32);
+            positions.insert(positions.end(), {f, -f * .5f, 1.f + f});
+            normals.insert(normals.end(), {0.f, 1.f, f * .1f});
+            tangents.insert(tangents.end(), {1.f, f * .2f, 0.f, -1.f});
+            for (int j = 0; j < _influences; ++j) {
+                indices.push_back(static_cast<uint16_t>((i * 7 + j * 3) % _num_joints));
+            }
+            for (int j = 0; j < _influences - 1; ++j) {
+                weights.push_back(1.f / static_cast<float>(_influences + j + i % 3));
+            }
+        }
+    }
+
+    // Setups _job to skin all vertices to out_* buffers.
+    void Setup(SkinningJob* _job) {
+        out_positions.assign(positions.size(), 0.f);
+        out_normals.assign(normals.size(), 0.f);
+        out_tangents.assign(tangents.size(), 42.f);
+
+        _job->vertex_count = vertex_count;
+        _job->influences_count = influences;
+        _job->joint_indices = make_span(indices);
+        _job->joint_indices_stride = sizeof(uint16_t) * influences;
+        _job->joint_weights = make_span(weights);
+        _job->joint_weights_stride = sizeof(float) * (influences - 1);
+        _job->in_positions = make_span(positions);
+        _job->in_positions_stride = sizeof(float) * 3;
+        _job->out_positions = make_span(out_positions);
+        _job->out_positions_stride = sizeof(float) * 3;
+        _job->in_normals = make_span(normals);
+        _job->in_normals_stride = sizeof(float) * 3;
+        _job->out_normals = make_span(out_normals);
+        _job->out_normals_stride = sizeof(float) * 3;
+        // Tangents have 4 components.
+        _job->in_tangents = make_span(tangents);
+        _job->in_tangents_stride = sizeof(float) * 4;
+        _job->out_tangents = make_span(out_tangents);
+        _job->out_tangents_stride = sizeof(float) * 4;
+    }
+
+    int vertex_count;
+    int influences;
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> tangents;
+    std::vector<uint16_t> indices;
+    std::vector<float> weights;
+    std::vector<float> out_positions;
+    std::vector<float> out_normals;
+    std::vector<float> out_tangents;
+};
+
+// Scalar reference implementation.
+void Reference(const std::vector<Float4x4>& _matrices,
+               const Vertices& _vertices,
+               int _vertex,
+               const float* _in,
+               float _w,
+               float* _out) {
+    const int influences = _vertices.influences;
+    float sum = 0.f;
+    for (int k = 0; k < 3; ++k) {
+        _out[k] = 0.f;
+    }
+    for (int j = 0; j < influences; ++j) {
+        float weight;
+        if (j < influences - 1) {
+            weight = _vertices.weights[_vertex * (influences - 1) + j];
+            sum += weight;
+        } else {
+            weight = 1.f - sum;
+        }
+        float cols[16];
+        const Float4x4& m = _matrices[_vertices.indices[_vertex * influences + j]];
+        for (int c = 0; c < 4; ++c) {
+            vox::simd_math::StorePtrU(m.cols[c], cols + c * 4);
+        }
+        for (int k = 0; k < 3; ++k) {
+            _out[k] += weight * (cols[k] * _in[0] + cols[4 + k] * _in[1] + cols[8 + k] * _in[2] + cols[12 + k] * _w);
+        }
+    }
+}
+
+void ExpectSkinned(const std::vector<Float4x4>& _matrices, const Vertices& _vertices) {
+    for (int i = 0; i < _vertices.vertex_count; ++i) {
+        float expected[3];
+        Reference(_matrices, _vertices, i, &_vertices.positions[i * 3], 1.f, expected);
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_NEAR(expected[k], _vertices.out_positions[i * 3 + k], 1e-3f);
+        }
+        Reference(_matrices, _vertices, i, &_vertices.normals[i * 3], 0.f, expected);
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_NEAR(expected[k], _vertices.out_normals[i * 3 + k], 1e-3f);
+        }
+        Reference(_matrices, _vertices, i, &_vertices.tangents[i * 4], 0.f, expected);
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_NEAR(expected[k], _vertices.out_tangents[i * 4 + k], 1e-3f);
+        }
+        // Tangents w isn't written.
+        EXPECT_FLOAT_EQ(42.f, _vertices.out_tangents[i * 4 + 3]);
+    }
+}
+}  // namespace
+
+TEST(JobValidity, SkinningJob) {
+    const std::vector<Float4x4> matrices = BuildMatrices(4);
+    Vertices vertices(10, 3, 4);
+
+    {  // Default is invalid.
+        SkinningJob job;
+        EXPECT_FALSE(job.Validate());
+        EXPECT_FALSE(job.Run());
+    }
+    {  // Valid.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        EXPECT_TRUE(job.Validate());
+        EXPECT_TRUE(job.Run());
+    }
+    {  // No vertex.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.vertex_count = 0;
+        EXPECT_TRUE(job.Validate());
+    }
+    {  // Missing matrices.
+        SkinningJob job;
+        vertices.Setup(&job);
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Inverse transpose matrices too small.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.joint_inverse_transpose_matrices = make_span(matrices).first(3);
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Invalid influences.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.influences_count = 0;
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Too many vertices.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.vertex_count = 11;
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Missing weights.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.joint_weights = {};
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Missing output normals.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.out_normals = {};
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Optional normals and tangents.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.in_normals = {};
+        job.out_normals = {};
+        job.in_tangents = {};
+        job.out_tangents = {};
+        EXPECT_TRUE(job.Validate());
+    }
+    {  // Stride smaller than a position.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.out_positions_stride = sizeof(float) * 2;
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Misaligned stride.
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.joint_weights_stride = sizeof(float) * 2 + 1;
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Single influence doesn't need weights.
+        Vertices single(10, 1, 4);
+        SkinningJob job;
+        single.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.joint_weights = {};
+        EXPECT_TRUE(job.Validate());
+    }
+}
+
+TEST(Influences, SkinningJob) {
+    const std::vector<Float4x4> matrices = BuildMatrices(7);
+
+    // Specialized kernels, and the generic one.
+    for (int influences = 1; influences <= 6; ++influences) {
+        SCOPED_TRACE(influences);
+        Vertices vertices(17, influences, 7);
+
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        ASSERT_TRUE(job.Run());
+
+        ExpectSkinned(matrices, vertices);
+    }
+}
+
+TEST(InverseTranspose, SkinningJob) {
+    const std::vector<Float4x4> matrices = BuildMatrices(3);
+    // Zero matrices make it obvious which set transforms normals.
+    const Float4x4 zero = {{vox::simd_math::simd_float4::zero(), vox::simd_math::simd_float4::zero(),
+                            vox::simd_math::simd_float4::zero(), vox::simd_math::simd_float4::zero()}};
+    const std::vector<Float4x4> it_matrices(3, zero);
+
+    for (int influences = 1; influences <= 2; ++influences) {
+        Vertices vertices(5, influences, 3);
+        SkinningJob job;
+        vertices.Setup(&job);
+        job.joint_matrices = make_span(matrices);
+        job.joint_inverse_transpose_matrices = make_span(it_matrices);
+        ASSERT_TRUE(job.Run());
+
+        for (float normal : vertices.out_normals) {
+            EXPECT_FLOAT_EQ(0.f, normal);
+        }
+        // Positions and tangents still use skinning matrices.
+        EXPECT_NE(0.f, vertices.out_tangents[0]);
+    }
+}
+
+TEST(InPlace, SkinningJob) {
+    const std::vector<Float4x4> matrices = BuildMatrices(4);
+    Vertices vertices(9, 2, 4);
+
+    SkinningJob job;
+    vertices.Setup(&job);
+    job.joint_matrices = make_span(matrices);
+    ASSERT_TRUE(job.Run());
+    const std::vector<float> expected = vertices.out_positions;
+
+    // Output aliases input.
+    job.out_positions = make_span(vertices.positions);
+    ASSERT_TRUE(job.Run());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(expected[i], vertices.positions[i]);
+    }
+}
+
+TEST(Parallel, SkinningJob) {
+    const std::vector<Float4x4> matrices = BuildMatrices(16);
+    Vertices vertices(10000, 4, 16);
+
+    SkinningJob whole;
+    vertices.Setup(&whole);
+    whole.joint_matrices = make_span(matrices);
+
+    // Skins disjoint vertex ranges concurrently, by offsetting streams.
+    const size_t kBatchSize = 512;
+    vox::parallelRangeFor(vox::kZeroSize, static_cast<size_t>(vertices.vertex_count), [&](size_t _begin, size_t _end) {
+        for (size_t begin = _begin; begin < _end; begin += kBatchSize) {
+            const size_t end = std::min(begin + kBatchSize, _end);
+            SkinningJob job = whole;
+            job.vertex_count = static_cast<int>(end - begin);
+            job.joint_indices = whole.joint_indices.subspan(begin * 4, (end - begin) * 4);
+            job.joint_weights = whole.joint_weights.subspan(begin * 3, (end - begin) * 3);
+            job.in_positions = whole.in_positions.subspan(begin * 3, (end - begin) * 3);
+            job.out_positions = whole.out_positions.subspan(begin * 3, (end - begin) * 3);
+            job.in_normals = whole.in_normals.subspan(begin * 3, (end - begin) * 3);
+            job.out_normals = whole.out_normals.subspan(begin * 3, (end - begin) * 3);
+            job.in_tangents = whole.in_tangents.subspan(begin * 4, (end - begin) * 4);
+            job.out_tangents = whole.out_tangents.subspan(begin * 4, (end - begin) * 4);
+            EXPECT_TRUE(job.Run());
+        }
+    });
+
+    ExpectSkinned(matrices, vertices);
+}
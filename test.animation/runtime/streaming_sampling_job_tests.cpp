@@ -0,0 +1,317 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "vox.animation/offline/animation_builder.h"
+#include "vox.animation/offline/raw_animation.h"
+#include "vox.animation/offline/streaming_animation_builder.h"
+#include "vox.animation/runtime/animation.h"
+#include "vox.animation/runtime/animation_page_cache.h"
+#include "vox.animation/runtime/sampling_job.h"
+#include "vox.animation/runtime/streaming_animation.h"
+#include "vox.animation/runtime/streaming_sampling_job.h"
+#include "vox.base/io/archive.h"
+#include "vox.simd_math/soa_transform.h"
+
+using vox::animation::Animation;
+using vox::animation::AnimationPageCache;
+using vox::animation::SamplingJob;
+using vox::animation::StreamingAnimation;
+using vox::animation::StreamingSamplingJob;
+using vox::animation::offline::AnimationBuilder;
+using vox::animation::offline::RawAnimation;
+using vox::animation::offline::StreamingAnimationBuilder;
+
+namespace {
+// Builds an animation with tracks keyed at different rates, including a track
+// without any key. Translations and scales are quantized on _bits bits if not 0.
+vox::unique_ptr<Animation> BuildAnimation(float _duration, int _num_tracks, int _bits = 0) {
+    RawAnimation raw_animation;
+    raw_animation.duration = _duration;
+    raw_animation.name = "streamed";
+    raw_animation.tracks.resize(_num_tracks);
+    for (int i = 1; i < _num_tracks; ++i) {
+        RawAnimation::JointTrack& track = raw_animation.tracks[i];
+        const float period = _duration / static_cast<float>(3 + i * 5);
+        int k = 0;
+        for (float time = period * .5f * static_cast<float>(i % 2); time <= _duration; time += period, ++k) {
+            const auto f = static_cast<float>(k);
+            track.translations.push_back({time, vox::Vector3F(f, -f * i, 1.f)});
+            track.rotations.push_back({time, vox::QuaternionF(vox::Vector3F::y_axis(), .3f * f)});
+            if (k % 3 == 0) {
+                track.scales.push_back({time, vox::Vector3F(1.f + f * .1f, 1.f, 2.f)});
+            }
+        }
+    }
+    AnimationBuilder builder;
+    builder.translation_bits = _bits;
+    builder.scale_bits = _bits;
+    return builder(raw_animation);
+}
+
+// Saves _streaming to _stream and loads it back in _loaded.
+void SaveAndLoad(const StreamingAnimation& _streaming, vox::io::MemoryStream* _stream, StreamingAnimation* _loaded) {
+    {
+        vox::io::OArchive o(_stream);
+        o << _streaming;
+    }
+    _stream->Seek(0, vox::io::Stream::kSet);
+    vox::io::IArchive i(_stream);
+    ASSERT_TRUE(i.TestTag<StreamingAnimation>());
+    i >> *_loaded;
+}
+}  // namespace
+
+TEST(JobValidity, StreamingSamplingJob) {
+    vox::unique_ptr<Animation> animation = BuildAnimation(2.f, 6);
+    ASSERT_TRUE(animation);
+    vox::unique_ptr<StreamingAnimation> streaming = StreamingAnimationBuilder()(*animation);
+    ASSERT_TRUE(streaming);
+
+    AnimationPageCache cache(1 << 20);
+    StreamingSamplingJob::Context context(6);
+    StreamingSamplingJob::Context small_context(1);
+    vox::simd_math::SoaTransform output[2];
+
+    {  // Default job.
+        StreamingSamplingJob job;
+        EXPECT_FALSE(job.Validate());
+        EXPECT_FALSE(job.Run());
+    }
+    {  // Missing cache.
+        StreamingSamplingJob job;
+        job.animation = streaming.get();
+        job.context = &context;
+        job.output = output;
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Context too small.
+        StreamingSamplingJob job;
+        job.animation = streaming.get();
+        job.cache = &cache;
+        job.context = &small_context;
+        job.output = output;
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Empty output.
+        StreamingSamplingJob job;
+        job.animation = streaming.get();
+        job.cache = &cache;
+        job.context = &context;
+        EXPECT_FALSE(job.Validate());
+    }
+    {  // Valid.
+        StreamingSamplingJob job;
+        job.ratio = 2155.f;  // Any time ratio can be set, it's clamped in unit interval.
+        job.animation = streaming.get();
+        job.cache = &cache;
+        job.context = &context;
+        job.output = output;
+        EXPECT_TRUE(job.Validate());
+        EXPECT_TRUE(job.Run());
+    }
+    {  // Invalid page duration.
+        StreamingAnimationBuilder builder;
+        builder.page_duration = 0.f;
+        EXPECT_FALSE(builder(*animation));
+    }
+}
+
+TEST(Pages, StreamingAnimation) {
+    vox::unique_ptr<Animation> animation = BuildAnimation(10.f, 5);
+    ASSERT_TRUE(animation);
+
+    StreamingAnimationBuilder builder;
+    builder.page_duration = 3.f;
+    vox::unique_ptr<StreamingAnimation> streaming = builder(*animation);
+    ASSERT_TRUE(streaming);
+
+    EXPECT_FLOAT_EQ(10.f, streaming->duration());
+    EXPECT_EQ(5, streaming->num_tracks());
+    EXPECT_STREQ("streamed", streaming->name());
+    ASSERT_EQ(4, streaming->num_pages());
+    EXPECT_FLOAT_EQ(0.f, streaming->page_ratios()[0]);
+    EXPECT_FLOAT_EQ(1.f, streaming->page_ratios()[4]);
+
+    EXPECT_EQ(0, streaming->FindPage(-1.f));
+    EXPECT_EQ(0, streaming->FindPage(0.f));
+    EXPECT_EQ(0, streaming->FindPage(.2f));
+    EXPECT_EQ(1, streaming->FindPage(.25f));
+    EXPECT_EQ(3, streaming->FindPage(.99f));
+    EXPECT_EQ(3, streaming->FindPage(1.f));
+    EXPECT_EQ(3, streaming->FindPage(2.f));
+
+    // Every page is smaller than the whole animation.
+    for (int i = 0; i < streaming->num_pages(); ++i) {
+        vox::unique_ptr<Animation> page = streaming->LoadPage(i);
+        ASSERT_TRUE(page);
+        EXPECT_EQ(animation->num_tracks(), page->num_tracks());
+        EXPECT_LT(page->translations().size(), animation->translations().size());
+    }
+    EXPECT_FALSE(streaming->LoadPage(-1));
+    EXPECT_FALSE(streaming->LoadPage(4));
+
+    // Loaded from a stream.
+    vox::io::MemoryStream stream;
+    StreamingAnimation loaded;
+    SaveAndLoad(*streaming, &stream, &loaded);
+    EXPECT_NE(streaming->id(), loaded.id());
+    EXPECT_FLOAT_EQ(10.f, loaded.duration());
+    EXPECT_EQ(5, loaded.num_tracks());
+    EXPECT_STREQ("streamed", loaded.name());
+    ASSERT_EQ(4, loaded.num_pages());
+    for (int i = 0; i < loaded.num_pages(); ++i) {
+        EXPECT_EQ(streaming->page_size(i), loaded.page_size(i));
+        EXPECT_TRUE(loaded.LoadPage(i));
+    }
+
+    // Saving a loaded animation copies pages from its stream.
+    vox::io::MemoryStream stream2;
+    StreamingAnimation reloaded;
+    SaveAndLoad(loaded, &stream2, &reloaded);
+    ASSERT_EQ(4, reloaded.num_pages());
+    EXPECT_TRUE(reloaded.LoadPage(3));
+}
+
+TEST(Sampling, StreamingSamplingJob) {
+    vox::unique_ptr<Animation> animation = BuildAnimation(10.f, 7);
+    ASSERT_TRUE(animation);
+
+    StreamingAnimationBuilder builder;
+    builder.page_duration = 1.5f;
+    vox::unique_ptr<StreamingAnimation> built = builder(*animation);
+    ASSERT_TRUE(built);
+
+    vox::io::MemoryStream stream;
+    StreamingAnimation streaming;
+    SaveAndLoad(*built, &stream, &streaming);
+    ASSERT_EQ(7, streaming.num_pages());
+
+    // A budget of a single page.
+    AnimationPageCache cache(1);
+
+    SamplingJob::Context context(7);
+    StreamingSamplingJob::Context streaming_context(7);
+    vox::simd_math::SoaTransform expected[2];
+    vox::simd_math::SoaTransform output[2];
+
+    SamplingJob job;
+    job.animation = animation.get();
+    job.context = &context;
+    job.output = expected;
+
+    StreamingSamplingJob streaming_job;
+    streaming_job.animation = &streaming;
+    streaming_job.cache = &cache;
+    streaming_job.context = &streaming_context;
+    streaming_job.output = output;
+
+    // Forward, backward, then jumping around, exactly at page boundaries too.
+    vox::vector<float> ratios;
+    for (int i = 0; i <= 140; ++i) {
+        ratios.push_back(static_cast<float>(i) / 140.f);
+    }
+    for (int i = 140; i >= 0; --i) {
+        ratios.push_back(static_cast<float>(i) / 140.f);
+    }
+    for (int i = 0; i < 50; ++i) {
+        ratios.push_back(static_cast<float>((i * 37) % 50) / 50.f);
+    }
+    for (float ratio : streaming.page_ratios()) {
+        ratios.push_back(ratio);
+    }
+
+    for (float ratio : ratios) {
+        SCOPED_TRACE(ratio);
+        job.ratio = ratio;
+        ASSERT_TRUE(job.Run());
+        streaming_job.ratio = ratio;
+        ASSERT_TRUE(streaming_job.Run());
+
+        // Same keys are interpolated, so results are identical.
+        EXPECT_EQ(0, std::memcmp(expected, output, sizeof(output)));
+    }
+
+    // Budget is respected, even if every page got loaded.
+    EXPECT_EQ(1u, cache.num_pages());
+    EXPECT_GE(cache.num_misses(), 7u);
+
+    // Pages are shared between animations instances and contexts.
+    cache.set_budget(1 << 20);
+    StreamingSamplingJob::Context other_context(7);
+    streaming_job.context = &other_context;
+    const size_t misses = cache.num_misses();
+    for (float ratio : ratios) {
+        streaming_job.ratio = ratio;
+        ASSERT_TRUE(streaming_job.Run());
+    }
+    EXPECT_EQ(7u, cache.num_pages());
+    EXPECT_EQ(misses + 6, cache.num_misses());
+    const size_t hits = cache.num_hits();
+    streaming_job.ratio = 0.f;
+    streaming_context.Invalidate();
+    streaming_job.context = &streaming_context;
+    ASSERT_TRUE(streaming_job.Run());
+    EXPECT_EQ(hits + 1, cache.num_hits());
+
+    // Evicts pages.
+    cache.Evict(streaming);
+    EXPECT_EQ(0u, cache.num_pages());
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST(QuantizedSampling, StreamingSamplingJob) {
+    vox::unique_ptr<Animation> animation = BuildAnimation(10.f, 7, 10);
+    ASSERT_TRUE(animation);
+    ASSERT_EQ(10, animation->quantized_translations().bits);
+
+    StreamingAnimationBuilder builder;
+    builder.page_duration = 1.5f;
+    vox::unique_ptr<StreamingAnimation> built = builder(*animation);
+    ASSERT_TRUE(built);
+
+    vox::io::MemoryStream stream;
+    StreamingAnimation streaming;
+    SaveAndLoad(*built, &stream, &streaming);
+
+    // Pages keep the quantized layout.
+    vox::unique_ptr<Animation> page = streaming.LoadPage(0);
+    ASSERT_TRUE(page);
+    EXPECT_EQ(10, page->quantized_translations().bits);
+    EXPECT_EQ(10, page->quantized_scales().bits);
+    EXPECT_LT(page->quantized_translations().size(), animation->quantized_translations().size());
+
+    AnimationPageCache cache(1 << 20);
+    SamplingJob::Context context(7);
+    StreamingSamplingJob::Context streaming_context(7);
+    vox::simd_math::SoaTransform expected[2];
+    vox::simd_math::SoaTransform output[2];
+
+    SamplingJob job;
+    job.animation = animation.get();
+    job.context = &context;
+    job.output = expected;
+
+    StreamingSamplingJob streaming_job;
+    streaming_job.animation = &streaming;
+    streaming_job.cache = &cache;
+    streaming_job.context = &streaming_context;
+    streaming_job.output = output;
+
+    for (int i = 0; i <= 140; ++i) {
+        const float ratio = static_cast<float>(i) / 140.f;
+        SCOPED_TRACE(ratio);
+        job.ratio = ratio;
+        ASSERT_TRUE(job.Run());
+        streaming_job.ratio = ratio;
+        ASSERT_TRUE(streaming_job.Run());
+
+        // Pages copy the quantized values, so results are identical.
+        EXPECT_EQ(0, std::memcmp(expected, output, sizeof(output)));
+    }
+}
@@ -0,0 +1,195 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vox.base/io/archive.h"
+#include "vox.base/io/stream.h"
+#include "vox.base/profiler.h"
+
+using namespace vox;
+
+namespace {
+void profiledLeaf() { VOX_PROFILE_ZONE("leaf"); }
+
+void profiledParent() {
+    VOX_PROFILE_ZONE("parent");
+    profiledLeaf();
+    profiledLeaf();
+}
+}  // namespace
+
+TEST(Profiler, Disabled) {
+    profiling::Trace trace;
+    trace.collect();
+
+    profiling::setEnabled(false);
+    EXPECT_FALSE(profiling::isEnabled());
+    profiledParent();
+
+    trace.clear();
+    trace.collect();
+    EXPECT_TRUE(trace.zones().empty());
+}
+
+TEST(Profiler, NestedZones) {
+    profiling::Trace trace;
+    trace.collect();
+    trace.clear();
+
+    profiling::setEnabled(true);
+    profiledParent();
+    profiling::setEnabled(false);
+
+    trace.collect();
+    ASSERT_EQ(3u, trace.zones().size());
+    EXPECT_EQ(2u, trace.sites().size());
+
+    // Zones are recorded when they are closed, so children come first.
+    const profiling::Trace::Zone &leaf0 = trace.zones()[0];
+    const profiling::Trace::Zone &leaf1 = trace.zones()[1];
+    const profiling::Trace::Zone &parent = trace.zones()[2];
+    EXPECT_EQ("leaf", trace.sites()[leaf0.site].name);
+    EXPECT_EQ(leaf0.site, leaf1.site);
+    EXPECT_EQ("parent", trace.sites()[parent.site].name);
+    EXPECT_EQ(1u, leaf0.depth);
+    EXPECT_EQ(1u, leaf1.depth);
+    EXPECT_EQ(0u, parent.depth);
+
+    EXPECT_LE(parent.start, leaf0.start);
+    EXPECT_LE(leaf0.start + leaf0.duration, leaf1.start);
+    EXPECT_LE(leaf1.start + leaf1.duration, parent.start + parent.duration);
+
+    // Zones are only collected once.
+    trace.clear();
+    trace.collect();
+    EXPECT_TRUE(trace.zones().empty());
+}
+
+TEST(Profiler, Threads) {
+    profiling::Trace trace;
+    trace.collect();
+    trace.clear();
+
+    profiling::setEnabled(true);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([i]() {
+            profiling::setThreadName(("Thread " + std::to_string(i)).c_str());
+            for (int j = 0; j < 100; ++j) {
+                profiledLeaf();
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    profiling::setEnabled(false);
+
+    trace.collect();
+    EXPECT_EQ(400u, trace.zones().size());
+    EXPECT_EQ(0u, trace.numDropped());
+
+    std::vector<int> counts(trace.threads().size(), 0);
+    for (const profiling::Trace::Zone &zone : trace.zones()) {
+        ASSERT_LT(zone.thread, counts.size());
+        ++counts[zone.thread];
+    }
+    int numNamedThreads = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] != 0) {
+            EXPECT_EQ(100, counts[i]);
+            EXPECT_EQ(0u, trace.threads()[i].name.find("Thread "));
+            ++numNamedThreads;
+        }
+    }
+    EXPECT_EQ(4, numNamedThreads);
+}
+
+TEST(Profiler, Dropped) {
+    profiling::Trace trace;
+    trace.collect();
+    trace.clear();
+
+    // The buffer of the new thread is smaller than its zones.
+    profiling::setBufferCapacity(16);
+    profiling::setEnabled(true);
+    std::thread thread([]() {
+        for (int j = 0; j < 20; ++j) {
+            profiledLeaf();
+        }
+    });
+    thread.join();
+    profiling::setEnabled(false);
+    profiling::setBufferCapacity(1 << 14);
+
+    trace.collect();
+    EXPECT_EQ(16u, trace.zones().size());
+    EXPECT_EQ(4u, trace.numDropped());
+}
+
+TEST(Profiler, ChromeTrace) {
+    profiling::Trace trace;
+    trace.collect();
+    trace.clear();
+
+    profiling::setEnabled(true);
+    profiledParent();
+    profiling::setEnabled(false);
+    trace.collect();
+
+    std::ostringstream stream;
+    trace.writeChromeTrace(stream);
+    const std::string json = stream.str();
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"parent\",\"ph\":\"X\",\"pid\":0,\"tid\":"));
+    EXPECT_NE(std::string::npos, json.find("\"ts\":0.000,"));
+    EXPECT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+}
+
+TEST(Profiler, Archive) {
+    profiling::Trace trace;
+    trace.collect();
+    trace.clear();
+
+    profiling::setEnabled(true);
+    profiledParent();
+    profiling::setEnabled(false);
+    trace.collect();
+
+    io::MemoryStream stream;
+    {
+        io::OArchive o(&stream);
+        o << trace;
+    }
+    stream.Seek(0, io::Stream::kSet);
+
+    io::IArchive i(&stream);
+    ASSERT_TRUE(i.TestTag<profiling::Trace>());
+    profiling::Trace loaded;
+    i >> loaded;
+
+    ASSERT_EQ(trace.sites().size(), loaded.sites().size());
+    for (size_t s = 0; s < trace.sites().size(); ++s) {
+        EXPECT_EQ(trace.sites()[s].name, loaded.sites()[s].name);
+        EXPECT_EQ(trace.sites()[s].file, loaded.sites()[s].file);
+        EXPECT_EQ(trace.sites()[s].line, loaded.sites()[s].line);
+    }
+    EXPECT_EQ(trace.threads().size(), loaded.threads().size());
+    ASSERT_EQ(trace.zones().size(), loaded.zones().size());
+    for (size_t z = 0; z < trace.zones().size(); ++z) {
+        EXPECT_EQ(trace.zones()[z].site, loaded.zones()[z].site);
+        EXPECT_EQ(trace.zones()[z].thread, loaded.zones()[z].thread);
+        EXPECT_EQ(trace.zones()[z].start, loaded.zones()[z].start);
+        EXPECT_EQ(trace.zones()[z].duration, loaded.zones()[z].duration);
+        EXPECT_EQ(trace.zones()[z].depth, loaded.zones()[z].depth);
+    }
+}
@@ -0,0 +1,128 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "vox.base/task_graph.h"
+
+using namespace vox;
+
+TEST(TaskGraph, Empty) {
+    TaskGraph graph;
+    EXPECT_EQ(0u, graph.numberOfTasks());
+    graph.run();
+}
+
+TEST(TaskGraph, Diamond) {
+    ThreadPool pool(3);
+    TaskGraph graph(&pool);
+
+    std::atomic<int> step{0};
+    int a = -1, b = -1, c = -1, d = -1;
+
+    auto taskA = graph.addTask([&]() { a = step++; });
+    auto taskB = graph.addTask([&]() { b = step++; }, {taskA});
+    auto taskC = graph.addTask([&]() { c = step++; }, {taskA});
+    graph.addTask([&]() { d = step++; }, {taskB, taskC});
+    EXPECT_EQ(4u, graph.numberOfTasks());
+
+    graph.run();
+
+    EXPECT_EQ(0, a);
+    EXPECT_LT(a, b);
+    EXPECT_LT(a, c);
+    EXPECT_EQ(3, d);
+}
+
+TEST(TaskGraph, InvalidDependency) {
+    TaskGraph graph;
+    auto first = graph.addTask([]() {});
+    auto second = graph.addTask([]() {});
+    EXPECT_THROW(graph.precede(second, first), std::invalid_argument);
+    EXPECT_THROW(graph.precede(first, 42), std::invalid_argument);
+}
+
+TEST(TaskGraph, Exception) {
+    ThreadPool pool(2);
+    TaskGraph graph(&pool);
+
+    std::atomic<int> counter{0};
+    auto first = graph.addTask([]() { throw std::runtime_error("task failed"); });
+    for (int i = 0; i < 16; ++i) {
+        graph.addTask([&counter]() { counter.fetch_add(1); }, {first});
+    }
+    graph.addTask([]() { throw std::logic_error("main thread task failed"); }, TaskAffinity::kMainThread);
+
+    // Continuations still run, and one of the exceptions is rethrown once the graph is drained.
+    EXPECT_ANY_THROW(graph.run());
+    EXPECT_EQ(16, counter.load());
+
+    // The exception is reported once.
+    counter = 0;
+    graph.clear();
+    graph.addTask([&counter]() { counter.fetch_add(1); });
+    EXPECT_NO_THROW(graph.run());
+    EXPECT_EQ(1, counter.load());
+}
+
+TEST(TaskGraph, MainThreadAffinity) {
+    ThreadPool pool(4);
+    TaskGraph graph(&pool);
+
+    const std::thread::id mainThreadId = std::this_thread::get_id();
+    std::vector<TaskGraph::TaskId> workers;
+    std::atomic<int> numWrongThreads{0};
+    for (int i = 0; i < 64; ++i) {
+        workers.push_back(graph.addTask([]() {}));
+        graph.addTask(
+                [&]() {
+                    if (std::this_thread::get_id() != mainThreadId) {
+                        ++numWrongThreads;
+                    }
+                },
+                {workers.back()}, TaskAffinity::kMainThread);
+    }
+    graph.run();
+
+    EXPECT_EQ(0, numWrongThreads.load());
+}
+
+TEST(TaskGraph, FenceAndRerun) {
+    ThreadPool pool(2);
+    TaskGraph graph(&pool);
+
+    std::atomic<int> counter{0};
+    int observed = 0;
+
+    std::vector<TaskGraph::TaskId> tasks;
+    for (int i = 0; i < 100; ++i) {
+        tasks.push_back(graph.addTask([&counter]() { ++counter; }));
+    }
+    auto fence = graph.addFence(tasks);
+    graph.addTask([&]() { observed = counter.load(); }, {fence}, TaskAffinity::kMainThread);
+
+    for (int frame = 1; frame <= 3; ++frame) {
+        graph.run();
+        EXPECT_EQ(100 * frame, observed);
+    }
+
+    graph.clear();
+    EXPECT_EQ(0u, graph.numberOfTasks());
+    graph.run();
+    EXPECT_EQ(300, counter.load());
+
+    // Recycled nodes start without the dependencies of the previous graph.
+    std::vector<int> order;
+    auto first = graph.addTask([&order]() { order.push_back(1); }, TaskAffinity::kMainThread);
+    graph.addTask([&order]() { order.push_back(2); }, {first}, TaskAffinity::kMainThread);
+    EXPECT_EQ(2u, graph.numberOfTasks());
+    graph.run();
+    EXPECT_EQ(std::vector<int>({1, 2}), order);
+}
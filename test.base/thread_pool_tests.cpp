@@ -0,0 +1,222 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "vox.base/parallel.h"
+#include "vox.base/thread_pool.h"
+
+using namespace vox;
+
+TEST(ThreadPool, TaskGroup) {
+    ThreadPool pool(4);
+    EXPECT_EQ(4u, pool.numberOfWorkers());
+    EXPECT_EQ(-1, pool.currentWorkerIndex());
+
+    std::atomic<int> counter{0};
+    {
+        TaskGroup group(pool);
+        for (int i = 0; i < 1000; ++i) {
+            group.run([&counter]() { counter.fetch_add(1); });
+        }
+        group.wait();
+        EXPECT_EQ(1000, counter.load());
+    }
+}
+
+TEST(ThreadPool, NoWorkers) {
+    // The waiting thread runs everything.
+    ThreadPool pool(0);
+
+    std::vector<int> visited(100, 0);
+    TaskGroup group(pool);
+    for (size_t i = 0; i < visited.size(); ++i) {
+        group.run([&visited, i]() { visited[i] = 1; });
+    }
+    group.wait();
+
+    EXPECT_EQ(100, std::accumulate(visited.begin(), visited.end(), 0));
+}
+
+TEST(ThreadPool, NestedGroups) {
+    ThreadPool pool(2);
+
+    std::atomic<int> counter{0};
+    TaskGroup outer(pool);
+    for (int i = 0; i < 16; ++i) {
+        outer.run([&pool, &counter]() {
+            // Waiting inside a task must not deadlock even with few workers.
+            TaskGroup inner(pool);
+            for (int j = 0; j < 16; ++j) {
+                inner.run([&counter]() { counter.fetch_add(1); });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+
+    EXPECT_EQ(256, counter.load());
+}
+
+TEST(ThreadPool, TaskGroupException) {
+    ThreadPool pool(2);
+
+    std::atomic<int> counter{0};
+    TaskGroup group(pool);
+    for (int i = 0; i < 100; ++i) {
+        group.run([&counter, i]() {
+            if (i % 10 == 0) {
+                throw std::runtime_error("task failed");
+            }
+            counter.fetch_add(1);
+        });
+    }
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(90, counter.load());
+
+    // The exception is reported once.
+    EXPECT_NO_THROW(group.wait());
+}
+
+TEST(ThreadPool, NestedParallelFor) {
+    const size_t n = 64;
+    std::vector<size_t> sums(n, 0);
+
+    parallelFor(kZeroSize, n, [&sums, n](size_t i) {
+        sums[i] = parallelReduce(
+                kZeroSize, n, kZeroSize,
+                [](size_t start, size_t end, size_t init) {
+                    for (size_t k = start; k < end; ++k) {
+                        init += k;
+                    }
+                    return init;
+                },
+                std::plus<size_t>());
+    });
+
+    for (size_t sum : sums) {
+        EXPECT_EQ(n * (n - 1) / 2, sum);
+    }
+}
+
+TEST(ThreadPool, SetMaxNumberOfThreads) {
+    const unsigned int numThreads = std::max(maxNumberOfThreads(), 1u);
+
+    for (unsigned int count : {1u, 3u, numThreads}) {
+        setMaxNumberOfThreads(count);
+        EXPECT_EQ(count - 1, ThreadPool::global()->numberOfWorkers());
+
+        std::vector<int> a(1000, 1);
+        int sum = parallelReduce(
+                kZeroSize, a.size(), 0,
+                [&a](size_t start, size_t end, int init) {
+                    for (size_t i = start; i < end; ++i) {
+                        init += a[i];
+                    }
+                    return init;
+                },
+                std::plus<int>());
+        EXPECT_EQ(1000, sum);
+    }
+}
+
+TEST(ThreadPool, ResetGlobalWhileInFlight) {
+    const unsigned int numThreads = std::max(maxNumberOfThreads(), 1u);
+
+    std::atomic<bool> isStarted{false};
+    std::atomic<bool> isReleased{false};
+    std::atomic<int> counter{0};
+    std::thread user([&]() {
+        TaskGroup group;
+        for (int i = 0; i < 8; ++i) {
+            group.run([&]() {
+                isStarted.store(true);
+                while (!isReleased.load()) {
+                    std::this_thread::yield();
+                }
+                counter.fetch_add(1);
+            });
+        }
+        group.wait();
+    });
+
+    while (!isStarted.load()) {
+        std::this_thread::yield();
+    }
+    // The running group keeps the previous pool alive.
+    setMaxNumberOfThreads(2);
+    EXPECT_EQ(1u, ThreadPool::global()->numberOfWorkers());
+    isReleased.store(true);
+    user.join();
+    EXPECT_EQ(8, counter.load());
+
+    setMaxNumberOfThreads(numThreads);
+}
+
+TEST(ThreadPool, SubmitException) {
+    ThreadPool pool(2);
+
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&counter, i]() {
+            counter.fetch_add(1);
+            if (i % 10 == 0) {
+                throw std::runtime_error("task failed");
+            }
+        });
+    }
+    // Throwing tasks don't take the workers down with them.
+    pool.waitUntil([&counter]() { return counter.load() == 100; });
+    EXPECT_EQ(100, counter.load());
+
+
+    // Without workers, tasks run on the calling thread. The first exception is
+    // kept for the caller, once.
+    ThreadPool inlinePool(0);
+    inlinePool.submit([]() { throw std::runtime_error("first"); });
+    inlinePool.submit([]() { throw std::logic_error("second"); });
+    while (inlinePool.runPendingTask()) {
+    }
+    EXPECT_THROW(inlinePool.rethrowException(), std::runtime_error);
+    EXPECT_NO_THROW(inlinePool.rethrowException());
+}
+
+TEST(ThreadPool, ParallelRadixSort) {
+    // Few distinct keys with bits spread over the whole word, so that equal keys exercise the stability and some
+    // digits are skipped.
+    const size_t n = 100000;
+    std::vector<uint64_t> keys(n);
+    uint64_t state = 12345;
+    for (uint64_t &key : keys) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        key = (state >> 40) * 0x0101000100000001ull;
+    }
+    std::vector<size_t> values(n);
+    std::iota(values.begin(), values.end(), kZeroSize);
+
+    std::vector<size_t> expected = values;
+    std::stable_sort(expected.begin(), expected.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+    for (ExecutionPolicy policy : {ExecutionPolicy::kParallel, ExecutionPolicy::kSerial}) {
+        std::vector<uint64_t> sortedKeys = keys;
+        std::vector<size_t> sortedValues = values;
+        parallelRadixSort(sortedKeys, sortedValues, policy);
+
+        EXPECT_TRUE(std::is_sorted(sortedKeys.begin(), sortedKeys.end()));
+        EXPECT_EQ(expected, sortedValues);
+    }
+
+    std::vector<uint64_t> single = {42};
+    std::vector<int> singleValue = {7};
+    parallelRadixSort(single, singleValue);
+    EXPECT_EQ(7, singleValue[0]);
+}
@@ -235,3 +235,114 @@ TEST(Bvh3, ForEachOverlappingItems) {
 
     EXPECT_EQ(numOverlaps, measured);
 }
+
+TEST(Bvh3, BinnedSah) {
+    Bvh3<Point3D> bvh;
+
+    auto distanceFunc = [](const Point3D& a, const Point3D& b) { return a.distanceTo(b); };
+
+    size_t numSamples = getNumberOfSamplePoints3();
+    std::vector<Point3D> points(getSamplePoints3(), getSamplePoints3() + numSamples);
+
+    std::vector<BoundingBox3D> bounds(points.size());
+    size_t i = 0;
+    std::generate(bounds.begin(), bounds.end(), [&]() {
+        auto c = points[i++];
+        BoundingBox3D box(c, c);
+        box.expand(0.1);
+        return box;
+    });
+
+    bvh.build(points, bounds, BvhBuildMethod::kBinnedSah);
+
+    EXPECT_EQ(numSamples, bvh.numberOfItems());
+    EXPECT_EQ(2 * numSamples - 1, bvh.numberOfNodes());
+
+    for (i = 0; i < getNumberOfSampleDirs3(); ++i) {
+        Point3D testPt = Point3D() + getSampleDirs3()[i];
+        auto nearest = bvh.nearest(testPt, distanceFunc);
+        double bestDist = kMaxD;
+        for (const Point3D& pt : points) {
+            bestDist = std::min(bestDist, testPt.distanceTo(pt));
+        }
+        EXPECT_DOUBLE_EQ(bestDist, nearest.distance);
+    }
+}
+
+TEST(Bvh3, IntersectsBatch) {
+    Bvh3<BoundingBox3D> bvh;
+
+    auto intersectsFunc = [](const BoundingBox3D& a, const Ray3D& ray) { return a.intersects(ray); };
+
+    size_t numSamples = getNumberOfSamplePoints3();
+    std::vector<BoundingBox3D> items(numSamples / 2);
+    size_t i = 0;
+    std::generate(items.begin(), items.end(), [&]() {
+        auto c = getSamplePoints3()[i++];
+        BoundingBox3D box(c, c);
+        box.expand(0.1);
+        return box;
+    });
+
+    bvh.build(items, items, BvhBuildMethod::kBinnedSah);
+
+    // The batch size isn't a multiple of the packet size, and rays are
+    // incoherent so that packet lanes diverge.
+    std::vector<Ray3D> rays;
+    for (i = 0; i + 3 < numSamples; ++i) {
+        rays.emplace_back(getSamplePoints3()[i], getSampleDirs3()[i + 3]);
+    }
+    std::vector<char> results(rays.size());
+    bvh.intersectsBatch(ConstArrayAccessor1<Ray3D>(rays.size(), rays.data()), intersectsFunc,
+                        ArrayAccessor1<char>(results.size(), results.data()));
+
+    for (i = 0; i < rays.size(); ++i) {
+        EXPECT_EQ(bvh.intersects(rays[i], intersectsFunc), static_cast<bool>(results[i]));
+    }
+}
+
+TEST(Bvh3, ClosestIntersectionBatch) {
+    Bvh3<BoundingBox3D> bvh;
+
+    auto intersectsFunc = [](const BoundingBox3D& a, const Ray3D& ray) {
+        auto bboxResult = a.closestIntersection(ray);
+        if (bboxResult.is_intersecting) {
+            return bboxResult.t_near;
+        } else {
+            return kMaxD;
+        }
+    };
+
+    size_t numSamples = getNumberOfSamplePoints3();
+    std::vector<BoundingBox3D> items(numSamples / 2);
+    size_t i = 0;
+    std::generate(items.begin(), items.end(), [&]() {
+        auto c = getSamplePoints3()[i++];
+        BoundingBox3D box(c, c);
+        box.expand(0.1);
+        return box;
+    });
+
+    std::vector<Ray3D> rays;
+    for (i = 0; i + 3 < numSamples; ++i) {
+        rays.emplace_back(getSamplePoints3()[i + 3], getSampleDirs3()[i]);
+    }
+
+    for (BvhBuildMethod method : {BvhBuildMethod::kMidpoint, BvhBuildMethod::kBinnedSah}) {
+        bvh.build(items, items, method);
+
+        std::vector<ClosestIntersectionQueryResult3<BoundingBox3D>> results(rays.size());
+        bvh.closestIntersectionBatch(
+                ConstArrayAccessor1<Ray3D>(rays.size(), rays.data()), intersectsFunc,
+                ArrayAccessor1<ClosestIntersectionQueryResult3<BoundingBox3D>>(results.size(), results.data()));
+
+        for (i = 0; i < rays.size(); ++i) {
+            auto bvhInts = bvh.closestIntersection(rays[i], intersectsFunc);
+            EXPECT_DOUBLE_EQ(bvhInts.distance, results[i].distance);
+            if (bvhInts.item != nullptr) {
+                ASSERT_NE(nullptr, results[i].item);
+                EXPECT_DOUBLE_EQ(bvhInts.distance, intersectsFunc(*results[i].item, rays[i]));
+            }
+        }
+    }
+}
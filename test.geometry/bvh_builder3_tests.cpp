@@ -0,0 +1,124 @@
+// Copyright (c) 2022 Feng Yang
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <random>
+
+#include "unit_tests_utils.h"
+#include "vox.geometry/bvh_builder3.h"
+
+using namespace vox;
+
+namespace {
+std::vector<BoundingBox3D> makeRandomBounds(size_t n) {
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> position(-10.0, 10.0);
+    std::uniform_real_distribution<double> size(0.0, 0.5);
+    std::vector<BoundingBox3D> bounds(n);
+    for (BoundingBox3D &bound : bounds) {
+        const Point3D c(position(rng), position(rng), position(rng));
+        bound = BoundingBox3D(c, c + Vector3D(size(rng), size(rng), size(rng)));
+    }
+    return bounds;
+}
+
+// Checks that the tree is depth-first, that every item is referenced once and
+// that nodes contain their children. Returns the depth of the tree.
+size_t validate(const BvhBuilder3 &builder, const std::vector<BoundingBox3D> &bounds) {
+    const std::vector<BvhBuilder3::Node> &nodes = builder.nodes();
+
+    std::vector<int> counts(bounds.size(), 0);
+    size_t maxDepth = 0;
+    std::vector<std::pair<size_t, size_t>> todo{{0, 1}};
+    size_t numVisited = 0;
+    while (!todo.empty()) {
+        const auto [index, depth] = todo.back();
+        todo.pop_back();
+        ++numVisited;
+        maxDepth = std::max(maxDepth, depth);
+
+        const BvhBuilder3::Node &node = nodes[index];
+        if (node.isLeaf()) {
+            ++counts[node.index];
+            EXPECT_TRUE(node.bound.contains(bounds[node.index].lower_corner));
+            EXPECT_TRUE(node.bound.contains(bounds[node.index].upper_corner));
+        } else {
+            EXPECT_GT(node.index, index + 1);
+            for (size_t child : {index + 1, node.index}) {
+                EXPECT_TRUE(node.bound.contains(nodes[child].bound.lower_corner));
+                EXPECT_TRUE(node.bound.contains(nodes[child].bound.upper_corner));
+                todo.emplace_back(child, depth + 1);
+            }
+        }
+    }
+
+    EXPECT_EQ(nodes.size(), numVisited);
+    for (int count : counts) {
+        EXPECT_EQ(1, count);
+    }
+    return maxDepth;
+}
+}  // namespace
+
+TEST(BvhBuilder3, Empty) {
+    BvhBuilder3 builder;
+    builder.build({});
+    EXPECT_TRUE(builder.nodes().empty());
+}
+
+TEST(BvhBuilder3, SingleItem) {
+    BvhBuilder3 builder;
+    const std::vector<BoundingBox3D> bounds{BoundingBox3D({0, 0, 0}, {1, 2, 3})};
+    builder.build(bounds);
+
+    ASSERT_EQ(1u, builder.nodes().size());
+    EXPECT_TRUE(builder.nodes()[0].isLeaf());
+    EXPECT_EQ(0u, builder.nodes()[0].index);
+    EXPECT_BOUNDING_BOX3_EQ(bounds[0], builder.nodes()[0].bound);
+}
+
+TEST(BvhBuilder3, Build) {
+    const std::vector<BoundingBox3D> bounds = makeRandomBounds(20000);
+
+    BvhBuilder3 builder;
+    builder.build(bounds);
+    EXPECT_EQ(2 * bounds.size() - 1, builder.nodes().size());
+    validate(builder, bounds);
+}
+
+TEST(BvhBuilder3, SahSplits) {
+    // Two distant clusters should be split apart at the root.
+    std::vector<BoundingBox3D> bounds;
+    for (int i = 0; i < 8; ++i) {
+        bounds.emplace_back(Point3D(i * 0.1, 0, 0), Point3D(i * 0.1 + 0.1, 0.1, 0.1));
+        bounds.emplace_back(Point3D(100 + i * 0.1, 0, 0), Point3D(100 + i * 0.1 + 0.1, 0.1, 0.1));
+    }
+
+    BvhBuilder3 builder;
+    builder.build(bounds);
+    validate(builder, bounds);
+
+    const std::vector<BvhBuilder3::Node> &nodes = builder.nodes();
+    EXPECT_EQ(0, nodes[0].axis);
+    EXPECT_LT(nodes[1].bound.upper_corner.x, 1.0);
+    EXPECT_GT(nodes[nodes[0].index].bound.lower_corner.x, 99.0);
+}
+
+TEST(BvhBuilder3, MaxDepth) {
+    // Exponentially spaced items make SAH splits very unbalanced.
+    std::vector<BoundingBox3D> bounds;
+    for (int i = 0; i < 1000; ++i) {
+        const double x = std::pow(1.05, i);
+        bounds.emplace_back(Point3D(x, 0, 0), Point3D(x, 0, 0));
+    }
+    // Identical items can only be split by count.
+    for (int i = 0; i < 1000; ++i) {
+        bounds.emplace_back(Point3D(-1, -1, -1), Point3D(-1, -1, -1));
+    }
+
+    BvhBuilder3 builder;
+    builder.build(bounds);
+    EXPECT_LE(validate(builder, bounds), BvhBuilder3::kMaxTreeDepth);
+}
@@ -21,6 +21,16 @@ TEST(FdmCgSolver3, Solve) {
     EXPECT_GT(solver.tolerance(), solver.lastResidual());
 }
 
+TEST(FdmCgSolver3, SolveSinglePrecision) {
+    FdmLinearSystem3F system;
+    FdmLinearSystemSolverTestHelper3::buildTestLinearSystem(&system, {3, 3, 3});
+
+    FdmCgSolver3F solver(100, 1e-5);
+    solver.solve(&system);
+
+    EXPECT_GT(solver.tolerance(), solver.lastResidual());
+}
+
 TEST(FdmCgSolver3, SolveCompressed) {
     FdmCompressedLinearSystem3 system;
     FdmLinearSystemSolverTestHelper3::buildTestCompressedLinearSystem(&system, {3, 3, 3});
@@ -30,3 +40,41 @@ TEST(FdmCgSolver3, SolveCompressed) {
 
     EXPECT_GT(solver.tolerance(), solver.lastResidual());
 }
+
+TEST(FdmCgSolver3, SolveMatrixFree) {
+    const Size3 size(8, 7, 6);
+
+    // Air on top, a solid box inside, and fluid elsewhere.
+    FdmMatrixFreeLinearSystem3 matrixFree;
+    matrixFree.resize(size, Vector3D(0.5, 0.5, 0.5));
+    matrixFree.A.markers.forEachIndex([&](size_t i, size_t j, size_t k) {
+        if (j == size.y - 1) {
+            matrixFree.A.markers(i, j, k) = FdmMatrixFreeLaplacian3::kAir;
+        } else if (i > 2 && i < 5 && j < 3 && k > 1 && k < 4) {
+            matrixFree.A.markers(i, j, k) = FdmMatrixFreeLaplacian3::kBoundary;
+        }
+        matrixFree.b(i, j, k) = 0.1 * static_cast<double>((i + 3 * j + 5 * k) % 7);
+    });
+
+    FdmLinearSystem3 system;
+    system.resize(size);
+    matrixFree.A.assemble(&system.A);
+    system.b.set(matrixFree.b);
+
+    // Matrix-free operators match the assembled matrix.
+    FdmVector3 expected(size), actual(size);
+    FdmBlas3::mvm(system.A, matrixFree.b, &expected);
+    const double dot = FdmMatrixFreeBlas3::mvmDot(matrixFree.A, matrixFree.b, &actual);
+    EXPECT_NEAR(FdmBlas3::dot(matrixFree.b, expected), dot, 1e-9);
+    expected.forEachIndex([&](size_t i, size_t j, size_t k) { EXPECT_NEAR(expected(i, j, k), actual(i, j, k), 1e-12); });
+
+    FdmCgSolver3 solver(200, 1e-9);
+    EXPECT_TRUE(solver.solve(&system));
+    const unsigned int iterations = solver.lastNumberOfIterations();
+
+    EXPECT_TRUE(solver.solveMatrixFree(&matrixFree));
+    EXPECT_GT(solver.tolerance(), solver.lastResidual());
+    EXPECT_EQ(iterations, solver.lastNumberOfIterations());
+    system.x.forEachIndex(
+            [&](size_t i, size_t j, size_t k) { EXPECT_NEAR(system.x(i, j, k), matrixFree.x(i, j, k), 1e-7); });
+}
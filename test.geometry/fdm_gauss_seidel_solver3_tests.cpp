@@ -104,3 +104,19 @@ TEST(FdmGaussSeidelSolver3, SolveCompressed) {
 
     EXPECT_LT(norm1, norm0);
 }
+
+TEST(FdmGaussSeidelSolver3, RelaxRedBlackBlocked) {
+    FdmLinearSystem3 system;
+    FdmLinearSystemSolverTestHelper3::buildTestLinearSystem(&system, {9, 6, 7});
+    system.b.forEachIndex([&](size_t i, size_t j, size_t k) { system.b(i, j, k) += 0.1 * ((i + 3 * j + 5 * k) % 7); });
+
+    // Pipelined sweeps match the sweeps done one after another.
+    FdmVector3 x1(system.x.size(), 0.0);
+    FdmVector3 x2(system.x.size(), 0.0);
+    for (unsigned int iter = 0; iter < 4; ++iter) {
+        FdmGaussSeidelSolver3::relaxRedBlack(system.A, system.b, 1.5, &x1);
+    }
+    FdmGaussSeidelSolver3::relaxRedBlack(system.A, system.b, 1.5, 4, &x2);
+
+    x1.forEachIndex([&](size_t i, size_t j, size_t k) { EXPECT_DOUBLE_EQ(x1(i, j, k), x2(i, j, k)); });
+}
@@ -40,3 +40,40 @@ TEST(FdmIccgSolver3, SolveCompressed) {
 
     EXPECT_GT(solver.tolerance(), solver.lastResidual());
 }
+
+TEST(FdmIccgSolver3, SolveMatchesCompressed) {
+    // Uneven sizes exercise partial anti-diagonals of the row wavefronts.
+    const Size3 size(9, 6, 4);
+
+    FdmLinearSystem3 system;
+    FdmLinearSystemSolverTestHelper3::buildTestLinearSystem(&system, size);
+
+    FdmCompressedLinearSystem3 compressed;
+    FdmLinearSystemSolverTestHelper3::buildTestCompressedLinearSystem(&compressed, size);
+
+    // Use the same zero-mean RHS without symmetry so that each cell's value
+    // matters while the pure Neumann system stays consistent.
+    const auto value = [](size_t i, size_t j, size_t k) {
+        return 0.1 * static_cast<double>((i + 3 * j + 5 * k) % 7);
+    };
+    double mean = 0.0;
+    system.b.forEachIndex([&](size_t i, size_t j, size_t k) { mean += value(i, j, k); });
+    mean /= static_cast<double>(size.x * size.y * size.z);
+    system.b.forEachIndex([&](size_t i, size_t j, size_t k) {
+        system.b(i, j, k) += value(i, j, k) - mean;
+        compressed.b[i + size.x * (j + size.y * k)] = system.b(i, j, k);
+    });
+
+    FdmIccgSolver3 solver(10, 1e-12);
+    solver.solve(&system);
+    const unsigned int iterations = solver.lastNumberOfIterations();
+    const double residual = solver.lastResidual();
+
+    solver.solveCompressed(&compressed);
+    EXPECT_EQ(iterations, solver.lastNumberOfIterations());
+    EXPECT_NEAR(residual, solver.lastResidual(), 1e-9);
+
+    system.x.forEachIndex([&](size_t i, size_t j, size_t k) {
+        EXPECT_NEAR(system.x(i, j, k), compressed.x[i + size.x * (j + size.y * k)], 1e-9);
+    });
+}
@@ -10,7 +10,8 @@ namespace vox {
 
 class FdmLinearSystemSolverTestHelper3 {
 public:
-    static void buildTestLinearSystem(FdmLinearSystem3* system, const Size3& size) {
+    template <typename T>
+    static void buildTestLinearSystem(FdmLinearSystem<T, 3>* system, const Size3& size) {
         system->A.resize(size);
         system->x.resize(size);
         system->b.resize(size);
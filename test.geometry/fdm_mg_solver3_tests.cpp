@@ -10,18 +10,18 @@
 
 using namespace vox;
 
-TEST(FdmMgSolver3, Solve) {
-    size_t levels = 6;
-    FdmMgLinearSystem3 system;
-    system.resizeWithCoarsest({4, 4, 4}, levels);
+namespace {
+
+void buildPoissonSystem(size_t levels, FdmMgLinearSystem3* system) {
+    system->resizeWithCoarsest({4, 4, 4}, levels);
 
     // Simple Poisson eq.
-    for (size_t l = 0; l < system.numberOfLevels(); ++l) {
+    for (size_t l = 0; l < system->numberOfLevels(); ++l) {
         double invdx = pow(0.5, l);
-        FdmMatrix3& A = system.A[l];
-        FdmVector3& b = system.b[l];
+        FdmMatrix3& A = system->A[l];
+        FdmVector3& b = system->b[l];
 
-        system.x[l].set(0);
+        system->x[l].set(0);
 
         A.forEachIndex([&](size_t i, size_t j, size_t k) {
             if (i > 0) {
@@ -54,6 +54,14 @@ TEST(FdmMgSolver3, Solve) {
             }
         });
     }
+}
+
+}  // namespace
+
+TEST(FdmMgSolver3, Solve) {
+    size_t levels = 6;
+    FdmMgLinearSystem3 system;
+    buildPoissonSystem(levels, &system);
 
     auto buffer = system.x[0];
     FdmBlas3::residual(system.A[0], system.x[0], system.b[0], &buffer);
@@ -67,3 +75,35 @@ TEST(FdmMgSolver3, Solve) {
 
     EXPECT_LT(norm1, norm0);
 }
+
+TEST(FdmMgSolver3, Cycles) {
+    size_t levels = 5;
+    FdmMgSolver3 solver(levels, 3, 3, 20, 20, 1e-9, 1.0, true);
+
+    FdmMgLinearSystem3 vSystem, wSystem, fSystem;
+    buildPoissonSystem(levels, &vSystem);
+    buildPoissonSystem(levels, &wSystem);
+    buildPoissonSystem(levels, &fSystem);
+
+    auto buffer = vSystem.x;
+    FdmBlas3::residual(vSystem.A[0], vSystem.x[0], vSystem.b[0], &buffer[0]);
+    const double norm0 = FdmBlas3::l2Norm(buffer[0]);
+
+    // One cycle of each shape from x = 0. W- and F-cycles do more work on the
+    // coarser levels and should reduce the residual at least as much.
+    mgVCycle(vSystem.A, solver.params(), &vSystem.x, &vSystem.b, &buffer);
+    FdmBlas3::residual(vSystem.A[0], vSystem.x[0], vSystem.b[0], &buffer[0]);
+    const double vNorm = FdmBlas3::l2Norm(buffer[0]);
+
+    mgWCycle(wSystem.A, solver.params(), &wSystem.x, &wSystem.b, &buffer);
+    FdmBlas3::residual(wSystem.A[0], wSystem.x[0], wSystem.b[0], &buffer[0]);
+    const double wNorm = FdmBlas3::l2Norm(buffer[0]);
+
+    mgFCycle(fSystem.A, solver.params(), &fSystem.x, &fSystem.b, &buffer);
+    FdmBlas3::residual(fSystem.A[0], fSystem.x[0], fSystem.b[0], &buffer[0]);
+    const double fNorm = FdmBlas3::l2Norm(buffer[0]);
+
+    EXPECT_LT(vNorm, norm0);
+    EXPECT_LE(wNorm, vNorm);
+    EXPECT_LE(fNorm, vNorm);
+}
@@ -6,22 +6,25 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "vox.geometry/fdm_mgpcg_solver3.h"
 
 using namespace vox;
 
-TEST(FdmMgpcgSolver3, Solve) {
-    size_t levels = 4;
-    FdmMgLinearSystem3 system;
-    system.resizeWithCoarsest({4, 4, 4}, levels);
+namespace {
+
+template <typename T>
+void buildPoissonSystem(size_t levels, FdmMgLinearSystem<T, 3>* system) {
+    system->resizeWithCoarsest({4, 4, 4}, levels);
 
     // Simple Poisson eq.
-    for (size_t l = 0; l < system.numberOfLevels(); ++l) {
-        double invdx = pow(0.5, l);
-        FdmMatrix3& A = system.A[l];
-        FdmVector3& b = system.b[l];
+    for (size_t l = 0; l < system->numberOfLevels(); ++l) {
+        T invdx = static_cast<T>(pow(0.5, l));
+        auto& A = system->A[l];
+        auto& b = system->b[l];
 
-        system.x[l].set(0);
+        system->x[l].set(0);
 
         A.forEachIndex([&](size_t i, size_t j, size_t k) {
             if (i > 0) {
@@ -54,7 +57,48 @@ TEST(FdmMgpcgSolver3, Solve) {
             }
         });
     }
+}
+
+}  // namespace
+
+TEST(FdmMgpcgSolver3, Solve) {
+    size_t levels = 4;
+    FdmMgLinearSystem3 system;
+    buildPoissonSystem(levels, &system);
 
     FdmMgpcgSolver3 solver(50, levels, 5, 5, 10, 10, 1e-4, 1.5, false);
     EXPECT_TRUE(solver.solve(&system));
 }
+
+TEST(FdmMgpcgSolver3, SolveSinglePrecision) {
+    size_t levels = 4;
+    FdmMgLinearSystem3F system;
+    buildPoissonSystem(levels, &system);
+
+    // Float storage bounds the reachable residual, so use a looser tolerance.
+    FdmMgpcgSolver3F solver(50, levels, 5, 5, 10, 10, 1e-2, 1.5, false);
+    EXPECT_TRUE(solver.solve(&system));
+}
+
+TEST(FdmMgpcgSolver3, SolveMixedPrecision) {
+    size_t levels = 4;
+    FdmMgLinearSystem3 system;
+    buildPoissonSystem(levels, &system);
+    FdmMgLinearSystem3 reference = system;
+
+    // Single-precision V-cycles shouldn't keep the double-precision CG from
+    // reaching a tolerance below float epsilon.
+    FdmMgpcgSolver3 referenceSolver(50, levels, 5, 5, 10, 10, 1e-9, 1.5, false);
+    EXPECT_TRUE(referenceSolver.solve(&reference));
+
+    FdmMixedMgpcgSolver3 solver(50, levels, 5, 5, 10, 10, 1e-9, 1.5, false);
+    EXPECT_EQ(levels, solver.params().maxNumberOfLevels);
+    EXPECT_EQ(10u, solver.params().numberOfCoarsestIter);
+    EXPECT_TRUE(solver.solve(&system));
+    EXPECT_GT(solver.tolerance(), solver.lastResidual());
+    EXPECT_LE(solver.lastNumberOfIterations(), referenceSolver.lastNumberOfIterations() + 2);
+
+    FdmVector3 residual(system.x.finest().size());
+    FdmBlas3::residual(system.A.finest(), system.x.finest(), system.b.finest(), &residual);
+    EXPECT_GT(1e-9, FdmBlas3::l2Norm(residual));
+}
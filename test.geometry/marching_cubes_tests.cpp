@@ -4,6 +4,10 @@
 // personal capacity and am not conveying any rights to any intellectual
 // property of any third parties.
 
+#include <map>
+#include <set>
+#include <tuple>
+
 #include "unit_tests_utils.h"
 #include "vox.geometry/array3.h"
 #include "vox.geometry/marching_cubes.h"
@@ -55,3 +59,38 @@ TEST(MarchingCubes, Connectivity) {
     marchingCubes(grid.constAccessor(), Vector3D(1, 1, 1), Point3D(), &triMesh, 0, kDirectionAll, kDirectionAll);
     EXPECT_EQ(8u, triMesh.numberOfPoints());
 }
+
+TEST(MarchingCubes, Slabs) {
+    // The grid spans several slabs which are extracted separately.
+    Array3<double> grid(20, 24, 50);
+    grid.forEachIndex([&](size_t i, size_t j, size_t k) {
+        const Vector3D x(i - 9.5, j - 11.5, 0.4 * (k - 24.5));
+        grid(i, j, k) = x.length() - 8.0;
+    });
+
+    TriangleMesh3 triMesh;
+    marchingCubes(grid.constAccessor(), Vector3D(1, 1, 1), Point3D(), &triMesh);
+
+    // Vertices are shared, so the closed surface has every edge shared by
+    // exactly two triangles.
+    std::map<std::pair<size_t, size_t>, size_t> edgeCounts;
+    for (size_t i = 0; i < triMesh.numberOfTriangles(); ++i) {
+        const Point3UI& face = triMesh.pointIndex(i);
+        for (size_t e = 0; e < 3; ++e) {
+            const size_t a = face[e];
+            const size_t b = face[(e + 1) % 3];
+            ++edgeCounts[std::make_pair(std::min(a, b), std::max(a, b))];
+        }
+    }
+    EXPECT_LT(0u, edgeCounts.size());
+    for (const auto& edgeCount : edgeCounts) {
+        EXPECT_EQ(2u, edgeCount.second);
+    }
+
+    std::set<std::tuple<double, double, double>> points;
+    for (size_t i = 0; i < triMesh.numberOfPoints(); ++i) {
+        const Point3D& pt = triMesh.point(i);
+        points.emplace(pt.x, pt.y, pt.z);
+    }
+    EXPECT_EQ(triMesh.numberOfPoints(), points.size());
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2022 Feng Yang
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "vox.geometry/array1.h"
+#include "vox.geometry/neighbor_lists.h"
+#include "vox.geometry/point_parallel_hash_grid_searcher3.h"
+
+using namespace vox;
+
+TEST(NeighborLists, Constructors) {
+    NeighborLists<size_t> lists;
+    EXPECT_TRUE(lists.empty());
+    EXPECT_EQ(0u, lists.size());
+    EXPECT_EQ(1u, lists.offsets().size());
+    EXPECT_TRUE(lists.indices().empty());
+}
+
+TEST(NeighborLists, Build) {
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    Array1<Point3D> points(500);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = Point3D(dist(rng), dist(rng), dist(rng));
+    }
+
+    const double radius = 0.15;
+    PointParallelHashGridSearcher3 searcher(16, 16, 16, 2.0 * radius);
+    searcher.build(points.constAccessor());
+
+    NeighborLists<size_t> lists;
+    lists.build(searcher, points.constAccessor(), radius);
+    NeighborLists<uint32_t> compactLists;
+    compactLists.build(searcher, points.constAccessor(), radius);
+
+    ASSERT_EQ(points.size(), lists.size());
+    ASSERT_EQ(points.size(), compactLists.size());
+    EXPECT_EQ(lists.offsets(), compactLists.offsets());
+    EXPECT_EQ(lists.indices().size(), lists.offsets().back());
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto neighbors = lists[i];
+        const auto compactNeighbors = compactLists[i];
+        ASSERT_EQ(neighbors.size(), compactNeighbors.size());
+
+        size_t count = 0;
+        for (size_t j = 0; j < points.size(); ++j) {
+            if (j != i && points[i].distanceTo(points[j]) <= radius) {
+                EXPECT_TRUE(neighbors.end() != std::find(neighbors.begin(), neighbors.end(), j));
+                ++count;
+            }
+        }
+        EXPECT_EQ(count, neighbors.size());
+
+        for (size_t n = 0; n < neighbors.size(); ++n) {
+            EXPECT_EQ(neighbors[n], compactNeighbors[n]);
+        }
+    }
+
+    // Rebuilding with fewer points shrinks the lists.
+    Array1<Point3D> fewerPoints(10);
+    searcher.build(fewerPoints.constAccessor());
+    lists.build(searcher, fewerPoints.constAccessor(), radius);
+    EXPECT_EQ(10u, lists.size());
+    EXPECT_EQ(90u, lists.indices().size());
+    EXPECT_EQ(9u, lists[3].size());
+
+    lists.clear();
+    EXPECT_TRUE(lists.empty());
+}
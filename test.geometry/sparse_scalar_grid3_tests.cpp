@@ -0,0 +1,161 @@
+// Copyright (c) 2022 Feng Yang
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "vox.geometry/cell_centered_scalar_grid3.h"
+#include "vox.geometry/sparse_scalar_grid3.h"
+
+using namespace vox;
+
+namespace {
+
+// Narrow band of a sphere's signed distance, clamped to +/- 3 cells.
+double sphereBand(const Point3D &pt) {
+    double phi = pt.distanceTo(Point3D(10.0, 9.0, 8.0)) - 5.0;
+    return std::max(-3.0, std::min(3.0, phi));
+}
+
+}  // namespace
+
+TEST(SparseScalarGrid3, Constructors) {
+    SparseScalarGrid3 grid1;
+    EXPECT_EQ(0u, grid1.resolution().x);
+    EXPECT_EQ(0u, grid1.resolution().y);
+    EXPECT_EQ(0u, grid1.resolution().z);
+    EXPECT_EQ(0u, grid1.numberOfActiveBlocks());
+
+    SparseScalarGrid3 grid2(Size3(20, 18, 17), Vector3D(1.0, 2.0, 3.0), Point3D(4.0, 5.0, 6.0), 7.0);
+    EXPECT_EQ(Size3(20, 18, 17), grid2.dataSize());
+    EXPECT_DOUBLE_EQ(4.5, grid2.dataOrigin().x);
+    EXPECT_DOUBLE_EQ(6.0, grid2.dataOrigin().y);
+    EXPECT_DOUBLE_EQ(7.5, grid2.dataOrigin().z);
+    EXPECT_DOUBLE_EQ(7.0, grid2.background());
+    EXPECT_EQ(0u, grid2.numberOfActiveBlocks());
+    EXPECT_DOUBLE_EQ(7.0, grid2(19, 17, 16));
+
+    grid2.setValue(19, 17, 16, 1.0);
+    SparseScalarGrid3 grid3(grid2);
+    EXPECT_EQ(1u, grid3.numberOfActiveBlocks());
+    EXPECT_DOUBLE_EQ(1.0, grid3(19, 17, 16));
+    EXPECT_DOUBLE_EQ(7.0, grid3(18, 17, 16));
+
+    auto grid4 = grid3.clone();
+    EXPECT_EQ(1u, grid4->numberOfActiveBlocks());
+    EXPECT_DOUBLE_EQ(1.0, (*grid4)(19, 17, 16));
+}
+
+TEST(SparseScalarGrid3, SetValueAndPrune) {
+    SparseScalarGrid3 grid(Size3(20, 20, 20), Vector3D(1, 1, 1), Point3D(), 3.0);
+
+    grid.setValue(0, 0, 0, 1.0);
+    grid.setValue(7, 7, 7, 2.0);
+    grid.setValue(8, 0, 0, 3.0);
+    grid.activate(19, 19, 19);
+    EXPECT_EQ(3u, grid.numberOfActiveBlocks());
+    EXPECT_TRUE(grid.isActive(3, 4, 5));
+    EXPECT_TRUE(grid.isActive(15, 0, 0));
+    EXPECT_FALSE(grid.isActive(0, 8, 0));
+    EXPECT_DOUBLE_EQ(1.0, grid(0, 0, 0));
+    EXPECT_DOUBLE_EQ(2.0, grid(7, 7, 7));
+    EXPECT_DOUBLE_EQ(3.0, grid(3, 4, 5));
+
+    // Only the first block holds a value other than the background.
+    grid.prune();
+    EXPECT_EQ(1u, grid.numberOfActiveBlocks());
+    EXPECT_DOUBLE_EQ(1.0, grid(0, 0, 0));
+    EXPECT_DOUBLE_EQ(2.0, grid(7, 7, 7));
+    EXPECT_FALSE(grid.isActive(8, 0, 0));
+
+    grid.setValue(19, 0, 0, 4.0);
+    EXPECT_DOUBLE_EQ(4.0, grid(19, 0, 0));
+    EXPECT_DOUBLE_EQ(1.0, grid(0, 0, 0));
+}
+
+TEST(SparseScalarGrid3, MatchesDenseGrid) {
+    CellCenteredScalarGrid3 dense(21, 19, 18, 1.0, 1.0, 1.0);
+    dense.fill(sphereBand);
+
+    SparseScalarGrid3 sparse(dense.resolution(), dense.gridSpacing(), dense.origin(), 3.0);
+    sparse.fill(dense.constDataAccessor());
+
+    // The far corners are at the background value.
+    EXPECT_LT(sparse.numberOfActiveBlocks(), 27u);
+    EXPECT_FALSE(sparse.isActive(20, 18, 17));
+
+    dense.forEachDataPointIndex([&](size_t i, size_t j, size_t k) {
+        EXPECT_DOUBLE_EQ(dense(i, j, k), sparse(i, j, k));
+        EXPECT_EQ(dense.gradientAtDataPoint(i, j, k), sparse.gradientAtDataPoint(i, j, k));
+        EXPECT_DOUBLE_EQ(dense.laplacianAtDataPoint(i, j, k), sparse.laplacianAtDataPoint(i, j, k));
+    });
+
+    auto sampler = sparse.sampler();
+    for (double x = -1.0; x < 22.0; x += 0.7) {
+        for (double y = -1.0; y < 20.0; y += 0.9) {
+            for (double z = -1.0; z < 19.0; z += 1.1) {
+                Point3D pt(x, y, z);
+                EXPECT_NEAR(dense.sample(pt), sparse.sample(pt), 1e-12);
+                EXPECT_NEAR(dense.sample(pt), sampler(pt), 1e-12);
+                EXPECT_NEAR(0.0, dense.gradient(pt).distanceTo(sparse.gradient(pt)), 1e-12);
+                EXPECT_NEAR(dense.laplacian(pt), sparse.laplacian(pt), 1e-12);
+            }
+        }
+    }
+
+    Array3<double> roundTrip(sparse.dataSize(), 0.0);
+    sparse.getDenseData(roundTrip.accessor());
+    dense.forEachDataPointIndex(
+            [&](size_t i, size_t j, size_t k) { EXPECT_DOUBLE_EQ(dense(i, j, k), roundTrip(i, j, k)); });
+}
+
+TEST(SparseScalarGrid3, ActiveIteration) {
+    SparseScalarGrid3 grid(Size3(20, 20, 10), Vector3D(1, 1, 1), Point3D(), 0.0);
+    grid.activate(0, 0, 0);
+    grid.activate(19, 19, 9);
+
+    // The second block is cut by the grid boundary.
+    size_t count = 0;
+    grid.forEachActiveDataPointIndex([&](size_t i, size_t j, size_t k) {
+        EXPECT_TRUE(grid.isActive(i, j, k));
+        ++count;
+    });
+    EXPECT_EQ(512u + 4u * 4u * 2u, count);
+
+    grid.fill([](const Point3D &pt) { return pt.x + 10.0 * pt.y + 100.0 * pt.z; });
+    EXPECT_DOUBLE_EQ(0.5 + 5.0 + 50.0, grid(0, 0, 0));
+    EXPECT_DOUBLE_EQ(19.5 + 195.0 + 950.0, grid(19, 19, 9));
+    EXPECT_DOUBLE_EQ(0.0, grid(10, 0, 0));
+
+    grid.parallelForEachActiveBlock([](SparseScalarGrid3::Block &block) {
+        for (double &v : block.data) {
+            v = -v;
+        }
+    });
+    EXPECT_DOUBLE_EQ(-55.5, grid(0, 0, 0));
+
+    std::vector<char> visited(20 * 20 * 10, 0);
+    grid.parallelForEachActiveDataPointIndex([&](size_t i, size_t j, size_t k) { visited[i + 20 * (j + 20 * k)] = 1; });
+    EXPECT_EQ(count, static_cast<size_t>(std::count(visited.begin(), visited.end(), 1)));
+}
+
+TEST(SparseScalarGrid3, Swap) {
+    SparseScalarGrid3 grid1(Size3(9, 9, 9), Vector3D(1, 1, 1), Point3D(), 1.0);
+    SparseScalarGrid3 grid2(Size3(30, 4, 4), Vector3D(2, 2, 2), Point3D(1, 1, 1), 2.0);
+    grid1.setValue(8, 8, 8, 5.0);
+    grid2.setValue(29, 0, 0, 6.0);
+
+    grid1.swap(&grid2);
+    EXPECT_EQ(Size3(30, 4, 4), grid1.resolution());
+    EXPECT_DOUBLE_EQ(2.0, grid1.background());
+    EXPECT_DOUBLE_EQ(6.0, grid1(29, 0, 0));
+    EXPECT_DOUBLE_EQ(2.0, grid1.sample(Point3D(2, 2, 2)));
+    EXPECT_EQ(Size3(9, 9, 9), grid2.resolution());
+    EXPECT_DOUBLE_EQ(5.0, grid2(8, 8, 8));
+    EXPECT_DOUBLE_EQ(5.0, grid2.sample(Point3D(8.5, 8.5, 8.5)));
+}
@@ -194,6 +194,105 @@ TEST(TriangleMesh3, IsInside) {
     }
 }
 
+TEST(TriangleMesh3, IsInsideBatch) {
+    std::string objStr = getCubeTriMesh3x3x3Obj();
+    std::istringstream objStream(objStr);
+
+    TriangleMesh3 mesh;
+    mesh.readObj(&objStream);
+    mesh.transform = Transform3(Vector3D(0.1, -0.2, 0.3), QuaternionD(Vector3D(1, 1, 0).normalized(), 0.3));
+
+    // Grid points are aligned with the cube, so that their rays are coherent.
+    std::vector<Point3D> points(getSamplePoints3(), getSamplePoints3() + getNumberOfSamplePoints3());
+    for (int k = -3; k <= 3; ++k) {
+        for (int j = -3; j <= 3; ++j) {
+            for (int i = -3; i <= 3; ++i) {
+                points.push_back(mesh.transform.toWorld(Point3D(i, j, k) / 5.0));
+            }
+        }
+    }
+
+    std::vector<char> results(points.size());
+    mesh.isInsideBatch(ConstArrayAccessor1<Point3D>(points.size(), points.data()),
+                       ArrayAccessor1<char>(results.size(), results.data()));
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(mesh.isInside(points[i]), static_cast<bool>(results[i])) << i;
+    }
+
+    mesh.isNormalFlipped = true;
+    mesh.isInsideBatch(ConstArrayAccessor1<Point3D>(points.size(), points.data()),
+                       ArrayAccessor1<char>(results.size(), results.data()));
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(mesh.isInside(points[i]), static_cast<bool>(results[i])) << i;
+    }
+}
+
+TEST(TriangleMesh3, IsInsideBatchOpenMesh) {
+    // A unit cube without its top face, at unit scale and scaled down so that
+    // its triangles are tiny.
+    for (double scale : {1.0, 1e-7}) {
+        TriangleMesh3 mesh;
+        for (int i = 0; i < 8; ++i) {
+            mesh.addPoint(Point3D((i >> 2) & 1, (i >> 1) & 1, i & 1) * scale);
+        }
+        mesh.addPointTriangle({0, 1, 3});
+        mesh.addPointTriangle({0, 3, 2});
+        mesh.addPointTriangle({4, 6, 7});
+        mesh.addPointTriangle({4, 7, 5});
+        mesh.addPointTriangle({0, 4, 5});
+        mesh.addPointTriangle({0, 5, 1});
+        mesh.addPointTriangle({2, 3, 7});
+        mesh.addPointTriangle({2, 7, 6});
+        mesh.addPointTriangle({0, 2, 6});
+        mesh.addPointTriangle({0, 6, 4});
+
+        std::vector<Point3D> points;
+        for (int k = -1; k <= 5; ++k) {
+            for (int j = -1; j <= 5; ++j) {
+                for (int i = -1; i <= 5; ++i) {
+                    points.push_back(Point3D(i + 0.5, j + 0.5, k + 0.5) * (0.2 * scale));
+                }
+            }
+        }
+
+        std::vector<char> results(points.size());
+        mesh.isInsideBatch(ConstArrayAccessor1<Point3D>(points.size(), points.data()),
+                           ArrayAccessor1<char>(results.size(), results.data()));
+        for (size_t i = 0; i < points.size(); ++i) {
+            EXPECT_EQ(mesh.isInside(points[i]), static_cast<bool>(results[i])) << scale << ' ' << i;
+        }
+        EXPECT_TRUE(results[points.size() / 2]);
+    }
+}
+
+TEST(TriangleMesh3, BinnedSahQueries) {
+    std::string objStr = getCubeTriMesh3x3x3Obj();
+    std::istringstream objStream(objStr);
+
+    TriangleMesh3 midpointMesh;
+    midpointMesh.readObj(&objStream);
+    EXPECT_EQ(BvhBuildMethod::kMidpoint, midpointMesh.bvhBuildMethod());
+
+    TriangleMesh3 sahMesh(midpointMesh);
+    sahMesh.setBvhBuildMethod(BvhBuildMethod::kBinnedSah);
+    EXPECT_EQ(BvhBuildMethod::kBinnedSah, sahMesh.bvhBuildMethod());
+
+    // Both trees hold the same triangles, so queries give the same results.
+    for (size_t i = 0; i < getNumberOfSamplePoints3(); ++i) {
+        const Point3D p = getSamplePoints3()[i];
+        EXPECT_DOUBLE_EQ(midpointMesh.closestDistance(p), sahMesh.closestDistance(p));
+        EXPECT_VECTOR3_EQ(midpointMesh.closestPoint(p), sahMesh.closestPoint(p));
+        EXPECT_EQ(midpointMesh.isInside(p), sahMesh.isInside(p));
+
+        const Ray3D ray(p, getSampleDirs3()[i]);
+        EXPECT_EQ(midpointMesh.intersects(ray), sahMesh.intersects(ray));
+        const auto expected = midpointMesh.closestIntersection(ray);
+        const auto actual = sahMesh.closestIntersection(ray);
+        EXPECT_EQ(expected.isIntersecting, actual.isIntersecting);
+        EXPECT_DOUBLE_EQ(expected.distance, actual.distance);
+    }
+}
+
 TEST(TriangleMesh3, BoundingBox) {
     std::string objStr = getCubeTriMesh3x3x3Obj();
     std::istringstream objStream(objStr);
@@ -12,7 +12,9 @@
 
 using namespace vox;
 
-TEST(TriangleMeshToSdf, TriangleMeshToSdf) {
+namespace {
+
+TriangleMesh3 makeCube(bool hasTop = true) {
     TriangleMesh3 mesh;
 
     // Build a cube
@@ -35,8 +37,18 @@ TEST(TriangleMeshToSdf, TriangleMeshToSdf) {
     mesh.addPointTriangle({2, 7, 6});
     mesh.addPointTriangle({0, 2, 6});
     mesh.addPointTriangle({0, 6, 4});
-    mesh.addPointTriangle({1, 5, 7});
-    mesh.addPointTriangle({1, 7, 3});
+    if (hasTop) {
+        mesh.addPointTriangle({1, 5, 7});
+        mesh.addPointTriangle({1, 7, 3});
+    }
+
+    return mesh;
+}
+
+}  // namespace
+
+TEST(TriangleMeshToSdf, TriangleMeshToSdf) {
+    const TriangleMesh3 mesh = makeCube();
 
     CellCenteredScalarGrid3 grid(3, 3, 3, 1.0, 1.0, 1.0, -1.0, -1.0, -1.0);
 
@@ -52,3 +64,52 @@ TEST(TriangleMeshToSdf, TriangleMeshToSdf) {
         EXPECT_DOUBLE_EQ(ans, grid(i, j, k));
     });
 }
+
+TEST(TriangleMeshToSdf, NarrowBand) {
+    const TriangleMesh3 mesh = makeCube();
+    Box3 box(Point3D(), Point3D(1.0, 1.0, 1.0));
+
+    // Most cells are beyond the band and get their distance by sweeping.
+    CellCenteredScalarGrid3 grid(24, 20, 16, 0.1, 0.1, 0.1, -0.7, -0.5, -0.3);
+    triangleMeshToSdf(mesh, &grid, 1);
+
+    auto gridPos = grid.dataPosition();
+    grid.forEachDataPointIndex([&](size_t i, size_t j, size_t k) {
+        auto pos = gridPos(i, j, k);
+        double ans = box.closestDistance(pos);
+        ans *= box.bound.contains(pos) ? -1.0 : 1.0;
+        EXPECT_NEAR(ans, grid(i, j, k), 1e-9);
+    });
+}
+
+TEST(TriangleMeshToSdf, MeshAwayFromGrid) {
+    const TriangleMesh3 mesh = makeCube();
+    Box3 box(Point3D(), Point3D(1.0, 1.0, 1.0));
+
+    CellCenteredScalarGrid3 grid(8, 8, 8, 0.25, 0.25, 0.25, 3.0, 2.0, 1.0);
+    triangleMeshToSdf(mesh, &grid);
+
+    auto gridPos = grid.dataPosition();
+    grid.forEachDataPointIndex([&](size_t i, size_t j, size_t k) {
+        auto pos = gridPos(i, j, k);
+        EXPECT_LT(0.0, grid(i, j, k));
+        EXPECT_NEAR(box.closestDistance(pos), grid(i, j, k), 1e-9);
+    });
+}
+
+TEST(TriangleMeshToSdf, OpenMesh) {
+    // The cube misses its top face, the sign is the one of isInside.
+    const TriangleMesh3 mesh = makeCube(false);
+
+    CellCenteredScalarGrid3 grid(4, 4, 4, 0.25, 0.25, 0.25, 0.0, 0.0, 0.0);
+    triangleMeshToSdf(mesh, &grid, 1);
+
+    auto gridPos = grid.dataPosition();
+    grid.forEachDataPointIndex([&](size_t i, size_t j, size_t k) {
+        auto pos = gridPos(i, j, k);
+        EXPECT_EQ(mesh.isInside(pos), grid(i, j, k) < 0.0);
+        if (pos.z < 0.5) {
+            EXPECT_GT(0.0, grid(i, j, k));
+        }
+    });
+}
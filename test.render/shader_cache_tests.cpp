@@ -0,0 +1,76 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "vox.render/shader/shader_cache.h"
+
+using namespace vox;
+
+namespace {
+const std::string kSource = "#version 450\nvoid main() {}\n";
+
+std::vector<uint8_t> sourceBytes() { return {kSource.begin(), kSource.end()}; }
+}  // namespace
+
+TEST(ShaderVariant, PreambleSortedByName) {
+    // Intern the names in reverse order, so the registry order differs from the name order
+    ShaderVariant interned;
+    interned.AddDefine("SORT_TEST_C");
+    interned.AddDefine("SORT_TEST_B 2");
+    interned.AddDefine("SORT_TEST_A");
+
+    ShaderVariant variant;
+    variant.AddDefine("SORT_TEST_B=2");
+    variant.AddDefine("SORT_TEST_A");
+    variant.AddDefine("SORT_TEST_C");
+
+    EXPECT_EQ("#define SORT_TEST_A\n#define SORT_TEST_B 2\n#define SORT_TEST_C\n", variant.GetPreamble());
+    EXPECT_EQ((std::vector<std::string>{"DSORT_TEST_A", "DSORT_TEST_B=2", "DSORT_TEST_C"}), variant.GetProcesses());
+}
+
+TEST(ShaderCache, KeyIndependentOfDefineOrder) {
+    ShaderVariant first;
+    first.AddDefine("KEY_TEST_HAS_UV");
+    first.AddDefine("KEY_TEST_LIGHT_COUNT 4");
+    first.AddDefine("KEY_TEST_HAS_NORMAL");
+    first.AddRuntimeArraySize("lights", 4);
+    first.AddRuntimeArraySize("bones", 32);
+
+    ShaderVariant second;
+    second.AddDefine("KEY_TEST_HAS_NORMAL");
+    second.AddDefine("KEY_TEST_LIGHT_COUNT=4");
+    second.AddRuntimeArraySize("bones", 32);
+    second.AddDefine("KEY_TEST_HAS_UV");
+    second.AddRuntimeArraySize("lights", 4);
+
+    // A variant merged from parts, as the render pipeline builds them
+    ShaderVariant left;
+    left.AddDefine("KEY_TEST_LIGHT_COUNT 4");
+    left.AddRuntimeArraySize("bones", 32);
+    ShaderVariant right;
+    right.AddDefine("KEY_TEST_HAS_UV");
+    right.AddDefine("KEY_TEST_HAS_NORMAL");
+    ShaderVariant merged;
+    ShaderVariant::UnionCollection(right, left, merged);
+    merged.AddRuntimeArraySize("lights", 4);
+
+    auto first_key = ShaderCache::MakeKey(wgpu::ShaderStage::Fragment, sourceBytes(), "main", first);
+    auto second_key = ShaderCache::MakeKey(wgpu::ShaderStage::Fragment, sourceBytes(), "main", second);
+    auto merged_key = ShaderCache::MakeKey(wgpu::ShaderStage::Fragment, sourceBytes(), "main", merged);
+
+    EXPECT_EQ(first_key.Serialize(), second_key.Serialize());
+    EXPECT_EQ(first_key.Hash(), second_key.Hash());
+    EXPECT_EQ(first_key.Serialize(), merged_key.Serialize());
+    EXPECT_EQ(first_key.Hash(), merged_key.Hash());
+
+    second.AddDefine("KEY_TEST_LIGHT_COUNT 8");
+    auto changed_key = ShaderCache::MakeKey(wgpu::ShaderStage::Fragment, sourceBytes(), "main", second);
+    EXPECT_NE(first_key.Serialize(), changed_key.Serialize());
+}
@@ -0,0 +1,107 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test.simd_math/gtest_math_helper.h"
+#include "vox.simd_math/simd_skinning.h"
+
+using vox::make_span;
+using vox::simd_math::Float4x4;
+using vox::simd_math::kSkinningMatrix3x4Floats;
+using vox::simd_math::SoaFloat4x4;
+using vox::simd_math::simd_float4::Load;
+
+namespace {
+// Builds a set of distinct affine matrices.
+std::vector<Float4x4> BuildMatrices(size_t _count, float _offset) {
+    std::vector<Float4x4> matrices;
+    for (size_t i = 0; i < _count; ++i) {
+        const float f = static_cast<float>(i) + _offset;
+        matrices.push_back(Float4x4::Translation(Load(f, -f, 2.f * f, 0.f)) *
+                           Float4x4::FromEuler(Load(.1f * f, .2f, -.3f * f, 0.f)) *
+                           Float4x4::Scaling(Load(1.f + f, 2.f, 1.f, 0.f)));
+    }
+    return matrices;
+}
+
+std::vector<SoaFloat4x4> Pack(const std::vector<Float4x4>& _inverse_bind_poses) {
+    std::vector<SoaFloat4x4> packed(vox::simd_math::SoaInverseBindPosesCount(_inverse_bind_poses.size()));
+    EXPECT_TRUE(vox::simd_math::PackInverseBindPoses(make_span(_inverse_bind_poses), make_span(packed)));
+    return packed;
+}
+}  // namespace
+
+TEST(Validate, SkinningMatrices) {
+    const std::vector<Float4x4> models = BuildMatrices(4, 0.f);
+    const std::vector<SoaFloat4x4> inverse_bind_poses = Pack(BuildMatrices(3, 1.f));
+    const std::vector<uint16_t> remaps = {0, 2, 3};
+    std::vector<float> output(3 * kSkinningMatrix3x4Floats);
+
+    EXPECT_TRUE(vox::simd_math::BuildSkinningMatrices3x4(make_span(models), make_span(remaps),
+                                                         make_span(inverse_bind_poses), make_span(output)));
+
+    // Output too small.
+    std::vector<float> small(3 * kSkinningMatrix3x4Floats - 1);
+    EXPECT_FALSE(vox::simd_math::BuildSkinningMatrices3x4(make_span(models), make_span(remaps),
+                                                          make_span(inverse_bind_poses), make_span(small)));
+
+    // Packed output too small.
+    std::vector<SoaFloat4x4> small_packed;
+    EXPECT_FALSE(vox::simd_math::PackInverseBindPoses(make_span(BuildMatrices(1, 0.f)), make_span(small_packed)));
+
+    // Remaps and inverse bind poses mismatch.
+    const std::vector<uint16_t> short_remaps = {0, 1, 2, 3, 0};
+    EXPECT_FALSE(vox::simd_math::BuildSkinningMatrices3x4(make_span(models), make_span(short_remaps),
+                                                          make_span(inverse_bind_poses), make_span(output)));
+
+    // Remap out of range.
+    const std::vector<uint16_t> invalid_remaps = {0, 1, 4};
+    EXPECT_FALSE(vox::simd_math::BuildSkinningMatrices3x4(make_span(models), make_span(invalid_remaps),
+                                                          make_span(inverse_bind_poses), make_span(output)));
+
+    // Empty.
+    EXPECT_TRUE(vox::simd_math::BuildSkinningMatrices3x4({}, {}, {}, {}));
+}
+
+TEST(Run, SkinningMatrices) {
+    const std::vector<Float4x4> models = BuildMatrices(12, 0.f);
+
+    // Counts covering full groups of 4 and every remainder.
+    for (size_t count = 1; count <= 9; ++count) {
+        const std::vector<Float4x4> inverse_bind_poses = BuildMatrices(count, 2.f);
+        const std::vector<SoaFloat4x4> packed = Pack(inverse_bind_poses);
+        std::vector<uint16_t> remaps;
+        for (size_t i = 0; i < count; ++i) {
+            remaps.push_back(static_cast<uint16_t>((i * 5 + 1) % models.size()));
+        }
+
+        // Guard values check that nothing is written past the matrices.
+        std::vector<float> output(count * kSkinningMatrix3x4Floats + 4, -42.f);
+        ASSERT_TRUE(vox::simd_math::BuildSkinningMatrices3x4(make_span(models), make_span(remaps), make_span(packed),
+                                                             make_span(output)));
+
+        for (size_t i = 0; i < count; ++i) {
+            const Float4x4 expected = models[remaps[i]] * inverse_bind_poses[i];
+            float cols[16];
+            for (int c = 0; c < 4; ++c) {
+                vox::simd_math::StorePtrU(expected.cols[c], cols + c * 4);
+            }
+
+            // Rows of the 3x4 layout are the columns' x, y and z components.
+            const float* packed = output.data() + i * kSkinningMatrix3x4Floats;
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 4; ++c) {
+                    EXPECT_NEAR(cols[c * 4 + r], packed[r * 4 + c], 1e-4f);
+                }
+            }
+        }
+        for (size_t i = count * kSkinningMatrix3x4Floats; i < output.size(); ++i) {
+            EXPECT_EQ(-42.f, output[i]);
+        }
+    }
+}
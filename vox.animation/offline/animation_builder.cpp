@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstring>
 #include <limits>
@@ -120,6 +121,54 @@ void CopyToAnimation(vox::vector<SortingKey>* _src, vox::span<Float3Key>* _dest,
     }
 }
 
+// Sorts keys and copies them to the animation, quantized with _dest->bits bits
+// in the range of their track.
+template <typename SortingKey>
+void CopyToAnimation(vox::vector<SortingKey>* _src, QuantizedFloat3Keys* _dest, float _inv_duration) {
+    const size_t src_count = _src->size();
+    if (!src_count) {
+        return;
+    }
+
+    // Sort animation keys to favor cache coherency.
+    std::sort(&_src->front(), (&_src->back()) + 1, &SortingKeyLess<SortingKey>);
+
+    // Computes the range of every track.
+    const size_t num_tracks = _dest->ranges.size() * 4;
+    const float kMax = std::numeric_limits<float>::max();
+    vox::vector<Vector3F> mins(num_tracks, Vector3F(kMax, kMax, kMax));
+    vox::vector<Vector3F> maxs(num_tracks, Vector3F(-kMax, -kMax, -kMax));
+    for (const SortingKey& src : *_src) {
+        mins[src.track] = vox::min(mins[src.track], src.key.value);
+        maxs[src.track] = vox::max(maxs[src.track], src.key.value);
+    }
+    const auto max_quantized = static_cast<float>((1 << _dest->bits) - 1);
+    for (size_t i = 0; i < num_tracks; ++i) {
+        Float3KeyRange& range = _dest->ranges[i / 4];
+        for (int c = 0; c < 3; ++c) {
+            range.min[c][i % 4] = mins[i][c];
+            range.scale[c][i % 4] = (maxs[i][c] - mins[i][c]) / max_quantized;
+        }
+    }
+
+    // Fills output. Packed values are or-ed, so they must be cleared first.
+    std::fill(_dest->values.begin(), _dest->values.end(), 0);
+    const SortingKey* src = &_src->front();
+    for (size_t i = 0; i < src_count; ++i) {
+        _dest->ratios[i] = src[i].key.time * _inv_duration;
+        _dest->tracks[i] = src[i].track;
+        const Float3KeyRange& range = _dest->ranges[src[i].track / 4];
+        const int lane = src[i].track % 4;
+        for (int c = 0; c < 3; ++c) {
+            const float scale = range.scale[c][lane];
+            const float quantized =
+                    scale == 0.f ? 0.f : std::floor((src[i].key.value[c] - range.min[c][lane]) / scale + .5f);
+            WriteQuantized(_dest->values.data(), i, c, _dest->bits,
+                           static_cast<uint32_t>(vox::clamp(0.f, quantized, max_quantized)));
+        }
+    }
+}
+
 // Compares float absolute values.
 bool LessAbs(float _left, float _right) { return std::abs(_left) < std::abs(_right); }
 
@@ -203,6 +252,8 @@ void CopyToAnimation(vox::vector<SortingRotationKey>* _src, vox::span<Quaternion
 }
 }  // namespace
 
+AnimationBuilder::AnimationBuilder() : translation_bits(0), scale_bits(0) {}
+
 // Ensures _input's validity and allocates _animation.
 // An animation needs to have at least two key frames per joint, the first at
 // t = 0 and the last at t = duration. If at least one of those keys are not
@@ -213,6 +264,13 @@ unique_ptr<Animation> AnimationBuilder::operator()(const RawAnimation& _input) c
         return nullptr;
     }
 
+    // Tests quantization parameters.
+    static_assert(kMaxQuantizationBits == kMaxFloat3KeyBits, "Quantization limits must match");
+    if (translation_bits < 0 || translation_bits > kMaxQuantizationBits || scale_bits < 0 ||
+        scale_bits > kMaxQuantizationBits) {
+        return nullptr;
+    }
+
     // Everything is fine, allocates and fills the animation.
     // Nothing can fail now.
     unique_ptr<Animation> animation = make_unique<Animation>();
@@ -273,12 +331,20 @@ unique_ptr<Animation> AnimationBuilder::operator()(const RawAnimation& _input) c
 
     // Allocate animation members.
     animation->Allocate(_input.name.length(), sorting_translations.size(), sorting_rotations.size(),
-                        sorting_scales.size());
+                        sorting_scales.size(), translation_bits, scale_bits);
 
     // Copy sorted keys to final animation.
-    CopyToAnimation(&sorting_translations, &animation->translations_, inv_duration);
+    if (translation_bits > 0) {
+        CopyToAnimation(&sorting_translations, &animation->quantized_translations_, inv_duration);
+    } else {
+        CopyToAnimation(&sorting_translations, &animation->translations_, inv_duration);
+    }
     CopyToAnimation(&sorting_rotations, &animation->rotations_, inv_duration);
-    CopyToAnimation(&sorting_scales, &animation->scales_, inv_duration);
+    if (scale_bits > 0) {
+        CopyToAnimation(&sorting_scales, &animation->quantized_scales_, inv_duration);
+    } else {
+        CopyToAnimation(&sorting_scales, &animation->scales_, inv_duration);
+    }
 
     // Copy animation's name.
     if (animation->name_) {
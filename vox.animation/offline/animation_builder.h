@@ -24,12 +24,30 @@ struct RawAnimation;
 // No optimization at all is performed on the raw animation.
 class VOX_ANIMOFFLINE_DLL AnimationBuilder {
 public:
+    // Initializes the builder with default parameters.
+    AnimationBuilder();
+
     // Creates an Animation based on _raw_animation and *this builder parameters.
     // Returns a valid Animation on success.
     // See RawAnimation::Validate() for more details about failure reasons.
+    // Also fails if translation_bits or scale_bits are out of range.
     // The animation is returned as a unique_ptr as ownership is given back to
     // the caller.
     unique_ptr<Animation> operator()(const RawAnimation& _raw_animation) const;
+
+    // Maximum number of bits of quantized translations and scales.
+    static constexpr int kMaxQuantizationBits = 16;
+
+    // Number of bits used to quantize translation components in the range of
+    // their track, in range [0, kMaxQuantizationBits]. Keys are then stored as
+    // QuantizedFloat3Keys, taking 6 + 3 * bits / 8 bytes instead of 12, with a
+    // uniform precision of range / (2^bits - 1), where half floats lose
+    // precision as values grow. 0 keeps half floats, which is the default.
+    int translation_bits;
+
+    // Number of bits used to quantize scale components, same as
+    // translation_bits.
+    int scale_bits;
 };
 }  // namespace offline
 }  // namespace vox::animation
\ No newline at end of file
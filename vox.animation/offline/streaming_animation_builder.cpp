@@ -0,0 +1,203 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.animation/offline/streaming_animation_builder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "vox.animation/runtime/animation.h"
+#include "vox.animation/runtime/streaming_animation.h"
+#include "vox.base/containers/vector.h"
+#include "vox.base/io/archive.h"
+
+// Internal include file
+#define VOX_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "vox.animation/runtime/animation_keyframe.h"
+
+namespace vox::animation::offline {
+namespace {
+
+// Indices of the keys of every track, in ratio order.
+using TrackKeys = vox::vector<vox::vector<int>>;
+
+template <typename Keys>
+TrackKeys GatherTrackKeys(const Keys& _keys, int _num_tracks) {
+    TrackKeys tracks(_num_tracks);
+    for (int i = 0; i < _keys.size(); ++i) {
+        tracks[_keys.track(i)].push_back(i);
+    }
+    return tracks;
+}
+
+struct SortingKey {
+    float prev_ratio;
+    uint16_t track;
+    int index;
+};
+
+// Same sorting as the AnimationBuilder: by previous key ratio, then track.
+bool SortingKeyLess(const SortingKey& _left, const SortingKey& _right) {
+    return _left.prev_ratio < _right.prev_ratio ||
+           (_left.prev_ratio == _right.prev_ratio && _left.track < _right.track);
+}
+
+// Gets the indices of the keys required to sample [_begin, _end]: for every
+// track, the last key before or at _begin, up to the first key after or at _end.
+// The SamplingJob expects the first key of every track first, then the second
+// key of every track, both in track order. So first keys get a previous ratio
+// of -1, and second keys a previous ratio of _begin, which is lower than all the
+// following ones.
+template <typename Keys>
+vox::vector<int> BuildPageKeys(const Keys& _keys, const TrackKeys& _tracks, float _begin, float _end) {
+    vox::vector<SortingKey> sorting;
+    for (size_t track = 0; track < _tracks.size(); ++track) {
+        const vox::vector<int>& indices = _tracks[track];
+        const auto first =
+                std::upper_bound(indices.begin(), indices.end(), _begin,
+                                 [&_keys](float _ratio, int _index) { return _ratio < _keys.ratio(_index); }) -
+                1;
+        const auto last = std::lower_bound(indices.begin(), indices.end(), _end,
+                                           [&_keys](int _index, float _ratio) { return _keys.ratio(_index) < _ratio; });
+        assert(first >= indices.begin() && last < indices.end() && first < last);
+
+        for (auto it = first; it <= last; ++it) {
+            float prev_ratio;
+            if (it == first) {
+                prev_ratio = -1.f;
+            } else if (it == first + 1) {
+                prev_ratio = _begin;
+            } else {
+                prev_ratio = _keys.ratio(*(it - 1));
+            }
+            sorting.push_back({prev_ratio, static_cast<uint16_t>(track), *it});
+        }
+    }
+    std::sort(sorting.begin(), sorting.end(), &SortingKeyLess);
+
+    vox::vector<int> indices;
+    indices.reserve(sorting.size());
+    for (const SortingKey& key : sorting) {
+        indices.push_back(key.index);
+    }
+    return indices;
+}
+
+// Copies the keys of _indices to a page.
+template <typename Key>
+void CopyPageKeys(const KeyArray<Key>& _keys, const vox::vector<int>& _indices, span<Key> _dest) {
+    for (size_t i = 0; i < _indices.size(); ++i) {
+        _dest[i] = _keys.keys[_indices[i]];
+    }
+}
+
+void CopyPageKeys(const QuantizedKeyArray& _keys, const vox::vector<int>& _indices, QuantizedFloat3Keys* _dest) {
+    const QuantizedFloat3Keys& src = _keys.keys;
+    std::copy(src.ranges.begin(), src.ranges.end(), _dest->ranges.begin());
+    std::fill(_dest->values.begin(), _dest->values.end(), 0);
+    for (size_t i = 0; i < _indices.size(); ++i) {
+        const int index = _indices[i];
+        _dest->ratios[i] = src.ratios[index];
+        _dest->tracks[i] = src.tracks[index];
+        for (int c = 0; c < 3; ++c) {
+            WriteQuantized(_dest->values.data(), i, c, src.bits, ReadQuantized(src.values.data(), index, c, src.bits));
+        }
+    }
+}
+
+// Translation or scale keys of an animation, in either layout.
+struct Float3Keys {
+    Float3Keys(span<const Float3Key> _keys, const QuantizedFloat3Keys& _quantized_keys, int _num_tracks)
+        : keys{_keys},
+          quantized_keys{_quantized_keys},
+          tracks(quantized() ? GatherTrackKeys(quantized_keys, _num_tracks) : GatherTrackKeys(keys, _num_tracks)) {}
+
+    [[nodiscard]] bool quantized() const { return quantized_keys.keys.bits > 0; }
+
+    [[nodiscard]] vox::vector<int> PageKeys(float _begin, float _end) const {
+        return quantized() ? BuildPageKeys(quantized_keys, tracks, _begin, _end)
+                           : BuildPageKeys(keys, tracks, _begin, _end);
+    }
+
+    void CopyPage(const vox::vector<int>& _indices, span<Float3Key> _dest, QuantizedFloat3Keys* _quantized_dest) const {
+        if (quantized()) {
+            CopyPageKeys(quantized_keys, _indices, _quantized_dest);
+        } else {
+            CopyPageKeys(keys, _indices, _dest);
+        }
+    }
+
+    const KeyArray<Float3Key> keys;
+    const QuantizedKeyArray quantized_keys;
+    const TrackKeys tracks;
+};
+}  // namespace
+
+StreamingAnimationBuilder::StreamingAnimationBuilder() : page_duration(1.f) {}
+
+unique_ptr<StreamingAnimation> StreamingAnimationBuilder::operator()(const Animation& _animation) const {
+    if (!(page_duration > 0.f)) {
+        return nullptr;
+    }
+
+    unique_ptr<StreamingAnimation> streaming = make_unique<StreamingAnimation>();
+    streaming->duration_ = _animation.duration();
+    streaming->num_tracks_ = _animation.num_tracks();
+    streaming->name_ = _animation.name();
+
+    // An animation without track has no page.
+    const int num_keyed_tracks = _animation.num_soa_tracks() * 4;
+    if (num_keyed_tracks == 0) {
+        return streaming;
+    }
+
+    const Float3Keys translations(_animation.translations(), _animation.quantized_translations(), num_keyed_tracks);
+    const KeyArray<QuaternionKey> rotation_keys{_animation.rotations()};
+    const TrackKeys rotations = GatherTrackKeys(rotation_keys, num_keyed_tracks);
+    const Float3Keys scales(_animation.scales(), _animation.quantized_scales(), num_keyed_tracks);
+
+    const int num_pages = std::max(1, static_cast<int>(std::ceil(_animation.duration() / page_duration)));
+    streaming->page_ratios_.resize(num_pages + 1);
+    for (int i = 0; i < num_pages; ++i) {
+        streaming->page_ratios_[i] = static_cast<float>(i) / static_cast<float>(num_pages);
+    }
+    streaming->page_ratios_[num_pages] = 1.f;
+
+    for (int i = 0; i < num_pages; ++i) {
+        const float begin = streaming->page_ratios_[i];
+        const float end = streaming->page_ratios_[i + 1];
+        const vox::vector<int> page_translations = translations.PageKeys(begin, end);
+        const vox::vector<int> page_rotations = BuildPageKeys(rotation_keys, rotations, begin, end);
+        const vox::vector<int> page_scales = scales.PageKeys(begin, end);
+
+        // Pages are unnamed animations, quantized like the animation.
+        Animation page;
+        page.duration_ = _animation.duration();
+        page.num_tracks_ = _animation.num_tracks();
+        page.Allocate(0, page_translations.size(), page_rotations.size(), page_scales.size(),
+                      _animation.quantized_translations().bits, _animation.quantized_scales().bits);
+        translations.CopyPage(page_translations, page.translations_, &page.quantized_translations_);
+        CopyPageKeys(rotation_keys, page_rotations, page.rotations_);
+        scales.CopyPage(page_scales, page.scales_, &page.quantized_scales_);
+
+        // Every page is serialized as a standalone archive, so it can be loaded
+        // independently.
+        io::MemoryStream stream;
+        {
+            io::OArchive archive(&stream);
+            archive << page;
+        }
+        const size_t offset = streaming->resident_data_.size();
+        streaming->resident_data_.resize(offset + stream.Size());
+        stream.Seek(0, io::Stream::kSet);
+        stream.Read(streaming->resident_data_.data() + offset, stream.Size());
+        streaming->page_offsets_.push_back(static_cast<uint32_t>(streaming->resident_data_.size()));
+    }
+
+    return streaming;
+}
+}  // namespace vox::animation::offline
@@ -0,0 +1,41 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "vox.animation/offline/export.h"
+#include "vox.base/memory/unique_ptr.h"
+
+namespace vox::animation {
+
+class Animation;
+class StreamingAnimation;
+
+namespace offline {
+
+// Splits a runtime Animation into the time pages of a StreamingAnimation.
+// Keyframes are copied as is, so sampling a page gives the same result as
+// sampling the source animation. Keys surrounding page boundaries are
+// duplicated in the adjacent pages, which slightly increases the total size.
+class VOX_ANIMOFFLINE_DLL StreamingAnimationBuilder {
+public:
+    // Initializes the builder with default parameters.
+    StreamingAnimationBuilder();
+
+    // Creates a StreamingAnimation from _animation and *this builder parameters.
+    // Returns nullptr if page_duration isn't strictly positive.
+    // The animation is returned as a unique_ptr as ownership is given back to
+    // the caller. Its pages are resident until it's saved to, then loaded from
+    // an archive.
+    unique_ptr<StreamingAnimation> operator()(const Animation& _animation) const;
+
+    // Maximum duration of a page in seconds. The animation is split into
+    // ceil(duration / page_duration) pages of equal duration, so every page
+    // lasts at most page_duration. Default is 1s.
+    float page_duration;
+};
+}  // namespace offline
+}  // namespace vox::animation
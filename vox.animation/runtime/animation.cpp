@@ -30,31 +30,116 @@ Animation& Animation::operator=(Animation&& _other) noexcept {
     std::swap(translations_, _other.translations_);
     std::swap(rotations_, _other.rotations_);
     std::swap(scales_, _other.scales_);
+    std::swap(quantized_translations_, _other.quantized_translations_);
+    std::swap(quantized_scales_, _other.quantized_scales_);
 
     return *this;
 }
 
 Animation::~Animation() { Deallocate(); }
 
-void Animation::Allocate(size_t _name_len, size_t _translation_count, size_t _rotation_count, size_t _scale_count) {
+namespace {
+// Gets the size of _count quantized keys, and of the ranges of their tracks.
+size_t QuantizedKeysSize(size_t _count, int _bits, size_t _num_soa_tracks) {
+    if (_bits == 0) {
+        return 0;
+    }
+    return _num_soa_tracks * sizeof(Float3KeyRange) + _count * (sizeof(float) + sizeof(uint16_t)) +
+           QuantizedValuesSize(_count, _bits);
+}
+
+size_t QuantizedKeysSizeBytes(const QuantizedFloat3Keys& _keys) {
+    return _keys.ratios.size_bytes() + _keys.tracks.size_bytes() + _keys.values.size_bytes() +
+           _keys.ranges.size_bytes();
+}
+
+// Loads or saves the ratio and track of every key, then their packed values.
+void SaveQuantizedKeys(vox::io::OArchive& _archive, const QuantizedFloat3Keys& _keys) {
+    for (const Float3KeyRange& range : _keys.ranges) {
+        _archive << vox::io::MakeArray(&range.min[0][0], 12);
+        _archive << vox::io::MakeArray(&range.scale[0][0], 12);
+    }
+    _archive << vox::io::MakeArray(_keys.ratios.data(), _keys.ratios.size());
+    _archive << vox::io::MakeArray(_keys.tracks.data(), _keys.tracks.size());
+    // Padding isn't serialized.
+    _archive << vox::io::MakeArray(_keys.values.data(), _keys.values.size() - 2);
+}
+
+void LoadQuantizedKeys(vox::io::IArchive& _archive, QuantizedFloat3Keys& _keys) {
+    for (Float3KeyRange& range : _keys.ranges) {
+        _archive >> vox::io::MakeArray(&range.min[0][0], 12);
+        _archive >> vox::io::MakeArray(&range.scale[0][0], 12);
+    }
+    _archive >> vox::io::MakeArray(_keys.ratios.data(), _keys.ratios.size());
+    _archive >> vox::io::MakeArray(_keys.tracks.data(), _keys.tracks.size());
+    _archive >> vox::io::MakeArray(_keys.values.data(), _keys.values.size() - 2);
+    _keys.values[_keys.values.size() - 2] = 0;
+    _keys.values[_keys.values.size() - 1] = 0;
+}
+}  // namespace
+
+void Animation::Allocate(size_t _name_len,
+                         size_t _translation_count,
+                         size_t _rotation_count,
+                         size_t _scale_count,
+                         int _translation_bits,
+                         int _scale_bits) {
     // Distributes buffer memory while ensuring proper alignment (serves larger
     // alignment values first).
     static_assert(alignof(Float3Key) >= alignof(QuaternionKey) && alignof(QuaternionKey) >= alignof(Float3Key) &&
-                          alignof(Float3Key) >= alignof(char),
+                          alignof(Float3Key) >= alignof(Float3KeyRange) &&
+                          alignof(Float3KeyRange) >= alignof(float) && alignof(float) >= alignof(uint16_t) &&
+                          alignof(uint16_t) >= alignof(byte) && alignof(byte) >= alignof(char),
                   "Must serve larger alignment values first)");
 
-    assert(name_ == nullptr && translations_.empty() && rotations_.empty() && scales_.empty());
+    assert(name_ == nullptr && translations_.empty() && rotations_.empty() && scales_.empty() &&
+           quantized_translations_.size() == 0 && quantized_scales_.size() == 0);
+
+    // Quantized keys have a range per soa track.
+    const auto num_soa_tracks = static_cast<size_t>(this->num_soa_tracks());
+    const size_t translation_count = _translation_bits == 0 ? _translation_count : 0;
+    const size_t scale_count = _scale_bits == 0 ? _scale_count : 0;
 
     // Compute overall size and allocate a single buffer for all the data.
-    const size_t buffer_size = (_name_len > 0 ? _name_len + 1 : 0) + _translation_count * sizeof(Float3Key) +
-                               _rotation_count * sizeof(QuaternionKey) + _scale_count * sizeof(Float3Key);
+    const size_t buffer_size = (_name_len > 0 ? _name_len + 1 : 0) + translation_count * sizeof(Float3Key) +
+                               _rotation_count * sizeof(QuaternionKey) + scale_count * sizeof(Float3Key) +
+                               QuantizedKeysSize(_translation_count, _translation_bits, num_soa_tracks) +
+                               QuantizedKeysSize(_scale_count, _scale_bits, num_soa_tracks);
     span<byte> buffer = {static_cast<byte*>(memory::default_allocator()->Allocate(buffer_size, alignof(Float3Key))),
                          buffer_size};
 
     // Fix up pointers. Serves larger alignment values first.
-    translations_ = fill_span<Float3Key>(buffer, _translation_count);
+    translations_ = fill_span<Float3Key>(buffer, translation_count);
     rotations_ = fill_span<QuaternionKey>(buffer, _rotation_count);
-    scales_ = fill_span<Float3Key>(buffer, _scale_count);
+    scales_ = fill_span<Float3Key>(buffer, scale_count);
+
+    if (_translation_bits > 0) {
+        quantized_translations_.bits = _translation_bits;
+        quantized_translations_.ranges = fill_span<Float3KeyRange>(buffer, num_soa_tracks);
+    }
+    if (_scale_bits > 0) {
+        quantized_scales_.bits = _scale_bits;
+        quantized_scales_.ranges = fill_span<Float3KeyRange>(buffer, num_soa_tracks);
+    }
+    if (_translation_bits > 0) {
+        quantized_translations_.ratios = fill_span<float>(buffer, _translation_count);
+    }
+    if (_scale_bits > 0) {
+        quantized_scales_.ratios = fill_span<float>(buffer, _scale_count);
+    }
+    if (_translation_bits > 0) {
+        quantized_translations_.tracks = fill_span<uint16_t>(buffer, _translation_count);
+    }
+    if (_scale_bits > 0) {
+        quantized_scales_.tracks = fill_span<uint16_t>(buffer, _scale_count);
+    }
+    if (_translation_bits > 0) {
+        quantized_translations_.values =
+                fill_span<byte>(buffer, QuantizedValuesSize(_translation_count, _translation_bits));
+    }
+    if (_scale_bits > 0) {
+        quantized_scales_.values = fill_span<byte>(buffer, QuantizedValuesSize(_scale_count, _scale_bits));
+    }
 
     // Let name be nullptr if animation has no name. Allows to avoid allocating
     // this buffer in the constructor of empty animations.
@@ -70,10 +155,13 @@ void Animation::Deallocate() {
     translations_ = {};
     rotations_ = {};
     scales_ = {};
+    quantized_translations_ = {};
+    quantized_scales_ = {};
 }
 
 size_t Animation::size() const {
-    const size_t size = sizeof(*this) + translations_.size_bytes() + rotations_.size_bytes() + scales_.size_bytes();
+    const size_t size = sizeof(*this) + translations_.size_bytes() + rotations_.size_bytes() + scales_.size_bytes() +
+                        QuantizedKeysSizeBytes(quantized_translations_) + QuantizedKeysSizeBytes(quantized_scales_);
     return size;
 }
 
@@ -84,12 +172,15 @@ void Animation::Save(vox::io::OArchive& _archive) const {
     const size_t name_len = name_ ? std::strlen(name_) : 0;
     _archive << static_cast<int32_t>(name_len);
 
-    const ptrdiff_t translation_count = translations_.size();
+    const size_t translation_count =
+            quantized_translations_.bits > 0 ? quantized_translations_.size() : translations_.size();
     _archive << static_cast<int32_t>(translation_count);
     const ptrdiff_t rotation_count = rotations_.size();
     _archive << static_cast<int32_t>(rotation_count);
-    const ptrdiff_t scale_count = scales_.size();
+    const size_t scale_count = quantized_scales_.bits > 0 ? quantized_scales_.size() : scales_.size();
     _archive << static_cast<int32_t>(scale_count);
+    _archive << static_cast<int32_t>(quantized_translations_.bits);
+    _archive << static_cast<int32_t>(quantized_scales_.bits);
 
     _archive << vox::io::MakeArray(name_, name_len);
 
@@ -98,6 +189,9 @@ void Animation::Save(vox::io::OArchive& _archive) const {
         _archive << key.track;
         _archive << vox::io::MakeArray(key.value);
     }
+    if (quantized_translations_.bits > 0) {
+        SaveQuantizedKeys(_archive, quantized_translations_);
+    }
 
     for (const QuaternionKey& key : rotations_) {
         _archive << key.ratio;
@@ -115,6 +209,9 @@ void Animation::Save(vox::io::OArchive& _archive) const {
         _archive << key.track;
         _archive << vox::io::MakeArray(key.value);
     }
+    if (quantized_scales_.bits > 0) {
+        SaveQuantizedKeys(_archive, quantized_scales_);
+    }
 }
 
 void Animation::Load(vox::io::IArchive& _archive, uint32_t _version) {
@@ -123,8 +220,9 @@ void Animation::Load(vox::io::IArchive& _archive, uint32_t _version) {
     duration_ = 0.f;
     num_tracks_ = 0;
 
-    // No retro-compatibility with anterior versions.
-    if (_version != 6) {
+    // No retro-compatibility with versions anterior to 6. Version 6 has no
+    // quantized keys.
+    if (_version != 6 && _version != 7) {
         LOGE("Unsupported Animation version {}", _version)
         return;
     }
@@ -143,8 +241,21 @@ void Animation::Load(vox::io::IArchive& _archive, uint32_t _version) {
     _archive >> rotation_count;
     int32_t scale_count;
     _archive >> scale_count;
+    int32_t translation_bits = 0;
+    int32_t scale_bits = 0;
+    if (_version >= 7) {
+        _archive >> translation_bits;
+        _archive >> scale_bits;
+        if (translation_bits < 0 || translation_bits > kMaxFloat3KeyBits || scale_bits < 0 ||
+            scale_bits > kMaxFloat3KeyBits) {
+            LOGE("Invalid Animation quantization bits {} and {}", translation_bits, scale_bits)
+            duration_ = 0.f;
+            num_tracks_ = 0;
+            return;
+        }
+    }
 
-    Allocate(name_len, translation_count, rotation_count, scale_count);
+    Allocate(name_len, translation_count, rotation_count, scale_count, translation_bits, scale_bits);
 
     if (name_) {  // nullptr name_ is supported.
         _archive >> vox::io::MakeArray(name_, name_len);
@@ -156,6 +267,9 @@ void Animation::Load(vox::io::IArchive& _archive, uint32_t _version) {
         _archive >> key.track;
         _archive >> vox::io::MakeArray(key.value);
     }
+    if (quantized_translations_.bits > 0) {
+        LoadQuantizedKeys(_archive, quantized_translations_);
+    }
 
     for (QuaternionKey& key : rotations_) {
         _archive >> key.ratio;
@@ -176,5 +290,8 @@ void Animation::Load(vox::io::IArchive& _archive, uint32_t _version) {
         _archive >> key.track;
         _archive >> vox::io::MakeArray(key.value);
     }
+    if (quantized_scales_.bits > 0) {
+        LoadQuantizedKeys(_archive, quantized_scales_);
+    }
 }
 }  // namespace vox::animation
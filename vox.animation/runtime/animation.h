@@ -21,12 +21,37 @@ namespace animation {
 // Forward declares the AnimationBuilder, used to instantiate an Animation.
 namespace offline {
 class AnimationBuilder;
+class StreamingAnimationBuilder;
 }
 
 // Forward declaration of key frame's type.
 struct Float3Key;
+struct Float3KeyRange;
 struct QuaternionKey;
 
+// Defines translation or scale keys quantized in the range of their track, see
+// AnimationBuilder::translation_bits. Keys are sorted like Float3Key ones, but
+// their ratios and tracks are stored in separate arrays, and the 3 components of
+// every key are packed in the values buffer with bits bits each. So a key takes
+// 6 + 3 * bits / 8 bytes, where a Float3Key takes 12 bytes.
+struct QuantizedFloat3Keys {
+    // Gets the number of keys.
+    [[nodiscard]] size_t size() const { return ratios.size(); }
+
+    // Number of bits of every component, 0 if keys aren't quantized.
+    int bits = 0;
+
+    // Ratio and track of every key.
+    span<float> ratios;
+    span<uint16_t> tracks;
+
+    // Packed components of every key, see ReadQuantized.
+    span<byte> values;
+
+    // Quantization range of every soa track.
+    span<Float3KeyRange> ranges;
+};
+
 // Defines a runtime skeletal animation clip.
 // The runtime animation data structure stores animation keyframes, for all the
 // joints of a skeleton. This structure is usually filled by the
@@ -37,6 +62,8 @@ struct QuaternionKey;
 // joints order of the runtime skeleton structure. In order to optimize cache
 // coherency when sampling the animation, Keyframes in this array are sorted by
 // time, then by track number.
+// Translation and scale values are stored either as half floats, or quantized
+// in the range of their track, see QuantizedFloat3Keys.
 class VOX_ANIMATION_DLL Animation {
 public:
     // Builds a default animation.
@@ -66,15 +93,22 @@ public:
     // Gets animation name.
     [[nodiscard]] const char* name() const { return name_ ? name_ : ""; }
 
-    // Gets the buffer of translations keys.
+    // Gets the buffer of translations keys. Empty if translations are quantized.
     [[nodiscard]] span<const Float3Key> translations() const { return translations_; }
 
+    // Gets the quantized translation keys. Empty unless translations are
+    // quantized.
+    [[nodiscard]] const QuantizedFloat3Keys& quantized_translations() const { return quantized_translations_; }
+
     // Gets the buffer of rotation keys.
     [[nodiscard]] span<const QuaternionKey> rotations() const { return rotations_; }
 
-    // Gets the buffer of scale keys.
+    // Gets the buffer of scale keys. Empty if scales are quantized.
     [[nodiscard]] span<const Float3Key> scales() const { return scales_; }
 
+    // Gets the quantized scale keys. Empty unless scales are quantized.
+    [[nodiscard]] const QuantizedFloat3Keys& quantized_scales() const { return quantized_scales_; }
+
     // Get the estimated animation's size in bytes.
     [[nodiscard]] size_t size() const;
 
@@ -86,9 +120,18 @@ public:
 private:
     // AnimationBuilder class is allowed to instantiate an Animation.
     friend class offline::AnimationBuilder;
+    // StreamingAnimationBuilder class is allowed to instantiate animation pages.
+    friend class offline::StreamingAnimationBuilder;
 
     // Internal destruction function.
-    void Allocate(size_t _name_len, size_t _translation_count, size_t _rotation_count, size_t _scale_count);
+    // Translations and scales are allocated as quantized keys if their number of
+    // bits isn't 0, which requires num_tracks_ to be set first.
+    void Allocate(size_t _name_len,
+                  size_t _translation_count,
+                  size_t _rotation_count,
+                  size_t _scale_count,
+                  int _translation_bits = 0,
+                  int _scale_bits = 0);
     void Deallocate();
 
     // Duration of the animation clip.
@@ -105,11 +148,16 @@ private:
     span<Float3Key> translations_;
     span<QuaternionKey> rotations_;
     span<Float3Key> scales_;
+
+    // Stores quantized translation/scale keys, used instead of translations_ and
+    // scales_ if not empty.
+    QuantizedFloat3Keys quantized_translations_;
+    QuantizedFloat3Keys quantized_scales_;
 };
 }  // namespace animation
 
 namespace io {
-VOX_IO_TYPE_VERSION(6, animation::Animation)
+VOX_IO_TYPE_VERSION(7, animation::Animation)
 VOX_IO_TYPE_TAG("ozz-animation", animation::Animation)
 }  // namespace io
 }  // namespace vox
\ No newline at end of file
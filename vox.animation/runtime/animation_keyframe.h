@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <cstddef>
+
+#include "vox.animation/runtime/animation.h"
 #include "vox.animation/runtime/export.h"
 #include "vox.base/macros.h"
 
@@ -31,6 +34,44 @@ struct VOX_ANIMATION_DLL Float3Key {
     uint16_t value[3];
 };
 
+// Defines the quantization range of the float3 keys of a soa track (4 tracks),
+// used when translations or scales are quantized, see QuantizedFloat3Keys.
+// Component c of a key of lane l is restored as
+// min[c][l] + quantized * scale[c][l], which decompresses 4 keys with a single
+// multiply-add per component.
+struct VOX_ANIMATION_DLL Float3KeyRange {
+    float min[3][4];
+    float scale[3][4];
+};
+
+// Maximum number of bits of the components of quantized float3 keys.
+constexpr int kMaxFloat3KeyBits = 16;
+
+// Gets the size in bytes of the packed values of _count quantized float3 keys
+// of _bits bits per component. Values are read 3 bytes at a time, so the buffer
+// is padded with 2 bytes to never read past its end.
+inline size_t QuantizedValuesSize(size_t _count, int _bits) { return (_count * 3 * _bits + 7) / 8 + 2; }
+
+// Reads the _component of the quantized float3 key _key from _values, where
+// every component is packed with _bits bits, at most kMaxFloat3KeyBits.
+inline uint32_t ReadQuantized(const byte* _values, size_t _key, int _component, int _bits) {
+    const size_t bit = (_key * 3 + _component) * _bits;
+    const byte* src = _values + bit / 8;
+    const uint32_t word = src[0] | (src[1] << 8) | (src[2] << 16);
+    return (word >> (bit % 8)) & ((1u << _bits) - 1);
+}
+
+// Writes the _component of the quantized float3 key _key to _values, see
+// ReadQuantized. Bits of _values written to must be 0.
+inline void WriteQuantized(byte* _values, size_t _key, int _component, int _bits, uint32_t _value) {
+    const size_t bit = (_key * 3 + _component) * _bits;
+    byte* dest = _values + bit / 8;
+    const uint32_t word = _value << (bit % 8);
+    dest[0] |= static_cast<byte>(word);
+    dest[1] |= static_cast<byte>(word >> 8);
+    dest[2] |= static_cast<byte>(word >> 16);
+}
+
 // Defines the rotation key frame type.
 // Rotation value is a quaternion. Quaternion are normalized, which means each
 // component is in range [0:1]. This property allows to quantize the 3
@@ -54,4 +95,25 @@ struct VOX_ANIMATION_DLL QuaternionKey {
     int16_t value[3];      // The quantized value of the 3 smallest components.
 };
 
+// Gives access to the ratio and track of keys stored as an array of key
+// structures, so that algorithms iterating sorted keys support all key layouts.
+template <typename Key>
+struct KeyArray {
+    [[nodiscard]] int size() const { return static_cast<int>(keys.size()); }
+    [[nodiscard]] float ratio(int _key) const { return keys[_key].ratio; }
+    [[nodiscard]] int track(int _key) const { return keys[_key].track; }
+
+    span<const Key> keys;
+};
+
+// Same as KeyArray for quantized keys, whose ratios and tracks are stored in
+// separate arrays.
+struct QuantizedKeyArray {
+    [[nodiscard]] int size() const { return static_cast<int>(keys.size()); }
+    [[nodiscard]] float ratio(int _key) const { return keys.ratios[_key]; }
+    [[nodiscard]] int track(int _key) const { return keys.tracks[_key]; }
+
+    const QuantizedFloat3Keys& keys;
+};
+
 }  // namespace vox::animation
\ No newline at end of file
@@ -0,0 +1,122 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.animation/runtime/animation_page_cache.h"
+
+#include <utility>
+
+#include "vox.animation/runtime/animation.h"
+#include "vox.animation/runtime/streaming_animation.h"
+#include "vox.base/memory/unique_ptr.h"
+
+namespace vox::animation {
+
+AnimationPageCache::AnimationPageCache(size_t _budget) : budget_(_budget), size_(0), num_hits_(0), num_misses_(0) {}
+
+AnimationPageCache::~AnimationPageCache() = default;
+
+uint64_t AnimationPageCache::Key(const StreamingAnimation& _animation, int _page) {
+    return (static_cast<uint64_t>(_animation.id()) << 32) | static_cast<uint32_t>(_page);
+}
+
+std::shared_ptr<const Animation> AnimationPageCache::Acquire(const StreamingAnimation& _animation, int _page) {
+    const uint64_t key = Key(_animation, _page);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = lookup_.find(key);
+        if (it != lookup_.end()) {
+            // Moves the entry to the front.
+            entries_.splice(entries_.begin(), entries_, it->second);
+            ++num_hits_;
+            return it->second->page;
+        }
+    }
+
+    // Loads outside of the lock, so that threads accessing resident pages
+    // aren't blocked by IO.
+    std::shared_ptr<const Animation> page(_animation.LoadPage(_page).release(), vox::Deleter<Animation>());
+    if (!page) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_misses_;
+
+    // Another thread might have loaded the same page meanwhile.
+    const auto it = lookup_.find(key);
+    if (it != lookup_.end()) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->page;
+    }
+
+    entries_.push_front({key, page->size(), page});
+    lookup_.emplace(key, entries_.begin());
+    size_ += entries_.front().size;
+    Trim();
+    return page;
+}
+
+void AnimationPageCache::Evict(const StreamingAnimation& _animation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t id = _animation.id();
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->key >> 32 == id) {
+            size_ -= it->size;
+            lookup_.erase(it->key);
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void AnimationPageCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    lookup_.clear();
+    size_ = 0;
+}
+
+void AnimationPageCache::set_budget(size_t _budget) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = _budget;
+    Trim();
+}
+
+size_t AnimationPageCache::budget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t AnimationPageCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+size_t AnimationPageCache::num_pages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t AnimationPageCache::num_hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_hits_;
+}
+
+size_t AnimationPageCache::num_misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_misses_;
+}
+
+void AnimationPageCache::Trim() {
+    while (size_ > budget_ && entries_.size() > 1) {
+        const Entry& lru = entries_.back();
+        size_ -= lru.size;
+        lookup_.erase(lru.key);
+        entries_.pop_back();
+    }
+}
+}  // namespace vox::animation
@@ -0,0 +1,90 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "vox.animation/runtime/export.h"
+
+namespace vox::animation {
+
+class Animation;
+class StreamingAnimation;
+
+// Bounded cache of StreamingAnimation pages, shared by any number of
+// animations and threads.
+// Pages are loaded on demand, and the least recently used ones are evicted as
+// soon as the total size of the resident pages exceeds the budget. Acquired
+// pages are returned as shared pointers, so a page remains valid as long as it
+// is used, even if it's evicted in the meantime. The page being acquired is
+// never evicted, so a budget smaller than a page still works, with a single
+// resident page.
+class VOX_ANIMATION_DLL AnimationPageCache {
+public:
+    // Constructs a cache that can keep up to _budget bytes of pages resident.
+    explicit AnimationPageCache(size_t _budget);
+
+    AnimationPageCache(const AnimationPageCache&) = delete;
+    AnimationPageCache& operator=(const AnimationPageCache&) = delete;
+
+    ~AnimationPageCache();
+
+    // Returns page _page of _animation, loading it if it isn't resident.
+    // Returns nullptr if the page can't be loaded.
+    std::shared_ptr<const Animation> Acquire(const StreamingAnimation& _animation, int _page);
+
+    // Evicts all the pages of _animation, for example when it's unloaded.
+    void Evict(const StreamingAnimation& _animation);
+
+    // Evicts all the pages.
+    void Clear();
+
+    // Changes the budget, evicting pages if needed.
+    void set_budget(size_t _budget);
+    [[nodiscard]] size_t budget() const;
+
+    // Returns the total size in bytes of the resident pages.
+    [[nodiscard]] size_t size() const;
+
+    // Returns the number of resident pages.
+    [[nodiscard]] size_t num_pages() const;
+
+    // Returns the number of Acquire calls served from the cache, and the number
+    // of pages loaded.
+    [[nodiscard]] size_t num_hits() const;
+    [[nodiscard]] size_t num_misses() const;
+
+private:
+    struct Entry {
+        uint64_t key;
+        size_t size;
+        std::shared_ptr<const Animation> page;
+    };
+    using Entries = std::list<Entry>;
+
+    static uint64_t Key(const StreamingAnimation& _animation, int _page);
+
+    // Evicts least recently used pages until the size fits the budget, but
+    // always keeps the most recent one. Must be called with mutex_ locked.
+    void Trim();
+
+    mutable std::mutex mutex_;
+
+    // Pages ordered from the most to the least recently used.
+    Entries entries_;
+    std::unordered_map<uint64_t, Entries::iterator> lookup_;
+
+    size_t budget_;
+    size_t size_;
+    size_t num_hits_;
+    size_t num_misses_;
+};
+}  // namespace vox::animation
@@ -6,12 +6,21 @@
 
 #include "vox.animation/runtime/animation_utils.h"
 
+#include <algorithm>
+
 // Internal include file
 #define VOX_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
 #include "vox.animation/runtime/animation_keyframe.h"
 
 namespace vox::animation {
 
+inline int CountKeyframesImpl(const QuantizedFloat3Keys& _keys, int _track) {
+    if (_track < 0) {
+        return static_cast<int>(_keys.size());
+    }
+    return static_cast<int>(std::count(_keys.tracks.begin(), _keys.tracks.end(), _track));
+}
+
 template <typename Key>
 inline int CountKeyframesImpl(const span<const Key>& _keys, int _track) {
     if (_track < 0) {
@@ -28,12 +37,18 @@ inline int CountKeyframesImpl(const span<const Key>& _keys, int _track) {
 }
 
 int CountTranslationKeyframes(const Animation& _animation, int _track) {
+    if (_animation.quantized_translations().bits > 0) {
+        return CountKeyframesImpl(_animation.quantized_translations(), _track);
+    }
     return CountKeyframesImpl(_animation.translations(), _track);
 }
 int CountRotationKeyframes(const Animation& _animation, int _track) {
     return CountKeyframesImpl(_animation.rotations(), _track);
 }
 int CountScaleKeyframes(const Animation& _animation, int _track) {
+    if (_animation.quantized_scales().bits > 0) {
+        return CountKeyframesImpl(_animation.quantized_scales(), _track);
+    }
     return CountKeyframesImpl(_animation.scales(), _track);
 }
 }  // namespace vox::animation
@@ -0,0 +1,140 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.animation/runtime/local_to_model_tracker.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "vox.animation/runtime/local_to_model_job.h"
+#include "vox.animation/runtime/skeleton.h"
+
+namespace vox::animation {
+
+LocalToModelTracker::LocalToModelTracker() : has_dirty_(false), num_jobs_(0) {}
+
+LocalToModelTracker::LocalToModelTracker(const Skeleton& _skeleton) : has_dirty_(false), num_jobs_(0) {
+    Resize(_skeleton);
+}
+
+void LocalToModelTracker::Resize(const Skeleton& _skeleton) {
+    const span<const int16_t> parents = _skeleton.joint_parents();
+    const size_t num_joints = parents.size();
+    parents_.assign(parents.begin(), parents.end());
+
+    // A hierarchy ends after the end of its last child. Children are after
+    // their parent, so iterating backward propagates ends up to the roots.
+    hierarchy_ends_.resize(num_joints);
+    for (size_t i = 0; i < num_joints; ++i) {
+        hierarchy_ends_[i] = static_cast<int16_t>(i + 1);
+    }
+    for (size_t i = num_joints; i-- > 0;) {
+        const int parent = parents_[i];
+        if (parent != Skeleton::kNoParent) {
+            hierarchy_ends_[parent] = std::max(hierarchy_ends_[parent], hierarchy_ends_[i]);
+        }
+    }
+
+    dirty_.resize(num_joints);
+    SetAllDirty();
+}
+
+void LocalToModelTracker::SetDirty(int _joint) {
+    assert(_joint >= 0 && _joint < num_joints() && "joint index out of bound.");
+    dirty_[_joint] = true;
+    has_dirty_ = true;
+}
+
+void LocalToModelTracker::SetAllDirty() {
+    std::fill(dirty_.begin(), dirty_.end(), true);
+    has_dirty_ = !dirty_.empty();
+}
+
+void LocalToModelTracker::Clear() {
+    std::fill(dirty_.begin(), dirty_.end(), false);
+    has_dirty_ = false;
+}
+
+bool LocalToModelTracker::IsOutdated(int _joint) const {
+    assert(_joint >= 0 && _joint < num_joints() && "joint index out of bound.");
+    if (!has_dirty_) {
+        return false;
+    }
+    for (int joint = _joint; joint != Skeleton::kNoParent; joint = parents_[joint]) {
+        if (dirty_[joint]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LocalToModelTracker::Update(const LocalToModelJob& _job) {
+    num_jobs_ = 0;
+    if (!_job.Validate() || _job.skeleton->num_joints() != num_joints()) {
+        return false;
+    }
+    if (!has_dirty_) {
+        return true;
+    }
+
+    // Dirty joints that are inside an updated hierarchy are skipped.
+    LocalToModelJob job = _job;
+    const int num_joints = this->num_joints();
+    for (int i = 0; i < num_joints;) {
+        if (dirty_[i]) {
+            const int end = hierarchy_ends_[i];
+            if (!UpdateHierarchy(&job, i)) {
+                return false;
+            }
+            i = end;
+        } else {
+            ++i;
+        }
+    }
+    has_dirty_ = false;
+    return true;
+}
+
+bool LocalToModelTracker::Update(const LocalToModelJob& _job, int _joint) {
+    num_jobs_ = 0;
+    if (!_job.Validate() || _job.skeleton->num_joints() != num_joints()) {
+        return false;
+    }
+    assert(_joint >= 0 && _joint < num_joints() && "joint index out of bound.");
+
+    // Finds the top-most dirty parent, which hierarchy contains all the other
+    // dirty parents.
+    int top = Skeleton::kNoParent;
+    for (int joint = _joint; joint != Skeleton::kNoParent; joint = parents_[joint]) {
+        if (dirty_[joint]) {
+            top = joint;
+        }
+    }
+    if (top == Skeleton::kNoParent) {
+        return true;
+    }
+
+    LocalToModelJob job = _job;
+    if (!UpdateHierarchy(&job, top)) {
+        return false;
+    }
+    has_dirty_ = std::find(dirty_.begin(), dirty_.end(), true) != dirty_.end();
+    return true;
+}
+
+bool LocalToModelTracker::UpdateHierarchy(LocalToModelJob* _job, int _joint) {
+    _job->from = _joint;
+    _job->to = Skeleton::kMaxJoints;
+    _job->from_excluded = false;
+    if (!_job->Run()) {
+        return false;
+    }
+    ++num_jobs_;
+
+    std::fill(dirty_.begin() + _joint, dirty_.begin() + hierarchy_ends_[_joint], false);
+    return true;
+}
+}  // namespace vox::animation
@@ -0,0 +1,92 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "vox.animation/runtime/export.h"
+#include "vox.base/containers/vector.h"
+#include "vox.base/macros.h"
+
+namespace vox::animation {
+
+// Forward declares the Skeleton object used to describe joint hierarchy.
+class Skeleton;
+struct LocalToModelJob;
+
+// Tracks joints whose local-space transform changed since model-space matrices
+// were computed, and runs the minimal set of LocalToModelJob to update them.
+// Skeleton joints are stored depth-first, so the hierarchy of a joint is a
+// contiguous range of joints, which is what a LocalToModelJob "from" a joint
+// updates. Dirty joints that are part of the hierarchy of another dirty joint
+// are updated by the same job, so every model-space matrix is computed at most
+// once per update, whatever the number of local-space changes.
+class VOX_ANIMATION_DLL LocalToModelTracker {
+public:
+    // Constructs a tracker with no joint.
+    LocalToModelTracker();
+
+    // Constructs a tracker for _skeleton, see Resize().
+    explicit LocalToModelTracker(const Skeleton& _skeleton);
+
+    // Sizes the tracker for _skeleton joints hierarchy. All joints are dirty
+    // as model-space matrices are unknown.
+    void Resize(const Skeleton& _skeleton);
+
+    // Flags _joint local-space transform as changed. Its model-space matrix and
+    // the ones of its hierarchy are outdated.
+    void SetDirty(int _joint);
+
+    // Flags all local-space transforms as changed.
+    void SetAllDirty();
+
+    // Flags all model-space matrices as up to date, for example after a full
+    // LocalToModelJob was run.
+    void Clear();
+
+    // Tests if _joint model-space matrix is outdated, which is when the joint
+    // or one of its parents is dirty.
+    [[nodiscard]] bool IsOutdated(int _joint) const;
+
+    // Tests if any model-space matrix is outdated.
+    [[nodiscard]] bool HasDirty() const { return has_dirty_; }
+
+    // Updates all outdated model-space matrices, running _job from the
+    // top-most dirty joints. _job skeleton, root, input and output are used,
+    // "from", "to" and "from_excluded" are overwritten.
+    // Returns false if _job is invalid or doesn't match the tracked skeleton.
+    [[nodiscard]] bool Update(const LocalToModelJob& _job);
+
+    // Updates only what is needed for _joint model-space matrix to be up to
+    // date, which is the hierarchy of its top-most dirty parent. Other
+    // outdated matrices remain outdated.
+    // Returns false if _job is invalid or doesn't match the tracked skeleton.
+    [[nodiscard]] bool Update(const LocalToModelJob& _job, int _joint);
+
+    // Returns the number of LocalToModelJob run by the last update.
+    [[nodiscard]] int num_jobs() const { return num_jobs_; }
+
+    // Returns the number of joints of the tracked skeleton.
+    [[nodiscard]] int num_joints() const { return static_cast<int>(parents_.size()); }
+
+private:
+    // Runs _job from _joint, for its whole hierarchy, and clears its dirty
+    // flags.
+    bool UpdateHierarchy(LocalToModelJob* _job, int _joint);
+
+    // Parent of each joint, copied from the skeleton.
+    vox::vector<int16_t> parents_;
+
+    // End (excluded) of the hierarchy of each joint.
+    vox::vector<int16_t> hierarchy_ends_;
+
+    // Dirty flags of each joint.
+    vox::vector<bool> dirty_;
+
+    bool has_dirty_;
+
+    int num_jobs_;
+};
+}  // namespace vox::animation
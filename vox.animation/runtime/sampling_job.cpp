@@ -48,23 +48,27 @@ bool SamplingJob::Validate() const {
     // Tests context size.
     valid &= context->max_soa_tracks() >= num_soa_tracks;
 
+    // Tests sampled tracks size.
+    valid &= sampled_soa_tracks.empty() || sampled_soa_tracks.size() >= static_cast<size_t>((num_soa_tracks + 7) / 8);
+
     return valid;
 }
 
 namespace {
 // Loops through the sorted key frames and update context structure.
-template <typename Key>
+template <typename Keys>
 void UpdateCacheCursor(float _ratio,
                        int _num_soa_tracks,
-                       const vox::span<const Key>& _keys,
+                       const Keys& _keys,
                        int* _cursor,
                        int* _cache,
                        unsigned char* _outdated) {
     assert(_num_soa_tracks >= 1);
     const int num_tracks = _num_soa_tracks * 4;
-    assert(_keys.begin() + num_tracks * 2 <= _keys.end());
+    const int num_keys = _keys.size();
+    assert(num_tracks * 2 <= num_keys);
 
-    const Key* cursor;
+    int cursor;
     if (!*_cursor) {
         // Initializes interpolated entries with the first 2 sets of key frames.
         // The sorting algorithm ensures that the first 2 key frames of a track
@@ -82,7 +86,7 @@ void UpdateCacheCursor(float _ratio,
             _cache[out_index + 6] = in_index0 + 3;
             _cache[out_index + 7] = in_index1 + 3;
         }
-        cursor = _keys.begin() + num_tracks * 2;  // New cursor position.
+        cursor = num_tracks * 2;  // New cursor position.
 
         // All entries are outdated. It cares to only flag valid soa entries as
         // this is the exit condition of other algorithms.
@@ -92,8 +96,8 @@ void UpdateCacheCursor(float _ratio,
         }
         _outdated[num_outdated_flags - 1] = 0xff >> (num_outdated_flags * 8 - _num_soa_tracks);
     } else {
-        cursor = _keys.begin() + *_cursor;  // Might be == end()
-        assert(cursor >= _keys.begin() + num_tracks * 2 && cursor <= _keys.end());
+        cursor = *_cursor;  // Might be == num_keys
+        assert(cursor >= num_tracks * 2 && cursor <= num_keys);
     }
 
     // Search for the keys that matches _ratio.
@@ -102,33 +106,40 @@ void UpdateCacheCursor(float _ratio,
     // keyframe sorting, the loop can end as soon as it finds a key greater that
     // _ratio. It will mean that all the keys lower than _ratio have been
     // processed, meaning all context entries are up-to-date.
-    while (cursor < _keys.end() && _keys[_cache[cursor->track * 2 + 1]].ratio <= _ratio) {
+    while (cursor < num_keys && _keys.ratio(_cache[_keys.track(cursor) * 2 + 1]) <= _ratio) {
+        const int track = _keys.track(cursor);
         // Flag this soa entry as outdated.
-        _outdated[cursor->track / 32] |= (1 << ((cursor->track & 0x1f) / 4));
+        _outdated[track / 32] |= (1 << ((track & 0x1f) / 4));
         // Updates context.
-        const int base = cursor->track * 2;
+        const int base = track * 2;
         _cache[base] = _cache[base + 1];
-        _cache[base + 1] = static_cast<int>(cursor - _keys.begin());
+        _cache[base + 1] = cursor;
         // Process next key.
         ++cursor;
     }
-    assert(cursor <= _keys.end());
+    assert(cursor <= num_keys);
 
     // Updates cursor output.
-    *_cursor = static_cast<int>(cursor - _keys.begin());
+    *_cursor = cursor;
 }
 
-template <typename Key, typename InterpKey, typename Decompress>
+template <typename Keys, typename InterpKey, typename Decompress>
 void UpdateInterpKeyframes(int _num_soa_tracks,
-                           const vox::span<const Key>& _keys,
+                           const Keys& _keys,
                            const int* _interp,
                            uint8_t* _outdated,
                            InterpKey* _interp_keys,
+                           const uint8_t* _sampled,
                            const Decompress& _decompress) {
     const int num_outdated_flags = (_num_soa_tracks + 7) / 8;
     for (int j = 0; j < num_outdated_flags; ++j) {
         uint8_t outdated = _outdated[j];
-        _outdated[j] = 0;  // Reset outdated entries as all will be processed.
+        if (_sampled) {
+            outdated &= _sampled[j];
+        }
+        // Reset outdated entries that will be processed. Tracks that aren't
+        // sampled stay outdated until they are.
+        _outdated[j] ^= outdated;
         for (int i = j * 8; outdated; ++i, outdated >>= 1) {
             if (!(outdated & 1)) {
                 continue;
@@ -136,67 +147,109 @@ void UpdateInterpKeyframes(int _num_soa_tracks,
             const int base = i * 4 * 2;  // * soa size * 2 keys
 
             // Decompress left side keyframes and store them in soa structures.
-            const Key& k00 = _keys[_interp[base + 0]];
-            const Key& k10 = _keys[_interp[base + 2]];
-            const Key& k20 = _keys[_interp[base + 4]];
-            const Key& k30 = _keys[_interp[base + 6]];
-            _interp_keys[i].ratio[0] = simd_math::simd_float4::Load(k00.ratio, k10.ratio, k20.ratio, k30.ratio);
-            _decompress(k00, k10, k20, k30, &_interp_keys[i].value[0]);
+            const int k00 = _interp[base + 0];
+            const int k10 = _interp[base + 2];
+            const int k20 = _interp[base + 4];
+            const int k30 = _interp[base + 6];
+            _interp_keys[i].ratio[0] = simd_math::simd_float4::Load(_keys.ratio(k00), _keys.ratio(k10),
+                                                                    _keys.ratio(k20), _keys.ratio(k30));
+            _decompress(_keys, i, k00, k10, k20, k30, &_interp_keys[i].value[0]);
 
             // Decompress right side keyframes and store them in soa structures.
-            const Key& k01 = _keys[_interp[base + 1]];
-            const Key& k11 = _keys[_interp[base + 3]];
-            const Key& k21 = _keys[_interp[base + 5]];
-            const Key& k31 = _keys[_interp[base + 7]];
-            _interp_keys[i].ratio[1] = simd_math::simd_float4::Load(k01.ratio, k11.ratio, k21.ratio, k31.ratio);
-            _decompress(k01, k11, k21, k31, &_interp_keys[i].value[1]);
+            const int k01 = _interp[base + 1];
+            const int k11 = _interp[base + 3];
+            const int k21 = _interp[base + 5];
+            const int k31 = _interp[base + 7];
+            _interp_keys[i].ratio[1] = simd_math::simd_float4::Load(_keys.ratio(k01), _keys.ratio(k11),
+                                                                    _keys.ratio(k21), _keys.ratio(k31));
+            _decompress(_keys, i, k01, k11, k21, k31, &_interp_keys[i].value[1]);
         }
     }
 }
 
-inline void DecompressFloat3(const Float3Key& _k0,
-                             const Float3Key& _k1,
-                             const Float3Key& _k2,
-                             const Float3Key& _k3,
+inline void DecompressFloat3(const KeyArray<Float3Key>& _keys,
+                             int,
+                             int _i0,
+                             int _i1,
+                             int _i2,
+                             int _i3,
                              simd_math::SoaFloat3* _soa_float3) {
+    const Float3Key& k0 = _keys.keys[_i0];
+    const Float3Key& k1 = _keys.keys[_i1];
+    const Float3Key& k2 = _keys.keys[_i2];
+    const Float3Key& k3 = _keys.keys[_i3];
     _soa_float3->x =
-            simd_math::HalfToFloat(simd_math::simd_int4::Load(_k0.value[0], _k1.value[0], _k2.value[0], _k3.value[0]));
+            simd_math::HalfToFloat(simd_math::simd_int4::Load(k0.value[0], k1.value[0], k2.value[0], k3.value[0]));
     _soa_float3->y =
-            simd_math::HalfToFloat(simd_math::simd_int4::Load(_k0.value[1], _k1.value[1], _k2.value[1], _k3.value[1]));
+            simd_math::HalfToFloat(simd_math::simd_int4::Load(k0.value[1], k1.value[1], k2.value[1], k3.value[1]));
     _soa_float3->z =
-            simd_math::HalfToFloat(simd_math::simd_int4::Load(_k0.value[2], _k1.value[2], _k2.value[2], _k3.value[2]));
+            simd_math::HalfToFloat(simd_math::simd_int4::Load(k0.value[2], k1.value[2], k2.value[2], k3.value[2]));
+}
+
+// Restores 4 quantized keys of the soa track _soa from its range.
+inline void DecompressQuantizedFloat3(const QuantizedKeyArray& _keys,
+                                      int _soa,
+                                      int _i0,
+                                      int _i1,
+                                      int _i2,
+                                      int _i3,
+                                      simd_math::SoaFloat3* _soa_float3) {
+    const QuantizedFloat3Keys& keys = _keys.keys;
+    const Float3KeyRange& range = keys.ranges[_soa];
+    const byte* values = keys.values.data();
+    simd_math::SimdFloat4 cpnt[3];
+    for (int c = 0; c < 3; ++c) {
+        const simd_math::SimdInt4 quantized = simd_math::simd_int4::Load(
+                static_cast<int>(ReadQuantized(values, _i0, c, keys.bits)),
+                static_cast<int>(ReadQuantized(values, _i1, c, keys.bits)),
+                static_cast<int>(ReadQuantized(values, _i2, c, keys.bits)),
+                static_cast<int>(ReadQuantized(values, _i3, c, keys.bits)));
+        cpnt[c] = simd_math::MAdd(simd_math::simd_float4::FromInt(quantized),
+                                  simd_math::simd_float4::LoadPtrU(range.scale[c]),
+                                  simd_math::simd_float4::LoadPtrU(range.min[c]));
+    }
+    _soa_float3->x = cpnt[0];
+    _soa_float3->y = cpnt[1];
+    _soa_float3->z = cpnt[2];
 }
 
 // Defines a mapping table that defines components assignation in the output
 // quaternion.
 constexpr int kCpntMapping[4][4] = {{0, 0, 1, 2}, {0, 0, 1, 2}, {0, 1, 0, 2}, {0, 1, 2, 0}};
 
-void DecompressQuaternion(const QuaternionKey& _k0,
-                          const QuaternionKey& _k1,
-                          const QuaternionKey& _k2,
-                          const QuaternionKey& _k3,
+void DecompressQuaternion(const KeyArray<QuaternionKey>& _keys,
+                          int,
+                          int _i0,
+                          int _i1,
+                          int _i2,
+                          int _i3,
                           simd_math::SoaQuaternion* _quaternion) {
+    const QuaternionKey& k0 = _keys.keys[_i0];
+    const QuaternionKey& k1 = _keys.keys[_i1];
+    const QuaternionKey& k2 = _keys.keys[_i2];
+    const QuaternionKey& k3 = _keys.keys[_i3];
+
     // Selects proper mapping for each key.
-    const int* m0 = kCpntMapping[_k0.largest];
-    const int* m1 = kCpntMapping[_k1.largest];
-    const int* m2 = kCpntMapping[_k2.largest];
-    const int* m3 = kCpntMapping[_k3.largest];
+    const int* m0 = kCpntMapping[k0.largest];
+    const int* m1 = kCpntMapping[k1.largest];
+    const int* m2 = kCpntMapping[k2.largest];
+    const int* m3 = kCpntMapping[k3.largest];
 
     // Prepares an array of input values, according to the mapping required to
     // restore quaternion the largest component.
     alignas(16) int cmp_keys[4][4] = {
-            {_k0.value[m0[0]], _k1.value[m1[0]], _k2.value[m2[0]], _k3.value[m3[0]]},
-            {_k0.value[m0[1]], _k1.value[m1[1]], _k2.value[m2[1]], _k3.value[m3[1]]},
-            {_k0.value[m0[2]], _k1.value[m1[2]], _k2.value[m2[2]], _k3.value[m3[2]]},
-            {_k0.value[m0[3]], _k1.value[m1[3]], _k2.value[m2[3]], _k3.value[m3[3]]},
+            {k0.value[m0[0]], k1.value[m1[0]], k2.value[m2[0]], k3.value[m3[0]]},
+            {k0.value[m0[1]], k1.value[m1[1]], k2.value[m2[1]], k3.value[m3[1]]},
+            {k0.value[m0[2]], k1.value[m1[2]], k2.value[m2[2]], k3.value[m3[2]]},
+            {k0.value[m0[3]], k1.value[m1[3]], k2.value[m2[3]], k3.value[m3[3]]},
     };
 
     // Resets the largest component to 0. Overwritting here avoids 16 branchings
     // above.
-    cmp_keys[_k0.largest][0] = 0;
-    cmp_keys[_k1.largest][1] = 0;
-    cmp_keys[_k2.largest][2] = 0;
-    cmp_keys[_k3.largest][3] = 0;
+    cmp_keys[k0.largest][0] = 0;
+    cmp_keys[k1.largest][1] = 0;
+    cmp_keys[k2.largest][2] = 0;
+    cmp_keys[k3.largest][3] = 0;
 
     // Rebuilds quaternion from quantized values.
     const simd_math::SimdFloat4 kInt2Float = simd_math::simd_float4::Load1(1.f / (32767.f * vox::kSqrt2));
@@ -216,14 +269,14 @@ void DecompressQuaternion(const QuaternionKey& _k0,
     const simd_math::SimdFloat4 w0 = ww0 * simd_math::RSqrtEst(ww0);
     // Re-applies 4th component' s sign.
     const simd_math::SimdInt4 sign =
-            simd_math::ShiftL(simd_math::simd_int4::Load(_k0.sign, _k1.sign, _k2.sign, _k3.sign), 31);
+            simd_math::ShiftL(simd_math::simd_int4::Load(k0.sign, k1.sign, k2.sign, k3.sign), 31);
     const simd_math::SimdFloat4 restored = simd_math::Or(w0, sign);
 
     // Re-injects the largest component inside the SoA structure.
-    cpnt[_k0.largest] = simd_math::Or(cpnt[_k0.largest], simd_math::And(restored, simd_math::simd_int4::mask_f000()));
-    cpnt[_k1.largest] = simd_math::Or(cpnt[_k1.largest], simd_math::And(restored, simd_math::simd_int4::mask_0f00()));
-    cpnt[_k2.largest] = simd_math::Or(cpnt[_k2.largest], simd_math::And(restored, simd_math::simd_int4::mask_00f0()));
-    cpnt[_k3.largest] = simd_math::Or(cpnt[_k3.largest], simd_math::And(restored, simd_math::simd_int4::mask_000f()));
+    cpnt[k0.largest] = simd_math::Or(cpnt[k0.largest], simd_math::And(restored, simd_math::simd_int4::mask_f000()));
+    cpnt[k1.largest] = simd_math::Or(cpnt[k1.largest], simd_math::And(restored, simd_math::simd_int4::mask_0f00()));
+    cpnt[k2.largest] = simd_math::Or(cpnt[k2.largest], simd_math::And(restored, simd_math::simd_int4::mask_00f0()));
+    cpnt[k3.largest] = simd_math::Or(cpnt[k3.largest], simd_math::And(restored, simd_math::simd_int4::mask_000f()));
 
     // Stores result.
     _quaternion->x = cpnt[0];
@@ -232,14 +285,42 @@ void DecompressQuaternion(const QuaternionKey& _k0,
     _quaternion->w = cpnt[3];
 }
 
+// Updates the cache and the outdated soa values of translations or scales,
+// stored either as half floats or quantized.
+void UpdateFloat3Keyframes(float _ratio,
+                           int _num_soa_tracks,
+                           span<const Float3Key> _keys,
+                           const QuantizedFloat3Keys& _quantized_keys,
+                           int* _cursor,
+                           int* _cache,
+                           uint8_t* _outdated,
+                           internal::InterpSoaFloat3* _interp_keys,
+                           const uint8_t* _sampled) {
+    if (_quantized_keys.bits > 0) {
+        const QuantizedKeyArray keys{_quantized_keys};
+        UpdateCacheCursor(_ratio, _num_soa_tracks, keys, _cursor, _cache, _outdated);
+        UpdateInterpKeyframes(_num_soa_tracks, keys, _cache, _outdated, _interp_keys, _sampled,
+                              &DecompressQuantizedFloat3);
+    } else {
+        const KeyArray<Float3Key> keys{_keys};
+        UpdateCacheCursor(_ratio, _num_soa_tracks, keys, _cursor, _cache, _outdated);
+        UpdateInterpKeyframes(_num_soa_tracks, keys, _cache, _outdated, _interp_keys, _sampled, &DecompressFloat3);
+    }
+}
+
 void Interpolates(float _anim_ratio,
                   int _num_soa_tracks,
                   const internal::InterpSoaFloat3* _translations,
                   const internal::InterpSoaQuaternion* _rotations,
                   const internal::InterpSoaFloat3* _scales,
+                  const uint8_t* _sampled,
                   simd_math::SoaTransform* _output) {
     const simd_math::SimdFloat4 anim_ratio = simd_math::simd_float4::Load1(_anim_ratio);
     for (int i = 0; i < _num_soa_tracks; ++i) {
+        if (_sampled && !(_sampled[i / 8] & (1 << (i & 7)))) {
+            continue;
+        }
+
         // Prepares interpolation coefficients.
         const simd_math::SimdFloat4 interp_t_ratio =
                 (anim_ratio - _translations[i].ratio[0]) *
@@ -278,29 +359,30 @@ bool SamplingJob::Run() const {
     assert(context->max_soa_tracks() >= num_soa_tracks);
     context->Step(*animation, anim_ratio);
 
+    const uint8_t* sampled = sampled_soa_tracks.empty() ? nullptr : sampled_soa_tracks.data();
+
     // Fetch key frames from the animation to the context at r = anim_ratio.
     // Then updates outdated soa hot values.
-    UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->translations(), &context->translation_cursor_,
-                      context->translation_keys_, context->outdated_translations_);
-    UpdateInterpKeyframes(num_soa_tracks, animation->translations(), context->translation_keys_,
-                          context->outdated_translations_, context->soa_translations_, &DecompressFloat3);
+    UpdateFloat3Keyframes(anim_ratio, num_soa_tracks, animation->translations(), animation->quantized_translations(),
+                          &context->translation_cursor_, context->translation_keys_, context->outdated_translations_,
+                          context->soa_translations_, sampled);
 
-    UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->rotations(), &context->rotation_cursor_,
-                      context->rotation_keys_, context->outdated_rotations_);
-    UpdateInterpKeyframes(num_soa_tracks, animation->rotations(), context->rotation_keys_, context->outdated_rotations_,
-                          context->soa_rotations_, &DecompressQuaternion);
+    const KeyArray<QuaternionKey> rotations{animation->rotations()};
+    UpdateCacheCursor(anim_ratio, num_soa_tracks, rotations, &context->rotation_cursor_, context->rotation_keys_,
+                      context->outdated_rotations_);
+    UpdateInterpKeyframes(num_soa_tracks, rotations, context->rotation_keys_, context->outdated_rotations_,
+                          context->soa_rotations_, sampled, &DecompressQuaternion);
 
-    UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->scales(), &context->scale_cursor_, context->scale_keys_,
-                      context->outdated_scales_);
-    UpdateInterpKeyframes(num_soa_tracks, animation->scales(), context->scale_keys_, context->outdated_scales_,
-                          context->soa_scales_, &DecompressFloat3);
+    UpdateFloat3Keyframes(anim_ratio, num_soa_tracks, animation->scales(), animation->quantized_scales(),
+                          &context->scale_cursor_, context->scale_keys_, context->outdated_scales_,
+                          context->soa_scales_, sampled);
 
     // only interp as much as we have output for.
     const int num_soa_interp_tracks = std::min(static_cast<int>(output.size()), num_soa_tracks);
 
     // Interpolates soa hot data.
     Interpolates(anim_ratio, num_soa_interp_tracks, context->soa_translations_, context->soa_rotations_,
-                 context->soa_scales_, output.begin());
+                 context->soa_scales_, sampled, output.begin());
 
     return true;
 }
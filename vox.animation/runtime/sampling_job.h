@@ -38,6 +38,7 @@ struct VOX_ANIMATION_DLL SamplingJob {
     // Validates job parameters. Returns true for a valid job, or false otherwise:
     // -if any input pointer is nullptr
     // -if output range is invalid.
+    // -if sampled_soa_tracks isn't empty and doesn't cover all soa tracks.
     [[nodiscard]] bool Validate() const;
 
     // Runs job's sampling task.
@@ -69,6 +70,12 @@ struct VOX_ANIMATION_DLL SamplingJob {
     // If there are more joints in the animation, then the last joints are not
     // sampled.
     span<vox::simd_math::SoaTransform> output;
+
+    // Optional set of the soa tracks to sample, one bit per soa track: soa track
+    // i is sampled if bit i % 8 of byte i / 8 is set. Disabled tracks are
+    // neither decompressed nor interpolated, their output is left unchanged.
+    // All tracks are sampled if empty.
+    span<const uint8_t> sampled_soa_tracks;
 };
 
 namespace internal {
@@ -0,0 +1,232 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.animation/runtime/skinning_job.h"
+
+#include <cassert>
+#include <type_traits>
+
+#include "vox.simd_math/simd_math.h"
+
+namespace vox::animation {
+
+SkinningJob::SkinningJob()
+    : vertex_count(0),
+      influences_count(0),
+      joint_indices_stride(0),
+      joint_weights_stride(0),
+      in_positions_stride(0),
+      in_normals_stride(0),
+      in_tangents_stride(0),
+      out_positions_stride(0),
+      out_normals_stride(0),
+      out_tangents_stride(0) {}
+
+namespace {
+// Tests that a stream of _size_bytes can hold _count elements of
+// _element_size bytes, each separated by _stride bytes.
+bool ValidateStream(size_t _size_bytes, size_t _stride, size_t _element_size, size_t _alignment, int _count) {
+    bool valid = true;
+    valid &= _stride >= _element_size;
+    valid &= _stride % _alignment == 0;
+    if (_count > 0) {
+        valid &= _size_bytes >= (static_cast<size_t>(_count) - 1) * _stride + _element_size;
+    }
+    return valid;
+}
+
+bool ValidateFloat3Stream(const span<const float>& _in,
+                          size_t _in_stride,
+                          const span<float>& _out,
+                          size_t _out_stride,
+                          int _count) {
+    const size_t kFloat3Size = sizeof(float) * 3;
+    bool valid = true;
+    valid &= ValidateStream(_in.size_bytes(), _in_stride, kFloat3Size, alignof(float), _count);
+    valid &= ValidateStream(_out.size_bytes(), _out_stride, kFloat3Size, alignof(float), _count);
+    return valid;
+}
+
+template <typename _Ty>
+VOX_INLINE _Ty* Advance(_Ty* _ptr, size_t _stride) {
+    using Byte = std::conditional_t<std::is_const_v<_Ty>, const char, char>;
+    return reinterpret_cast<_Ty*>(reinterpret_cast<Byte*>(_ptr) + _stride);
+}
+
+// Blends the matrices of a vertex according to its weights. The last weight is
+// 1 minus the sum of the others. _Influences is the compile time number of
+// influences, or 0 to use the runtime _influences count.
+template <int _Influences>
+VOX_INLINE void BlendMatrices(const simd_math::Float4x4* _matrices,
+                              const uint16_t* _indices,
+                              const float* _weights,
+                              int _influences,
+                              simd_math::Float4x4* _out) {
+    using simd_math::Float4x4;
+    using simd_math::SimdFloat4;
+    const int influences = _Influences > 0 ? _Influences : _influences;
+    assert(influences > 1);
+
+    const SimdFloat4 w0 = simd_math::simd_float4::Load1(_weights[0]);
+    const Float4x4& m0 = _matrices[_indices[0]];
+    SimdFloat4 sum = w0;
+    SimdFloat4 cols0 = m0.cols[0] * w0;
+    SimdFloat4 cols1 = m0.cols[1] * w0;
+    SimdFloat4 cols2 = m0.cols[2] * w0;
+    SimdFloat4 cols3 = m0.cols[3] * w0;
+
+    for (int i = 1; i < influences - 1; ++i) {
+        const SimdFloat4 w = simd_math::simd_float4::Load1(_weights[i]);
+        const Float4x4& m = _matrices[_indices[i]];
+        sum = sum + w;
+        cols0 = simd_math::MAdd(m.cols[0], w, cols0);
+        cols1 = simd_math::MAdd(m.cols[1], w, cols1);
+        cols2 = simd_math::MAdd(m.cols[2], w, cols2);
+        cols3 = simd_math::MAdd(m.cols[3], w, cols3);
+    }
+
+    const SimdFloat4 wl = simd_math::simd_float4::one() - sum;
+    const Float4x4& ml = _matrices[_indices[influences - 1]];
+    _out->cols[0] = simd_math::MAdd(ml.cols[0], wl, cols0);
+    _out->cols[1] = simd_math::MAdd(ml.cols[1], wl, cols1);
+    _out->cols[2] = simd_math::MAdd(ml.cols[2], wl, cols2);
+    _out->cols[3] = simd_math::MAdd(ml.cols[3], wl, cols3);
+}
+
+// Skins all the vertices of _job. Vertex matrices are blended once and shared
+// by all the streams.
+template <int _Influences>
+void SkinVertices(const SkinningJob& _job) {
+    using simd_math::Float4x4;
+    const int influences = _Influences > 0 ? _Influences : _job.influences_count;
+
+    const Float4x4* matrices = _job.joint_matrices.data();
+    const Float4x4* it_matrices =
+            _job.joint_inverse_transpose_matrices.empty() ? nullptr : _job.joint_inverse_transpose_matrices.data();
+    const bool has_normals = !_job.in_normals.empty();
+    const bool has_tangents = !_job.in_tangents.empty();
+
+    const uint16_t* indices = _job.joint_indices.data();
+    const float* weights = _job.joint_weights.data();
+    const float* in_positions = _job.in_positions.data();
+    const float* in_normals = _job.in_normals.data();
+    const float* in_tangents = _job.in_tangents.data();
+    float* out_positions = _job.out_positions.data();
+    float* out_normals = _job.out_normals.data();
+    float* out_tangents = _job.out_tangents.data();
+
+    for (int i = 0; i < _job.vertex_count; ++i) {
+        Float4x4 blended;
+        const Float4x4* transform;
+        if constexpr (_Influences == 1) {
+            transform = &matrices[indices[0]];
+        } else {
+            BlendMatrices<_Influences>(matrices, indices, weights, influences, &blended);
+            transform = &blended;
+        }
+
+        const simd_math::SimdFloat4 position = simd_math::simd_float4::Load3PtrU(in_positions);
+        simd_math::Store3PtrU(simd_math::TransformPoint(*transform, position), out_positions);
+        in_positions = Advance(in_positions, _job.in_positions_stride);
+        out_positions = Advance(out_positions, _job.out_positions_stride);
+
+        if (has_normals) {
+            Float4x4 blended_it;
+            const Float4x4* normal_transform = transform;
+            if (it_matrices != nullptr) {
+                if constexpr (_Influences == 1) {
+                    normal_transform = &it_matrices[indices[0]];
+                } else {
+                    BlendMatrices<_Influences>(it_matrices, indices, weights, influences, &blended_it);
+                    normal_transform = &blended_it;
+                }
+            }
+            const simd_math::SimdFloat4 normal = simd_math::simd_float4::Load3PtrU(in_normals);
+            simd_math::Store3PtrU(simd_math::TransformVector(*normal_transform, normal), out_normals);
+            in_normals = Advance(in_normals, _job.in_normals_stride);
+            out_normals = Advance(out_normals, _job.out_normals_stride);
+        }
+
+        if (has_tangents) {
+            const simd_math::SimdFloat4 tangent = simd_math::simd_float4::Load3PtrU(in_tangents);
+            simd_math::Store3PtrU(simd_math::TransformVector(*transform, tangent), out_tangents);
+            in_tangents = Advance(in_tangents, _job.in_tangents_stride);
+            out_tangents = Advance(out_tangents, _job.out_tangents_stride);
+        }
+
+        indices = Advance(indices, _job.joint_indices_stride);
+        if constexpr (_Influences != 1) {
+            weights = Advance(weights, _job.joint_weights_stride);
+        }
+    }
+}
+}  // namespace
+
+bool SkinningJob::Validate() const {
+    // Don't need any early out, as jobs are valid in most of the performance
+    // critical cases.
+    // Tests are written in multiple lines in order to avoid branches.
+    bool valid = true;
+
+    valid &= vertex_count >= 0;
+    valid &= influences_count > 0;
+
+    // Matrices.
+    valid &= !joint_matrices.empty();
+    if (!joint_inverse_transpose_matrices.empty()) {
+        valid &= joint_inverse_transpose_matrices.size() >= joint_matrices.size();
+    }
+
+    // Joint indices and weights. Weights aren't needed for a single influence.
+    const size_t num_influences = influences_count > 0 ? static_cast<size_t>(influences_count) : 0;
+    valid &= ValidateStream(joint_indices.size_bytes(), joint_indices_stride, sizeof(uint16_t) * num_influences,
+                            alignof(uint16_t), vertex_count);
+    if (num_influences > 1) {
+        valid &= ValidateStream(joint_weights.size_bytes(), joint_weights_stride, sizeof(float) * (num_influences - 1),
+                                alignof(float), vertex_count);
+    }
+
+    // Positions are mandatory.
+    valid &= ValidateFloat3Stream(in_positions, in_positions_stride, out_positions, out_positions_stride, vertex_count);
+
+    // Normals and tangents are optional.
+    if (!in_normals.empty()) {
+        valid &= ValidateFloat3Stream(in_normals, in_normals_stride, out_normals, out_normals_stride, vertex_count);
+    }
+    if (!in_tangents.empty()) {
+        valid &= ValidateFloat3Stream(in_tangents, in_tangents_stride, out_tangents, out_tangents_stride,
+                                      vertex_count);
+    }
+
+    return valid;
+}
+
+bool SkinningJob::Run() const {
+    if (!Validate()) {
+        return false;
+    }
+
+    // Dispatches to a kernel specialized for the number of influences.
+    switch (influences_count) {
+        case 1:
+            SkinVertices<1>(*this);
+            break;
+        case 2:
+            SkinVertices<2>(*this);
+            break;
+        case 3:
+            SkinVertices<3>(*this);
+            break;
+        case 4:
+            SkinVertices<4>(*this);
+            break;
+        default:
+            SkinVertices<0>(*this);
+            break;
+    }
+    return true;
+}
+}  // namespace vox::animation
@@ -0,0 +1,104 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "vox.animation/runtime/export.h"
+#include "vox.base/span.h"
+
+namespace vox {
+
+// Forward declaration math structures.
+namespace simd_math {
+struct Float4x4;
+}  // namespace simd_math
+
+namespace animation {
+
+// Skins vertices on the CPU, for example to compute bounds, build hit-boxes or
+// bake meshes where no GPU is available.
+// Every vertex attribute is an independent stream (positions, normals,
+// tangents, joint indices and weights), as stored by the sample Skin::Part.
+// Each stream is a span with a stride expressed in bytes, so that streams can
+// be tightly packed or interleaved in a single vertex buffer. Position, normal
+// and tangent elements are 3 floats. Tangents w component, if any, isn't
+// written.
+// Every vertex is influenced by influences_count joints. Joint weights are
+// normalized, so only influences_count - 1 weights are stored per vertex, the
+// last one is computed as 1 minus the sum of the others. Dedicated kernels are
+// used for 1 to 4 influences, a generic one above.
+// The job doesn't allocate nor has any state, so disjoint vertex ranges can
+// be skinned concurrently by running jobs on sub-spans of the same streams.
+struct VOX_ANIMATION_DLL SkinningJob {
+    // Default constructor, initializes default values.
+    SkinningJob();
+
+    // Validates job parameters. Returns true for a valid job, or false otherwise:
+    // -if influences_count is less than 1.
+    // -if joint_matrices is empty.
+    // -if joint_inverse_transpose_matrices isn't empty but smaller than
+    // joint_matrices.
+    // -if any input stream is too small for vertex_count vertices, or a required
+    // one is missing: positions, joint indices, and joint weights as soon as
+    // influences_count is greater than 1.
+    // -if an output stream is missing or too small for an input one.
+    // -if a stride is smaller than its element size.
+    // Joint indices aren't checked against joint_matrices size, this is the
+    // responsibility of the data pipeline.
+    [[nodiscard]] bool Validate() const;
+
+    // Runs job's skinning task.
+    // The job is validated before any operation is performed, see Validate() for
+    // more details.
+    // Returns false if job is not valid. See Validate() function.
+    [[nodiscard]] bool Run() const;
+
+    // Number of vertices to skin.
+    int vertex_count;
+
+    // Number of joints influencing each vertex.
+    int influences_count;
+
+    // Skinning matrices, ie model-space joint matrices multiplied by inverse
+    // bind poses, indexed by joint_indices.
+    span<const simd_math::Float4x4> joint_matrices;
+
+    // Optional inverse transpose of the skinning matrices, used to transform
+    // normals. If empty, normals are transformed with joint_matrices, which is
+    // only correct when skinning matrices don't contain non-uniform scale.
+    span<const simd_math::Float4x4> joint_inverse_transpose_matrices;
+
+    // Joint indices, influences_count per vertex.
+    span<const uint16_t> joint_indices;
+    size_t joint_indices_stride;
+
+    // Joint weights, influences_count - 1 per vertex. Unused for a single
+    // influence.
+    span<const float> joint_weights;
+    size_t joint_weights_stride;
+
+    // Input streams. Positions are mandatory, normals and tangents optional.
+    span<const float> in_positions;
+    size_t in_positions_stride;
+    span<const float> in_normals;
+    size_t in_normals_stride;
+    span<const float> in_tangents;
+    size_t in_tangents_stride;
+
+    // Output streams, required for each input stream provided. They can alias
+    // the input ones to skin in place.
+    span<float> out_positions;
+    size_t out_positions_stride;
+    span<float> out_normals;
+    size_t out_normals_stride;
+    span<float> out_tangents;
+    size_t out_tangents_stride;
+};
+}  // namespace animation
+}  // namespace vox
@@ -0,0 +1,157 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.animation/runtime/streaming_animation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+#include "vox.animation/runtime/animation.h"
+#include "vox.base/io/archive.h"
+#include "vox.base/logging.h"
+#include "vox.math/math_utils.h"
+
+namespace vox::animation {
+
+namespace {
+uint32_t NextId() {
+    static std::atomic<uint32_t> next_id{0};
+    return ++next_id;
+}
+}  // namespace
+
+StreamingAnimation::StreamingAnimation()
+    : duration_(0.f), num_tracks_(0), stream_(nullptr), stream_data_begin_(0), id_(NextId()) {
+    page_offsets_.push_back(0);
+}
+
+StreamingAnimation::~StreamingAnimation() = default;
+
+void StreamingAnimation::Reset() {
+    duration_ = 0.f;
+    num_tracks_ = 0;
+    name_.clear();
+    page_ratios_.clear();
+    page_offsets_.assign(1, 0);
+    resident_data_.clear();
+    stream_ = nullptr;
+    stream_data_begin_ = 0;
+    id_ = NextId();
+}
+
+int StreamingAnimation::FindPage(float _ratio) const {
+    const int num = num_pages();
+    if (num <= 0) {
+        return -1;
+    }
+    // Counts the pages ending before or at _ratio. The last page end isn't
+    // tested, so that a ratio of 1 belongs to the last page.
+    const float ratio = vox::clamp(0.f, _ratio, 1.f);
+    const auto ends_begin = page_ratios_.begin() + 1;
+    const auto ends_end = page_ratios_.end() - 1;
+    return static_cast<int>(std::upper_bound(ends_begin, ends_end, ratio) - ends_begin);
+}
+
+size_t StreamingAnimation::page_size(int _page) const {
+    assert(_page >= 0 && _page < num_pages());
+    return page_offsets_[_page + 1] - page_offsets_[_page];
+}
+
+unique_ptr<Animation> StreamingAnimation::LoadPage(int _page) const {
+    if (_page < 0 || _page >= num_pages()) {
+        return nullptr;
+    }
+
+    unique_ptr<Animation> page = make_unique<Animation>();
+    const uint32_t offset = page_offsets_[_page];
+    if (stream_ == nullptr) {
+        // Resident pages are copied to a temporary stream.
+        io::MemoryStream stream;
+        stream.Write(resident_data_.data() + offset, page_size(_page));
+        stream.Seek(0, io::Stream::kSet);
+        io::IArchive archive(&stream);
+        archive >> *page;
+    } else {
+        std::lock_guard<std::mutex> lock(stream_mutex_);
+        if (stream_->Seek(stream_data_begin_ + static_cast<int>(offset), io::Stream::kSet) != 0) {
+            LOGE("Failed to seek to page {} of animation {}", _page, name())
+            return nullptr;
+        }
+        io::IArchive archive(stream_);
+        archive >> *page;
+    }
+
+    // Detects corrupted or mismatching page data.
+    if (page->num_tracks() != num_tracks_) {
+        LOGE("Invalid page {} of animation {}", _page, name())
+        return nullptr;
+    }
+    return page;
+}
+
+void StreamingAnimation::Save(vox::io::OArchive& _archive) const {
+    const int32_t num = num_pages();
+    _archive << duration_;
+    _archive << static_cast<int32_t>(num_tracks_);
+    _archive << static_cast<int32_t>(name_.size());
+    _archive << num;
+    _archive << vox::io::MakeArray(name_.c_str(), name_.size());
+    _archive << vox::io::MakeArray(page_ratios_.data(), page_ratios_.size());
+    _archive << vox::io::MakeArray(page_offsets_.data(), page_offsets_.size());
+
+    // Page data are saved as raw bytes, as every page is a standalone archive.
+    const uint32_t data_size = page_offsets_.back();
+    if (stream_ == nullptr) {
+        _archive.SaveBinary(resident_data_.data(), data_size);
+    } else {
+        std::lock_guard<std::mutex> lock(stream_mutex_);
+        stream_->Seek(stream_data_begin_, io::Stream::kSet);
+        char buffer[4096];
+        for (uint32_t copied = 0; copied < data_size;) {
+            const size_t chunk = std::min<size_t>(sizeof(buffer), data_size - copied);
+            if (stream_->Read(buffer, chunk) != chunk) {
+                LOGE("Failed to read pages of animation {}", name())
+                return;
+            }
+            _archive.SaveBinary(buffer, chunk);
+            copied += static_cast<uint32_t>(chunk);
+        }
+    }
+}
+
+void StreamingAnimation::Load(vox::io::IArchive& _archive, uint32_t _version) {
+    // Destroy animation in case it was already used before.
+    Reset();
+
+    if (_version != 1) {
+        LOGE("Unsupported StreamingAnimation version {}", _version)
+        return;
+    }
+
+    _archive >> duration_;
+    int32_t num_tracks;
+    _archive >> num_tracks;
+    num_tracks_ = num_tracks;
+    int32_t name_len;
+    _archive >> name_len;
+    int32_t num;
+    _archive >> num;
+
+    name_.resize(name_len);
+    _archive >> vox::io::MakeArray(name_.data(), name_.size());
+    page_ratios_.resize(num + 1);
+    _archive >> vox::io::MakeArray(page_ratios_.data(), page_ratios_.size());
+    page_offsets_.resize(num + 1);
+    _archive >> vox::io::MakeArray(page_offsets_.data(), page_offsets_.size());
+
+    // Keeps a reference to the stream, and skips page data so that the archive
+    // can be used to read the next objects.
+    stream_ = _archive.stream();
+    stream_data_begin_ = stream_->Tell();
+    stream_->Seek(static_cast<int>(page_offsets_.back()), io::Stream::kCurrent);
+}
+}  // namespace vox::animation
@@ -0,0 +1,145 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <mutex>
+
+#include "vox.animation/runtime/export.h"
+#include "vox.base/containers/string.h"
+#include "vox.base/containers/vector.h"
+#include "vox.base/io/archive_traits.h"
+#include "vox.base/macros.h"
+#include "vox.base/memory/unique_ptr.h"
+#include "vox.base/span.h"
+
+namespace vox {
+namespace io {
+class IArchive;
+class OArchive;
+class Stream;
+}  // namespace io
+namespace animation {
+
+// Forward declares the StreamingAnimationBuilder, used to instantiate a
+// StreamingAnimation.
+namespace offline {
+class StreamingAnimationBuilder;
+}
+
+class Animation;
+
+// Defines a skeletal animation clip split into time pages, so that only the
+// keyframes around the sampled time need to be resident.
+// Every page is a self-contained Animation covering a time ratio interval
+// [page_begin, page_end]: it contains, for every track, the keys inside the
+// interval plus the surrounding ones, so it can be sampled by a SamplingJob at
+// any ratio of the interval.
+// Loading a StreamingAnimation from an archive only reads its header and page
+// table. Pages are then read on demand from the same stream, which must thus
+// outlive *this object and not be used concurrently by another reader. Pages
+// are usually accessed through an AnimationPageCache, using a
+// StreamingSamplingJob.
+class VOX_ANIMATION_DLL StreamingAnimation {
+public:
+    // Builds a default, empty, animation.
+    StreamingAnimation();
+
+    // Delete copies and moves, as pages can be loaded concurrently.
+    StreamingAnimation(StreamingAnimation const&) = delete;
+    StreamingAnimation& operator=(StreamingAnimation const&) = delete;
+
+    // Declares the public non-virtual destructor.
+    ~StreamingAnimation();
+
+    // Gets the animation clip duration.
+    [[nodiscard]] float duration() const { return duration_; }
+
+    // Gets the number of animated tracks.
+    [[nodiscard]] int num_tracks() const { return num_tracks_; }
+
+    // Returns the number of SoA elements matching the number of tracks of *this
+    // animation. This value is useful to allocate SoA runtime data structures.
+    [[nodiscard]] int num_soa_tracks() const { return (num_tracks_ + 3) / 4; }
+
+    // Gets animation name.
+    [[nodiscard]] const char* name() const { return name_.c_str(); }
+
+    // Gets the number of pages.
+    [[nodiscard]] int num_pages() const { return static_cast<int>(page_offsets_.size()) - 1; }
+
+    // Gets page time ratio boundaries. Page i covers the interval
+    // [page_ratios()[i], page_ratios()[i + 1]].
+    [[nodiscard]] span<const float> page_ratios() const { return make_span(page_ratios_); }
+
+    // Returns the page to sample at _ratio, which is clamped to the unit
+    // interval. Returns -1 if the animation has no page.
+    [[nodiscard]] int FindPage(float _ratio) const;
+
+    // Returns the size in bytes of page _page, as stored in the stream.
+    [[nodiscard]] size_t page_size(int _page) const;
+
+    // Returns an identifier unique to this animation content. It changes every
+    // time the animation is loaded, so it can be used to identify pages in a
+    // cache even if an animation object is reused or reallocated.
+    [[nodiscard]] uint32_t id() const { return id_; }
+
+    // Reads page _page. Returns nullptr if _page is out of range or if reading
+    // the stream failed. This function is thread safe.
+    [[nodiscard]] unique_ptr<Animation> LoadPage(int _page) const;
+
+    // Serialization functions.
+    // Should not be called directly but through io::Archive << and >> operators.
+    // Pages are copied to the output archive when saving, which can be slow if
+    // the animation was loaded from a stream.
+    void Save(vox::io::OArchive& _archive) const;
+    void Load(vox::io::IArchive& _archive, uint32_t _version);
+
+private:
+    // StreamingAnimationBuilder class is allowed to instantiate a
+    // StreamingAnimation.
+    friend class offline::StreamingAnimationBuilder;
+
+    // Resets the animation to its default state, with a new id.
+    void Reset();
+
+    // Duration of the animation clip.
+    float duration_;
+
+    // The number of joint tracks.
+    int num_tracks_;
+
+    // Animation name.
+    vox::string name_;
+
+    // Time ratio boundaries of the pages, num_pages() + 1 values.
+    vox::vector<float> page_ratios_;
+
+    // Offset of each page in the page data, num_pages() + 1 values. The last one
+    // is the total size of the page data.
+    vox::vector<uint32_t> page_offsets_;
+
+    // Page data, only when *this animation was built and not loaded.
+    vox::vector<char> resident_data_;
+
+    // Stream page data is read from, and the position of page data in this
+    // stream. nullptr when pages are resident.
+    io::Stream* stream_;
+    int stream_data_begin_;
+
+    // Serializes stream accesses.
+    mutable std::mutex stream_mutex_;
+
+    // Identifier of this animation content.
+    uint32_t id_;
+};
+}  // namespace animation
+
+namespace io {
+VOX_IO_TYPE_VERSION(1, animation::StreamingAnimation)
+VOX_IO_TYPE_TAG("vox-streaming-animation", animation::StreamingAnimation)
+}  // namespace io
+}  // namespace vox
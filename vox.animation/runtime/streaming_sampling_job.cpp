@@ -0,0 +1,91 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.animation/runtime/streaming_sampling_job.h"
+
+#include "vox.animation/runtime/animation.h"
+#include "vox.animation/runtime/animation_page_cache.h"
+#include "vox.animation/runtime/streaming_animation.h"
+#include "vox.math/math_utils.h"
+
+namespace vox::animation {
+
+StreamingSamplingJob::StreamingSamplingJob() : ratio(0.f), animation(nullptr), cache(nullptr), context(nullptr) {}
+
+bool StreamingSamplingJob::Validate() const {
+    // Don't need any early out, as jobs are valid in most of the performance
+    // critical cases.
+    // Tests are written in multiple lines in order to avoid branches.
+    bool valid = true;
+
+    // Test for nullptr pointers.
+    if (!animation || !cache || !context) {
+        return false;
+    }
+    valid &= !output.empty();
+
+    // Tests context size.
+    valid &= context->max_soa_tracks() >= animation->num_soa_tracks();
+
+    return valid;
+}
+
+bool StreamingSamplingJob::Run() const {
+    if (!Validate()) {
+        return false;
+    }
+
+    if (animation->num_soa_tracks() == 0) {  // Early out if animation contains no joint.
+        return true;
+    }
+
+    const float anim_ratio = vox::clamp(0.f, ratio, 1.f);
+    const int page_index = animation->FindPage(anim_ratio);
+    if (page_index < 0) {
+        return false;
+    }
+
+    // Switches page if needed. The sampling context is explicitly invalidated,
+    // as a new page could be allocated at the address of a released one.
+    if (!context->page_ || context->animation_id_ != animation->id() || context->page_index_ != page_index) {
+        std::shared_ptr<const Animation> page = cache->Acquire(*animation, page_index);
+        if (!page) {
+            context->Invalidate();
+            return false;
+        }
+        context->sampling_context_.Invalidate();
+        context->page_ = std::move(page);
+        context->animation_id_ = animation->id();
+        context->page_index_ = page_index;
+    }
+
+    SamplingJob job;
+    job.ratio = anim_ratio;
+    job.animation = context->page_.get();
+    job.context = &context->sampling_context_;
+    job.output = output;
+    return job.Run();
+}
+
+StreamingSamplingJob::Context::Context() : animation_id_(0), page_index_(-1) {}
+
+StreamingSamplingJob::Context::Context(int _max_tracks)
+    : sampling_context_(_max_tracks), animation_id_(0), page_index_(-1) {}
+
+StreamingSamplingJob::Context::~Context() = default;
+
+void StreamingSamplingJob::Context::Resize(int _max_tracks) {
+    Invalidate();
+    sampling_context_.Resize(_max_tracks);
+}
+
+void StreamingSamplingJob::Context::Invalidate() {
+    sampling_context_.Invalidate();
+    page_.reset();
+    animation_id_ = 0;
+    page_index_ = -1;
+}
+}  // namespace vox::animation
@@ -0,0 +1,111 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <memory>
+
+#include "vox.animation/runtime/export.h"
+#include "vox.animation/runtime/sampling_job.h"
+#include "vox.base/span.h"
+
+namespace vox {
+
+// Forward declaration of math structures.
+namespace simd_math {
+struct SoaTransform;
+}
+
+namespace animation {
+
+class Animation;
+class AnimationPageCache;
+class StreamingAnimation;
+
+// Samples a StreamingAnimation at a given time ratio in the unit interval
+// [0,1], to output the corresponding posture in local-space.
+// Only the page covering the sampled ratio is required. It's acquired from
+// a page cache that can be shared by all the animations, and is kept by the
+// context until sampling moves to another page. Within a page, sampling
+// benefits from the same frame coherency optimizations as the SamplingJob.
+struct VOX_ANIMATION_DLL StreamingSamplingJob {
+    // Default constructor, initializes default values.
+    StreamingSamplingJob();
+
+    // Validates job parameters. Returns true for a valid job, or false otherwise:
+    // -if any input pointer is nullptr
+    // -if output range is invalid.
+    // -if the context is too small for the animation.
+    [[nodiscard]] bool Validate() const;
+
+    // Runs job's sampling task.
+    // The job is validated before any operation is performed, see Validate() for
+    // more details.
+    // Returns false if *this job is not valid, or if the page required to sample
+    // the animation can't be loaded.
+    [[nodiscard]] bool Run() const;
+
+    // Time ratio in the unit interval [0,1] used to sample animation. It's
+    // clamped before job execution.
+    float ratio;
+
+    // The animation to sample.
+    const StreamingAnimation* animation;
+
+    // The cache used to acquire animation pages.
+    AnimationPageCache* cache;
+
+    // Forward declares the context object used by the StreamingSamplingJob.
+    class Context;
+
+    // A context object that must be big enough to sample *this animation.
+    Context* context;
+
+    // Job output, see SamplingJob::output.
+    span<vox::simd_math::SoaTransform> output;
+};
+
+// Declares the context object used by the StreamingSamplingJob. It holds the
+// page being sampled, alongside the SamplingJob context used to sample it.
+class VOX_ANIMATION_DLL StreamingSamplingJob::Context {
+public:
+    // Constructs an empty context, see SamplingJob::Context.
+    Context();
+
+    // Constructs a context that can be used to sample any animation with at most
+    // _max_tracks tracks.
+    explicit Context(int _max_tracks);
+
+    // Disables copy and assignation.
+    Context(Context const&) = delete;
+    Context& operator=(Context const&) = delete;
+
+    ~Context();
+
+    // Resize the number of joints that the context can support.
+    // This also implicitly invalidate the context.
+    void Resize(int _max_tracks);
+
+    // Invalidates the context, releasing the page it holds.
+    void Invalidate();
+
+    // The maximum number of tracks that the context can handle.
+    [[nodiscard]] int max_tracks() const { return sampling_context_.max_tracks(); }
+    [[nodiscard]] int max_soa_tracks() const { return sampling_context_.max_soa_tracks(); }
+
+private:
+    friend struct StreamingSamplingJob;
+
+    // Context used to sample the current page.
+    SamplingJob::Context sampling_context_;
+
+    // Current page, and what it was acquired for.
+    std::shared_ptr<const Animation> page_;
+    uint32_t animation_id_;
+    int page_index_;
+};
+}  // namespace animation
+}  // namespace vox
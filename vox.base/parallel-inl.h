@@ -7,12 +7,14 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <future>
 #include <vector>
 
 #include "vox.base/constants.h"
 #include "vox.base/macros.h"
+#include "vox.base/thread_pool.h"
 
 #define JET_TASKING_CPP11THREADS true
 
@@ -21,10 +23,6 @@
 #include <tbb/parallel_reduce.h>
 #include <tbb/parallel_sort.h>
 #include <tbb/task.h>
-#elif defined(JET_TASKING_CPP11THREADS)
-
-#include <thread>
-
 #endif
 
 namespace vox {
@@ -49,8 +47,7 @@ inline void schedule(TASK_T &&fcn) {
     auto *tbb_node = new (tbb::task::allocate_root()) LocalTBBTask(std::forward<TASK_T>(fcn));
     tbb::task::enqueue(*tbb_node);
 #elif defined(JET_TASKING_CPP11THREADS)
-    std::thread thread(fcn);
-    thread.detach();
+    ThreadPool::global()->submit(std::forward<TASK_T>(fcn));
 #else  // OpenMP or Serial --> synchronous!
     fcn();
 #endif
@@ -59,7 +56,9 @@ inline void schedule(TASK_T &&fcn) {
 template <typename TASK_T>
 using operator_return_t = typename std::invoke_result<TASK_T>::type;
 
-// NOTE - see above, same issues associated with schedule()
+// NOTE - see above, same issues associated with schedule(). Blocking on the
+//        returned future from inside a pool task does not help the pool, so
+//        prefer TaskGroup for nested work.
 template <typename TASK_T>
 inline auto async(TASK_T &&fcn) -> std::future<operator_return_t<TASK_T>> {
     using package_t = std::packaged_task<operator_return_t<TASK_T>()>;
@@ -75,6 +74,54 @@ inline auto async(TASK_T &&fcn) -> std::future<operator_return_t<TASK_T>> {
     return future;
 }
 
+//! Number of chunks per thread a parallel loop is split into. Chunks are
+//! claimed dynamically, so a few per thread are enough to absorb stragglers.
+constexpr size_t kChunksPerThread = 4;
+
+//! Returns the number of chunks used for a loop of size \p n.
+inline size_t numberOfChunks(size_t n, unsigned int numThreads) {
+    if (n == 0) {
+        return 0;
+    }
+    return numThreads <= 1 ? 1 : std::min(n, numThreads * kChunksPerThread);
+}
+
+// Calls func(chunkIndex, chunkBegin, chunkEnd) for each of the \p numChunks
+// consecutive chunks of [start, end). Up to numThreads - 1 helpers are submitted
+// to the global thread pool; the calling thread takes part in the work.
+template <typename IndexType, typename Function>
+void parallelChunks(IndexType start, IndexType end, size_t numChunks, unsigned int numThreads, const Function &func) {
+    const auto n = static_cast<size_t>(end - start);
+    if (numChunks <= 1) {
+        if (n > 0) {
+            func(kZeroSize, start, end);
+        }
+        return;
+    }
+
+    const size_t chunkSize = (n + numChunks - 1) / numChunks;
+    std::atomic<size_t> nextChunk{0};
+
+    auto worker = [&]() {
+        for (size_t chunk = nextChunk.fetch_add(1); chunk < numChunks; chunk = nextChunk.fetch_add(1)) {
+            const size_t chunkBegin = chunk * chunkSize;
+            if (chunkBegin >= n) {
+                break;
+            }
+            const size_t chunkEnd = std::min(chunkBegin + chunkSize, n);
+            func(chunk, static_cast<IndexType>(start + chunkBegin), static_cast<IndexType>(start + chunkEnd));
+        }
+    };
+
+    TaskGroup group;
+    const size_t numHelpers = std::min(static_cast<size_t>(numThreads), numChunks) - 1;
+    for (size_t i = 0; i < numHelpers; ++i) {
+        group.run(worker);
+    }
+    worker();
+    group.wait();
+}
+
 // Adopted from:
 // Radenski, A.
 // Shared Memory, Message Passing, and Hybrid Merge Sorts for Standalone and
@@ -120,25 +167,14 @@ void parallelMergeSort(
     if (numThreads == 1) {
         std::sort(a, a + size, compareFunction);
     } else if (numThreads > 1) {
-        std::vector<std::future<void>> pool;
-        pool.reserve(2);
+        TaskGroup group;
+        group.run([=]() { parallelMergeSort(a, size / 2, temp, numThreads / 2, compareFunction); });
 
-        auto launchRange = [compareFunction](RandomIterator begin, size_t k2, RandomIterator2 temp,
-                                             unsigned int numThreads) {
-            parallelMergeSort(begin, k2, temp, numThreads, compareFunction);
-        };
-
-        pool.emplace_back(internal::async([=]() { launchRange(a, size / 2, temp, numThreads / 2); }));
-
-        pool.emplace_back(internal::async(
-                [=]() { launchRange(a + size / 2, size - size / 2, temp + size / 2, numThreads - numThreads / 2); }));
+        parallelMergeSort(a + size / 2, size - size / 2, temp + size / 2, numThreads - numThreads / 2,
+                          compareFunction);
 
         // Wait for jobs to finish
-        for (auto &f : pool) {
-            if (f.valid()) {
-                f.wait();
-            }
-        }
+        group.wait();
 
         merge(a, size, temp, compareFunction);
     }
@@ -175,43 +211,15 @@ void parallelFor(IndexType start, IndexType end, const Function &func, Execution
     }
 
 #elif JET_TASKING_CPP11THREADS
-    // Estimate number of threads in the pool
-    unsigned int numThreadsHint = maxNumberOfThreads();
-    const unsigned int numThreads =
-            (policy == ExecutionPolicy::kParallel) ? (numThreadsHint == 0u ? 8u : numThreadsHint) : 1;
-
-    // Size of a slice for the range functions
-    IndexType n = end - start + 1;
-    auto slice = (IndexType)std::round(n / static_cast<double>(numThreads));
-    slice = std::max(slice, IndexType(1));
-
-    // [Helper] Inner loop
-    auto launchRange = [&func](IndexType k1, IndexType k2) {
+    // Run on the global thread pool
+    const unsigned int numThreads = (policy == ExecutionPolicy::kParallel) ? maxNumberOfThreads() : 1;
+    const size_t numChunks = internal::numberOfChunks(static_cast<size_t>(end - start), numThreads);
+
+    internal::parallelChunks(start, end, numChunks, numThreads, [&func](size_t, IndexType k1, IndexType k2) {
         for (IndexType k = k1; k < k2; k++) {
             func(k);
         }
-    };
-
-    // Create pool and launch jobs
-    std::vector<std::thread> pool;
-    pool.reserve(numThreads);
-    IndexType i1 = start;
-    IndexType i2 = std::min(start + slice, end);
-    for (unsigned int i = 0; i + 1 < numThreads && i1 < end; ++i) {
-        pool.emplace_back(launchRange, i1, i2);
-        i1 = i2;
-        i2 = std::min(i2 + slice, end);
-    }
-    if (i1 < end) {
-        pool.emplace_back(launchRange, i1, end);
-    }
-
-    // Wait for jobs to finish
-    for (std::thread &t : pool) {
-        if (t.joinable()) {
-            t.join();
-        }
-    }
+    });
 #else
 
 #ifdef JET_TASKING_OPENMP
@@ -253,36 +261,12 @@ void parallelRangeFor(IndexType start, IndexType end, const Function &func, Exec
     }
 
 #else
-    // Estimate number of threads in the pool
-    unsigned int numThreadsHint = maxNumberOfThreads();
-    const unsigned int numThreads =
-            (policy == ExecutionPolicy::kParallel) ? (numThreadsHint == 0u ? 8u : numThreadsHint) : 1;
-
-    // Size of a slice for the range functions
-    IndexType n = end - start + 1;
-    auto slice = (IndexType)std::round(n / static_cast<double>(numThreads));
-    slice = std::max(slice, IndexType(1));
-
-    // Create pool and launch jobs
-    std::vector<std::future<void>> pool;
-    pool.reserve(numThreads);
-    IndexType i1 = start;
-    IndexType i2 = std::min(start + slice, end);
-    for (unsigned int i = 0; i + 1 < numThreads && i1 < end; ++i) {
-        pool.emplace_back(internal::async([=]() { func(i1, i2); }));
-        i1 = i2;
-        i2 = std::min(i2 + slice, end);
-    }
-    if (i1 < end) {
-        pool.emplace_back(internal::async([=]() { func(i1, end); }));
-    }
+    // Run on the global thread pool
+    const unsigned int numThreads = (policy == ExecutionPolicy::kParallel) ? maxNumberOfThreads() : 1;
+    const size_t numChunks = internal::numberOfChunks(static_cast<size_t>(end - start), numThreads);
 
-    // Wait for jobs to finish
-    for (auto &f : pool) {
-        if (f.valid()) {
-            f.wait();
-        }
-    }
+    internal::parallelChunks(start, end, numChunks, numThreads,
+                             [&func](size_t, IndexType k1, IndexType k2) { func(k1, k2); });
 #endif
 }
 
@@ -378,43 +362,16 @@ Value parallelReduce(IndexType start,
     }
 
 #else
-    // Estimate number of threads in the pool
-    unsigned int numThreadsHint = maxNumberOfThreads();
-    const unsigned int numThreads =
-            (policy == ExecutionPolicy::kParallel) ? (numThreadsHint == 0u ? 8u : numThreadsHint) : 1;
-
-    // Size of a slice for the range functions
-    IndexType n = end - start + 1;
-    auto slice = (IndexType)std::round(n / static_cast<double>(numThreads));
-    slice = std::max(slice, IndexType(1));
-
-    // Results
-    std::vector<Value> results(numThreads, identity);
-
-    // [Helper] Inner loop
-    auto launchRange = [&](IndexType k1, IndexType k2, unsigned int tid) { results[tid] = func(k1, k2, identity); };
-
-    // Create pool and launch jobs
-    std::vector<std::future<void>> pool;
-    pool.reserve(numThreads);
-    IndexType i1 = start;
-    IndexType i2 = std::min(start + slice, end);
-    unsigned int tid = 0;
-    for (; tid + 1 < numThreads && i1 < end; ++tid) {
-        pool.emplace_back(internal::async([=]() { launchRange(i1, i2, tid); }));
-        i1 = i2;
-        i2 = std::min(i2 + slice, end);
-    }
-    if (i1 < end) {
-        pool.emplace_back(internal::async([=]() { launchRange(i1, end, tid); }));
-    }
+    // Run on the global thread pool
+    const unsigned int numThreads = (policy == ExecutionPolicy::kParallel) ? maxNumberOfThreads() : 1;
+    const size_t numChunks = internal::numberOfChunks(static_cast<size_t>(end - start), numThreads);
 
-    // Wait for jobs to finish
-    for (auto &f : pool) {
-        if (f.valid()) {
-            f.wait();
-        }
-    }
+    // Results, one per chunk so that the reduction order is deterministic
+    std::vector<Value> results(numChunks, identity);
+
+    internal::parallelChunks(start, end, numChunks, numThreads, [&](size_t chunk, IndexType k1, IndexType k2) {
+        results[chunk] = func(k1, k2, identity);
+    });
 
     // Gather
     Value finalResult = identity;
@@ -445,10 +402,7 @@ void parallelSort(RandomIterator begin, RandomIterator end, CompareFunction comp
     typedef typename std::iterator_traits<RandomIterator>::value_type value_type;
     std::vector<value_type> temp(size);
 
-    // Estimate number of threads in the pool
-    unsigned int numThreadsHint = maxNumberOfThreads();
-    const unsigned int numThreads =
-            (policy == ExecutionPolicy::kParallel) ? (numThreadsHint == 0u ? 8u : numThreadsHint) : 1;
+    const unsigned int numThreads = (policy == ExecutionPolicy::kParallel) ? maxNumberOfThreads() : 1;
 
     internal::parallelMergeSort(begin, size, temp.begin(), numThreads, compareFunction);
 #endif
@@ -459,4 +413,69 @@ void parallelSort(RandomIterator begin, RandomIterator end, ExecutionPolicy poli
     parallelSort(begin, end, std::less<typename std::iterator_traits<RandomIterator>::value_type>(), policy);
 }
 
+template <typename Value>
+void parallelRadixSort(std::vector<uint64_t> &keys, std::vector<Value> &values, ExecutionPolicy policy) {
+    VOX_ASSERT(keys.size() == values.size());
+
+    const size_t n = keys.size();
+    if (n < 2) {
+        return;
+    }
+
+    constexpr unsigned int kDigitBits = 8;
+    constexpr size_t kRadix = size_t{1} << kDigitBits;
+
+    // Bits that differ between the keys; the other digits need no pass.
+    uint64_t differentBits = 0;
+    for (size_t i = 1; i < n; ++i) {
+        differentBits |= keys[i] ^ keys[0];
+    }
+
+    const unsigned int numThreads = (policy == ExecutionPolicy::kParallel) ? maxNumberOfThreads() : 1;
+    const size_t numChunks = internal::numberOfChunks(n, numThreads);
+
+    std::vector<uint64_t> sortedKeys(n);
+    std::vector<Value> sortedValues(n);
+    std::vector<size_t> offsets(numChunks * kRadix);
+
+    for (unsigned int shift = 0; shift < 64; shift += kDigitBits) {
+        if (((differentBits >> shift) & (kRadix - 1)) == 0) {
+            continue;
+        }
+
+        // Count the digits of each chunk.
+        std::fill(offsets.begin(), offsets.end(), kZeroSize);
+        internal::parallelChunks(kZeroSize, n, numChunks, numThreads, [&](size_t chunk, size_t begin, size_t end) {
+            size_t *counts = &offsets[chunk * kRadix];
+            for (size_t i = begin; i < end; ++i) {
+                ++counts[(keys[i] >> shift) & (kRadix - 1)];
+            }
+        });
+
+        // Digit-major, chunk-minor prefix sum, which keeps the sort stable.
+        size_t sum = 0;
+        for (size_t digit = 0; digit < kRadix; ++digit) {
+            for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+                const size_t count = offsets[chunk * kRadix + digit];
+                offsets[chunk * kRadix + digit] = sum;
+                sum += count;
+            }
+        }
+
+        // The chunks are the same as in the counting pass, so each one owns its
+        // destination ranges.
+        internal::parallelChunks(kZeroSize, n, numChunks, numThreads, [&](size_t chunk, size_t begin, size_t end) {
+            size_t *destinations = &offsets[chunk * kRadix];
+            for (size_t i = begin; i < end; ++i) {
+                const size_t j = destinations[(keys[i] >> shift) & (kRadix - 1)]++;
+                sortedKeys[j] = keys[i];
+                sortedValues[j] = std::move(values[i]);
+            }
+        });
+
+        keys.swap(sortedKeys);
+        values.swap(sortedValues);
+    }
+}
+
 }  // namespace vox
@@ -8,6 +8,8 @@
 
 #include <thread>
 
+#include "vox.base/thread_pool.h"
+
 #if defined(JET_TASKING_TBB)
 #include <tbb/task_arena.h>
 #include <tbb/task_scheduler_init.h>
@@ -32,6 +34,10 @@ void setMaxNumberOfThreads(unsigned int numThreads) {
     omp_set_num_threads(numThreads);
 #endif
     sMaxNumberOfThreads = std::max(numThreads, 1u);
+#if !defined(JET_TASKING_TBB) && !defined(JET_TASKING_OPENMP)
+    // The calling thread always takes part in the work.
+    ThreadPool::resetGlobal(sMaxNumberOfThreads - 1);
+#endif
 }
 
 unsigned int maxNumberOfThreads() { return sMaxNumberOfThreads; }
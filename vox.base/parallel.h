@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 namespace vox {
 
 //! Execution policy tag.
@@ -250,6 +253,26 @@ void parallelSort(RandomIterator begin,
                   CompareFunction compare,
                   ExecutionPolicy policy = ExecutionPolicy::kParallel);
 
+//!
+//! \brief      Sorts values by their 64-bit keys in parallel.
+//!
+//! This function sorts \p keys in ascending order and moves \p values along
+//! with them. It is a stable least-significant-digit radix sort with 8-bit
+//! digits; every pass counts the digits of each chunk in parallel and then
+//! scatters the chunks in parallel, and the digits that are equal for all the
+//! keys are skipped. Both vectors must have the same size.
+//!
+//! \param[in,out]  keys    The keys to sort.
+//! \param[in,out]  values  The values moved along with the keys.
+//! \param[in]      policy  The execution policy (parallel or serial).
+//!
+//! \tparam     Value      Value type, which must be default constructible.
+//!
+template <typename Value>
+void parallelRadixSort(std::vector<uint64_t> &keys,
+                       std::vector<Value> &values,
+                       ExecutionPolicy policy = ExecutionPolicy::kParallel);
+
 //! Sets maximum number of threads to use.
 void setMaxNumberOfThreads(unsigned int numThreads);
 
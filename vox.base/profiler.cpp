@@ -0,0 +1,290 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.base/profiler.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include "vox.base/containers/string_archive.h"
+#include "vox.base/io/archive.h"
+#include "vox.base/logging.h"
+
+namespace vox::profiling {
+namespace {
+constexpr size_t kDefaultBufferCapacity = 1 << 14;
+
+// Ticks and nanoseconds read at the same time.
+struct ClockSample {
+    uint64_t ticks;
+    uint64_t nanoseconds;
+};
+
+ClockSample sampleClock() { return {ticks(), now()}; }
+
+// Buffers of all the threads that recorded a zone. Buffers are never released,
+// so events of exited threads can still be collected.
+struct Registry {
+    // Reference for converting ticks to nanoseconds. The tick rate is measured
+    // from it at each collection, so it gets more precise over time.
+    ClockSample origin{sampleClock()};
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<vox::string> names;
+    size_t capacity{kDefaultBufferCapacity};
+};
+
+Registry &registry() {
+    static Registry sRegistry;
+    return sRegistry;
+}
+
+// Name given to the calling thread before it recorded its first zone.
+thread_local vox::string tPendingName;
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void writeJsonString(std::ostream &stream, const vox::string &string) {
+    static const char kHex[] = "0123456789abcdef";
+    stream << '"';
+    for (const char c : string) {
+        switch (c) {
+            case '"':
+                stream << "\\\"";
+                break;
+            case '\\':
+                stream << "\\\\";
+                break;
+            case '\n':
+                stream << "\\n";
+                break;
+            case '\t':
+                stream << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    stream << "\\u00" << kHex[(c >> 4) & 0xf] << kHex[c & 0xf];
+                } else {
+                    stream << c;
+                }
+                break;
+        }
+    }
+    stream << '"';
+}
+
+// Writes nanoseconds as microseconds, the unit of Chrome trace timestamps.
+void writeMicroseconds(std::ostream &stream, uint64_t nanoseconds) {
+    const uint64_t fraction = nanoseconds % 1000;
+    stream << nanoseconds / 1000 << '.' << static_cast<char>('0' + fraction / 100)
+           << static_cast<char>('0' + fraction / 10 % 10) << static_cast<char>('0' + fraction % 10);
+}
+}  // namespace
+
+namespace internal {
+std::atomic<bool> gEnabled{false};
+
+ThreadBuffer *registerThread() {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    const auto index = static_cast<uint32_t>(reg.buffers.size());
+    reg.buffers.push_back(std::make_unique<ThreadBuffer>(index, reg.capacity));
+    reg.names.push_back(std::move(tPendingName));
+    tBuffer = reg.buffers.back().get();
+    return tBuffer;
+}
+}  // namespace internal
+
+ThreadBuffer::ThreadBuffer(uint32_t index, size_t capacity)
+    : _events(roundUpPowerOfTwo(std::max<size_t>(capacity, 1))), _mask(_events.size() - 1), _index(index) {}
+
+void ThreadBuffer::drain(vox::vector<ZoneEvent> &events) {
+    const uint64_t tail = _tail.load(std::memory_order_relaxed);
+    const uint64_t head = _head.load(std::memory_order_acquire);
+    for (uint64_t i = tail; i < head; ++i) {
+        events.push_back(_events[i & _mask]);
+    }
+    _tail.store(head, std::memory_order_release);
+}
+
+uint64_t ThreadBuffer::takeNumDropped() { return _numDropped.exchange(0, std::memory_order_relaxed); }
+
+void setEnabled(bool enabled) { internal::gEnabled.store(enabled, std::memory_order_relaxed); }
+
+void setBufferCapacity(size_t capacity) {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.capacity = capacity;
+}
+
+void setThreadName(const char *name) {
+    // Threads that never record a zone don't need a buffer.
+    if (!internal::tBuffer) {
+        tPendingName = name;
+        return;
+    }
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.names[internal::tBuffer->index()] = name;
+}
+
+void Trace::collect() {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    if (_threads.size() < reg.names.size()) {
+        _threads.resize(reg.names.size());
+    }
+    for (size_t i = 0; i < reg.names.size(); ++i) {
+        _threads[i].name = reg.names[i];
+    }
+
+#ifdef VOX_PROFILING_TSC
+    const ClockSample current = sampleClock();
+    const double nanosecondsPerTick =
+            current.ticks > reg.origin.ticks
+                    ? static_cast<double>(current.nanoseconds - reg.origin.nanoseconds) /
+                              static_cast<double>(current.ticks - reg.origin.ticks)
+                    : 1.;
+#else
+    const double nanosecondsPerTick = 1.;
+#endif
+    const auto toNanoseconds = [&reg, nanosecondsPerTick](uint64_t ticks) {
+        const auto elapsed = static_cast<int64_t>(ticks - reg.origin.ticks);
+        return reg.origin.nanoseconds + static_cast<int64_t>(static_cast<double>(elapsed) * nanosecondsPerTick);
+    };
+
+    for (const std::unique_ptr<ThreadBuffer> &buffer : reg.buffers) {
+        _events.clear();
+        buffer->drain(_events);
+        _numDropped += buffer->takeNumDropped();
+
+        for (const ZoneEvent &event : _events) {
+            auto iter = _siteIndices.find(event.site);
+            if (iter == _siteIndices.end()) {
+                iter = _siteIndices.emplace(event.site, static_cast<uint32_t>(_sites.size())).first;
+                _sites.push_back({event.site->name, event.site->file, event.site->line});
+            }
+            const uint64_t start = toNanoseconds(event.start);
+            _zones.push_back({iter->second, buffer->index(), start, toNanoseconds(event.end) - start, event.depth});
+        }
+    }
+}
+
+void Trace::clear() {
+    _sites.clear();
+    _threads.clear();
+    _zones.clear();
+    _numDropped = 0;
+    _siteIndices.clear();
+}
+
+void Trace::writeChromeTrace(std::ostream &stream) const {
+    uint64_t origin = std::numeric_limits<uint64_t>::max();
+    for (const Zone &zone : _zones) {
+        origin = std::min(origin, zone.start);
+    }
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t i = 0; i < _threads.size(); ++i) {
+        if (_threads[i].name.empty()) {
+            continue;
+        }
+        stream << (first ? "\n" : ",\n") << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << i
+               << R"(,"args":{"name":)";
+        writeJsonString(stream, _threads[i].name);
+        stream << "}}";
+        first = false;
+    }
+    for (const Zone &zone : _zones) {
+        const Site &site = _sites[zone.site];
+        stream << (first ? "\n" : ",\n") << R"({"name":)";
+        writeJsonString(stream, site.name);
+        stream << R"(,"ph":"X","pid":0,"tid":)" << zone.thread << R"(,"ts":)";
+        writeMicroseconds(stream, zone.start - origin);
+        stream << R"(,"dur":)";
+        writeMicroseconds(stream, zone.duration);
+        stream << R"(,"args":{"file":)";
+        writeJsonString(stream, site.file);
+        stream << R"(,"line":)" << site.line << "}}";
+        first = false;
+    }
+    stream << "\n]}\n";
+}
+
+void Trace::Save(io::OArchive &_archive) const {
+    _archive << static_cast<uint32_t>(_sites.size());
+    for (const Site &site : _sites) {
+        _archive << site.name;
+        _archive << site.file;
+        _archive << site.line;
+    }
+
+    _archive << static_cast<uint32_t>(_threads.size());
+    for (const Thread &thread : _threads) {
+        _archive << thread.name;
+    }
+
+    _archive << static_cast<uint32_t>(_zones.size());
+    for (const Zone &zone : _zones) {
+        _archive << zone.site;
+        _archive << zone.thread;
+        _archive << zone.start;
+        _archive << zone.duration;
+        _archive << zone.depth;
+    }
+
+    _archive << _numDropped;
+}
+
+void Trace::Load(io::IArchive &_archive, uint32_t _version) {
+    clear();
+
+    if (_version != 1) {
+        LOGE("Unsupported Trace version {}", _version)
+        return;
+    }
+
+    uint32_t num_sites;
+    _archive >> num_sites;
+    _sites.resize(num_sites);
+    for (Site &site : _sites) {
+        _archive >> site.name;
+        _archive >> site.file;
+        _archive >> site.line;
+    }
+
+    uint32_t num_threads;
+    _archive >> num_threads;
+    _threads.resize(num_threads);
+    for (Thread &thread : _threads) {
+        _archive >> thread.name;
+    }
+
+    uint32_t num_zones;
+    _archive >> num_zones;
+    _zones.resize(num_zones);
+    for (Zone &zone : _zones) {
+        _archive >> zone.site;
+        _archive >> zone.thread;
+        _archive >> zone.start;
+        _archive >> zone.duration;
+        _archive >> zone.depth;
+    }
+
+    _archive >> _numDropped;
+}
+
+}  // namespace vox::profiling
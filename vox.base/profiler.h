@@ -0,0 +1,285 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+
+#include "vox.base/containers/string.h"
+#include "vox.base/containers/vector.h"
+#include "vox.base/io/archive_traits.h"
+#include "vox.base/macros.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define VOX_PROFILING_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Profiling zones are compiled in by default and enabled at runtime with
+// vox::profiling::setEnabled. Define VOX_PROFILING to 0 to compile them out.
+#ifndef VOX_PROFILING
+#define VOX_PROFILING 1
+#endif
+
+namespace vox {
+namespace io {
+class OArchive;
+class IArchive;
+}  // namespace io
+
+namespace profiling {
+
+//! Static description of a profiled scope. There is one instance per call
+//! site, so zones only record a pointer to it, see VOX_PROFILE_ZONE.
+struct ZoneSite {
+    const char *name;
+    const char *file;
+    uint32_t line;
+};
+
+//! A finished zone, as recorded by the thread that ran it.
+struct ZoneEvent {
+    const ZoneSite *site;
+    //! Timestamps in ticks, see ticks().
+    uint64_t start;
+    uint64_t end;
+    //! Number of zones of the same thread the zone is nested in.
+    uint32_t depth;
+};
+
+//! Returns a monotonic timestamp in nanoseconds.
+inline uint64_t now() {
+    return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+}
+
+//! Returns the timestamp recorded by zones. It reads the time stamp counter on
+//! x86, which is several times cheaper than the system clock, and is converted
+//! to nanoseconds when zones are collected. It is now() on other platforms.
+inline uint64_t ticks() {
+#ifdef VOX_PROFILING_TSC
+    return __rdtsc();
+#else
+    return now();
+#endif
+}
+
+//!
+//! \brief Single producer, single consumer ring buffer of zone events.
+//!
+//! Each thread owns a buffer it writes without lock nor allocation. The
+//! collecting thread drains it concurrently. Events are dropped when the buffer
+//! is full, which happens if zones aren't collected frequently enough.
+//!
+class VOX_BASE_DLL ThreadBuffer final {
+public:
+    ThreadBuffer(uint32_t index, size_t capacity);
+
+    ThreadBuffer(const ThreadBuffer &) = delete;
+
+    ThreadBuffer &operator=(const ThreadBuffer &) = delete;
+
+    //! Appends an event, called by the owning thread only.
+    void push(const ZoneSite *site, uint64_t start, uint64_t end, uint32_t depth) {
+        const uint64_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= _events.size()) {
+            _numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ZoneEvent &event = _events[head & _mask];
+        event.site = site;
+        event.start = start;
+        event.end = end;
+        event.depth = depth;
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    //! Moves all the pending events to \p events, in recording order.
+    void drain(vox::vector<ZoneEvent> &events);
+
+    //! Returns and resets the number of dropped events.
+    uint64_t takeNumDropped();
+
+    //! Index of the buffer, in registration order.
+    [[nodiscard]] uint32_t index() const { return _index; }
+
+    //! Nesting depth of the current zone of the owning thread.
+    uint32_t depth{0};
+
+private:
+    vox::vector<ZoneEvent> _events;
+    uint64_t _mask;
+    uint32_t _index;
+    std::atomic<uint64_t> _numDropped{0};
+    // Written by the owning thread and the collecting thread respectively, so
+    // they are kept on separate cache lines.
+    alignas(64) std::atomic<uint64_t> _head{0};
+    alignas(64) std::atomic<uint64_t> _tail{0};
+};
+
+namespace internal {
+extern VOX_BASE_DLL std::atomic<bool> gEnabled;
+
+// Buffer of the calling thread, registered on first use.
+inline thread_local ThreadBuffer *tBuffer = nullptr;
+
+VOX_BASE_DLL ThreadBuffer *registerThread();
+
+inline ThreadBuffer *threadBuffer() {
+    ThreadBuffer *buffer = tBuffer;
+    return buffer ? buffer : registerThread();
+}
+}  // namespace internal
+
+//! Enables or disables zones recording. Zones opened while disabled aren't
+//! recorded, even if they are closed after the profiler is enabled.
+VOX_BASE_DLL void setEnabled(bool enabled);
+
+//! Returns true if zones are being recorded.
+inline bool isEnabled() { return internal::gEnabled.load(std::memory_order_relaxed); }
+
+//! Sets the number of events of the buffers of threads that record their
+//! first zone after this call. It is rounded up to a power of two.
+VOX_BASE_DLL void setBufferCapacity(size_t capacity);
+
+//! Names the calling thread in collected traces.
+VOX_BASE_DLL void setThreadName(const char *name);
+
+//!
+//! \brief Records the duration of the enclosing scope.
+//!
+//! Opening and closing a zone costs two ticks() reads and a ring buffer write,
+//! or a single relaxed load when the profiler is disabled.
+//!
+class ScopedZone final {
+public:
+    explicit ScopedZone(const ZoneSite *site) {
+        if (isEnabled()) {
+            _buffer = internal::threadBuffer();
+            _site = site;
+            _depth = _buffer->depth++;
+            _start = ticks();
+        }
+    }
+
+    ~ScopedZone() {
+        if (_buffer) {
+            const uint64_t end = ticks();
+            --_buffer->depth;
+            _buffer->push(_site, _start, end, _depth);
+        }
+    }
+
+    ScopedZone(const ScopedZone &) = delete;
+
+    ScopedZone &operator=(const ScopedZone &) = delete;
+
+private:
+    ThreadBuffer *_buffer{nullptr};
+    const ZoneSite *_site{nullptr};
+    uint64_t _start{0};
+    uint32_t _depth{0};
+};
+
+//!
+//! \brief Zones collected from all threads.
+//!
+//! A trace owns its names, so it can be serialized in a compact binary form
+//! with vox::io archives and converted later to Chrome trace format
+//! (chrome://tracing, Perfetto).
+//!
+class VOX_BASE_DLL Trace final {
+public:
+    struct Site {
+        vox::string name;
+        vox::string file;
+        uint32_t line;
+    };
+
+    struct Thread {
+        vox::string name;
+    };
+
+    struct Zone {
+        //! Index in sites().
+        uint32_t site;
+        //! Index in threads().
+        uint32_t thread;
+        //! Nanoseconds timestamp and duration.
+        uint64_t start;
+        uint64_t duration;
+        uint32_t depth;
+    };
+
+    //! Appends the zones recorded by all threads since the last collection.
+    void collect();
+
+    //! Removes all zones, sites and threads.
+    void clear();
+
+    [[nodiscard]] const vox::vector<Site> &sites() const { return _sites; }
+
+    [[nodiscard]] const vox::vector<Thread> &threads() const { return _threads; }
+
+    [[nodiscard]] const vox::vector<Zone> &zones() const { return _zones; }
+
+    //! Returns the number of zones that were dropped because of full buffers.
+    [[nodiscard]] uint64_t numDropped() const { return _numDropped; }
+
+    //! Writes the trace as Chrome trace event JSON. Timestamps are relative to
+    //! the first zone.
+    void writeChromeTrace(std::ostream &stream) const;
+
+    // Serialization functions.
+    // Should not be called directly but through io::Archive << and >> operators.
+    void Save(io::OArchive &_archive) const;
+
+    void Load(io::IArchive &_archive, uint32_t _version);
+
+private:
+    vox::vector<Site> _sites;
+    vox::vector<Thread> _threads;
+    vox::vector<Zone> _zones;
+    uint64_t _numDropped{0};
+
+    // Interned sites, valid as long as the trace is only collected.
+    std::unordered_map<const ZoneSite *, uint32_t> _siteIndices;
+
+    // Events drained from the thread buffers, kept to reuse the allocation.
+    vox::vector<ZoneEvent> _events;
+};
+
+}  // namespace profiling
+
+namespace io {
+VOX_IO_TYPE_VERSION(1, profiling::Trace)
+VOX_IO_TYPE_TAG("vox-profiling-trace", profiling::Trace)
+}  // namespace io
+}  // namespace vox
+
+#define VOX_PROFILE_CONCAT_IMPL(a, b) a##b
+#define VOX_PROFILE_CONCAT(a, b) VOX_PROFILE_CONCAT_IMPL(a, b)
+
+#if VOX_PROFILING
+//! Profiles the enclosing scope as a zone named \p name, which must be a string
+//! literal (or any string living as long as the program).
+#define VOX_PROFILE_ZONE(name)                                                            \
+    static const ::vox::profiling::ZoneSite VOX_PROFILE_CONCAT(voxProfileSite, __LINE__){ \
+            name, __FILE__, static_cast<uint32_t>(__LINE__)};                             \
+    const ::vox::profiling::ScopedZone VOX_PROFILE_CONCAT(voxProfileZone, __LINE__)(      \
+            &VOX_PROFILE_CONCAT(voxProfileSite, __LINE__))
+#else
+#define VOX_PROFILE_ZONE(name) (void)0
+#endif
@@ -0,0 +1,147 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.base/task_graph.h"
+
+#include <thread>
+#include <utility>
+
+#include "vox.base/macros.h"
+#include "vox.base/profiler.h"
+
+namespace vox {
+
+TaskGraph::TaskGraph(ThreadPool *pool) : _pool(pool) {}
+
+TaskGraph::TaskId TaskGraph::addTask(Function function, TaskAffinity affinity) {
+    // Nodes left by clear() are recycled along with their continuation storage.
+    if (_numNodes == _nodes.size()) {
+        _nodes.emplace_back();
+    }
+    Node &node = _nodes[_numNodes];
+    node.function = std::move(function);
+    node.affinity = affinity;
+    node.numDependencies = 0;
+    node.continuations.clear();
+    return _numNodes++;
+}
+
+TaskGraph::TaskId TaskGraph::addTask(Function function,
+                                     const std::vector<TaskId> &dependencies,
+                                     TaskAffinity affinity) {
+    const TaskId task = addTask(std::move(function), affinity);
+    for (TaskId dependency : dependencies) {
+        precede(dependency, task);
+    }
+    return task;
+}
+
+TaskGraph::TaskId TaskGraph::addFence(const std::vector<TaskId> &dependencies) {
+    return addTask(nullptr, dependencies, TaskAffinity::kAnyThread);
+}
+
+void TaskGraph::precede(TaskId task, TaskId successor) {
+    VOX_THROW_INVALID_ARG_IF(task >= successor || successor >= _numNodes);
+
+    _nodes[task].continuations.push_back(successor);
+    ++_nodes[successor].numDependencies;
+}
+
+void TaskGraph::run() {
+    const size_t numTasks = _numNodes;
+    if (numTasks == 0) {
+        return;
+    }
+
+    if (_pendingDependenciesCapacity < numTasks) {
+        _pendingDependencies = std::make_unique<std::atomic<size_t>[]>(numTasks);
+        _pendingDependenciesCapacity = numTasks;
+    }
+    for (size_t i = 0; i < numTasks; ++i) {
+        _pendingDependencies[i].store(_nodes[i].numDependencies, std::memory_order_relaxed);
+    }
+    _numRemainingTasks.store(numTasks);
+
+    // Hold the global pool so a concurrent setMaxNumberOfThreads cannot destroy it.
+    std::shared_ptr<ThreadPool> poolLease = _pool != nullptr ? nullptr : ThreadPool::global();
+    ThreadPool &pool = _pool != nullptr ? *_pool : *poolLease;
+    for (TaskId task = 0; task < numTasks; ++task) {
+        if (_nodes[task].numDependencies == 0) {
+            schedule(pool, task);
+        }
+    }
+
+    // Main-thread tasks have priority, otherwise help the pool.
+    while (_numRemainingTasks.load(std::memory_order_acquire) > 0) {
+        TaskId task = numTasks;
+        {
+            std::lock_guard<std::mutex> lock(_mainThreadTasksMutex);
+            if (!_mainThreadTasks.empty()) {
+                task = _mainThreadTasks.back();
+                _mainThreadTasks.pop_back();
+            }
+        }
+
+        if (task < numTasks) {
+            execute(pool, task);
+        } else if (!pool.runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(_exceptionMutex);
+        std::swap(exception, _exception);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskGraph::clear() {
+    // Release the closures now, their captures may not outlive the frame.
+    for (size_t i = 0; i < _numNodes; ++i) {
+        _nodes[i].function = nullptr;
+    }
+    _numNodes = 0;
+}
+
+size_t TaskGraph::numberOfTasks() const { return _numNodes; }
+
+void TaskGraph::schedule(ThreadPool &pool, TaskId task) {
+    if (_nodes[task].affinity == TaskAffinity::kMainThread) {
+        std::lock_guard<std::mutex> lock(_mainThreadTasksMutex);
+        _mainThreadTasks.push_back(task);
+    } else {
+        pool.submit([this, &pool, task]() { execute(pool, task); });
+    }
+}
+
+void TaskGraph::execute(ThreadPool &pool, TaskId task) {
+    const Node &node = _nodes[task];
+    if (node.function) {
+        VOX_PROFILE_ZONE("TaskGraph task");
+        try {
+            node.function();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_exceptionMutex);
+            if (!_exception) {
+                _exception = std::current_exception();
+            }
+        }
+    }
+
+    for (TaskId continuation : node.continuations) {
+        if (_pendingDependencies[continuation].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(pool, continuation);
+        }
+    }
+
+    _numRemainingTasks.fetch_sub(1, std::memory_order_release);
+}
+
+}  // namespace vox
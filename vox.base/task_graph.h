@@ -0,0 +1,110 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "vox.base/thread_pool.h"
+
+namespace vox {
+
+//! Thread a task of a TaskGraph is allowed to run on.
+enum class TaskAffinity {
+    //! Any worker of the pool, or the thread running the graph.
+    kAnyThread,
+    //! Only the thread calling TaskGraph::run, e.g. for scripts or GPU uploads.
+    kMainThread
+};
+
+//!
+//! \brief Dependency-aware graph of tasks.
+//!
+//! Tasks are added with their dependencies, which must have been added before,
+//! so a graph can never contain cycles. Each task keeps a counter of unfinished
+//! dependencies; a finishing task decrements the counters of its continuations
+//! and schedules those reaching zero. Fences are empty tasks used as join
+//! points.
+//!
+//! A graph can be run several times and rebuilt cheaply with clear(), which
+//! recycles the nodes and their continuation lists. Closures that do not fit
+//! in std::function's small buffer are still allocated per task.
+//!
+class TaskGraph final {
+public:
+    using TaskId = size_t;
+    using Function = std::function<void()>;
+
+    //! Constructs an empty graph whose tasks are executed by \p pool. The
+    //! global pool is looked up at each run if \p pool is nullptr, so the graph
+    //! stays valid across setMaxNumberOfThreads calls.
+    explicit TaskGraph(ThreadPool *pool = nullptr);
+
+    TaskGraph(const TaskGraph &) = delete;
+
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    //! Adds a task without dependency and returns its id.
+    TaskId addTask(Function function, TaskAffinity affinity = TaskAffinity::kAnyThread);
+
+    //! Adds a task that runs once all the \p dependencies are finished.
+    TaskId addTask(Function function,
+                   const std::vector<TaskId> &dependencies,
+                   TaskAffinity affinity = TaskAffinity::kAnyThread);
+
+    //! Adds an empty task finishing once all the \p dependencies are finished.
+    TaskId addFence(const std::vector<TaskId> &dependencies);
+
+    //! Makes \p successor a continuation of \p task. \p task must have been
+    //! added before \p successor.
+    void precede(TaskId task, TaskId successor);
+
+    //! Runs all the tasks and blocks until they are finished. The calling
+    //! thread executes main-thread tasks and helps the pool otherwise.
+    //! As with TaskGroup, an exception thrown by a task is caught, the other
+    //! tasks still run, and the first exception is rethrown once the graph is
+    //! finished.
+    void run();
+
+    //! Removes all the tasks.
+    void clear();
+
+    //! Returns the number of tasks.
+    [[nodiscard]] size_t numberOfTasks() const;
+
+private:
+    struct Node {
+        Function function;
+        TaskAffinity affinity{TaskAffinity::kAnyThread};
+        size_t numDependencies{0};
+        std::vector<TaskId> continuations;
+    };
+
+    void schedule(ThreadPool &pool, TaskId task);
+
+    void execute(ThreadPool &pool, TaskId task);
+
+    ThreadPool *_pool{nullptr};
+    // Only the first _numNodes nodes are used, the others are kept for reuse.
+    std::vector<Node> _nodes;
+    size_t _numNodes{0};
+
+    // Per-run state.
+    std::unique_ptr<std::atomic<size_t>[]> _pendingDependencies;
+    size_t _pendingDependenciesCapacity{0};
+    std::atomic<size_t> _numRemainingTasks{0};
+    std::mutex _mainThreadTasksMutex;
+    std::vector<TaskId> _mainThreadTasks;
+    std::mutex _exceptionMutex;
+    std::exception_ptr _exception;
+};
+
+}  // namespace vox
@@ -0,0 +1,263 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.base/thread_pool.h"
+
+#include <algorithm>
+#include <string>
+
+#include "vox.base/parallel.h"
+#include "vox.base/profiler.h"
+
+namespace vox {
+
+namespace {
+
+thread_local ThreadPool *sCurrentPool = nullptr;
+thread_local int sCurrentWorkerIndex = -1;
+
+// Only serializes the creation and the replacement of the global pool, which
+// is read with std::atomic_load.
+std::mutex sGlobalPoolMutex;
+std::shared_ptr<ThreadPool> sGlobalPool;
+// Mirrors sGlobalPool, so that workers can recognize their pool without
+// touching the reference count.
+std::atomic<ThreadPool *> sGlobalPoolPtr{nullptr};
+
+// The last reference to a replaced global pool may be released by a task
+// running on one of its own workers, which cannot join itself.
+void deletePool(ThreadPool *pool) {
+    if (pool->currentWorkerIndex() >= 0) {
+        std::thread([pool]() { delete pool; }).detach();
+    } else {
+        delete pool;
+    }
+}
+
+std::shared_ptr<ThreadPool> makePool(unsigned int numWorkers) {
+    return std::shared_ptr<ThreadPool>(new ThreadPool(numWorkers), deletePool);
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(unsigned int numWorkers) {
+    _queues.reserve(numWorkers + 1);
+    for (unsigned int i = 0; i <= numWorkers; ++i) {
+        _queues.emplace_back(std::make_unique<TaskQueue>());
+    }
+
+    _workers.reserve(numWorkers);
+    for (unsigned int i = 0; i < numWorkers; ++i) {
+        _workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _isRunning.store(false);
+    }
+    _sleepCondition.notify_all();
+
+    for (std::thread &worker : _workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // Pool without workers (or tasks submitted during shutdown).
+    while (runPendingTask()) {
+    }
+}
+
+unsigned int ThreadPool::numberOfWorkers() const { return static_cast<unsigned int>(_workers.size()); }
+
+int ThreadPool::currentWorkerIndex() const { return sCurrentPool == this ? sCurrentWorkerIndex : -1; }
+
+void ThreadPool::submit(Task task) {
+    const int workerIndex = currentWorkerIndex();
+    TaskQueue &queue = workerIndex >= 0 ? *_queues[workerIndex] : *_queues.back();
+    // Count the task before publishing it, so a thief never decrements first.
+    _numPendingTasks.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+
+    // Taking the lock guarantees a worker that just found no task is either
+    // already waiting (and gets notified) or will see the new counter value.
+    { std::lock_guard<std::mutex> lock(_sleepMutex); }
+    _sleepCondition.notify_one();
+}
+
+bool ThreadPool::runPendingTask() {
+    Task task;
+    if (popTask(&task)) {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_exceptionMutex);
+            if (!_exception) {
+                _exception = std::current_exception();
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::rethrowException() {
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(_exceptionMutex);
+        std::swap(exception, _exception);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+bool ThreadPool::popTask(Task *task) {
+    if (_numPendingTasks.load() == 0) {
+        return false;
+    }
+
+    const int workerIndex = currentWorkerIndex();
+    if (workerIndex >= 0 && popBack(*_queues[workerIndex], task)) {
+        return true;
+    }
+
+    if (popFront(*_queues.back(), task)) {
+        return true;
+    }
+
+    // Steal from the other workers, starting next to ourselves.
+    const auto numWorkers = static_cast<unsigned int>(_workers.size());
+    const unsigned int first = workerIndex >= 0 ? static_cast<unsigned int>(workerIndex) + 1 : 0;
+    for (unsigned int i = 0; i < numWorkers; ++i) {
+        const unsigned int victim = (first + i) % numWorkers;
+        if (static_cast<int>(victim) != workerIndex && popFront(*_queues[victim], task)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::popBack(TaskQueue &queue, Task *task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    *task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    _numPendingTasks.fetch_sub(1);
+    return true;
+}
+
+bool ThreadPool::popFront(TaskQueue &queue, Task *task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    *task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    _numPendingTasks.fetch_sub(1);
+    return true;
+}
+
+void ThreadPool::workerLoop(unsigned int index) {
+    sCurrentPool = this;
+    sCurrentWorkerIndex = static_cast<int>(index);
+    profiling::setThreadName(("Worker " + std::to_string(index)).c_str());
+
+    while (true) {
+        if (runPendingTask()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        if (!_isRunning.load() && _numPendingTasks.load() == 0) {
+            break;
+        }
+        _sleepCondition.wait(lock, [this]() { return !_isRunning.load() || _numPendingTasks.load() > 0; });
+    }
+
+    sCurrentPool = nullptr;
+    sCurrentWorkerIndex = -1;
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::global() {
+    std::shared_ptr<ThreadPool> pool = std::atomic_load(&sGlobalPool);
+    if (pool) {
+        return pool;
+    }
+
+    std::lock_guard<std::mutex> lock(sGlobalPoolMutex);
+    pool = std::atomic_load(&sGlobalPool);
+    if (!pool) {
+        pool = makePool(std::max(maxNumberOfThreads(), 1u) - 1);
+        sGlobalPoolPtr.store(pool.get());
+        std::atomic_store(&sGlobalPool, pool);
+    }
+    return pool;
+}
+
+void ThreadPool::resetGlobal(unsigned int numWorkers) {
+    std::shared_ptr<ThreadPool> previous;
+    {
+        std::lock_guard<std::mutex> lock(sGlobalPoolMutex);
+        std::shared_ptr<ThreadPool> pool = makePool(numWorkers);
+        sGlobalPoolPtr.store(pool.get());
+        previous = std::atomic_exchange(&sGlobalPool, std::move(pool));
+    }
+    // Destroyed here unless a TaskGroup or TaskGraph still holds it.
+    previous.reset();
+}
+
+// MARK: - TaskGroup
+namespace {
+// A worker of the global pool can't outlive its pool while it runs a task, so
+// nested groups don't need to hold a reference.
+std::shared_ptr<ThreadPool> leaseGlobalPool() {
+    if (sCurrentPool != nullptr && sCurrentPool == sGlobalPoolPtr.load()) {
+        return nullptr;
+    }
+    return ThreadPool::global();
+}
+}  // namespace
+
+TaskGroup::TaskGroup() : _poolLease(leaseGlobalPool()), _pool(_poolLease ? *_poolLease : *sCurrentPool) {}
+
+TaskGroup::TaskGroup(ThreadPool &pool) : _pool(pool) {}
+
+TaskGroup::~TaskGroup() { waitForTasks(); }
+
+void TaskGroup::wait() {
+    waitForTasks();
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(_exceptionMutex);
+        std::swap(exception, _exception);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskGroup::waitForTasks() {
+    _pool.waitUntil([this]() { return _numPendingTasks.load(std::memory_order_acquire) == 0; });
+}
+
+void TaskGroup::setException(std::exception_ptr exception) {
+    std::lock_guard<std::mutex> lock(_exceptionMutex);
+    if (!_exception) {
+        _exception = std::move(exception);
+    }
+}
+
+}  // namespace vox
@@ -0,0 +1,173 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vox {
+
+//!
+//! \brief Persistent work-stealing thread pool.
+//!
+//! Every worker owns a deque of tasks. A worker pushes and pops its own tasks
+//! at the back (LIFO, cache friendly for nested work) and steals from the front
+//! of other workers' deques when it runs dry. Tasks submitted from threads that
+//! do not belong to the pool go to a shared injection deque.
+//!
+//! Threads that need to wait for tasks (see TaskGroup) keep executing pending
+//! tasks instead of blocking, which makes nested parallelism deadlock free.
+//!
+class ThreadPool final {
+public:
+    using Task = std::function<void()>;
+
+    //! Constructs a pool with \p numWorkers background threads. A pool without
+    //! workers is valid; its tasks are run by the waiting threads.
+    explicit ThreadPool(unsigned int numWorkers);
+
+    //! Runs the remaining tasks and joins all workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    //! Returns the number of background workers.
+    [[nodiscard]] unsigned int numberOfWorkers() const;
+
+    //! Returns the worker index of the calling thread, or -1 if the calling
+    //! thread does not belong to this pool.
+    [[nodiscard]] int currentWorkerIndex() const;
+
+    //! Enqueues \p task for asynchronous execution. The first exception thrown
+    //! by a submitted task is kept until rethrowException() collects it; use
+    //! TaskGroup to wait for tasks and collect their exceptions together.
+    void submit(Task task);
+
+    //! Rethrows the first exception thrown by a task of submit() since the
+    //! last call, if any. Exceptions not collected are dropped with the pool.
+    void rethrowException();
+
+    //! Pops (or steals) one pending task and runs it on the calling thread.
+    //! Returns false if no task was available.
+    bool runPendingTask();
+
+    //! Runs pending tasks on the calling thread until \p predicate is true.
+    template <typename Predicate>
+    void waitUntil(const Predicate &predicate) {
+        while (!predicate()) {
+            if (!runPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    //! Returns the process-wide pool used by the parallel* functions. It is
+    //! created on first use with maxNumberOfThreads() - 1 workers, since the
+    //! calling thread takes part in the work. The pool stays alive while the
+    //! returned reference is held, even if resetGlobal() replaces it. Reading
+    //! the pool doesn't take a lock once it exists.
+    static std::shared_ptr<ThreadPool> global();
+
+    //! Re-creates the process-wide pool with \p numWorkers workers. Users that
+    //! acquired the previous pool keep running on it; it is destroyed once the
+    //! last of them releases it.
+    static void resetGlobal(unsigned int numWorkers);
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool popTask(Task *task);
+
+    bool popBack(TaskQueue &queue, Task *task);
+
+    bool popFront(TaskQueue &queue, Task *task);
+
+    void workerLoop(unsigned int index);
+
+    // One queue per worker, followed by the injection queue.
+    std::vector<std::unique_ptr<TaskQueue>> _queues;
+    std::vector<std::thread> _workers;
+    std::atomic<size_t> _numPendingTasks{0};
+    std::atomic<bool> _isRunning{true};
+    std::mutex _exceptionMutex;
+    std::exception_ptr _exception;
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+};
+
+//!
+//! \brief Set of tasks that can be waited for as a whole.
+//!
+//! The waiting thread helps executing pending tasks of the pool, so groups can
+//! be nested freely, e.g. a task of a group may itself spawn and wait for
+//! another group.
+//!
+//! An exception thrown by a task is caught on the worker, the remaining tasks
+//! still run, and the first exception is rethrown by wait().
+//!
+class TaskGroup final {
+public:
+    //! Constructs a group that submits its tasks to the global pool, which is
+    //! kept alive until the group is destroyed. Groups created by a worker of
+    //! the global pool use it without taking a reference.
+    TaskGroup();
+
+    //! Constructs a group that submits its tasks to \p pool.
+    explicit TaskGroup(ThreadPool &pool);
+
+    //! Waits for all the tasks of the group. Exceptions not collected by
+    //! wait() are dropped.
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    //! Submits \p function as a task of this group.
+    template <typename Function>
+    void run(Function &&function) {
+        _numPendingTasks.fetch_add(1, std::memory_order_relaxed);
+        _pool.submit([this, function = std::forward<Function>(function)]() {
+            try {
+                function();
+            } catch (...) {
+                setException(std::current_exception());
+            }
+            _numPendingTasks.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    //! Blocks until all the tasks of the group are finished, then rethrows the
+    //! first exception thrown by one of them, if any.
+    void wait();
+
+private:
+    void waitForTasks();
+
+    void setException(std::exception_ptr exception);
+
+    std::shared_ptr<ThreadPool> _poolLease;
+    ThreadPool &_pool;
+    std::atomic<size_t> _numPendingTasks{0};
+    std::mutex _exceptionMutex;
+    std::exception_ptr _exception;
+};
+
+}  // namespace vox
@@ -88,16 +88,24 @@ bool EditorApplication::prepare(Platform& platform) {
 void EditorApplication::update(float deltaTime) {
     GraphicsApplication::update(deltaTime);
     {
-        _componentsManager->callScriptOnStart();
-
-        _physicsManager->update(deltaTime);
-
-        _componentsManager->callScriptOnUpdate(deltaTime);
-        _componentsManager->callAnimatorUpdate(deltaTime);
-        _componentsManager->callScriptOnLateUpdate(deltaTime);
-
-        _componentsManager->callRendererOnUpdate(deltaTime);
-        _sceneManager->currentScene()->updateShaderData();
+        // Scripts, collider syncs and renderer uploads stay on the main thread. Physics steps on a worker, then
+        // animators are evaluated after the scripts, which may drive them. The skinning matrices are built on
+        // workers while the cameras update.
+        constexpr auto kMainThread = TaskAffinity::kMainThread;
+        _updateGraph.clear();
+        auto start = _updateGraph.addTask([&]() { _componentsManager->callScriptOnStart(); }, kMainThread);
+        auto physics = _physicsManager->addUpdateTasks(_updateGraph, deltaTime, start);
+        auto scriptUpdate = _updateGraph.addTask([&]() { _componentsManager->callScriptOnUpdate(deltaTime); },
+                                                 {physics}, kMainThread);
+        auto animators = _componentsManager->addAnimatorUpdateTask(_updateGraph, deltaTime, scriptUpdate);
+        auto lateUpdate = _updateGraph.addTask([&]() { _componentsManager->callScriptOnLateUpdate(deltaTime); },
+                                               {animators}, kMainThread);
+        auto skinning = _componentsManager->addSkinningTask(_updateGraph, lateUpdate);
+        _updateGraph.addTask([&]() { _sceneManager->currentScene()->updateShaderData(); }, {lateUpdate},
+                             kMainThread);
+        _updateGraph.addTask([&]() { _componentsManager->callRendererOnUpdate(deltaTime); }, {skinning},
+                             kMainThread);
+        _updateGraph.run();
     }
 
     wgpu::CommandEncoder commandEncoder = _device.CreateCommandEncoder();
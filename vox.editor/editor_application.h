@@ -82,6 +82,11 @@ protected:
     std::unique_ptr<LightManager> _lightManager{nullptr};
     //    std::unique_ptr<ParticleManager> _particleManager{nullptr};
     std::unique_ptr<PhysicsManager> _physicsManager{nullptr};
+
+    /**
+     * @brief Per-frame update work, rebuilt every frame
+     */
+    TaskGraph _updateGraph;
 };
 
 }  // namespace vox::editor
@@ -54,6 +54,32 @@ void Blas<ScalarType, VectorType, MatrixType>::residual(const MatrixType &a,
     *result = b - a * x;
 }
 
+template <typename ScalarType, typename VectorType, typename MatrixType>
+ScalarType Blas<ScalarType, VectorType, MatrixType>::mvmDot(const MatrixType &m,
+                                                          const VectorType &v,
+                                                          VectorType *result) {
+    mvm(m, v, result);
+    return dot(v, *result);
+}
+
+template <typename ScalarType, typename VectorType, typename MatrixType>
+ScalarType Blas<ScalarType, VectorType, MatrixType>::residualDot(const MatrixType &a,
+                                                               const VectorType &x,
+                                                               const VectorType &b,
+                                                               VectorType *result) {
+    residual(a, x, b, result);
+    return dot(*result, *result);
+}
+
+template <typename ScalarType, typename VectorType, typename MatrixType>
+ScalarType Blas<ScalarType, VectorType, MatrixType>::axpyDot(ScalarType a,
+                                                           const VectorType &x,
+                                                           const VectorType &y,
+                                                           VectorType *result) {
+    axpy(a, x, y, result);
+    return dot(*result, *result);
+}
+
 template <typename ScalarType, typename VectorType, typename MatrixType>
 ScalarType Blas<ScalarType, VectorType, MatrixType>::l2Norm(const VectorType &v) {
     return std::sqrt(v.dot(v));
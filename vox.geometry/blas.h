@@ -20,7 +20,8 @@ namespace vox {
 //! Matrix<T, 4, 4>. For custom vector/matrix classes, create a new BLAS class
 //! that conforms the function interfaces defined in this class. It will enable
 //! performing linear algebra routines (such as conjugate grapdient) for the
-//! custom vector/matrix types.
+//! custom vector/matrix types. The fused operators (mvmDot, residualDot and
+//! axpyDot) let large vector types finish the reduction in the same pass.
 //!
 template <typename S, typename V, typename M>
 struct Blas {
@@ -53,6 +54,15 @@ struct Blas {
     //! Computes residual vector (b - ax).
     static void residual(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
 
+    //! Performs matrix-vector multiplication and returns \p v dot \p result.
+    static ScalarType mvmDot(const MatrixType &m, const VectorType &v, VectorType *result);
+
+    //! Computes residual vector (b - ax) and returns its squared L2-norm.
+    static ScalarType residualDot(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
+
+    //! Performs ax + y operation and returns the squared L2-norm of \p result.
+    static ScalarType axpyDot(ScalarType a, const VectorType &x, const VectorType &y, VectorType *result);
+
     //! Returns L2-norm of the given vector \p v.
     static ScalarType l2Norm(const VectorType &v);
 
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <numeric>
 
 #include "vox.base/constants.h"
@@ -14,6 +16,68 @@
 
 namespace vox {
 
+namespace internal {
+
+// Rays of a batched query stored as structure of arrays, so that slab tests
+// are branch-free loops over the lanes which compilers vectorize.
+template <size_t N>
+struct Bvh3RayPacket {
+    static_assert(N <= 32, "Lanes are stored as 32 bits masks.");
+
+    double origin[3][N];
+    double invDirection[3][N];
+    // Distance beyond which each ray doesn't look for intersections.
+    double maxDistance[N];
+    // Bit i is set if lane i holds a ray.
+    uint32_t lanes;
+
+    // Loads \p count rays from \p first. Unused lanes repeat the first ray so
+    // that they don't compute on garbage.
+    Bvh3RayPacket(const ConstArrayAccessor1<Ray3D> &rays, size_t first, size_t count)
+        : lanes(static_cast<uint32_t>((uint64_t(1) << count) - 1)) {
+        for (size_t lane = 0; lane < N; ++lane) {
+            const Ray3D &ray = rays[first + (lane < count ? lane : 0)];
+            for (size_t axis = 0; axis < 3; ++axis) {
+                origin[axis][lane] = ray.origin[axis];
+                invDirection[axis][lane] = 1.0 / ray.direction[axis];
+            }
+            maxDistance[lane] = kMaxD;
+        }
+    }
+
+    // Returns the lanes of \p mask whose rays intersect \p box before their
+    // maximum distance. This is the same test as BoundingBox3D::intersects:
+    // rays parallel to a slab and starting on its plane give NaN, which is
+    // ignored, so they are considered inside.
+    [[nodiscard]] uint32_t intersects(const BoundingBox3D &box, uint32_t mask) const {
+        double tMin[N];
+        double tMax[N];
+        for (size_t lane = 0; lane < N; ++lane) {
+            tMin[lane] = 0.0;
+            tMax[lane] = maxDistance[lane];
+        }
+        for (size_t axis = 0; axis < 3; ++axis) {
+            const double lower = box.lower_corner[axis];
+            const double upper = box.upper_corner[axis];
+            for (size_t lane = 0; lane < N; ++lane) {
+                const double t0 = (lower - origin[axis][lane]) * invDirection[axis][lane];
+                const double t1 = (upper - origin[axis][lane]) * invDirection[axis][lane];
+                const double tNear = t0 > t1 ? t1 : t0;
+                const double tFar = t0 > t1 ? t0 : t1;
+                tMin[lane] = tNear > tMin[lane] ? tNear : tMin[lane];
+                tMax[lane] = tFar < tMax[lane] ? tFar : tMax[lane];
+            }
+        }
+        uint32_t result = 0;
+        for (size_t lane = 0; lane < N; ++lane) {
+            result |= static_cast<uint32_t>(!(tMin[lane] > tMax[lane])) << lane;
+        }
+        return result & mask;
+    }
+};
+
+}  // namespace internal
+
 template <typename T>
 Bvh3<T>::Node::Node() : flags(0) {
     child = kMaxSize;
@@ -44,7 +108,9 @@ template <typename T>
 Bvh3<T>::Bvh3() = default;
 
 template <typename T>
-void Bvh3<T>::build(const std::vector<T> &items, const std::vector<BoundingBox3D> &itemsBounds) {
+void Bvh3<T>::build(const std::vector<T> &items,
+                    const std::vector<BoundingBox3D> &itemsBounds,
+                    BvhBuildMethod method) {
     _items = items;
     _itemBounds = itemsBounds;
 
@@ -59,6 +125,23 @@ void Bvh3<T>::build(const std::vector<T> &items, const std::vector<BoundingBox3D
         _bound.merge(_itemBounds[i]);
     }
 
+    if (method == BvhBuildMethod::kBinnedSah) {
+        // The builder lays nodes out the same way, first child next to its
+        // parent, so they convert one to one.
+        BvhBuilder3 builder;
+        builder.build(_itemBounds);
+        const std::vector<BvhBuilder3::Node> &nodes = builder.nodes();
+        _nodes.resize(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].isLeaf()) {
+                _nodes[i].initLeaf(nodes[i].index, nodes[i].bound);
+            } else {
+                _nodes[i].initInternal(nodes[i].axis, nodes[i].index, nodes[i].bound);
+            }
+        }
+        return;
+    }
+
     std::vector<size_t> itemIndices(_items.size());
     std::iota(std::begin(itemIndices), std::end(itemIndices), 0);
 
@@ -434,6 +517,73 @@ inline ClosestIntersectionQueryResult3<T> Bvh3<T>::closestIntersection(
     return best;
 }
 
+template <typename T>
+void Bvh3<T>::intersectsBatch(const ConstArrayAccessor1<Ray3D> &rays,
+                              const RayIntersectionTestFunc3<T> &testFunc,
+                              ArrayAccessor1<char> results,
+                              ExecutionPolicy policy) const {
+    const size_t numPackets = (rays.size() + kRayPacketSize - 1) / kRayPacketSize;
+    parallelFor(
+            kZeroSize, numPackets,
+            [&](size_t p) {
+                const size_t first = p * kRayPacketSize;
+                const size_t count = std::min(kRayPacketSize, rays.size() - first);
+                const internal::Bvh3RayPacket<kRayPacketSize> packet(rays, first, count);
+                for (size_t lane = 0; lane < count; ++lane) {
+                    results[first + lane] = false;
+                }
+
+                // A ray is done once it hits an item.
+                traverse(packet, [&](size_t item, uint32_t lanes) {
+                    uint32_t hits = 0;
+                    for (size_t lane = 0; lane < count; ++lane) {
+                        if (((lanes >> lane) & 1) && testFunc(_items[item], rays[first + lane])) {
+                            results[first + lane] = true;
+                            hits |= uint32_t(1) << lane;
+                        }
+                    }
+                    return hits;
+                });
+            },
+            policy);
+}
+
+template <typename T>
+void Bvh3<T>::closestIntersectionBatch(const ConstArrayAccessor1<Ray3D> &rays,
+                                       const GetRayIntersectionFunc3<T> &testFunc,
+                                       ArrayAccessor1<ClosestIntersectionQueryResult3<T>> results,
+                                       ExecutionPolicy policy) const {
+    const size_t numPackets = (rays.size() + kRayPacketSize - 1) / kRayPacketSize;
+    parallelFor(
+            kZeroSize, numPackets,
+            [&](size_t p) {
+                const size_t first = p * kRayPacketSize;
+                const size_t count = std::min(kRayPacketSize, rays.size() - first);
+                internal::Bvh3RayPacket<kRayPacketSize> packet(rays, first, count);
+                for (size_t lane = 0; lane < count; ++lane) {
+                    results[first + lane].distance = kMaxD;
+                    results[first + lane].item = nullptr;
+                }
+
+                // Rays are shortened to their closest intersection so far.
+                traverse(packet, [&](size_t item, uint32_t lanes) {
+                    for (size_t lane = 0; lane < count; ++lane) {
+                        if ((lanes >> lane) & 1) {
+                            const double dist = testFunc(_items[item], rays[first + lane]);
+                            ClosestIntersectionQueryResult3<T> &best = results[first + lane];
+                            if (dist < best.distance) {
+                                best.distance = dist;
+                                best.item = _items.data() + item;
+                                packet.maxDistance[lane] = dist;
+                            }
+                        }
+                    }
+                    return uint32_t(0);
+                });
+            },
+            policy);
+}
+
 template <typename T>
 const BoundingBox3D &Bvh3<T>::boundingBox() const {
     return _bound;
@@ -551,6 +701,55 @@ size_t Bvh3<T>::build(size_t nodeIndex, size_t *itemIndices, size_t nItems, size
     return std::max(d0, d1);
 }
 
+template <typename T>
+template <typename LeafFunc>
+void Bvh3<T>::traverse(const internal::Bvh3RayPacket<kRayPacketSize> &packet, const LeafFunc &leafFunc) const {
+    if (_nodes.empty()) {
+        return;
+    }
+
+    // Lanes whose traversal isn't over.
+    uint32_t active = packet.lanes;
+
+    // Nodes are tested when they are dequeued rather than enqueued, since
+    // rays may have been shortened in between.
+    static const int kMaxTreeDepth = 8 * sizeof(size_t);
+    std::pair<const Node *, uint32_t> todo[kMaxTreeDepth + 1];
+    size_t todoPos = 0;
+    todo[todoPos++] = {_nodes.data(), active};
+
+    while (todoPos > 0) {
+        --todoPos;
+        const Node *node = todo[todoPos].first;
+        const uint32_t lanes = packet.intersects(node->bound, todo[todoPos].second & active);
+        if (lanes == 0) {
+            continue;
+        }
+
+        if (node->isLeaf()) {
+            active &= ~leafFunc(node->item, lanes);
+            if (active == 0) {
+                return;
+            }
+        } else {
+            // Visits first the child that the first ray enters first.
+            size_t lead = 0;
+            while (((lanes >> lead) & 1) == 0) {
+                ++lead;
+            }
+            const Node *left = node + 1;
+            const Node *right = &_nodes[node->child];
+            if (packet.invDirection[static_cast<size_t>(node->flags)][lead] > 0.0) {
+                todo[todoPos++] = {right, lanes};
+                todo[todoPos++] = {left, lanes};
+            } else {
+                todo[todoPos++] = {left, lanes};
+                todo[todoPos++] = {right, lanes};
+            }
+        }
+    }
+}
+
 template <typename T>
 size_t Bvh3<T>::qsplit(size_t *itemIndices, size_t numItems, double pivot, uint8_t axis) {
     double centroid;
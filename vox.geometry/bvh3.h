@@ -8,11 +8,19 @@
 
 #include <vector>
 
+#include "vox.base/parallel.h"
+#include "vox.geometry/array_accessor1.h"
+#include "vox.geometry/bvh_builder3.h"
 #include "vox.geometry/intersection_query_engine3.h"
 #include "vox.geometry/nearest_neighbor_query_engine3.h"
 
 namespace vox {
 
+namespace internal {
+template <size_t N>
+struct Bvh3RayPacket;
+}  // namespace internal
+
 //!
 //! \brief Bounding Volume Hierarchy (BVH) in 3D
 //!
@@ -21,6 +29,10 @@ namespace vox {
 //! intersection tests. Also, NearestNeighborQueryEngine3 is implemented to
 //! provide nearest neighbor query.
 //!
+//! Batched ray queries traverse the tree with packets of kRayPacketSize rays
+//! which share the node stack, so that node bounds are loaded once per packet
+//! and tested against all the rays at once.
+//!
 template <typename T>
 class Bvh3 final : public IntersectionQueryEngine3<T>, public NearestNeighborQueryEngine3<T> {
 public:
@@ -28,11 +40,16 @@ public:
     using Iterator = typename ContainerType::iterator;
     using ConstIterator = typename ContainerType::const_iterator;
 
+    //! Number of rays traversed together by batched ray queries.
+    static constexpr size_t kRayPacketSize = 8;
+
     //! Default constructor.
     Bvh3();
 
-    //! Builds bounding volume hierarchy.
-    void build(const std::vector<T> &items, const std::vector<BoundingBox3D> &itemsBounds);
+    //! Builds bounding volume hierarchy with the given split \p method.
+    void build(const std::vector<T> &items,
+               const std::vector<BoundingBox3D> &itemsBounds,
+               BvhBuildMethod method = BvhBuildMethod::kMidpoint);
 
     //! Clears all the contents of this instance.
     void clear();
@@ -62,6 +79,22 @@ public:
     ClosestIntersectionQueryResult3<T> closestIntersection(const Ray3D &ray,
                                                            const GetRayIntersectionFunc3<T> &testFunc) const override;
 
+    //! Sets \p results[i] to true if \p rays[i] intersects with any of the
+    //! stored items. Rays are traversed by packets, in parallel over the batch.
+    void intersectsBatch(const ConstArrayAccessor1<Ray3D> &rays,
+                         const RayIntersectionTestFunc3<T> &testFunc,
+                         ArrayAccessor1<char> results,
+                         ExecutionPolicy policy = ExecutionPolicy::kParallel) const;
+
+    //! Sets \p results[i] to the closest intersection of \p rays[i]. Rays are
+    //! traversed by packets, in parallel over the batch, and each ray skips
+    //! the nodes it enters beyond its closest intersection so far. \p testFunc
+    //! should thus return the distance along the ray.
+    void closestIntersectionBatch(const ConstArrayAccessor1<Ray3D> &rays,
+                                  const GetRayIntersectionFunc3<T> &testFunc,
+                                  ArrayAccessor1<ClosestIntersectionQueryResult3<T>> results,
+                                  ExecutionPolicy policy = ExecutionPolicy::kParallel) const;
+
     //! Returns bounding box of every items.
     [[nodiscard]] const BoundingBox3D &boundingBox() const;
 
@@ -127,6 +160,12 @@ private:
     size_t build(size_t nodeIndex, size_t *itemIndices, size_t nItems, size_t currentDepth);
 
     size_t qsplit(size_t *itemIndices, size_t numItems, double pivot, uint8_t axis);
+
+    //! Traverses the tree with the rays of \p packet, calling
+    //! \p leafFunc(item, lanes) for each leaf entered by the rays of \p lanes.
+    //! \p leafFunc returns the lanes whose traversal is over.
+    template <typename LeafFunc>
+    void traverse(const internal::Bvh3RayPacket<kRayPacketSize> &packet, const LeafFunc &leafFunc) const;
 };
 }  // namespace vox
 
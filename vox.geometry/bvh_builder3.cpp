@@ -0,0 +1,307 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.geometry/bvh_builder3.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "vox.base/parallel.h"
+#include "vox.base/thread_pool.h"
+
+namespace vox {
+
+namespace {
+
+constexpr size_t kNumberOfBins = 16;
+
+// Ranges larger than this are binned in parallel, and their subtrees are built
+// as separate tasks.
+constexpr size_t kParallelThreshold = 4096;
+
+struct RangeBounds {
+    BoundingBox3D bound;
+    BoundingBox3D centroidBound;
+};
+
+RangeBounds merge(RangeBounds a, const RangeBounds &b) {
+    a.bound.merge(b.bound);
+    a.centroidBound.merge(b.centroidBound);
+    return a;
+}
+
+// Bounds of the items of each bin, so that the bounds of both children are
+// known once a split is chosen.
+struct Bins {
+    RangeBounds bounds[kNumberOfBins];
+    size_t counts[kNumberOfBins] = {};
+};
+
+Bins merge(Bins a, const Bins &b) {
+    for (size_t bin = 0; bin < kNumberOfBins; ++bin) {
+        a.bounds[bin] = merge(a.bounds[bin], b.bounds[bin]);
+        a.counts[bin] += b.counts[bin];
+    }
+    return a;
+}
+
+double surfaceArea(const BoundingBox3D &box) {
+    const Vector3D d = box.upper_corner - box.lower_corner;
+    return 2.0 * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+size_t ceilLog2(size_t value) {
+    size_t result = 0;
+    while ((size_t(1) << result) < value) {
+        ++result;
+    }
+    return result;
+}
+
+// Maps centroids to bins along an axis.
+struct BinMapping {
+    size_t axis;
+    double lower;
+    double scale;
+
+    [[nodiscard]] size_t operator()(const Point3D &centroid) const {
+        const auto bin = static_cast<size_t>((centroid[axis] - lower) * scale);
+        return std::min(bin, kNumberOfBins - 1);
+    }
+};
+
+// Bounds of an item, moved along with its index so that each level reads items
+// sequentially.
+struct ItemRef {
+    BoundingBox3D bound;
+    Point3D centroid;
+    size_t item;
+};
+
+// Returns the bounds of the items in [begin, end) of refs.
+RangeBounds computeRangeBounds(const ItemRef *refs, size_t begin, size_t end) {
+    const auto boundRange = [refs](size_t b, size_t e, RangeBounds result) {
+        for (size_t i = b; i < e; ++i) {
+            result.bound.merge(refs[i].bound);
+            result.centroidBound.merge(refs[i].centroid);
+        }
+        return result;
+    };
+    return end - begin > kParallelThreshold
+                   ? parallelReduce(begin, end, RangeBounds(), boundRange,
+                                    [](const RangeBounds &a, const RangeBounds &b) { return merge(a, b); })
+                   : boundRange(begin, end, RangeBounds());
+}
+
+}  // namespace
+
+struct BvhBuilder3::BuildNode {
+    // Computed by the parent, along with the split.
+    BoundingBox3D bound;
+    // Children are allocated by pairs, this is the index of the first one.
+    size_t firstChild = 0;
+    size_t begin = 0;
+    size_t end = 0;
+    uint8_t axis = 0;
+    bool isLeaf = false;
+};
+
+struct BvhBuilder3::BuildContext {
+    std::vector<ItemRef> refs;
+    // A binary tree of n leaves has 2n - 1 nodes, which are allocated by
+    // incrementing numNodes so that tasks don't need to synchronize.
+    std::vector<BuildNode> nodes;
+    std::atomic<size_t> numNodes{1};
+};
+
+void BvhBuilder3::build(const std::vector<BoundingBox3D> &itemsBounds) {
+    _nodes.clear();
+    if (itemsBounds.empty()) {
+        return;
+    }
+
+    BuildContext context;
+    context.refs.resize(itemsBounds.size());
+    parallelFor(kZeroSize, itemsBounds.size(), [&](size_t i) {
+        context.refs[i] = {itemsBounds[i], itemsBounds[i].midPoint(), i};
+    });
+    context.nodes.resize(2 * itemsBounds.size() - 1);
+
+    const RangeBounds rootBounds = computeRangeBounds(context.refs.data(), 0, itemsBounds.size());
+    context.nodes[0].bound = rootBounds.bound;
+    buildNode(context, 0, 0, itemsBounds.size(), 1, rootBounds.centroidBound);
+
+    // Lays out the tree depth-first, so the first child of a node is the next
+    // one and traversals mostly move forward in memory.
+    _nodes.reserve(context.numNodes.load());
+    std::vector<std::pair<size_t, size_t>> todo;  // Build node, and parent to patch.
+    todo.emplace_back(0, kMaxSize);
+    while (!todo.empty()) {
+        const auto [buildIndex, parent] = todo.back();
+        todo.pop_back();
+
+        if (parent != kMaxSize) {
+            _nodes[parent].index = _nodes.size();
+        }
+
+        const BuildNode &buildNode = context.nodes[buildIndex];
+        Node node;
+        node.bound = buildNode.bound;
+        if (buildNode.isLeaf) {
+            node.index = context.refs[buildNode.begin].item;
+            node.axis = 3;
+            _nodes.push_back(node);
+        } else {
+            node.axis = buildNode.axis;
+            _nodes.push_back(node);
+            todo.emplace_back(buildNode.firstChild + 1, _nodes.size() - 1);
+            todo.emplace_back(buildNode.firstChild, kMaxSize);
+        }
+    }
+}
+
+const std::vector<BvhBuilder3::Node> &BvhBuilder3::nodes() const { return _nodes; }
+
+void BvhBuilder3::buildNode(BuildContext &context,
+                            size_t nodeIndex,
+                            size_t begin,
+                            size_t end,
+                            size_t depth,
+                            const BoundingBox3D &centroidBound) const {
+    const size_t numItems = end - begin;
+    const bool isParallel = numItems > kParallelThreshold;
+    ItemRef *refs = context.refs.data();
+
+    BuildNode &node = context.nodes[nodeIndex];
+    node.begin = begin;
+    node.end = end;
+
+    if (numItems == 1) {
+        node.isLeaf = true;
+        return;
+    }
+
+    // Splits along the axis where centroids spread the most.
+    const Vector3D centroidExtent = centroidBound.upper_corner - centroidBound.lower_corner;
+    uint8_t axis = 0;
+    if (centroidExtent.y > centroidExtent[axis]) axis = 1;
+    if (centroidExtent.z > centroidExtent[axis]) axis = 2;
+    const auto compareCentroids = [axis](const ItemRef &a, const ItemRef &b) {
+        return a.centroid[axis] < b.centroid[axis];
+    };
+
+    size_t mid = begin + numItems / 2;
+    RangeBounds childBounds[2];
+    bool hasChildBounds = false;
+
+    if (centroidExtent[axis] <= 0.0) {
+        // All centroids are the same, items are split by count.
+    } else if (depth + ceilLog2(numItems) + 1 >= kMaxTreeDepth) {
+        // Median splits keep the remaining depth logarithmic.
+        std::nth_element(refs + begin, refs + mid, refs + end, compareCentroids);
+    } else if (numItems <= kNumberOfBins) {
+        // Binning costs more than evaluating every split of a few sorted items.
+        std::sort(refs + begin, refs + end, compareCentroids);
+
+        double rightCosts[kNumberOfBins];
+        BoundingBox3D rightBound;
+        for (size_t i = numItems - 1; i > 0; --i) {
+            rightBound.merge(refs[begin + i].bound);
+            rightCosts[i] = (numItems - i) * surfaceArea(rightBound);
+        }
+
+        double bestCost = std::numeric_limits<double>::max();
+        BoundingBox3D leftBound;
+        for (size_t i = 1; i < numItems; ++i) {
+            leftBound.merge(refs[begin + i - 1].bound);
+            const double cost = i * surfaceArea(leftBound) + rightCosts[i];
+            if (cost < bestCost) {
+                bestCost = cost;
+                mid = begin + i;
+            }
+        }
+    } else {
+        const BinMapping mapping{axis, centroidBound.lower_corner[axis], kNumberOfBins / centroidExtent[axis]};
+        const auto binRange = [refs, &mapping](size_t b, size_t e, Bins bins) {
+            for (size_t i = b; i < e; ++i) {
+                const size_t bin = mapping(refs[i].centroid);
+                bins.bounds[bin].bound.merge(refs[i].bound);
+                bins.bounds[bin].centroidBound.merge(refs[i].centroid);
+                ++bins.counts[bin];
+            }
+            return bins;
+        };
+        const Bins bins = isParallel ? parallelReduce(begin, end, Bins(), binRange,
+                                                      [](const Bins &a, const Bins &b) { return merge(a, b); })
+                                     : binRange(begin, end, Bins());
+
+        // Sweeps the bins from both sides to evaluate the cost of splitting
+        // after each bin.
+        double rightCosts[kNumberOfBins];
+        BoundingBox3D rightBound;
+        size_t rightCount = 0;
+        for (size_t bin = kNumberOfBins - 1; bin > 0; --bin) {
+            rightBound.merge(bins.bounds[bin].bound);
+            rightCount += bins.counts[bin];
+            rightCosts[bin] = rightCount * surfaceArea(rightBound);
+        }
+
+        double bestCost = std::numeric_limits<double>::max();
+        size_t bestSplit = 0;
+        BoundingBox3D leftBound;
+        size_t leftCount = 0;
+        for (size_t bin = 0; bin + 1 < kNumberOfBins; ++bin) {
+            leftBound.merge(bins.bounds[bin].bound);
+            leftCount += bins.counts[bin];
+            if (leftCount == 0 || leftCount == numItems) {
+                continue;
+            }
+            const double cost = leftCount * surfaceArea(leftBound) + rightCosts[bin + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = bin + 1;
+            }
+        }
+
+        // The extreme centroids fall in the first and last bins, so there is
+        // always a split with items on both sides.
+        ItemRef *midRef = std::partition(refs + begin, refs + end,
+                                         [&](const ItemRef &ref) { return mapping(ref.centroid) < bestSplit; });
+        mid = static_cast<size_t>(midRef - refs);
+
+        for (size_t bin = 0; bin < kNumberOfBins; ++bin) {
+            RangeBounds &childBound = childBounds[bin < bestSplit ? 0 : 1];
+            childBound = merge(childBound, bins.bounds[bin]);
+        }
+        hasChildBounds = true;
+    }
+
+    if (!hasChildBounds) {
+        childBounds[0] = computeRangeBounds(refs, begin, mid);
+        childBounds[1] = computeRangeBounds(refs, mid, end);
+    }
+
+    const size_t firstChild = context.numNodes.fetch_add(2, std::memory_order_relaxed);
+    node.firstChild = firstChild;
+    node.axis = axis;
+    context.nodes[firstChild].bound = childBounds[0].bound;
+    context.nodes[firstChild + 1].bound = childBounds[1].bound;
+
+    if (isParallel) {
+        TaskGroup group;
+        group.run([this, &context, firstChild, begin, mid, depth, centroidBound = childBounds[0].centroidBound]() {
+            buildNode(context, firstChild, begin, mid, depth + 1, centroidBound);
+        });
+        buildNode(context, firstChild + 1, mid, end, depth + 1, childBounds[1].centroidBound);
+        group.wait();
+    } else {
+        buildNode(context, firstChild, begin, mid, depth + 1, childBounds[0].centroidBound);
+        buildNode(context, firstChild + 1, mid, end, depth + 1, childBounds[1].centroidBound);
+    }
+}
+
+}  // namespace vox
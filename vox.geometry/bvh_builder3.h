@@ -0,0 +1,72 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "vox.math/bounding_box3.h"
+
+namespace vox {
+
+//! Algorithm used to split the items of a bounding volume hierarchy.
+enum class BvhBuildMethod {
+    //! Splits at the middle of the largest axis of the node bounding box.
+    kMidpoint,
+    //! Splits with the binned surface area heuristic, building subtrees in
+    //! parallel. Slower to build; whether queries get faster depends on the
+    //! distribution of the items.
+    kBinnedSah
+};
+
+//!
+//! \brief Parallel binned SAH builder of 3D bounding volume hierarchies.
+//!
+//! Items are binned by centroid along the axis where centroids spread the most,
+//! and split where the surface area heuristic cost is the lowest. Large nodes are binned in parallel and
+//! their subtrees are built as separate tasks. The resulting binary tree is
+//! stored depth-first: the first child of an internal node is the next node.
+//! Like Bvh3, each leaf holds a single item.
+//! Tree depth is kept below kMaxTreeDepth by falling back to median splits.
+//!
+class BvhBuilder3 final {
+public:
+    //! Depth that traversal stacks of built trees can rely on.
+    static constexpr size_t kMaxTreeDepth = 64;
+
+    struct Node {
+        BoundingBox3D bound;
+        //! Index of the second child for internal nodes, or index of the
+        //! item for leaves.
+        size_t index = 0;
+        //! Split axis of internal nodes, 3 for leaves.
+        uint8_t axis = 0;
+
+        [[nodiscard]] bool isLeaf() const { return axis == 3; }
+    };
+
+    //! Builds the hierarchy of items whose bounds are \p itemsBounds.
+    void build(const std::vector<BoundingBox3D> &itemsBounds);
+
+    //! Returns the nodes, the root being the first one.
+    [[nodiscard]] const std::vector<Node> &nodes() const;
+
+private:
+    struct BuildNode;
+    struct BuildContext;
+
+    std::vector<Node> _nodes;
+
+    void buildNode(BuildContext &context,
+                   size_t nodeIndex,
+                   size_t begin,
+                   size_t end,
+                   size_t depth,
+                   const BoundingBox3D &centroidBound) const;
+};
+
+}  // namespace vox
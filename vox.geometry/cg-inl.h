@@ -43,11 +43,8 @@ void pcg(const typename BlasType::MatrixType &A,
     unsigned int iter = 0;
     bool trigger = false;
     while (sigmaNew > square(tolerance) && iter < maxNumberOfIterations) {
-        // q = Ad
-        BlasType::mvm(A, *d, q);
-
-        // alpha = sigmaNew/d.q
-        double alpha = sigmaNew / BlasType::dot(*d, *q);
+        // q = Ad, alpha = sigmaNew/d.q
+        double alpha = sigmaNew / BlasType::mvmDot(A, *d, q);
 
         // x = x + alpha*d
         BlasType::axpy(alpha, *d, *x, x);
@@ -102,10 +99,60 @@ void cg(const typename BlasType::MatrixType &A,
         typename BlasType::VectorType *s,
         unsigned int *lastNumberOfIterations,
         double *lastResidualNorm) {
-    typedef NullCgPreconditioner<BlasType> PrecondType;
-    PrecondType precond;
-    pcg<BlasType, PrecondType>(A, b, maxNumberOfIterations, tolerance, &precond, x, r, d, q, s, lastNumberOfIterations,
-                               lastResidualNorm);
+    // Same iterations as pcg with NullCgPreconditioner, but since s = r the
+    // reductions are fused into the passes that write the vectors.
+
+    // Clear
+    BlasType::set(0, r);
+    BlasType::set(0, d);
+    BlasType::set(0, q);
+    BlasType::set(0, s);
+
+    // r = b - Ax, sigmaNew = r.r
+    double sigmaNew = BlasType::residualDot(A, *x, b, r);
+
+    // d = r
+    BlasType::set(*r, d);
+
+    unsigned int iter = 0;
+    bool trigger = false;
+    while (sigmaNew > square(tolerance) && iter < maxNumberOfIterations) {
+        // q = Ad, alpha = sigmaNew/d.q
+        double alpha = sigmaNew / BlasType::mvmDot(A, *d, q);
+
+        // x = x + alpha*d
+        BlasType::axpy(alpha, *d, *x, x);
+
+        // sigmaOld = sigmaNew
+        double sigmaOld = sigmaNew;
+
+        // if i is divisible by 50...
+        if (trigger || (iter % 50 == 0 && iter > 0)) {
+            // r = b - Ax, sigmaNew = r.r
+            sigmaNew = BlasType::residualDot(A, *x, b, r);
+            trigger = false;
+        } else {
+            // r = r - alpha*q, sigmaNew = r.r
+            sigmaNew = BlasType::axpyDot(-alpha, *q, *r, r);
+        }
+
+        if (sigmaNew > sigmaOld) {
+            trigger = true;
+        }
+
+        // beta = sigmaNew/sigmaOld
+        double beta = sigmaNew / sigmaOld;
+
+        // d = r + beta*d
+        BlasType::axpy(beta, *d, *r, d);
+
+        ++iter;
+    }
+
+    *lastNumberOfIterations = iter;
+
+    // std::fabs(sigmaNew) - Workaround for negative zero
+    *lastResidualNorm = std::sqrt(std::fabs(sigmaNew));
 }
 
 }  // namespace vox
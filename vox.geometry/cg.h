@@ -26,6 +26,9 @@ struct NullCgPreconditioner final {
 //!
 //! \brief Solves conjugate gradient.
 //!
+//! This function performs the same iterations as pcg with NullCgPreconditioner
+//! but uses the fused BLAS operators, so \p s is only cleared and left unused.
+//!
 template <typename BlasType>
 void cg(const typename BlasType::MatrixType &A,
         const typename BlasType::VectorType &b,
@@ -11,16 +11,18 @@
 
 using namespace vox;
 
-FdmCgSolver3::FdmCgSolver3(unsigned int maxNumberOfIterations, double tolerance)
+template <typename T>
+FdmCgSolver<T, 3>::FdmCgSolver(unsigned int maxNumberOfIterations, double tolerance)
     : _maxNumberOfIterations(maxNumberOfIterations),
       _lastNumberOfIterations(0),
       _tolerance(tolerance),
       _lastResidual(kMaxD) {}
 
-bool FdmCgSolver3::solve(FdmLinearSystem3 *system) {
-    FdmMatrix3 &matrix = system->A;
-    FdmVector3 &solution = system->x;
-    FdmVector3 &rhs = system->b;
+template <typename T>
+bool FdmCgSolver<T, 3>::solve(FdmLinearSystem<T, 3> *system) {
+    auto &matrix = system->A;
+    auto &solution = system->x;
+    auto &rhs = system->b;
 
     VOX_ASSERT(matrix.size() == rhs.size());
     VOX_ASSERT(matrix.size() == solution.size());
@@ -33,22 +35,23 @@ bool FdmCgSolver3::solve(FdmLinearSystem3 *system) {
     _q.resize(size);
     _s.resize(size);
 
-    system->x.set(0.0);
-    _r.set(0.0);
-    _d.set(0.0);
-    _q.set(0.0);
-    _s.set(0.0);
+    system->x.set(0);
+    _r.set(0);
+    _d.set(0);
+    _q.set(0);
+    _s.set(0);
 
-    cg<FdmBlas3>(matrix, rhs, _maxNumberOfIterations, _tolerance, &solution, &_r, &_d, &_q, &_s,
-                 &_lastNumberOfIterations, &_lastResidual);
+    cg<FdmBlas<T, 3>>(matrix, rhs, _maxNumberOfIterations, _tolerance, &solution, &_r, &_d, &_q, &_s,
+                      &_lastNumberOfIterations, &_lastResidual);
 
     return _lastResidual <= _tolerance || _lastNumberOfIterations < _maxNumberOfIterations;
 }
 
-bool FdmCgSolver3::solveCompressed(FdmCompressedLinearSystem3 *system) {
-    MatrixCsrD &matrix = system->A;
-    VectorND &solution = system->x;
-    VectorND &rhs = system->b;
+template <typename T>
+bool FdmCgSolver<T, 3>::solveCompressed(FdmCompressedLinearSystem<T, 3> *system) {
+    auto &matrix = system->A;
+    auto &solution = system->x;
+    auto &rhs = system->b;
 
     clearUncompressedVectors();
 
@@ -58,36 +61,86 @@ bool FdmCgSolver3::solveCompressed(FdmCompressedLinearSystem3 *system) {
     _qComp.resize(size);
     _sComp.resize(size);
 
-    system->x.set(0.0);
-    _rComp.set(0.0);
-    _dComp.set(0.0);
-    _qComp.set(0.0);
-    _sComp.set(0.0);
+    system->x.set(0);
+    _rComp.set(0);
+    _dComp.set(0);
+    _qComp.set(0);
+    _sComp.set(0);
 
-    cg<FdmCompressedBlas3>(matrix, rhs, _maxNumberOfIterations, _tolerance, &solution, &_rComp, &_dComp, &_qComp,
-                           &_sComp, &_lastNumberOfIterations, &_lastResidual);
+    cg<FdmCompressedBlas<T, 3>>(matrix, rhs, _maxNumberOfIterations, _tolerance, &solution, &_rComp, &_dComp,
+                                &_qComp, &_sComp, &_lastNumberOfIterations, &_lastResidual);
 
     return _lastResidual <= _tolerance || _lastNumberOfIterations < _maxNumberOfIterations;
 }
 
-unsigned int FdmCgSolver3::maxNumberOfIterations() const { return _maxNumberOfIterations; }
+template <typename T>
+bool FdmCgSolver<T, 3>::solveMatrixFree(FdmMatrixFreeLinearSystem<T, 3> *system) {
+    auto &matrix = system->A;
+    auto &solution = system->x;
+    auto &rhs = system->b;
 
-unsigned int FdmCgSolver3::lastNumberOfIterations() const { return _lastNumberOfIterations; }
+    VOX_ASSERT(matrix.size() == rhs.size());
+    VOX_ASSERT(matrix.size() == solution.size());
+
+    clearCompressedVectors();
+
+    Size3 size = matrix.size();
+    _r.resize(size);
+    _d.resize(size);
+    _q.resize(size);
+    _s.resize(size);
+
+    system->x.set(0);
+    _r.set(0);
+    _d.set(0);
+    _q.set(0);
+    _s.set(0);
+
+    cg<FdmMatrixFreeBlas<T, 3>>(matrix, rhs, _maxNumberOfIterations, _tolerance, &solution, &_r, &_d, &_q, &_s,
+                                &_lastNumberOfIterations, &_lastResidual);
 
-double FdmCgSolver3::tolerance() const { return _tolerance; }
+    return _lastResidual <= _tolerance || _lastNumberOfIterations < _maxNumberOfIterations;
+}
+
+template <typename T>
+unsigned int FdmCgSolver<T, 3>::maxNumberOfIterations() const {
+    return _maxNumberOfIterations;
+}
+
+template <typename T>
+unsigned int FdmCgSolver<T, 3>::lastNumberOfIterations() const {
+    return _lastNumberOfIterations;
+}
 
-double FdmCgSolver3::lastResidual() const { return _lastResidual; }
+template <typename T>
+double FdmCgSolver<T, 3>::tolerance() const {
+    return _tolerance;
+}
+
+template <typename T>
+double FdmCgSolver<T, 3>::lastResidual() const {
+    return _lastResidual;
+}
 
-void FdmCgSolver3::clearUncompressedVectors() {
+template <typename T>
+void FdmCgSolver<T, 3>::clearUncompressedVectors() {
     _r.clear();
     _d.clear();
     _q.clear();
     _s.clear();
 }
 
-void FdmCgSolver3::clearCompressedVectors() {
+template <typename T>
+void FdmCgSolver<T, 3>::clearCompressedVectors() {
     _rComp.clear();
     _dComp.clear();
     _qComp.clear();
     _sComp.clear();
 }
+
+namespace vox {
+
+template class FdmCgSolver<float, 3>;
+template class FdmCgSolver<double, 3>;
+
+}  // namespace vox
@@ -10,18 +10,32 @@
 
 namespace vox {
 
+//! \brief Finite difference-type linear system solver using conjugate
+//!        gradient, specialized for each dimension.
+template <typename T, size_t N>
+class FdmCgSolver;
+
 //! \brief 3-D finite difference-type linear system solver using conjugate
 //!        gradient.
-class FdmCgSolver3 final : public FdmLinearSystemSolver3 {
+template <typename T>
+class FdmCgSolver<T, 3> final : public FdmLinearSystemSolver<T, 3> {
 public:
     //! Constructs the solver with given parameters.
-    FdmCgSolver3(unsigned int maxNumberOfIterations, double tolerance);
+    FdmCgSolver(unsigned int maxNumberOfIterations, double tolerance);
 
     //! Solves the given linear system.
-    bool solve(FdmLinearSystem3 *system) override;
+    bool solve(FdmLinearSystem<T, 3> *system) override;
 
     //! Solves the given compressed linear system.
-    bool solveCompressed(FdmCompressedLinearSystem3 *system) override;
+    bool solveCompressed(FdmCompressedLinearSystem<T, 3> *system) override;
+
+    //!
+    //! \brief Solves the given matrix-free linear system.
+    //!
+    //! The matrix is applied from the cell markers on the fly, which saves the
+    //! memory traffic of reading FdmMatrixRow per cell in each iteration.
+    //!
+    bool solveMatrixFree(FdmMatrixFreeLinearSystem<T, 3> *system);
 
     //! Returns the max number of CG iterations.
     [[nodiscard]] unsigned int maxNumberOfIterations() const;
@@ -42,23 +56,32 @@ private:
     double _lastResidual;
 
     // Uncompressed vectors
-    FdmVector3 _r;
-    FdmVector3 _d;
-    FdmVector3 _q;
-    FdmVector3 _s;
+    Array3<T> _r;
+    Array3<T> _d;
+    Array3<T> _q;
+    Array3<T> _s;
 
     // Compressed vectors
-    VectorND _rComp;
-    VectorND _dComp;
-    VectorND _qComp;
-    VectorND _sComp;
+    VectorN<T> _rComp;
+    VectorN<T> _dComp;
+    VectorN<T> _qComp;
+    VectorN<T> _sComp;
 
     void clearUncompressedVectors();
 
     void clearCompressedVectors();
 };
 
+//! Double-precision 3-D conjugate gradient solver.
+typedef FdmCgSolver<double, 3> FdmCgSolver3;
+
+//! Single-precision 3-D conjugate gradient solver.
+typedef FdmCgSolver<float, 3> FdmCgSolver3F;
+
 //! Shared pointer type for the FdmCgSolver3.
 typedef std::shared_ptr<FdmCgSolver3> FdmCgSolver3Ptr;
 
+//! Shared pointer type for the FdmCgSolver3F.
+typedef std::shared_ptr<FdmCgSolver3F> FdmCgSolver3FPtr;
+
 }  // namespace vox
\ No newline at end of file
@@ -6,10 +6,37 @@
 
 #include "vox.geometry/fdm_gauss_seidel_solver3.h"
 
+#include <algorithm>
+
 #include "vox.base/constants.h"
+#include "vox.base/parallel.h"
 
 using namespace vox;
 
+namespace {
+
+// Returns the SOR update of x(i, j, k) from its current neighbor values.
+template <typename T>
+T relaxedValue(const Array3<FdmMatrixRow<T, 3>> &A,
+               const Array3<T> &b,
+               const Array3<T> &x,
+               const Size3 &size,
+               T w,
+               size_t i,
+               size_t j,
+               size_t k) {
+    T r = ((i > 0) ? A(i - 1, j, k).right * x(i - 1, j, k) : 0) +
+          ((i + 1 < size.x) ? A(i, j, k).right * x(i + 1, j, k) : 0) +
+          ((j > 0) ? A(i, j - 1, k).up * x(i, j - 1, k) : 0) +
+          ((j + 1 < size.y) ? A(i, j, k).up * x(i, j + 1, k) : 0) +
+          ((k > 0) ? A(i, j, k - 1).front * x(i, j, k - 1) : 0) +
+          ((k + 1 < size.z) ? A(i, j, k).front * x(i, j, k + 1) : 0);
+
+    return (1 - w) * x(i, j, k) + w * (b(i, j, k) - r) / A(i, j, k).center;
+}
+
+}  // namespace
+
 FdmGaussSeidelSolver3::FdmGaussSeidelSolver3(unsigned int maxNumberOfIterations,
                                              unsigned int residualCheckInterval,
                                              double tolerance,
@@ -91,19 +118,24 @@ double FdmGaussSeidelSolver3::sorFactor() const { return _sorFactor; }
 
 bool FdmGaussSeidelSolver3::useRedBlackOrdering() const { return _useRedBlackOrdering; }
 
-void FdmGaussSeidelSolver3::relax(const FdmMatrix3 &A, const FdmVector3 &b, double sorFactor, FdmVector3 *x_) {
+template <typename T>
+void FdmGaussSeidelSolver3::relax(const Array3<FdmMatrixRow<T, 3>> &A,
+                                  const Array3<T> &b,
+                                  double sorFactor,
+                                  Array3<T> *x_) {
     Size3 size = A.size();
-    FdmVector3 &x = *x_;
+    Array3<T> &x = *x_;
+    const auto w = static_cast<T>(sorFactor);
 
     A.forEachIndex([&](size_t i, size_t j, size_t k) {
-        double r = ((i > 0) ? A(i - 1, j, k).right * x(i - 1, j, k) : 0.0) +
-                   ((i + 1 < size.x) ? A(i, j, k).right * x(i + 1, j, k) : 0.0) +
-                   ((j > 0) ? A(i, j - 1, k).up * x(i, j - 1, k) : 0.0) +
-                   ((j + 1 < size.y) ? A(i, j, k).up * x(i, j + 1, k) : 0.0) +
-                   ((k > 0) ? A(i, j, k - 1).front * x(i, j, k - 1) : 0.0) +
-                   ((k + 1 < size.z) ? A(i, j, k).front * x(i, j, k + 1) : 0.0);
-
-        x(i, j, k) = (1.0 - sorFactor) * x(i, j, k) + sorFactor * (b(i, j, k) - r) / A(i, j, k).center;
+        T r = ((i > 0) ? A(i - 1, j, k).right * x(i - 1, j, k) : 0) +
+              ((i + 1 < size.x) ? A(i, j, k).right * x(i + 1, j, k) : 0) +
+              ((j > 0) ? A(i, j - 1, k).up * x(i, j - 1, k) : 0) +
+              ((j + 1 < size.y) ? A(i, j, k).up * x(i, j + 1, k) : 0) +
+              ((k > 0) ? A(i, j, k - 1).front * x(i, j, k - 1) : 0) +
+              ((k + 1 < size.z) ? A(i, j, k).front * x(i, j, k + 1) : 0);
+
+        x(i, j, k) = (1 - w) * x(i, j, k) + w * (b(i, j, k) - r) / A(i, j, k).center;
     });
 }
 
@@ -134,26 +166,23 @@ void FdmGaussSeidelSolver3::relax(const MatrixCsrD &A, const VectorND &b, double
     });
 }
 
-void FdmGaussSeidelSolver3::relaxRedBlack(const FdmMatrix3 &A, const FdmVector3 &b, double sorFactor, FdmVector3 *x_) {
+template <typename T>
+void FdmGaussSeidelSolver3::relaxRedBlack(const Array3<FdmMatrixRow<T, 3>> &A,
+                                          const Array3<T> &b,
+                                          double sorFactor,
+                                          Array3<T> *x_) {
     Size3 size = A.size();
-    FdmVector3 &x = *x_;
+    Array3<T> &x = *x_;
+    const auto w = static_cast<T>(sorFactor);
 
     // Red update
     parallelRangeFor(kZeroSize, size.x, kZeroSize, size.y, kZeroSize, size.z,
                      [&](size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd) {
                          for (size_t k = kBegin; k < kEnd; ++k) {
                              for (size_t j = jBegin; j < jEnd; ++j) {
-                                 size_t i = (j + k) % 2 + iBegin;  // i.e. (0, 0, 0)
+                                 size_t i = iBegin + (iBegin + j + k) % 2;  // i.e. (0, 0, 0)
                                  for (; i < iEnd; i += 2) {
-                                     double r = ((i > 0) ? A(i - 1, j, k).right * x(i - 1, j, k) : 0.0) +
-                                                ((i + 1 < size.x) ? A(i, j, k).right * x(i + 1, j, k) : 0.0) +
-                                                ((j > 0) ? A(i, j - 1, k).up * x(i, j - 1, k) : 0.0) +
-                                                ((j + 1 < size.y) ? A(i, j, k).up * x(i, j + 1, k) : 0.0) +
-                                                ((k > 0) ? A(i, j, k - 1).front * x(i, j, k - 1) : 0.0) +
-                                                ((k + 1 < size.z) ? A(i, j, k).front * x(i, j, k + 1) : 0.0);
-
-                                     x(i, j, k) = (1.0 - sorFactor) * x(i, j, k) +
-                                                  sorFactor * (b(i, j, k) - r) / A(i, j, k).center;
+                                     x(i, j, k) = relaxedValue(A, b, x, size, w, i, j, k);
                                  }
                              }
                          }
@@ -164,23 +193,73 @@ void FdmGaussSeidelSolver3::relaxRedBlack(const FdmMatrix3 &A, const FdmVector3
                      [&](size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd) {
                          for (size_t k = kBegin; k < kEnd; ++k) {
                              for (size_t j = jBegin; j < jEnd; ++j) {
-                                 size_t i = 1 - (j + k) % 2 + iBegin;  // i.e. (1, 1, 1)
+                                 size_t i = iBegin + (iBegin + j + k + 1) % 2;  // i.e. (1, 1, 1)
                                  for (; i < iEnd; i += 2) {
-                                     double r = ((i > 0) ? A(i - 1, j, k).right * x(i - 1, j, k) : 0.0) +
-                                                ((i + 1 < size.x) ? A(i, j, k).right * x(i + 1, j, k) : 0.0) +
-                                                ((j > 0) ? A(i, j - 1, k).up * x(i, j - 1, k) : 0.0) +
-                                                ((j + 1 < size.y) ? A(i, j, k).up * x(i, j + 1, k) : 0.0) +
-                                                ((k > 0) ? A(i, j, k - 1).front * x(i, j, k - 1) : 0.0) +
-                                                ((k + 1 < size.z) ? A(i, j, k).front * x(i, j, k + 1) : 0.0);
-
-                                     x(i, j, k) = (1.0 - sorFactor) * x(i, j, k) +
-                                                  sorFactor * (b(i, j, k) - r) / A(i, j, k).center;
+                                     x(i, j, k) = relaxedValue(A, b, x, size, w, i, j, k);
                                  }
                              }
                          }
                      });
 }
 
+template <typename T>
+void FdmGaussSeidelSolver3::relaxRedBlack(const Array3<FdmMatrixRow<T, 3>> &A,
+                                          const Array3<T> &b,
+                                          double sorFactor,
+                                          unsigned int numberOfIterations,
+                                          Array3<T> *x_) {
+    Size3 size = A.size();
+    Array3<T> &x = *x_;
+    const auto w = static_cast<T>(sorFactor);
+
+    // Stage s updates the color s % 2 (red first) of iteration s / 2. Stage s
+    // of plane k only reads the other color of planes k - 1, k, and k + 1,
+    // which stage s - 1 has written, and stage s + 1 of those planes must not
+    // have overwritten it yet. Thus stage s of plane k runs at step k + 2 * s:
+    // the planes active in one step are two apart, so they neither read nor
+    // write each other's cells and one parallel loop covers all of them. This
+    // takes size.z + 2 * (numberOfStages - 1) loops instead of one per stage
+    // and plane. Only the planes behind the front are touched, so they stay
+    // in cache across the iterations, and each cell sees the same neighbor
+    // values as in the sweeps done one after another.
+    const size_t numberOfStages = 2 * static_cast<size_t>(numberOfIterations);
+    if (numberOfStages == 0 || size.z == 0) {
+        return;
+    }
+
+    const size_t numberOfSteps = size.z + 2 * (numberOfStages - 1);
+    for (size_t step = 0; step < numberOfSteps; ++step) {
+        // Stages whose plane step - 2 * stage lies in [0, size.z)
+        const size_t firstStage = step < size.z ? 0 : (step - size.z + 2) / 2;
+        const size_t lastStage = std::min(numberOfStages - 1, step / 2);
+        const size_t numberOfRows = (lastStage - firstStage + 1) * size.y;
+
+        parallelRangeFor(kZeroSize, numberOfRows, [&](size_t rowBegin, size_t rowEnd) {
+            for (size_t row = rowBegin; row < rowEnd; ++row) {
+                const size_t stage = firstStage + row / size.y;
+                const size_t j = row % size.y;
+                const size_t k = step - 2 * stage;
+                for (size_t i = (j + k + stage) % 2; i < size.x; i += 2) {
+                    x(i, j, k) = relaxedValue(A, b, x, size, w, i, j, k);
+                }
+            }
+        });
+    }
+}
+
 void FdmGaussSeidelSolver3::clearUncompressedVectors() { _residual.clear(); }
 
 void FdmGaussSeidelSolver3::clearCompressedVectors() { _residualComp.clear(); }
+
+namespace vox {
+
+template void FdmGaussSeidelSolver3::relax(const FdmMatrix3F &, const FdmVector3F &, double, FdmVector3F *);
+template void FdmGaussSeidelSolver3::relax(const FdmMatrix3 &, const FdmVector3 &, double, FdmVector3 *);
+template void FdmGaussSeidelSolver3::relaxRedBlack(const FdmMatrix3F &, const FdmVector3F &, double, FdmVector3F *);
+template void FdmGaussSeidelSolver3::relaxRedBlack(const FdmMatrix3 &, const FdmVector3 &, double, FdmVector3 *);
+template void FdmGaussSeidelSolver3::relaxRedBlack(
+        const FdmMatrix3F &, const FdmVector3F &, double, unsigned int, FdmVector3F *);
+template void FdmGaussSeidelSolver3::relaxRedBlack(
+        const FdmMatrix3 &, const FdmVector3 &, double, unsigned int, FdmVector3 *);
+
+}  // namespace vox
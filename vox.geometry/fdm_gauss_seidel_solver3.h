@@ -45,15 +45,39 @@ public:
     //! Returns true if red-black ordering is enabled.
     [[nodiscard]] bool useRedBlackOrdering() const;
 
-    //! Performs single natural Gauss-Seidel relaxation step.
-    static void relax(const FdmMatrix3 &A, const FdmVector3 &b, double sorFactor, FdmVector3 *x);
+    //! Performs single natural Gauss-Seidel relaxation step in either
+    //! precision.
+    template <typename T>
+    static void relax(const Array3<FdmMatrixRow<T, 3>> &A, const Array3<T> &b, double sorFactor, Array3<T> *x);
 
     //! \brief Performs single natural Gauss-Seidel relaxation step for
     //!        compressed sys.
     static void relax(const MatrixCsrD &A, const VectorND &b, double sorFactor, VectorND *x);
 
-    //! Performs single Red-Black Gauss-Seidel relaxation step.
-    static void relaxRedBlack(const FdmMatrix3 &A, const FdmVector3 &b, double sorFactor, FdmVector3 *x);
+    //! Performs single Red-Black Gauss-Seidel relaxation step in either
+    //! precision.
+    template <typename T>
+    static void relaxRedBlack(const Array3<FdmMatrixRow<T, 3>> &A,
+                              const Array3<T> &b,
+                              double sorFactor,
+                              Array3<T> *x);
+
+    //!
+    //! \brief Performs \p numberOfIterations Red-Black Gauss-Seidel relaxation
+    //!        steps with temporal blocking.
+    //!
+    //! The result is the same as calling relaxRedBlack \p numberOfIterations
+    //! times, but the sweeps are pipelined along the k-planes so that the grid
+    //! is streamed from memory once instead of once per sweep. Each pipeline
+    //! step is a single parallel loop over the active planes, so a call has
+    //! about nz + 4 * \p numberOfIterations barriers.
+    //!
+    template <typename T>
+    static void relaxRedBlack(const Array3<FdmMatrixRow<T, 3>> &A,
+                              const Array3<T> &b,
+                              double sorFactor,
+                              unsigned int numberOfIterations,
+                              Array3<T> *x);
 
 private:
     unsigned int _maxNumberOfIterations;
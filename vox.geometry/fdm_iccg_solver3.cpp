@@ -6,12 +6,90 @@
 
 #include "vox.geometry/fdm_iccg_solver3.h"
 
+#include <algorithm>
+
 #include "vox.base/constants.h"
 #include "vox.base/logging.h"
+#include "vox.base/parallel.h"
 #include "vox.geometry/cg.h"
 
 using namespace vox;
 
+namespace {
+
+// Row (j, k) of the structured matrix only depends on rows (j - 1, k) and
+// (j, k - 1), so the rows on each anti-diagonal j + k can be swept in parallel
+// once the previous anti-diagonal is done. The backward sweep visits the
+// anti-diagonals in reverse order.
+template <typename Function>
+void forEachRowInWavefronts(size_t sy, size_t sz, bool reverse, const Function &func) {
+    if (sy == 0 || sz == 0) {
+        return;
+    }
+
+    const size_t numberOfLevels = sy + sz - 1;
+    for (size_t l = 0; l < numberOfLevels; ++l) {
+        const size_t level = reverse ? numberOfLevels - 1 - l : l;
+        const size_t kBegin = (level >= sy) ? level - sy + 1 : 0;
+        const size_t kEnd = std::min(level + 1, sz);
+        parallelFor(kBegin, kEnd, [&](size_t k) { func(level - k, k); });
+    }
+}
+
+// Groups the rows of the compressed matrix by their depth in the dependency
+// graph of the lower (or upper) triangle. Rows of the same level don't depend
+// on each other.
+void buildLevels(const MatrixCsrD &matrix,
+                 bool lower,
+                 std::vector<size_t> *levelPointers,
+                 std::vector<size_t> *levelRows) {
+    const size_t n = matrix.rows();
+    const auto rp = matrix.rowPointersBegin();
+    const auto ci = matrix.columnIndicesBegin();
+
+    std::vector<size_t> levels(n, 0);
+    size_t numberOfLevels = 0;
+    for (size_t r = 0; r < n; ++r) {
+        const size_t i = lower ? r : n - 1 - r;
+
+        size_t level = 0;
+        for (size_t jj = rp[i]; jj < rp[i + 1]; ++jj) {
+            const size_t j = ci[jj];
+            if (lower ? j < i : j > i) {
+                level = std::max(level, levels[j] + 1);
+            }
+        }
+
+        levels[i] = level;
+        numberOfLevels = std::max(numberOfLevels, level + 1);
+    }
+
+    levelPointers->assign(numberOfLevels + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        ++(*levelPointers)[levels[i] + 1];
+    }
+    for (size_t l = 0; l < numberOfLevels; ++l) {
+        (*levelPointers)[l + 1] += (*levelPointers)[l];
+    }
+
+    std::vector<size_t> offsets(levelPointers->begin(), levelPointers->end() - 1);
+    levelRows->resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        (*levelRows)[offsets[levels[i]]++] = i;
+    }
+}
+
+template <typename Function>
+void forEachRowInLevels(const std::vector<size_t> &levelPointers,
+                        const std::vector<size_t> &levelRows,
+                        const Function &func) {
+    for (size_t l = 0; l + 1 < levelPointers.size(); ++l) {
+        parallelFor(levelPointers[l], levelPointers[l + 1], [&](size_t r) { func(levelRows[r]); });
+    }
+}
+
+}  // namespace
+
 void FdmIccgSolver3::Preconditioner::build(const FdmMatrix3 &matrix) {
     Size3 size = matrix.size();
     A = matrix.constAccessor();
@@ -19,15 +97,18 @@ void FdmIccgSolver3::Preconditioner::build(const FdmMatrix3 &matrix) {
     d.resize(size, 0.0);
     y.resize(size, 0.0);
 
-    matrix.forEachIndex([&](size_t i, size_t j, size_t k) {
-        double denom = matrix(i, j, k).center - ((i > 0) ? square(matrix(i - 1, j, k).right) * d(i - 1, j, k) : 0.0) -
-                       ((j > 0) ? square(matrix(i, j - 1, k).up) * d(i, j - 1, k) : 0.0) -
-                       ((k > 0) ? square(matrix(i, j, k - 1).front) * d(i, j, k - 1) : 0.0);
-
-        if (std::fabs(denom) > 0.0) {
-            d(i, j, k) = 1.0 / denom;
-        } else {
-            d(i, j, k) = 0.0;
+    forEachRowInWavefronts(size.y, size.z, false, [&](size_t j, size_t k) {
+        for (size_t i = 0; i < size.x; ++i) {
+            double denom = matrix(i, j, k).center -
+                           ((i > 0) ? square(matrix(i - 1, j, k).right) * d(i - 1, j, k) : 0.0) -
+                           ((j > 0) ? square(matrix(i, j - 1, k).up) * d(i, j - 1, k) : 0.0) -
+                           ((k > 0) ? square(matrix(i, j, k - 1).front) * d(i, j, k - 1) : 0.0);
+
+            if (std::fabs(denom) > 0.0) {
+                d(i, j, k) = 1.0 / denom;
+            } else {
+                d(i, j, k) = 0.0;
+            }
         }
     });
 }
@@ -38,23 +119,25 @@ void FdmIccgSolver3::Preconditioner::solve(const FdmVector3 &b, FdmVector3 *x) {
     auto sy = static_cast<ssize_t>(size.y);
     auto sz = static_cast<ssize_t>(size.z);
 
-    b.forEachIndex([&](size_t i, size_t j, size_t k) {
-        y(i, j, k) = (b(i, j, k) - ((i > 0) ? A(i - 1, j, k).right * y(i - 1, j, k) : 0.0) -
-                      ((j > 0) ? A(i, j - 1, k).up * y(i, j - 1, k) : 0.0) -
-                      ((k > 0) ? A(i, j, k - 1).front * y(i, j, k - 1) : 0.0)) *
-                     d(i, j, k);
+    forEachRowInWavefronts(size.y, size.z, false, [&](size_t j, size_t k) {
+        for (size_t i = 0; i < size.x; ++i) {
+            y(i, j, k) = (b(i, j, k) - ((i > 0) ? A(i - 1, j, k).right * y(i - 1, j, k) : 0.0) -
+                          ((j > 0) ? A(i, j - 1, k).up * y(i, j - 1, k) : 0.0) -
+                          ((k > 0) ? A(i, j, k - 1).front * y(i, j, k - 1) : 0.0)) *
+                         d(i, j, k);
+        }
     });
 
-    for (ssize_t k = sz - 1; k >= 0; --k) {
-        for (ssize_t j = sy - 1; j >= 0; --j) {
-            for (ssize_t i = sx - 1; i >= 0; --i) {
-                (*x)(i, j, k) = (y(i, j, k) - ((i + 1 < sx) ? A(i, j, k).right * (*x)(i + 1, j, k) : 0.0) -
-                                 ((j + 1 < sy) ? A(i, j, k).up * (*x)(i, j + 1, k) : 0.0) -
-                                 ((k + 1 < sz) ? A(i, j, k).front * (*x)(i, j, k + 1) : 0.0)) *
-                                d(i, j, k);
-            }
+    forEachRowInWavefronts(size.y, size.z, true, [&](size_t j_, size_t k_) {
+        auto j = static_cast<ssize_t>(j_);
+        auto k = static_cast<ssize_t>(k_);
+        for (ssize_t i = sx - 1; i >= 0; --i) {
+            (*x)(i, j, k) = (y(i, j, k) - ((i + 1 < sx) ? A(i, j, k).right * (*x)(i + 1, j, k) : 0.0) -
+                             ((j + 1 < sy) ? A(i, j, k).up * (*x)(i, j + 1, k) : 0.0) -
+                             ((k + 1 < sz) ? A(i, j, k).front * (*x)(i, j, k + 1) : 0.0)) *
+                            d(i, j, k);
         }
-    }
+    });
 }
 
 //
@@ -66,11 +149,14 @@ void FdmIccgSolver3::PreconditionerCompressed::build(const MatrixCsrD &matrix) {
     d.resize(size, 0.0);
     y.resize(size, 0.0);
 
+    buildLevels(matrix, true, &lowerLevelPointers, &lowerLevelRows);
+    buildLevels(matrix, false, &upperLevelPointers, &upperLevelRows);
+
     const auto rp = A->rowPointersBegin();
     const auto ci = A->columnIndicesBegin();
     const auto nnz = A->nonZeroBegin();
 
-    d.forEachIndex([&](size_t i) {
+    forEachRowInLevels(lowerLevelPointers, lowerLevelRows, [&](size_t i) {
         const size_t rowBegin = rp[i];
         const size_t rowEnd = rp[i + 1];
 
@@ -94,13 +180,11 @@ void FdmIccgSolver3::PreconditionerCompressed::build(const MatrixCsrD &matrix) {
 }
 
 void FdmIccgSolver3::PreconditionerCompressed::solve(const VectorND &b, VectorND *x) {
-    const auto size = static_cast<ssize_t>(b.size());
-
     const auto rp = A->rowPointersBegin();
     const auto ci = A->columnIndicesBegin();
     const auto nnz = A->nonZeroBegin();
 
-    b.forEachIndex([&](size_t i) {
+    forEachRowInLevels(lowerLevelPointers, lowerLevelRows, [&](size_t i) {
         const size_t rowBegin = rp[i];
         const size_t rowEnd = rp[i + 1];
 
@@ -116,13 +200,13 @@ void FdmIccgSolver3::PreconditionerCompressed::solve(const VectorND &b, VectorND
         y[i] = sum * d[i];
     });
 
-    for (ssize_t i = size - 1; i >= 0; --i) {
+    forEachRowInLevels(upperLevelPointers, upperLevelRows, [&](size_t i) {
         const size_t rowBegin = rp[i];
         const size_t rowEnd = rp[i + 1];
 
         double sum = y[i];
         for (size_t jj = rowBegin; jj < rowEnd; ++jj) {
-            auto j = static_cast<ssize_t>(ci[jj]);
+            size_t j = ci[jj];
 
             if (j > i) {
                 sum -= nnz[jj] * (*x)[j];
@@ -130,7 +214,7 @@ void FdmIccgSolver3::PreconditionerCompressed::solve(const VectorND &b, VectorND
         }
 
         (*x)[i] = sum * d[i];
-    }
+    });
 }
 
 //
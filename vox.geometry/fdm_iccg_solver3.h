@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "vox.geometry/fdm_cg_solver3.h"
 
 namespace vox {
@@ -14,6 +16,10 @@ namespace vox {
 //! \brief 3-D finite difference-type linear system solver using incomplete
 //!        Cholesky conjugate gradient (ICCG).
 //!
+//! The triangular solves of the preconditioner are scheduled in wavefronts of
+//! independent rows which run in parallel. The result is identical to the
+//! sequential sweep.
+//!
 class FdmIccgSolver3 final : public FdmLinearSystemSolver3 {
 public:
     //! Constructs the solver with given parameters.
@@ -53,6 +59,12 @@ private:
         VectorND d;
         VectorND y;
 
+        // Rows grouped by dependency level of the lower and upper triangles.
+        std::vector<size_t> lowerLevelPointers;
+        std::vector<size_t> lowerLevelRows;
+        std::vector<size_t> upperLevelPointers;
+        std::vector<size_t> upperLevelRows;
+
         void build(const MatrixCsrD &matrix);
 
         void solve(const VectorND &b, VectorND *x);
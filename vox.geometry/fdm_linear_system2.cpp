@@ -98,6 +98,21 @@ void FdmBlas2::residual(const FdmMatrix2 &a, const FdmVector2 &x, const FdmVecto
     });
 }
 
+double FdmBlas2::mvmDot(const FdmMatrix2 &m, const FdmVector2 &v, FdmVector2 *result) {
+    mvm(m, v, result);
+    return dot(v, *result);
+}
+
+double FdmBlas2::residualDot(const FdmMatrix2 &a, const FdmVector2 &x, const FdmVector2 &b, FdmVector2 *result) {
+    residual(a, x, b, result);
+    return dot(*result, *result);
+}
+
+double FdmBlas2::axpyDot(double a, const FdmVector2 &x, const FdmVector2 &y, FdmVector2 *result) {
+    axpy(a, x, y, result);
+    return dot(*result, *result);
+}
+
 double FdmBlas2::l2Norm(const FdmVector2 &v) { return std::sqrt(dot(v, v)); }
 
 double FdmBlas2::lInfNorm(const FdmVector2 &v) {
@@ -168,6 +183,24 @@ void FdmCompressedBlas2::residual(const MatrixCsrD &a, const VectorND &x, const
     });
 }
 
+double FdmCompressedBlas2::mvmDot(const MatrixCsrD &m, const VectorND &v, VectorND *result) {
+    mvm(m, v, result);
+    return dot(v, *result);
+}
+
+double FdmCompressedBlas2::residualDot(const MatrixCsrD &a,
+                                       const VectorND &x,
+                                       const VectorND &b,
+                                       VectorND *result) {
+    residual(a, x, b, result);
+    return dot(*result, *result);
+}
+
+double FdmCompressedBlas2::axpyDot(double a, const VectorND &x, const VectorND &y, VectorND *result) {
+    axpy(a, x, y, result);
+    return dot(*result, *result);
+}
+
 double FdmCompressedBlas2::l2Norm(const VectorND &v) { return std::sqrt(v.dot(v)); }
 
 double FdmCompressedBlas2::lInfNorm(const VectorND &v) { return std::fabs(v.absmax()); }
@@ -95,6 +95,15 @@ struct FdmBlas2 {
     //! Computes residual vector (b - ax).
     static void residual(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
 
+    //! Performs matrix-vector multiplication and returns \p v dot \p result.
+    static double mvmDot(const MatrixType &m, const VectorType &v, VectorType *result);
+
+    //! Computes residual vector (b - ax) and returns its squared L2-norm.
+    static double residualDot(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
+
+    //! Performs ax + y operation and returns the squared L2-norm of \p result.
+    static double axpyDot(double a, const VectorType &x, const VectorType &y, VectorType *result);
+
     //! Returns L2-norm of the given vector \p v.
     static ScalarType l2Norm(const VectorType &v);
 
@@ -133,6 +142,15 @@ struct FdmCompressedBlas2 {
     //! Computes residual vector (b - ax).
     static void residual(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
 
+    //! Performs matrix-vector multiplication and returns \p v dot \p result.
+    static double mvmDot(const MatrixType &m, const VectorType &v, VectorType *result);
+
+    //! Computes residual vector (b - ax) and returns its squared L2-norm.
+    static double residualDot(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
+
+    //! Performs ax + y operation and returns the squared L2-norm of \p result.
+    static double axpyDot(double a, const VectorType &x, const VectorType &y, VectorType *result);
+
     //! Returns L2-norm of the given vector \p v.
     static ScalarType l2Norm(const VectorType &v);
 
@@ -6,17 +6,135 @@
 
 #include "vox.geometry/fdm_linear_system3.h"
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "vox.base/parallel.h"
 #include "vox.math/math_utils.h"
 
 using namespace vox;
 
-void FdmLinearSystem3::clear() {
+namespace {
+
+// Number of CSR rows summed into one partial sum of the compressed reductions.
+const size_t kRowChunkSize = 4096;
+
+// Invokes func(i, j, k) for each grid point in parallel and sums the returned
+// values. Each k-slice is summed serially into its own partial sum, so the
+// result doesn't depend on the number of threads.
+template <typename Func>
+double parallelSum(const Size3 &size, const Func &func) {
+    std::vector<double> partialSums(size.z, 0.0);
+
+    parallelFor(kZeroSize, size.z, [&](size_t k) {
+        double sum = 0.0;
+        for (size_t j = 0; j < size.y; ++j) {
+            for (size_t i = 0; i < size.x; ++i) {
+                sum += func(i, j, k);
+            }
+        }
+        partialSums[k] = sum;
+    });
+
+    return std::accumulate(partialSums.begin(), partialSums.end(), 0.0);
+}
+
+// Same as above for the rows of a compressed system, chunked by kRowChunkSize.
+template <typename Func>
+double parallelSum(size_t numberOfRows, const Func &func) {
+    const size_t numberOfChunks = (numberOfRows + kRowChunkSize - 1) / kRowChunkSize;
+    std::vector<double> partialSums(numberOfChunks, 0.0);
+
+    parallelFor(kZeroSize, numberOfChunks, [&](size_t c) {
+        const size_t end = std::min(numberOfRows, (c + 1) * kRowChunkSize);
+        double sum = 0.0;
+        for (size_t i = c * kRowChunkSize; i < end; ++i) {
+            sum += func(i);
+        }
+        partialSums[c] = sum;
+    });
+
+    return std::accumulate(partialSums.begin(), partialSums.end(), 0.0);
+}
+
+// Returns the row (i, j, k) of the stored matrix \p m multiplied by \p v.
+template <typename T>
+T applyRow(const Array3<FdmMatrixRow<T, 3>> &m, const Array3<T> &v, const Size3 &size, size_t i, size_t j, size_t k) {
+    return m(i, j, k).center * v(i, j, k) + ((i > 0) ? m(i - 1, j, k).right * v(i - 1, j, k) : 0) +
+           ((i + 1 < size.x) ? m(i, j, k).right * v(i + 1, j, k) : 0) +
+           ((j > 0) ? m(i, j - 1, k).up * v(i, j - 1, k) : 0) +
+           ((j + 1 < size.y) ? m(i, j, k).up * v(i, j + 1, k) : 0) +
+           ((k > 0) ? m(i, j, k - 1).front * v(i, j, k - 1) : 0) +
+           ((k + 1 < size.z) ? m(i, j, k).front * v(i, j, k + 1) : 0);
+}
+
+// Returns the row (i, j, k) of the matrix-free Laplacian \p m multiplied by
+// \p v, computing the coefficients from the markers.
+template <typename T>
+T applyRow(const FdmMatrixFreeLaplacian<T, 3> &m,
+           const Array3<T> &v,
+           const Size3 &size,
+           size_t i,
+           size_t j,
+           size_t k) {
+    typedef FdmMatrixFreeLaplacian<T, 3> MatrixType;
+
+    const auto &markers = m.markers;
+    if (markers(i, j, k) != MatrixType::kFluid) {
+        return v(i, j, k);
+    }
+
+    const Vector3<T> &invH2 = m.invGridSpacingSquared;
+    T center = 0;
+    T sum = 0;
+
+    const auto couple = [&](char marker, T invH2Axis, T value) {
+        if (marker == MatrixType::kFluid) {
+            center += invH2Axis;
+            sum -= invH2Axis * value;
+        } else if (marker == MatrixType::kAir) {
+            center += invH2Axis;
+        }
+    };
+
+    if (i > 0) couple(markers(i - 1, j, k), invH2.x, v(i - 1, j, k));
+    if (i + 1 < size.x) couple(markers(i + 1, j, k), invH2.x, v(i + 1, j, k));
+    if (j > 0) couple(markers(i, j - 1, k), invH2.y, v(i, j - 1, k));
+    if (j + 1 < size.y) couple(markers(i, j + 1, k), invH2.y, v(i, j + 1, k));
+    if (k > 0) couple(markers(i, j, k - 1), invH2.z, v(i, j, k - 1));
+    if (k + 1 < size.z) couple(markers(i, j, k + 1), invH2.z, v(i, j, k + 1));
+
+    return center * v(i, j, k) + sum;
+}
+
+// Sparse matrix-vector product of row \p i of the compressed matrix \p m.
+template <typename T>
+T applyRow(const MatrixCsr<T> &m, const VectorN<T> &v, size_t i) {
+    const auto rp = m.rowPointersBegin();
+    const auto ci = m.columnIndicesBegin();
+    const auto nnz = m.nonZeroBegin();
+
+    T sum = 0;
+
+    for (size_t jj = rp[i]; jj < rp[i + 1]; ++jj) {
+        sum += nnz[jj] * v[ci[jj]];
+    }
+
+    return sum;
+}
+
+}  // namespace
+
+template <typename T>
+void FdmLinearSystem<T, 3>::clear() {
     A.clear();
     x.clear();
     b.clear();
 }
 
-void FdmLinearSystem3::resize(const Size3 &size) {
+template <typename T>
+void FdmLinearSystem<T, 3>::resize(const Size3 &size) {
     A.resize(size);
     x.resize(size);
     b.resize(size);
@@ -24,7 +142,8 @@ void FdmLinearSystem3::resize(const Size3 &size) {
 
 //
 
-void FdmCompressedLinearSystem3::clear() {
+template <typename T>
+void FdmCompressedLinearSystem<T, 3>::clear() {
     A.clear();
     x.clear();
     b.clear();
@@ -32,82 +151,195 @@ void FdmCompressedLinearSystem3::clear() {
 
 //
 
-void FdmBlas3::set(double s, FdmVector3 *result) { result->set(s); }
+template <typename T>
+Size3 FdmMatrixFreeLaplacian<T, 3>::size() const {
+    return markers.size();
+}
+
+template <typename T>
+void FdmMatrixFreeLaplacian<T, 3>::resize(const Size3 &size, const Vector3<T> &gridSpacing) {
+    markers.resize(size, kFluid);
+    invGridSpacingSquared = Vector3<T>(1 / square(gridSpacing.x), 1 / square(gridSpacing.y), 1 / square(gridSpacing.z));
+}
+
+template <typename T>
+void FdmMatrixFreeLaplacian<T, 3>::clear() {
+    markers.clear();
+}
+
+template <typename T>
+FdmMatrixRow<T, 3> FdmMatrixFreeLaplacian<T, 3>::row(size_t i, size_t j, size_t k) const {
+    const Size3 size = markers.size();
+    FdmMatrixRow<T, 3> result;
+
+    if (markers(i, j, k) != kFluid) {
+        result.center = 1;
+        return result;
+    }
+
+    // Neighbors outside of the grid are treated as boundary cells.
+    const char neighbors[6] = {(i > 0) ? markers(i - 1, j, k) : kBoundary,
+                               (i + 1 < size.x) ? markers(i + 1, j, k) : kBoundary,
+                               (j > 0) ? markers(i, j - 1, k) : kBoundary,
+                               (j + 1 < size.y) ? markers(i, j + 1, k) : kBoundary,
+                               (k > 0) ? markers(i, j, k - 1) : kBoundary,
+                               (k + 1 < size.z) ? markers(i, j, k + 1) : kBoundary};
+    const T invH2[3] = {invGridSpacingSquared.x, invGridSpacingSquared.y, invGridSpacingSquared.z};
+
+    for (int n = 0; n < 6; ++n) {
+        if (neighbors[n] != kBoundary) {
+            result.center += invH2[n / 2];
+        }
+    }
+
+    result.right = (neighbors[1] == kFluid) ? -invH2[0] : 0;
+    result.up = (neighbors[3] == kFluid) ? -invH2[1] : 0;
+    result.front = (neighbors[5] == kFluid) ? -invH2[2] : 0;
+
+    return result;
+}
 
-void FdmBlas3::set(const FdmVector3 &v, FdmVector3 *result) { result->set(v); }
+template <typename T>
+void FdmMatrixFreeLaplacian<T, 3>::assemble(Array3<FdmMatrixRow<T, 3>> *result) const {
+    result->resize(markers.size());
+    result->parallelForEachIndex([&](size_t i, size_t j, size_t k) { (*result)(i, j, k) = row(i, j, k); });
+}
+
+//
 
-void FdmBlas3::set(double s, FdmMatrix3 *result) {
-    FdmMatrixRow3 row;
+template <typename T>
+void FdmMatrixFreeLinearSystem<T, 3>::clear() {
+    A.clear();
+    x.clear();
+    b.clear();
+}
+
+template <typename T>
+void FdmMatrixFreeLinearSystem<T, 3>::resize(const Size3 &size, const Vector3<T> &gridSpacing) {
+    A.resize(size, gridSpacing);
+    x.resize(size);
+    b.resize(size);
+}
+
+//
+
+template <typename T>
+void FdmBlas<T, 3>::set(ScalarType s, VectorType *result) {
+    result->set(s);
+}
+
+template <typename T>
+void FdmBlas<T, 3>::set(const VectorType &v, VectorType *result) {
+    result->set(v);
+}
+
+template <typename T>
+void FdmBlas<T, 3>::set(ScalarType s, MatrixType *result) {
+    FdmMatrixRow<T, 3> row;
     row.center = row.right = row.up = row.front = s;
     result->set(row);
 }
 
-void FdmBlas3::set(const FdmMatrix3 &m, FdmMatrix3 *result) { result->set(m); }
+template <typename T>
+void FdmBlas<T, 3>::set(const MatrixType &m, MatrixType *result) {
+    result->set(m);
+}
 
-double FdmBlas3::dot(const FdmVector3 &a, const FdmVector3 &b) {
+template <typename T>
+double FdmBlas<T, 3>::dot(const VectorType &a, const VectorType &b) {
     Size3 size = a.size();
 
     VOX_THROW_INVALID_ARG_IF(size != b.size())
 
-    double result = 0.0;
-
-    for (size_t k = 0; k < size.z; ++k) {
-        for (size_t j = 0; j < size.y; ++j) {
-            for (size_t i = 0; i < size.x; ++i) {
-                result += a(i, j, k) * b(i, j, k);
-            }
-        }
-    }
-
-    return result;
+    return parallelSum(size,
+                       [&](size_t i, size_t j, size_t k) { return static_cast<double>(a(i, j, k)) * b(i, j, k); });
 }
 
-void FdmBlas3::axpy(double a, const FdmVector3 &x, const FdmVector3 &y, FdmVector3 *result) {
+template <typename T>
+void FdmBlas<T, 3>::axpy(double a, const VectorType &x, const VectorType &y, VectorType *result) {
     Size3 size = x.size();
 
     VOX_THROW_INVALID_ARG_IF(size != y.size())
     VOX_THROW_INVALID_ARG_IF(size != result->size())
 
-    x.parallelForEachIndex([&](size_t i, size_t j, size_t k) { (*result)(i, j, k) = a * x(i, j, k) + y(i, j, k); });
+    const auto s = static_cast<T>(a);
+    x.parallelForEachIndex([&](size_t i, size_t j, size_t k) { (*result)(i, j, k) = s * x(i, j, k) + y(i, j, k); });
+}
+
+template <typename T>
+void FdmBlas<T, 3>::mvm(const MatrixType &m, const VectorType &v, VectorType *result) {
+    Size3 size = m.size();
+
+    VOX_THROW_INVALID_ARG_IF(size != v.size())
+    VOX_THROW_INVALID_ARG_IF(size != result->size())
+
+    m.parallelForEachIndex(
+            [&](size_t i, size_t j, size_t k) { (*result)(i, j, k) = applyRow(m, v, size, i, j, k); });
+}
+
+template <typename T>
+void FdmBlas<T, 3>::residual(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result) {
+    Size3 size = a.size();
+
+    VOX_THROW_INVALID_ARG_IF(size != x.size())
+    VOX_THROW_INVALID_ARG_IF(size != b.size())
+    VOX_THROW_INVALID_ARG_IF(size != result->size())
+
+    a.parallelForEachIndex(
+            [&](size_t i, size_t j, size_t k) { (*result)(i, j, k) = b(i, j, k) - applyRow(a, x, size, i, j, k); });
 }
 
-void FdmBlas3::mvm(const FdmMatrix3 &m, const FdmVector3 &v, FdmVector3 *result) {
+template <typename T>
+double FdmBlas<T, 3>::mvmDot(const MatrixType &m, const VectorType &v, VectorType *result) {
     Size3 size = m.size();
 
     VOX_THROW_INVALID_ARG_IF(size != v.size())
     VOX_THROW_INVALID_ARG_IF(size != result->size())
 
-    m.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
-        (*result)(i, j, k) = m(i, j, k).center * v(i, j, k) + ((i > 0) ? m(i - 1, j, k).right * v(i - 1, j, k) : 0.0) +
-                             ((i + 1 < size.x) ? m(i, j, k).right * v(i + 1, j, k) : 0.0) +
-                             ((j > 0) ? m(i, j - 1, k).up * v(i, j - 1, k) : 0.0) +
-                             ((j + 1 < size.y) ? m(i, j, k).up * v(i, j + 1, k) : 0.0) +
-                             ((k > 0) ? m(i, j, k - 1).front * v(i, j, k - 1) : 0.0) +
-                             ((k + 1 < size.z) ? m(i, j, k).front * v(i, j, k + 1) : 0.0);
+    return parallelSum(size, [&](size_t i, size_t j, size_t k) {
+        const T value = applyRow(m, v, size, i, j, k);
+        (*result)(i, j, k) = value;
+        return static_cast<double>(v(i, j, k)) * value;
     });
 }
 
-void FdmBlas3::residual(const FdmMatrix3 &a, const FdmVector3 &x, const FdmVector3 &b, FdmVector3 *result) {
+template <typename T>
+double FdmBlas<T, 3>::residualDot(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result) {
     Size3 size = a.size();
 
     VOX_THROW_INVALID_ARG_IF(size != x.size())
     VOX_THROW_INVALID_ARG_IF(size != b.size())
     VOX_THROW_INVALID_ARG_IF(size != result->size())
 
-    a.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
-        (*result)(i, j, k) = b(i, j, k) - a(i, j, k).center * x(i, j, k) -
-                             ((i > 0) ? a(i - 1, j, k).right * x(i - 1, j, k) : 0.0) -
-                             ((i + 1 < size.x) ? a(i, j, k).right * x(i + 1, j, k) : 0.0) -
-                             ((j > 0) ? a(i, j - 1, k).up * x(i, j - 1, k) : 0.0) -
-                             ((j + 1 < size.y) ? a(i, j, k).up * x(i, j + 1, k) : 0.0) -
-                             ((k > 0) ? a(i, j, k - 1).front * x(i, j, k - 1) : 0.0) -
-                             ((k + 1 < size.z) ? a(i, j, k).front * x(i, j, k + 1) : 0.0);
+    return parallelSum(size, [&](size_t i, size_t j, size_t k) {
+        const T value = b(i, j, k) - applyRow(a, x, size, i, j, k);
+        (*result)(i, j, k) = value;
+        return static_cast<double>(value) * value;
     });
 }
 
-double FdmBlas3::l2Norm(const FdmVector3 &v) { return std::sqrt(dot(v, v)); }
+template <typename T>
+double FdmBlas<T, 3>::axpyDot(double a, const VectorType &x, const VectorType &y, VectorType *result) {
+    Size3 size = x.size();
+
+    VOX_THROW_INVALID_ARG_IF(size != y.size())
+    VOX_THROW_INVALID_ARG_IF(size != result->size())
+
+    const auto s = static_cast<T>(a);
+    return parallelSum(size, [&](size_t i, size_t j, size_t k) {
+        const T value = s * x(i, j, k) + y(i, j, k);
+        (*result)(i, j, k) = value;
+        return static_cast<double>(value) * value;
+    });
+}
 
-double FdmBlas3::lInfNorm(const FdmVector3 &v) {
+template <typename T>
+double FdmBlas<T, 3>::l2Norm(const VectorType &v) {
+    return std::sqrt(dot(v, v));
+}
+
+template <typename T>
+double FdmBlas<T, 3>::lInfNorm(const VectorType &v) {
     Size3 size = v.size();
 
     double result = 0.0;
@@ -115,7 +347,7 @@ double FdmBlas3::lInfNorm(const FdmVector3 &v) {
     for (size_t k = 0; k < size.z; ++k) {
         for (size_t j = 0; j < size.y; ++j) {
             for (size_t i = 0; i < size.x; ++i) {
-                result = absmax(result, v(i, j, k));
+                result = absmax(result, static_cast<double>(v(i, j, k)));
             }
         }
     }
@@ -125,58 +357,169 @@ double FdmBlas3::lInfNorm(const FdmVector3 &v) {
 
 //
 
-void FdmCompressedBlas3::set(double s, VectorND *result) { result->set(s); }
+template <typename T>
+void FdmCompressedBlas<T, 3>::set(ScalarType s, VectorType *result) {
+    result->set(s);
+}
 
-void FdmCompressedBlas3::set(const VectorND &v, VectorND *result) { result->set(v); }
+template <typename T>
+void FdmCompressedBlas<T, 3>::set(const VectorType &v, VectorType *result) {
+    result->set(v);
+}
 
-void FdmCompressedBlas3::set(double s, MatrixCsrD *result) { result->set(s); }
+template <typename T>
+void FdmCompressedBlas<T, 3>::set(ScalarType s, MatrixType *result) {
+    result->set(s);
+}
 
-void FdmCompressedBlas3::set(const MatrixCsrD &m, MatrixCsrD *result) { result->set(m); }
+template <typename T>
+void FdmCompressedBlas<T, 3>::set(const MatrixType &m, MatrixType *result) {
+    result->set(m);
+}
 
-double FdmCompressedBlas3::dot(const VectorND &a, const VectorND &b) { return a.dot(b); }
+template <typename T>
+double FdmCompressedBlas<T, 3>::dot(const VectorType &a, const VectorType &b) {
+    return a.dot(b);
+}
 
-void FdmCompressedBlas3::axpy(double a, const VectorND &x, const VectorND &y, VectorND *result) { *result = a * x + y; }
+template <typename T>
+void FdmCompressedBlas<T, 3>::axpy(double a, const VectorType &x, const VectorType &y, VectorType *result) {
+    *result = static_cast<T>(a) * x + y;
+}
 
-void FdmCompressedBlas3::mvm(const MatrixCsrD &m, const VectorND &v, VectorND *result) {
-    const auto rp = m.rowPointersBegin();
-    const auto ci = m.columnIndicesBegin();
-    const auto nnz = m.nonZeroBegin();
+template <typename T>
+void FdmCompressedBlas<T, 3>::mvm(const MatrixType &m, const VectorType &v, VectorType *result) {
+    v.parallelForEachIndex([&](size_t i) { (*result)[i] = applyRow(m, v, i); });
+}
 
-    v.parallelForEachIndex([&](size_t i) {
-        const size_t rowBegin = rp[i];
-        const size_t rowEnd = rp[i + 1];
+template <typename T>
+void FdmCompressedBlas<T, 3>::residual(const MatrixType &a,
+                                       const VectorType &x,
+                                       const VectorType &b,
+                                       VectorType *result) {
+    x.parallelForEachIndex([&](size_t i) { (*result)[i] = b[i] - applyRow(a, x, i); });
+}
 
-        double sum = 0.0;
+template <typename T>
+double FdmCompressedBlas<T, 3>::mvmDot(const MatrixType &m, const VectorType &v, VectorType *result) {
+    return parallelSum(v.size(), [&](size_t i) {
+        const T value = applyRow(m, v, i);
+        (*result)[i] = value;
+        return static_cast<double>(v[i]) * value;
+    });
+}
 
-        for (size_t jj = rowBegin; jj < rowEnd; ++jj) {
-            size_t j = ci[jj];
-            sum += nnz[jj] * v[j];
-        }
+template <typename T>
+double FdmCompressedBlas<T, 3>::residualDot(const MatrixType &a,
+                                            const VectorType &x,
+                                            const VectorType &b,
+                                            VectorType *result) {
+    return parallelSum(x.size(), [&](size_t i) {
+        const T value = b[i] - applyRow(a, x, i);
+        (*result)[i] = value;
+        return static_cast<double>(value) * value;
+    });
+}
 
-        (*result)[i] = sum;
+template <typename T>
+double FdmCompressedBlas<T, 3>::axpyDot(double a, const VectorType &x, const VectorType &y, VectorType *result) {
+    const auto s = static_cast<T>(a);
+    return parallelSum(x.size(), [&](size_t i) {
+        const T value = s * x[i] + y[i];
+        (*result)[i] = value;
+        return static_cast<double>(value) * value;
     });
 }
 
-void FdmCompressedBlas3::residual(const MatrixCsrD &a, const VectorND &x, const VectorND &b, VectorND *result) {
-    const auto rp = a.rowPointersBegin();
-    const auto ci = a.columnIndicesBegin();
-    const auto nnz = a.nonZeroBegin();
+template <typename T>
+double FdmCompressedBlas<T, 3>::l2Norm(const VectorType &v) {
+    return std::sqrt(dot(v, v));
+}
 
-    x.parallelForEachIndex([&](size_t i) {
-        const size_t rowBegin = rp[i];
-        const size_t rowEnd = rp[i + 1];
+template <typename T>
+double FdmCompressedBlas<T, 3>::lInfNorm(const VectorType &v) {
+    return std::fabs(v.absmax());
+}
 
-        double sum = 0.0;
+template <typename T>
+void FdmMatrixFreeBlas<T, 3>::set(const MatrixType &m, MatrixType *result) {
+    result->markers.set(m.markers);
+    result->invGridSpacingSquared = m.invGridSpacingSquared;
+}
 
-        for (size_t jj = rowBegin; jj < rowEnd; ++jj) {
-            size_t j = ci[jj];
-            sum += nnz[jj] * x[j];
-        }
+template <typename T>
+void FdmMatrixFreeBlas<T, 3>::mvm(const MatrixType &m, const VectorType &v, VectorType *result) {
+    Size3 size = m.size();
+
+    VOX_THROW_INVALID_ARG_IF(size != v.size())
+    VOX_THROW_INVALID_ARG_IF(size != result->size())
+
+    v.parallelForEachIndex(
+            [&](size_t i, size_t j, size_t k) { (*result)(i, j, k) = applyRow(m, v, size, i, j, k); });
+}
+
+template <typename T>
+void FdmMatrixFreeBlas<T, 3>::residual(const MatrixType &a,
+                                       const VectorType &x,
+                                       const VectorType &b,
+                                       VectorType *result) {
+    Size3 size = a.size();
 
-        (*result)[i] = b[i] - sum;
+    VOX_THROW_INVALID_ARG_IF(size != x.size())
+    VOX_THROW_INVALID_ARG_IF(size != b.size())
+    VOX_THROW_INVALID_ARG_IF(size != result->size())
+
+    x.parallelForEachIndex(
+            [&](size_t i, size_t j, size_t k) { (*result)(i, j, k) = b(i, j, k) - applyRow(a, x, size, i, j, k); });
+}
+
+template <typename T>
+double FdmMatrixFreeBlas<T, 3>::mvmDot(const MatrixType &m, const VectorType &v, VectorType *result) {
+    Size3 size = m.size();
+
+    VOX_THROW_INVALID_ARG_IF(size != v.size())
+    VOX_THROW_INVALID_ARG_IF(size != result->size())
+
+    return parallelSum(size, [&](size_t i, size_t j, size_t k) {
+        const T value = applyRow(m, v, size, i, j, k);
+        (*result)(i, j, k) = value;
+        return static_cast<double>(v(i, j, k)) * value;
     });
 }
 
-double FdmCompressedBlas3::l2Norm(const VectorND &v) { return std::sqrt(v.dot(v)); }
+template <typename T>
+double FdmMatrixFreeBlas<T, 3>::residualDot(const MatrixType &a,
+                                            const VectorType &x,
+                                            const VectorType &b,
+                                            VectorType *result) {
+    Size3 size = a.size();
+
+    VOX_THROW_INVALID_ARG_IF(size != x.size())
+    VOX_THROW_INVALID_ARG_IF(size != b.size())
+    VOX_THROW_INVALID_ARG_IF(size != result->size())
+
+    return parallelSum(size, [&](size_t i, size_t j, size_t k) {
+        const T value = b(i, j, k) - applyRow(a, x, size, i, j, k);
+        (*result)(i, j, k) = value;
+        return static_cast<double>(value) * value;
+    });
+}
 
-double FdmCompressedBlas3::lInfNorm(const VectorND &v) { return std::fabs(v.absmax()); }
+namespace vox {
+
+template struct FdmLinearSystem<float, 3>;
+template struct FdmLinearSystem<double, 3>;
+template struct FdmCompressedLinearSystem<float, 3>;
+template struct FdmCompressedLinearSystem<double, 3>;
+template struct FdmMatrixFreeLaplacian<float, 3>;
+template struct FdmMatrixFreeLaplacian<double, 3>;
+template struct FdmMatrixFreeLinearSystem<float, 3>;
+template struct FdmMatrixFreeLinearSystem<double, 3>;
+template struct FdmBlas<float, 3>;
+template struct FdmBlas<double, 3>;
+template struct FdmCompressedBlas<float, 3>;
+template struct FdmCompressedBlas<double, 3>;
+template struct FdmMatrixFreeBlas<float, 3>;
+template struct FdmMatrixFreeBlas<double, 3>;
+
+}  // namespace vox
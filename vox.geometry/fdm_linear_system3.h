@@ -6,44 +6,72 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "vox.geometry/array1.h"
 #include "vox.geometry/array3.h"
 #include "vox.geometry/matrix_csr.h"
 #include "vox.geometry/vector_n.h"
+#include "vox.math/vector3.h"
 
 namespace vox {
 
+//! The row of an FDM matrix, specialized for each dimension.
+template <typename T, size_t N>
+struct FdmMatrixRow;
+
 //! The row of FdmMatrix3 where row corresponds to (i, j, k) grid point.
-struct FdmMatrixRow3 {
+template <typename T>
+struct FdmMatrixRow<T, 3> {
+    static_assert(std::is_floating_point<T>::value, "FdmMatrixRow only can be instantiated with floating point types");
+
     //! Diagonal component of the matrix (row, row).
-    double center = 0.0;
+    T center = 0;
 
     //! Off-diagonal element where colum refers to (i+1, j, k) grid point.
-    double right = 0.0;
+    T right = 0;
 
     //! Off-diagonal element where column refers to (i, j+1, k) grid point.
-    double up = 0.0;
+    T up = 0;
 
     //! OFf-diagonal element where column refers to (i, j, k+1) grid point.
-    double front = 0.0;
+    T front = 0;
 };
 
+//! Double-precision matrix row type for 3-D finite differencing.
+typedef FdmMatrixRow<double, 3> FdmMatrixRow3;
+
+//! Single-precision matrix row type for 3-D finite differencing.
+typedef FdmMatrixRow<float, 3> FdmMatrixRow3F;
+
 //! Vector type for 3-D finite differencing.
 typedef Array3<double> FdmVector3;
 
+//! Single-precision vector type for 3-D finite differencing.
+typedef Array3<float> FdmVector3F;
+
 //! Matrix type for 3-D finite differencing.
 typedef Array3<FdmMatrixRow3> FdmMatrix3;
 
+//! Single-precision matrix type for 3-D finite differencing.
+typedef Array3<FdmMatrixRow3F> FdmMatrix3F;
+
+//! Linear system (Ax=b) for finite differencing, specialized for each
+//! dimension.
+template <typename T, size_t N>
+struct FdmLinearSystem;
+
 //! Linear system (Ax=b) for 3-D finite differencing.
-struct FdmLinearSystem3 {
+template <typename T>
+struct FdmLinearSystem<T, 3> {
     //! System matrix.
-    FdmMatrix3 A;
+    Array3<FdmMatrixRow<T, 3>> A;
 
     //! Solution vector.
-    FdmVector3 x;
+    Array3<T> x;
 
     //! RHS vector.
-    FdmVector3 b;
+    Array3<T> b;
 
     //! Clears all the data.
     void clear();
@@ -52,26 +80,58 @@ struct FdmLinearSystem3 {
     void resize(const Size3 &size);
 };
 
+//! Double-precision linear system for 3-D finite differencing.
+typedef FdmLinearSystem<double, 3> FdmLinearSystem3;
+
+//! Single-precision linear system for 3-D finite differencing.
+typedef FdmLinearSystem<float, 3> FdmLinearSystem3F;
+
+//! Compressed linear system (Ax=b) for finite differencing, specialized for
+//! each dimension.
+template <typename T, size_t N>
+struct FdmCompressedLinearSystem;
+
 //! Compressed linear system (Ax=b) for 3-D finite differencing.
-struct FdmCompressedLinearSystem3 {
+template <typename T>
+struct FdmCompressedLinearSystem<T, 3> {
     //! System matrix.
-    MatrixCsrD A;
+    MatrixCsr<T> A;
 
     //! Solution vector.
-    VectorND x;
+    VectorN<T> x;
 
     //! RHS vector.
-    VectorND b;
+    VectorN<T> b;
 
     //! Clears all the data.
     void clear();
 };
 
-//! BLAS operator wrapper for 3-D finite differencing.
-struct FdmBlas3 {
-    typedef double ScalarType;
-    typedef FdmVector3 VectorType;
-    typedef FdmMatrix3 MatrixType;
+//! Double-precision compressed linear system for 3-D finite differencing.
+typedef FdmCompressedLinearSystem<double, 3> FdmCompressedLinearSystem3;
+
+//! Single-precision compressed linear system for 3-D finite differencing.
+typedef FdmCompressedLinearSystem<float, 3> FdmCompressedLinearSystem3F;
+
+//! BLAS operator wrapper for finite differencing, specialized for each
+//! dimension.
+template <typename T, size_t N>
+struct FdmBlas;
+
+//!
+//! \brief BLAS operator wrapper for 3-D finite differencing.
+//!
+//! Reductions (dot and norms) are accumulated in double precision regardless
+//! of \p T, so single-precision systems lose accuracy only in storage. The
+//! fused operators finish their reduction in the same pass over the grid, and
+//! the partial sums are taken per k-slice so the results don't depend on the
+//! number of threads.
+//!
+template <typename T>
+struct FdmBlas<T, 3> {
+    typedef T ScalarType;
+    typedef Array3<T> VectorType;
+    typedef Array3<FdmMatrixRow<T, 3>> MatrixType;
 
     //! Sets entire element of given vector \p result with scalar \p s.
     static void set(ScalarType s, VectorType *result);
@@ -98,18 +158,167 @@ struct FdmBlas3 {
     //! Computes residual vector (b - ax).
     static void residual(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
 
+    //! Performs matrix-vector multiplication and returns \p v dot \p result.
+    static double mvmDot(const MatrixType &m, const VectorType &v, VectorType *result);
+
+    //! Computes residual vector (b - ax) and returns its squared L2-norm.
+    static double residualDot(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
+
+    //! Performs ax + y operation and returns the squared L2-norm of \p result.
+    static double axpyDot(double a, const VectorType &x, const VectorType &y, VectorType *result);
+
     //! Returns L2-norm of the given vector \p v.
-    static ScalarType l2Norm(const VectorType &v);
+    static double l2Norm(const VectorType &v);
 
     //! Returns Linf-norm of the given vector \p v.
-    static ScalarType lInfNorm(const VectorType &v);
+    static double lInfNorm(const VectorType &v);
 };
 
+//! Double-precision BLAS operator wrapper for 3-D finite differencing.
+typedef FdmBlas<double, 3> FdmBlas3;
+
+//! Single-precision BLAS operator wrapper for 3-D finite differencing.
+typedef FdmBlas<float, 3> FdmBlas3F;
+
+//! Matrix-free Laplacian operator for finite differencing, specialized for
+//! each dimension.
+template <typename T, size_t N>
+struct FdmMatrixFreeLaplacian;
+
+//!
+//! \brief Matrix-free 7-point Laplacian operator for 3-D finite differencing.
+//!
+//! This operator represents the same matrix a pressure solver would assemble
+//! into FdmMatrix3, but computes the coefficients on the fly from the cell
+//! markers instead of storing a FdmMatrixRow per cell. Fluid cells couple with
+//! their fluid neighbors, air neighbors act as zero Dirichlet boundaries, and
+//! boundary neighbors (including the outside of the grid) act as Neumann
+//! boundaries. Rows of non-fluid cells are the identity.
+//!
+template <typename T>
+struct FdmMatrixFreeLaplacian<T, 3> {
+    //! Marker for cells where the Laplacian is solved.
+    static constexpr char kFluid = 0;
+
+    //! Marker for cells with zero Dirichlet boundary condition.
+    static constexpr char kAir = 1;
+
+    //! Marker for cells with Neumann boundary condition.
+    static constexpr char kBoundary = 2;
+
+    //! Cell markers which define the matrix.
+    Array3<char> markers;
+
+    //! Inverse of the squared grid spacing along each axis.
+    Vector3<T> invGridSpacingSquared = Vector3<T>(1, 1, 1);
+
+    //! Returns the size of the grid.
+    [[nodiscard]] Size3 size() const;
+
+    //! Resizes the markers with given grid size and marks all cells as fluid.
+    void resize(const Size3 &size, const Vector3<T> &gridSpacing = Vector3<T>(1, 1, 1));
+
+    //! Clears all the data.
+    void clear();
+
+    //! Returns the row of the matrix at (i, j, k).
+    [[nodiscard]] FdmMatrixRow<T, 3> row(size_t i, size_t j, size_t k) const;
+
+    //! Writes the assembled matrix to \p result, e.g. for preconditioners.
+    void assemble(Array3<FdmMatrixRow<T, 3>> *result) const;
+};
+
+//! Double-precision matrix-free Laplacian for 3-D finite differencing.
+typedef FdmMatrixFreeLaplacian<double, 3> FdmMatrixFreeLaplacian3;
+
+//! Single-precision matrix-free Laplacian for 3-D finite differencing.
+typedef FdmMatrixFreeLaplacian<float, 3> FdmMatrixFreeLaplacian3F;
+
+//! Matrix-free linear system (Ax=b) for finite differencing, specialized for
+//! each dimension.
+template <typename T, size_t N>
+struct FdmMatrixFreeLinearSystem;
+
+//! Matrix-free linear system (Ax=b) for 3-D finite differencing.
+template <typename T>
+struct FdmMatrixFreeLinearSystem<T, 3> {
+    //! System matrix.
+    FdmMatrixFreeLaplacian<T, 3> A;
+
+    //! Solution vector.
+    Array3<T> x;
+
+    //! RHS vector.
+    Array3<T> b;
+
+    //! Clears all the data.
+    void clear();
+
+    //! Resizes the arrays with given grid size and spacing.
+    void resize(const Size3 &size, const Vector3<T> &gridSpacing = Vector3<T>(1, 1, 1));
+};
+
+//! Double-precision matrix-free linear system for 3-D finite differencing.
+typedef FdmMatrixFreeLinearSystem<double, 3> FdmMatrixFreeLinearSystem3;
+
+//! Single-precision matrix-free linear system for 3-D finite differencing.
+typedef FdmMatrixFreeLinearSystem<float, 3> FdmMatrixFreeLinearSystem3F;
+
+//! BLAS operator wrapper for matrix-free finite differencing, specialized for
+//! each dimension.
+template <typename T, size_t N>
+struct FdmMatrixFreeBlas;
+
+//!
+//! \brief BLAS operator wrapper for matrix-free 3-D finite differencing.
+//!
+//! Vector operators are the ones from FdmBlas; only the operators that take
+//! the matrix are replaced. Setting the matrix with a scalar is meaningless
+//! for a marker-defined operator and thus not provided.
+//!
+template <typename T>
+struct FdmMatrixFreeBlas<T, 3> : public FdmBlas<T, 3> {
+    typedef T ScalarType;
+    typedef Array3<T> VectorType;
+    typedef FdmMatrixFreeLaplacian<T, 3> MatrixType;
+
+    using FdmBlas<T, 3>::set;
+
+    //! Copies entire element of given matrix \p result with other matrix \p v.
+    static void set(const MatrixType &m, MatrixType *result);
+
+    //! Performs matrix-vector multiplication.
+    static void mvm(const MatrixType &m, const VectorType &v, VectorType *result);
+
+    //! Computes residual vector (b - ax).
+    static void residual(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
+
+    //! Performs matrix-vector multiplication and returns \p v dot \p result.
+    static double mvmDot(const MatrixType &m, const VectorType &v, VectorType *result);
+
+    //! Computes residual vector (b - ax) and returns its squared L2-norm.
+    static double residualDot(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
+};
+
+//! Double-precision BLAS operator wrapper for matrix-free 3-D finite
+//! differencing.
+typedef FdmMatrixFreeBlas<double, 3> FdmMatrixFreeBlas3;
+
+//! Single-precision BLAS operator wrapper for matrix-free 3-D finite
+//! differencing.
+typedef FdmMatrixFreeBlas<float, 3> FdmMatrixFreeBlas3F;
+
+//! BLAS operator wrapper for compressed finite differencing, specialized for
+//! each dimension.
+template <typename T, size_t N>
+struct FdmCompressedBlas;
+
 //! BLAS operator wrapper for compressed 3-D finite differencing.
-struct FdmCompressedBlas3 {
-    typedef double ScalarType;
-    typedef VectorND VectorType;
-    typedef MatrixCsrD MatrixType;
+template <typename T>
+struct FdmCompressedBlas<T, 3> {
+    typedef T ScalarType;
+    typedef VectorN<T> VectorType;
+    typedef MatrixCsr<T> MatrixType;
 
     //! Sets entire element of given vector \p result with scalar \p s.
     static void set(ScalarType s, VectorType *result);
@@ -136,11 +345,28 @@ struct FdmCompressedBlas3 {
     //! Computes residual vector (b - ax).
     static void residual(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
 
+    //! Performs matrix-vector multiplication and returns \p v dot \p result.
+    static double mvmDot(const MatrixType &m, const VectorType &v, VectorType *result);
+
+    //! Computes residual vector (b - ax) and returns its squared L2-norm.
+    static double residualDot(const MatrixType &a, const VectorType &x, const VectorType &b, VectorType *result);
+
+    //! Performs ax + y operation and returns the squared L2-norm of \p result.
+    static double axpyDot(double a, const VectorType &x, const VectorType &y, VectorType *result);
+
     //! Returns L2-norm of the given vector \p v.
-    static ScalarType l2Norm(const VectorType &v);
+    static double l2Norm(const VectorType &v);
 
     //! Returns Linf-norm of the given vector \p v.
-    static ScalarType lInfNorm(const VectorType &v);
+    static double lInfNorm(const VectorType &v);
 };
 
-}  // namespace vox
\ No newline at end of file
+//! Double-precision BLAS operator wrapper for compressed 3-D finite
+//! differencing.
+typedef FdmCompressedBlas<double, 3> FdmCompressedBlas3;
+
+//! Single-precision BLAS operator wrapper for compressed 3-D finite
+//! differencing.
+typedef FdmCompressedBlas<float, 3> FdmCompressedBlas3F;
+
+}  // namespace vox
@@ -12,21 +12,36 @@
 
 namespace vox {
 
+//! Abstract base class for finite difference-type linear system solver,
+//! specialized for each dimension.
+template <typename T, size_t N>
+class FdmLinearSystemSolver;
+
 //! Abstract base class for 3-D finite difference-type linear system solver.
-class FdmLinearSystemSolver3 {
+template <typename T>
+class FdmLinearSystemSolver<T, 3> {
 public:
-    FdmLinearSystemSolver3() = default;
+    FdmLinearSystemSolver() = default;
 
-    virtual ~FdmLinearSystemSolver3() = default;
+    virtual ~FdmLinearSystemSolver() = default;
 
     //! Solves the given linear system.
-    virtual bool solve(FdmLinearSystem3 *system) = 0;
+    virtual bool solve(FdmLinearSystem<T, 3> *system) = 0;
 
     //! Solves the given compressed linear system.
-    virtual bool solveCompressed(FdmCompressedLinearSystem3 *) { return false; }
+    virtual bool solveCompressed(FdmCompressedLinearSystem<T, 3> *) { return false; }
 };
 
+//! Double-precision 3-D finite difference-type linear system solver.
+typedef FdmLinearSystemSolver<double, 3> FdmLinearSystemSolver3;
+
+//! Single-precision 3-D finite difference-type linear system solver.
+typedef FdmLinearSystemSolver<float, 3> FdmLinearSystemSolver3F;
+
 //! Shared pointer type for the FdmLinearSystemSolver3.
 typedef std::shared_ptr<FdmLinearSystemSolver3> FdmLinearSystemSolver3Ptr;
 
+//! Shared pointer type for the FdmLinearSystemSolver3F.
+typedef std::shared_ptr<FdmLinearSystemSolver3F> FdmLinearSystemSolver3FPtr;
+
 }  // namespace vox
\ No newline at end of file
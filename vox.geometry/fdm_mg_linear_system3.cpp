@@ -6,31 +6,72 @@
 
 #include "vox.geometry/fdm_mg_linear_system3.h"
 
+#include <array>
+#include <vector>
+
+#include "vox.base/parallel.h"
+
 using namespace vox;
 
+namespace {
+
+// Indices of the four finer cells that contribute to coarser cell c along an
+// axis with n coarser cells, clamped at the boundaries.
+std::array<size_t, 4> restrictionIndices(size_t c, size_t n) {
+    return {{(c > 0) ? 2 * c - 1 : 2 * c, 2 * c, 2 * c + 1, (c + 1 < n) ? 2 * c + 2 : 2 * c + 1}};
+}
+
+// Two coarser cells and their weights that interpolate finer cell f.
+template <typename T>
+struct CorrectionStencil {
+    std::array<size_t, 2> indices;
+    std::array<T, 2> weights;
+};
+
+// Returns the correction stencil of finer cell f along an axis with n finer
+// cells, clamped at the boundaries.
+template <typename T>
+CorrectionStencil<T> correctionStencil(size_t f, size_t n) {
+    const size_t c = f / 2;
+    if (f % 2 == 0) {
+        return {{{(f > 1) ? c - 1 : c, c}}, {{T(0.25), T(0.75)}}};
+    } else {
+        return {{{c, (f + 1 < n) ? c + 1 : c}}, {{T(0.75), T(0.25)}}};
+    }
+}
+
+}  // namespace
+
 //
 
-void FdmMgLinearSystem3::clear() {
+template <typename T>
+void FdmMgLinearSystem<T, 3>::clear() {
     A.levels.clear();
     x.levels.clear();
     b.levels.clear();
 }
 
-size_t FdmMgLinearSystem3::numberOfLevels() const { return A.levels.size(); }
+template <typename T>
+size_t FdmMgLinearSystem<T, 3>::numberOfLevels() const {
+    return A.levels.size();
+}
 
-void FdmMgLinearSystem3::resizeWithCoarsest(const Size3 &coarsestResolution, size_t numberOfLevels) {
+template <typename T>
+void FdmMgLinearSystem<T, 3>::resizeWithCoarsest(const Size3 &coarsestResolution, size_t numberOfLevels) {
     FdmMgUtils3::resizeArrayWithCoarsest(coarsestResolution, numberOfLevels, &A.levels);
     FdmMgUtils3::resizeArrayWithCoarsest(coarsestResolution, numberOfLevels, &x.levels);
     FdmMgUtils3::resizeArrayWithCoarsest(coarsestResolution, numberOfLevels, &b.levels);
 }
 
-void FdmMgLinearSystem3::resizeWithFinest(const Size3 &finestResolution, size_t maxNumberOfLevels) {
+template <typename T>
+void FdmMgLinearSystem<T, 3>::resizeWithFinest(const Size3 &finestResolution, size_t maxNumberOfLevels) {
     FdmMgUtils3::resizeArrayWithFinest(finestResolution, maxNumberOfLevels, &A.levels);
     FdmMgUtils3::resizeArrayWithFinest(finestResolution, maxNumberOfLevels, &x.levels);
     FdmMgUtils3::resizeArrayWithFinest(finestResolution, maxNumberOfLevels, &b.levels);
 }
 
-void FdmMgUtils3::restrict(const FdmVector3 &finer, FdmVector3 *coarser) {
+template <typename T>
+void FdmMgUtils3::restrict(const Array3<T> &finer, Array3<T> *coarser) {
     VOX_ASSERT(finer.size().x == 2 * coarser->size().x);
     VOX_ASSERT(finer.size().y == 2 * coarser->size().y);
     VOX_ASSERT(finer.size().z == 2 * coarser->size().z);
@@ -39,51 +80,53 @@ void FdmMgUtils3::restrict(const FdmVector3 &finer, FdmVector3 *coarser) {
     //  1/8   3/8   3/8   1/8
     //           to
     // -----|-----*-----|-----
-    static const std::array<double, 4> kernel = {{0.125, 0.375, 0.375, 0.125}};
+    static const std::array<T, 4> kernel = {{0.125, 0.375, 0.375, 0.125}};
 
+    // The kernel is separable, so it is applied along z, y, and then x. The z
+    // and y passes run over contiguous rows of the finer grid, which lets the
+    // compiler vectorize them, and the x pass reads a single row.
     const Size3 n = coarser->size();
-    parallelRangeFor(kZeroSize, n.x, kZeroSize, n.y, kZeroSize, n.z,
-                     [&](size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd) {
-                         std::array<size_t, 4> kIndices{};
-
-                         for (size_t k = kBegin; k < kEnd; ++k) {
-                             kIndices[0] = (k > 0) ? 2 * k - 1 : 2 * k;
-                             kIndices[1] = 2 * k;
-                             kIndices[2] = 2 * k + 1;
-                             kIndices[3] = (k + 1 < n.z) ? 2 * k + 2 : 2 * k + 1;
-
-                             std::array<size_t, 4> jIndices{};
-
-                             for (size_t j = jBegin; j < jEnd; ++j) {
-                                 jIndices[0] = (j > 0) ? 2 * j - 1 : 2 * j;
-                                 jIndices[1] = 2 * j;
-                                 jIndices[2] = 2 * j + 1;
-                                 jIndices[3] = (j + 1 < n.y) ? 2 * j + 2 : 2 * j + 1;
-
-                                 std::array<size_t, 4> iIndices{};
-                                 for (size_t i = iBegin; i < iEnd; ++i) {
-                                     iIndices[0] = (i > 0) ? 2 * i - 1 : 2 * i;
-                                     iIndices[1] = 2 * i;
-                                     iIndices[2] = 2 * i + 1;
-                                     iIndices[3] = (i + 1 < n.x) ? 2 * i + 2 : 2 * i + 1;
-
-                                     double sum = 0.0;
-                                     for (size_t z = 0; z < 4; ++z) {
-                                         for (size_t y = 0; y < 4; ++y) {
-                                             for (size_t x = 0; x < 4; ++x) {
-                                                 double w = kernel[x] * kernel[y] * kernel[z];
-                                                 sum += w * finer(iIndices[x], jIndices[y], kIndices[z]);
-                                             }
-                                         }
-                                     }
-                                     (*coarser)(i, j, k) = sum;
-                                 }
-                             }
-                         }
-                     });
+    const Size3 fn = finer.size();
+    parallelRangeFor(kZeroSize, n.z, [&](size_t kBegin, size_t kEnd) {
+        std::vector<T> plane(fn.x * fn.y);
+        std::vector<T> row(fn.x);
+
+        for (size_t k = kBegin; k < kEnd; ++k) {
+            const std::array<size_t, 4> kIndices = restrictionIndices(k, n.z);
+
+            for (size_t fj = 0; fj < fn.y; ++fj) {
+                const T *z0 = &finer(0, fj, kIndices[0]);
+                const T *z1 = &finer(0, fj, kIndices[1]);
+                const T *z2 = &finer(0, fj, kIndices[2]);
+                const T *z3 = &finer(0, fj, kIndices[3]);
+                T *dst = &plane[fj * fn.x];
+                for (size_t fi = 0; fi < fn.x; ++fi) {
+                    dst[fi] = kernel[0] * z0[fi] + kernel[1] * z1[fi] + kernel[2] * z2[fi] + kernel[3] * z3[fi];
+                }
+            }
+
+            for (size_t j = 0; j < n.y; ++j) {
+                const std::array<size_t, 4> jIndices = restrictionIndices(j, n.y);
+                const T *y0 = &plane[jIndices[0] * fn.x];
+                const T *y1 = &plane[jIndices[1] * fn.x];
+                const T *y2 = &plane[jIndices[2] * fn.x];
+                const T *y3 = &plane[jIndices[3] * fn.x];
+                for (size_t fi = 0; fi < fn.x; ++fi) {
+                    row[fi] = kernel[0] * y0[fi] + kernel[1] * y1[fi] + kernel[2] * y2[fi] + kernel[3] * y3[fi];
+                }
+
+                for (size_t i = 0; i < n.x; ++i) {
+                    const std::array<size_t, 4> iIndices = restrictionIndices(i, n.x);
+                    (*coarser)(i, j, k) = kernel[0] * row[iIndices[0]] + kernel[1] * row[iIndices[1]] +
+                                          kernel[2] * row[iIndices[2]] + kernel[3] * row[iIndices[3]];
+                }
+            }
+        }
+    });
 }
 
-void FdmMgUtils3::correct(const FdmVector3 &coarser, FdmVector3 *finer) {
+template <typename T>
+void FdmMgUtils3::correct(const Array3<T> &coarser, Array3<T> *finer) {
     VOX_ASSERT(finer->size().x == 2 * coarser.size().x);
     VOX_ASSERT(finer->size().y == 2 * coarser.size().y);
     VOX_ASSERT(finer->size().z == 2 * coarser.size().z);
@@ -92,70 +135,54 @@ void FdmMgUtils3::correct(const FdmVector3 &coarser, FdmVector3 *finer) {
     //           to
     //  1/4   3/4   3/4   1/4
     // --*--|--*--|--*--|--*--
+
+    // Separable like restrict(): the coarser grid is interpolated along z and
+    // y over contiguous coarse rows, then along x while adding to the finer
+    // row.
     const Size3 n = finer->size();
-    parallelRangeFor(kZeroSize, n.x, kZeroSize, n.y, kZeroSize, n.z,
-                     [&](size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd) {
-                         for (size_t k = kBegin; k < kEnd; ++k) {
-                             for (size_t j = jBegin; j < jEnd; ++j) {
-                                 for (size_t i = iBegin; i < iEnd; ++i) {
-                                     std::array<size_t, 2> iIndices{};
-                                     std::array<size_t, 2> jIndices{};
-                                     std::array<size_t, 2> kIndices{};
-                                     std::array<double, 2> iWeights{};
-                                     std::array<double, 2> jWeights{};
-                                     std::array<double, 2> kWeights{};
-
-                                     const size_t ci = i / 2;
-                                     const size_t cj = j / 2;
-                                     const size_t ck = k / 2;
-
-                                     if (i % 2 == 0) {
-                                         iIndices[0] = (i > 1) ? ci - 1 : ci;
-                                         iIndices[1] = ci;
-                                         iWeights[0] = 0.25;
-                                         iWeights[1] = 0.75;
-                                     } else {
-                                         iIndices[0] = ci;
-                                         iIndices[1] = (i + 1 < n.x) ? ci + 1 : ci;
-                                         iWeights[0] = 0.75;
-                                         iWeights[1] = 0.25;
-                                     }
-
-                                     if (j % 2 == 0) {
-                                         jIndices[0] = (j > 1) ? cj - 1 : cj;
-                                         jIndices[1] = cj;
-                                         jWeights[0] = 0.25;
-                                         jWeights[1] = 0.75;
-                                     } else {
-                                         jIndices[0] = cj;
-                                         jIndices[1] = (j + 1 < n.y) ? cj + 1 : cj;
-                                         jWeights[0] = 0.75;
-                                         jWeights[1] = 0.25;
-                                     }
-
-                                     if (k % 2 == 0) {
-                                         kIndices[0] = (k > 1) ? ck - 1 : ck;
-                                         kIndices[1] = ck;
-                                         kWeights[0] = 0.25;
-                                         kWeights[1] = 0.75;
-                                     } else {
-                                         kIndices[0] = ck;
-                                         kIndices[1] = (k + 1 < n.y) ? ck + 1 : ck;
-                                         kWeights[0] = 0.75;
-                                         kWeights[1] = 0.25;
-                                     }
-
-                                     for (size_t z = 0; z < 2; ++z) {
-                                         for (size_t y = 0; y < 2; ++y) {
-                                             for (size_t x = 0; x < 2; ++x) {
-                                                 double w = iWeights[x] * jWeights[y] * kWeights[z] *
-                                                            coarser(iIndices[x], jIndices[y], kIndices[z]);
-                                                 (*finer)(i, j, k) += w;
-                                             }
-                                         }
-                                     }
-                                 }
-                             }
-                         }
-                     });
+    const Size3 cn = coarser.size();
+    parallelRangeFor(kZeroSize, n.z, [&](size_t kBegin, size_t kEnd) {
+        std::vector<T> plane(cn.x * cn.y);
+        std::vector<T> row(cn.x);
+
+        for (size_t k = kBegin; k < kEnd; ++k) {
+            const CorrectionStencil<T> kStencil = correctionStencil<T>(k, n.z);
+
+            for (size_t cj = 0; cj < cn.y; ++cj) {
+                const T *z0 = &coarser(0, cj, kStencil.indices[0]);
+                const T *z1 = &coarser(0, cj, kStencil.indices[1]);
+                T *dst = &plane[cj * cn.x];
+                for (size_t ci = 0; ci < cn.x; ++ci) {
+                    dst[ci] = kStencil.weights[0] * z0[ci] + kStencil.weights[1] * z1[ci];
+                }
+            }
+
+            for (size_t j = 0; j < n.y; ++j) {
+                const CorrectionStencil<T> jStencil = correctionStencil<T>(j, n.y);
+                const T *y0 = &plane[jStencil.indices[0] * cn.x];
+                const T *y1 = &plane[jStencil.indices[1] * cn.x];
+                for (size_t ci = 0; ci < cn.x; ++ci) {
+                    row[ci] = jStencil.weights[0] * y0[ci] + jStencil.weights[1] * y1[ci];
+                }
+
+                T *dst = &(*finer)(0, j, k);
+                for (size_t i = 0; i < n.x; ++i) {
+                    const CorrectionStencil<T> iStencil = correctionStencil<T>(i, n.x);
+                    dst[i] += iStencil.weights[0] * row[iStencil.indices[0]] +
+                              iStencil.weights[1] * row[iStencil.indices[1]];
+                }
+            }
+        }
+    });
 }
+
+namespace vox {
+
+template struct FdmMgLinearSystem<float, 3>;
+template struct FdmMgLinearSystem<double, 3>;
+template void FdmMgUtils3::restrict(const FdmVector3F &, FdmVector3F *);
+template void FdmMgUtils3::restrict(const FdmVector3 &, FdmVector3 *);
+template void FdmMgUtils3::correct(const FdmVector3F &, FdmVector3F *);
+template void FdmMgUtils3::correct(const FdmVector3 &, FdmVector3 *);
+
+}  // namespace vox
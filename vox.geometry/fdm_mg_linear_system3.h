@@ -15,19 +15,30 @@ namespace vox {
 //! Multigrid-style 3-D FDM matrix.
 typedef MgMatrix<FdmBlas3> FdmMgMatrix3;
 
+//! Single-precision multigrid-style 3-D FDM matrix.
+typedef MgMatrix<FdmBlas3F> FdmMgMatrix3F;
+
 //! Multigrid-style 3-D FDM vector.
 typedef MgVector<FdmBlas3> FdmMgVector3;
 
+//! Single-precision multigrid-style 3-D FDM vector.
+typedef MgVector<FdmBlas3F> FdmMgVector3F;
+
+//! Multigrid-syle FDM linear system, specialized for each dimension.
+template <typename T, size_t N>
+struct FdmMgLinearSystem;
+
 //! Multigrid-syle 3-D linear system.
-struct FdmMgLinearSystem3 {
+template <typename T>
+struct FdmMgLinearSystem<T, 3> {
     //! The system matrix.
-    FdmMgMatrix3 A;
+    MgMatrix<FdmBlas<T, 3>> A;
 
     //! The solution vector.
-    FdmMgVector3 x;
+    MgVector<FdmBlas<T, 3>> x;
 
     //! The RHS vector.
-    FdmMgVector3 b;
+    MgVector<FdmBlas<T, 3>> b;
 
     //! Clears the linear system.
     void clear();
@@ -51,14 +62,22 @@ struct FdmMgLinearSystem3 {
     void resizeWithFinest(const Size3 &finestResolution, size_t maxNumberOfLevels);
 };
 
+//! Double-precision multigrid-syle 3-D linear system.
+typedef FdmMgLinearSystem<double, 3> FdmMgLinearSystem3;
+
+//! Single-precision multigrid-syle 3-D linear system.
+typedef FdmMgLinearSystem<float, 3> FdmMgLinearSystem3F;
+
 //! Multigrid utilities for 2-D FDM system.
 class FdmMgUtils3 {
 public:
     //! Restricts given finer grid to the coarser grid.
-    static void restrict(const FdmVector3 &finer, FdmVector3 *coarser);
+    template <typename T>
+    static void restrict(const Array3<T> &finer, Array3<T> *coarser);
 
     //! Corrects given coarser grid to the finer grid.
-    static void correct(const FdmVector3 &coarser, FdmVector3 *finer);
+    template <typename T>
+    static void correct(const Array3<T> &coarser, Array3<T> *finer);
 
     //! Resizes the array with the coarsest resolution and number of levels.
     template <typename T>
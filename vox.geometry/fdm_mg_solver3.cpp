@@ -10,14 +10,15 @@
 
 using namespace vox;
 
-FdmMgSolver3::FdmMgSolver3(size_t maxNumberOfLevels,
-                           unsigned int numberOfRestrictionIter,
-                           unsigned int numberOfCorrectionIter,
-                           unsigned int numberOfCoarsestIter,
-                           unsigned int numberOfFinalIter,
-                           double maxTolerance,
-                           double sorFactor,
-                           bool useRedBlackOrdering) {
+template <typename T>
+FdmMgSolver<T, 3>::FdmMgSolver(size_t maxNumberOfLevels,
+                               unsigned int numberOfRestrictionIter,
+                               unsigned int numberOfCorrectionIter,
+                               unsigned int numberOfCoarsestIter,
+                               unsigned int numberOfFinalIter,
+                               double maxTolerance,
+                               double sorFactor,
+                               bool useRedBlackOrdering) {
     _mgParams.maxNumberOfLevels = maxNumberOfLevels;
     _mgParams.numberOfRestrictionIter = numberOfRestrictionIter;
     _mgParams.numberOfCorrectionIter = numberOfCorrectionIter;
@@ -25,37 +26,57 @@ FdmMgSolver3::FdmMgSolver3(size_t maxNumberOfLevels,
     _mgParams.numberOfFinalIter = numberOfFinalIter;
     _mgParams.maxTolerance = maxTolerance;
     if (useRedBlackOrdering) {
-        _mgParams.relaxFunc = [sorFactor](const FdmMatrix3 &A, const FdmVector3 &b, unsigned int numberOfIterations,
-                                          double maxTolerance, FdmVector3 *x, FdmVector3 *buffer) {
-            for (unsigned int iter = 0; iter < numberOfIterations; ++iter) {
-                FdmGaussSeidelSolver3::relaxRedBlack(A, b, sorFactor, x);
-            }
+        _mgParams.relaxFunc = [sorFactor](const Array3<FdmMatrixRow<T, 3>> &A, const Array3<T> &b,
+                                          unsigned int numberOfIterations, double maxTolerance, Array3<T> *x,
+                                          Array3<T> *buffer) {
+            FdmGaussSeidelSolver3::relaxRedBlack(A, b, sorFactor, numberOfIterations, x);
         };
     } else {
-        _mgParams.relaxFunc = [sorFactor](const FdmMatrix3 &A, const FdmVector3 &b, unsigned int numberOfIterations,
-                                          double maxTolerance, FdmVector3 *x, FdmVector3 *buffer) {
+        _mgParams.relaxFunc = [sorFactor](const Array3<FdmMatrixRow<T, 3>> &A, const Array3<T> &b,
+                                          unsigned int numberOfIterations, double maxTolerance, Array3<T> *x,
+                                          Array3<T> *buffer) {
             for (unsigned int iter = 0; iter < numberOfIterations; ++iter) {
                 FdmGaussSeidelSolver3::relax(A, b, sorFactor, x);
             }
         };
     }
-    _mgParams.restrictFunc = FdmMgUtils3::restrict;
-    _mgParams.correctFunc = FdmMgUtils3::correct;
+    _mgParams.restrictFunc = FdmMgUtils3::restrict<T>;
+    _mgParams.correctFunc = FdmMgUtils3::correct<T>;
 
     _sorFactor = sorFactor;
     _useRedBlackOrdering = useRedBlackOrdering;
 }
 
-const MgParameters<FdmBlas3> &FdmMgSolver3::params() const { return _mgParams; }
+template <typename T>
+const MgParameters<FdmBlas<T, 3>> &FdmMgSolver<T, 3>::params() const {
+    return _mgParams;
+}
 
-double FdmMgSolver3::sorFactor() const { return _sorFactor; }
+template <typename T>
+double FdmMgSolver<T, 3>::sorFactor() const {
+    return _sorFactor;
+}
 
-bool FdmMgSolver3::useRedBlackOrdering() const { return _useRedBlackOrdering; }
+template <typename T>
+bool FdmMgSolver<T, 3>::useRedBlackOrdering() const {
+    return _useRedBlackOrdering;
+}
 
-bool FdmMgSolver3::solve(FdmLinearSystem3 *system) { return false; }
+template <typename T>
+bool FdmMgSolver<T, 3>::solve(FdmLinearSystem<T, 3> *system) {
+    return false;
+}
 
-bool FdmMgSolver3::solve(FdmMgLinearSystem3 *system) {
-    FdmMgVector3 buffer = system->x;
+template <typename T>
+bool FdmMgSolver<T, 3>::solve(FdmMgLinearSystem<T, 3> *system) {
+    MgVector<FdmBlas<T, 3>> buffer = system->x;
     auto result = mgVCycle(system->A, _mgParams, &system->x, &system->b, &buffer);
     return result.lastResidualNorm < _mgParams.maxTolerance;
 }
+
+namespace vox {
+
+template class FdmMgSolver<float, 3>;
+template class FdmMgSolver<double, 3>;
+
+}  // namespace vox
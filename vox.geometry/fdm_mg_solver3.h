@@ -12,25 +12,31 @@
 
 namespace vox {
 
+//! \brief Finite difference-type linear system solver using Multigrid,
+//!        specialized for each dimension.
+template <typename T, size_t N>
+class FdmMgSolver;
+
 //! \brief 3-D finite difference-type linear system solver using Multigrid.
-class FdmMgSolver3 : public FdmLinearSystemSolver3 {
+template <typename T>
+class FdmMgSolver<T, 3> : public FdmLinearSystemSolver<T, 3> {
 public:
-    FdmMgSolver3() = default;
+    FdmMgSolver() = default;
 
-    ~FdmMgSolver3() override = default;
+    ~FdmMgSolver() override = default;
 
     //! Constructs the solver with given parameters.
-    explicit FdmMgSolver3(size_t maxNumberOfLevels,
-                          unsigned int numberOfRestrictionIter = 5,
-                          unsigned int numberOfCorrectionIter = 5,
-                          unsigned int numberOfCoarsestIter = 20,
-                          unsigned int numberOfFinalIter = 20,
-                          double maxTolerance = 1e-9,
-                          double sorFactor = 1.5,
-                          bool useRedBlackOrdering = false);
+    explicit FdmMgSolver(size_t maxNumberOfLevels,
+                         unsigned int numberOfRestrictionIter = 5,
+                         unsigned int numberOfCorrectionIter = 5,
+                         unsigned int numberOfCoarsestIter = 20,
+                         unsigned int numberOfFinalIter = 20,
+                         double maxTolerance = 1e-9,
+                         double sorFactor = 1.5,
+                         bool useRedBlackOrdering = false);
 
     //! Returns the Multigrid parameters.
-    [[nodiscard]] const MgParameters<FdmBlas3> &params() const;
+    [[nodiscard]] const MgParameters<FdmBlas<T, 3>> &params() const;
 
     //! Returns the SOR (Successive Over Relaxation) factor.
     [[nodiscard]] double sorFactor() const;
@@ -39,18 +45,27 @@ public:
     [[nodiscard]] bool useRedBlackOrdering() const;
 
     //! No-op. Multigrid-type solvers do not solve FdmLinearSystem3.
-    bool solve(FdmLinearSystem3 *system) final;
+    bool solve(FdmLinearSystem<T, 3> *system) final;
 
     //! Solves Multigrid linear system.
-    virtual bool solve(FdmMgLinearSystem3 *system);
+    virtual bool solve(FdmMgLinearSystem<T, 3> *system);
 
 private:
-    MgParameters<FdmBlas3> _mgParams;
+    MgParameters<FdmBlas<T, 3>> _mgParams;
     double _sorFactor{};
     bool _useRedBlackOrdering{};
 };
 
+//! Double-precision 3-D Multigrid solver.
+typedef FdmMgSolver<double, 3> FdmMgSolver3;
+
+//! Single-precision 3-D Multigrid solver.
+typedef FdmMgSolver<float, 3> FdmMgSolver3F;
+
 //! Shared pointer type for the FdmMgSolver3.
 typedef std::shared_ptr<FdmMgSolver3> FdmMgSolver3Ptr;
 
+//! Shared pointer type for the FdmMgSolver3F.
+typedef std::shared_ptr<FdmMgSolver3F> FdmMgSolver3FPtr;
+
 }  // namespace vox
\ No newline at end of file
@@ -9,21 +9,58 @@
 #include <utility>
 
 #include "vox.base/logging.h"
+#include "vox.base/parallel.h"
 #include "vox.geometry/cg.h"
 #include "vox.geometry/mg.h"
 
 using namespace vox;
 
-void FdmMgpcgSolver3::Preconditioner::build(FdmMgLinearSystem3 *system_, MgParameters<FdmBlas3> mgParams_) {
+namespace {
+
+template <typename T, typename U>
+void convert(const Array3<T> &from, Array3<U> *to) {
+    const Size3 size = from.size();
+    to->resize(size);
+    parallelFor(kZeroSize, size.x * size.y * size.z, [&](size_t i) { (*to)[i] = static_cast<U>(from[i]); });
+}
+
+template <typename T, typename U>
+void convert(const Array3<FdmMatrixRow<T, 3>> &from, Array3<FdmMatrixRow<U, 3>> *to) {
+    const Size3 size = from.size();
+    to->resize(size);
+    parallelFor(kZeroSize, size.x * size.y * size.z, [&](size_t i) {
+        (*to)[i].center = static_cast<U>(from[i].center);
+        (*to)[i].right = static_cast<U>(from[i].right);
+        (*to)[i].up = static_cast<U>(from[i].up);
+        (*to)[i].front = static_cast<U>(from[i].front);
+    });
+}
+
+// Maps the parameters of a double-precision solver to the single-precision
+// functions.
+MgParameters<FdmBlas3F> toSinglePrecision(const FdmMgSolver3 &solver) {
+    const MgParameters<FdmBlas3> &params = solver.params();
+    return FdmMgSolver3F(params.maxNumberOfLevels, params.numberOfRestrictionIter, params.numberOfCorrectionIter,
+                         params.numberOfCoarsestIter, params.numberOfFinalIter, params.maxTolerance,
+                         solver.sorFactor(), solver.useRedBlackOrdering())
+            .params();
+}
+
+}  // namespace
+
+template <typename T>
+void FdmMgpcgSolver<T, 3>::Preconditioner::build(FdmMgLinearSystem<T, 3> *system_,
+                                                 MgParameters<FdmBlas<T, 3>> mgParams_) {
     system = system_;
     mgParams = std::move(mgParams_);
 }
 
-void FdmMgpcgSolver3::Preconditioner::solve(const FdmVector3 &b, FdmVector3 *x) const {
+template <typename T>
+void FdmMgpcgSolver<T, 3>::Preconditioner::solve(const Array3<T> &b, Array3<T> *x) const {
     // Copy dimension
-    FdmMgVector3 mgX = system->x;
-    FdmMgVector3 mgB = system->x;
-    FdmMgVector3 mgBuffer = system->x;
+    MgVector<FdmBlas<T, 3>> mgX = system->x;
+    MgVector<FdmBlas<T, 3>> mgB = system->x;
+    MgVector<FdmBlas<T, 3>> mgBuffer = system->x;
 
     // Copy input to the top
     mgX.levels.front().set(*x);
@@ -37,15 +74,119 @@ void FdmMgpcgSolver3::Preconditioner::solve(const FdmVector3 &b, FdmVector3 *x)
 
 //
 
-FdmMgpcgSolver3::FdmMgpcgSolver3(unsigned int numberOfCgIter,
-                                 size_t maxNumberOfLevels,
-                                 unsigned int numberOfRestrictionIter,
-                                 unsigned int numberOfCorrectionIter,
-                                 unsigned int numberOfCoarsestIter,
-                                 unsigned int numberOfFinalIter,
-                                 double maxTolerance,
-                                 double sorFactor,
-                                 bool useRedBlackOrdering)
+template <typename T>
+FdmMgpcgSolver<T, 3>::FdmMgpcgSolver(unsigned int numberOfCgIter,
+                                     size_t maxNumberOfLevels,
+                                     unsigned int numberOfRestrictionIter,
+                                     unsigned int numberOfCorrectionIter,
+                                     unsigned int numberOfCoarsestIter,
+                                     unsigned int numberOfFinalIter,
+                                     double maxTolerance,
+                                     double sorFactor,
+                                     bool useRedBlackOrdering)
+    : FdmMgSolver<T, 3>(maxNumberOfLevels,
+                        numberOfRestrictionIter,
+                        numberOfCorrectionIter,
+                        numberOfCoarsestIter,
+                        numberOfFinalIter,
+                        maxTolerance,
+                        sorFactor,
+                        useRedBlackOrdering),
+      _maxNumberOfIterations(numberOfCgIter),
+      _lastNumberOfIterations(0),
+      _tolerance(maxTolerance),
+      _lastResidualNorm(kMaxD) {}
+
+template <typename T>
+bool FdmMgpcgSolver<T, 3>::solve(FdmMgLinearSystem<T, 3> *system) {
+    Size3 size = system->A.levels.front().size();
+    _r.resize(size);
+    _d.resize(size);
+    _q.resize(size);
+    _s.resize(size);
+
+    system->x.levels.front().set(0);
+    _r.set(0);
+    _d.set(0);
+    _q.set(0);
+    _s.set(0);
+
+    _precond.build(system, this->params());
+
+    pcg<FdmBlas<T, 3>, Preconditioner>(system->A.levels.front(), system->b.levels.front(), _maxNumberOfIterations,
+                                       _tolerance, &_precond, &system->x.levels.front(), &_r, &_d, &_q, &_s,
+                                       &_lastNumberOfIterations, &_lastResidualNorm);
+
+    LOGI("Residual after solving MGPCG: {} Number of MGPCG iterations: {}", _lastResidualNorm, _lastNumberOfIterations)
+
+    return _lastResidualNorm <= _tolerance || _lastNumberOfIterations < _maxNumberOfIterations;
+}
+
+template <typename T>
+unsigned int FdmMgpcgSolver<T, 3>::maxNumberOfIterations() const {
+    return _maxNumberOfIterations;
+}
+
+template <typename T>
+unsigned int FdmMgpcgSolver<T, 3>::lastNumberOfIterations() const {
+    return _lastNumberOfIterations;
+}
+
+template <typename T>
+double FdmMgpcgSolver<T, 3>::tolerance() const {
+    return _tolerance;
+}
+
+template <typename T>
+double FdmMgpcgSolver<T, 3>::lastResidual() const {
+    return _lastResidualNorm;
+}
+
+namespace vox {
+
+template class FdmMgpcgSolver<float, 3>;
+template class FdmMgpcgSolver<double, 3>;
+
+}  // namespace vox
+
+//
+
+void FdmMixedMgpcgSolver3::Preconditioner::build(const FdmMgLinearSystem3 &system_,
+                                                 MgParameters<FdmBlas3F> mgParams_) {
+    const size_t numberOfLevels = system_.numberOfLevels();
+    system.A.levels.resize(numberOfLevels);
+    system.x.levels.resize(numberOfLevels);
+    system.b.levels.resize(numberOfLevels);
+    for (size_t l = 0; l < numberOfLevels; ++l) {
+        convert(system_.A[l], &system.A[l]);
+        system.x[l].resize(system_.x[l].size());
+        system.b[l].resize(system_.b[l].size());
+    }
+    buffer = system.x;
+    mgParams = std::move(mgParams_);
+}
+
+void FdmMixedMgpcgSolver3::Preconditioner::solve(const FdmVector3 &b, FdmVector3 *x) {
+    // Only the finest level carries data in; the V-cycle fills the rest.
+    convert(*x, &system.x.finest());
+    convert(b, &system.b.finest());
+
+    mgVCycle(system.A, mgParams, &system.x, &system.b, &buffer);
+
+    convert(system.x.finest(), x);
+}
+
+//
+
+FdmMixedMgpcgSolver3::FdmMixedMgpcgSolver3(unsigned int numberOfCgIter,
+                                           size_t maxNumberOfLevels,
+                                           unsigned int numberOfRestrictionIter,
+                                           unsigned int numberOfCorrectionIter,
+                                           unsigned int numberOfCoarsestIter,
+                                           unsigned int numberOfFinalIter,
+                                           double maxTolerance,
+                                           double sorFactor,
+                                           bool useRedBlackOrdering)
     : FdmMgSolver3(maxNumberOfLevels,
                    numberOfRestrictionIter,
                    numberOfCorrectionIter,
@@ -59,7 +200,7 @@ FdmMgpcgSolver3::FdmMgpcgSolver3(unsigned int numberOfCgIter,
       _tolerance(maxTolerance),
       _lastResidualNorm(kMaxD) {}
 
-bool FdmMgpcgSolver3::solve(FdmMgLinearSystem3 *system) {
+bool FdmMixedMgpcgSolver3::solve(FdmMgLinearSystem3 *system) {
     Size3 size = system->A.levels.front().size();
     _r.resize(size);
     _d.resize(size);
@@ -72,21 +213,22 @@ bool FdmMgpcgSolver3::solve(FdmMgLinearSystem3 *system) {
     _q.set(0.0);
     _s.set(0.0);
 
-    _precond.build(system, params());
+    _precond.build(*system, toSinglePrecision(*this));
 
     pcg<FdmBlas3, Preconditioner>(system->A.levels.front(), system->b.levels.front(), _maxNumberOfIterations,
                                   _tolerance, &_precond, &system->x.levels.front(), &_r, &_d, &_q, &_s,
                                   &_lastNumberOfIterations, &_lastResidualNorm);
 
-    LOGI("Residual after solving MGPCG: {} Number of MGPCG iterations: {}", _lastResidualNorm, _lastNumberOfIterations)
+    LOGI("Residual after solving mixed-precision MGPCG: {} Number of MGPCG iterations: {}", _lastResidualNorm,
+         _lastNumberOfIterations)
 
     return _lastResidualNorm <= _tolerance || _lastNumberOfIterations < _maxNumberOfIterations;
 }
 
-unsigned int FdmMgpcgSolver3::maxNumberOfIterations() const { return _maxNumberOfIterations; }
+unsigned int FdmMixedMgpcgSolver3::maxNumberOfIterations() const { return _maxNumberOfIterations; }
 
-unsigned int FdmMgpcgSolver3::lastNumberOfIterations() const { return _lastNumberOfIterations; }
+unsigned int FdmMixedMgpcgSolver3::lastNumberOfIterations() const { return _lastNumberOfIterations; }
 
-double FdmMgpcgSolver3::tolerance() const { return _tolerance; }
+double FdmMixedMgpcgSolver3::tolerance() const { return _tolerance; }
 
-double FdmMgpcgSolver3::lastResidual() const { return _lastResidualNorm; }
+double FdmMixedMgpcgSolver3::lastResidual() const { return _lastResidualNorm; }
@@ -10,6 +10,11 @@
 
 namespace vox {
 
+//! \brief Finite difference-type linear system solver using MGPCG,
+//!        specialized for each dimension.
+template <typename T, size_t N>
+class FdmMgpcgSolver;
+
 //!
 //! \brief 3-D finite difference-type linear system solver using Multigrid
 //!        Preconditioned conjugate gradient (MGPCG).
@@ -19,7 +24,8 @@ namespace vox {
 //!      grids." Proceedings of the 2010 ACM SIGGRAPH/Eurographics Symposium on
 //!      Computer Animation. Eurographics Association, 2010.
 //!
-class FdmMgpcgSolver3 final : public FdmMgSolver3 {
+template <typename T>
+class FdmMgpcgSolver<T, 3> final : public FdmMgSolver<T, 3> {
 public:
     //!
     //! Constructs the solver with given parameters.
@@ -31,18 +37,18 @@ public:
     //! \param numberOfCoarsestIter - Number of iterations at the coarsest grid.
     //! \param numberOfFinalIter - Number of final iterations.
     //! \param maxTolerance - Number of max residual tolerance.
-    FdmMgpcgSolver3(unsigned int numberOfCgIter,
-                    size_t maxNumberOfLevels,
-                    unsigned int numberOfRestrictionIter = 5,
-                    unsigned int numberOfCorrectionIter = 5,
-                    unsigned int numberOfCoarsestIter = 20,
-                    unsigned int numberOfFinalIter = 20,
-                    double maxTolerance = 1e-9,
-                    double sorFactor = 1.5,
-                    bool useRedBlackOrdering = false);
+    FdmMgpcgSolver(unsigned int numberOfCgIter,
+                   size_t maxNumberOfLevels,
+                   unsigned int numberOfRestrictionIter = 5,
+                   unsigned int numberOfCorrectionIter = 5,
+                   unsigned int numberOfCoarsestIter = 20,
+                   unsigned int numberOfFinalIter = 20,
+                   double maxTolerance = 1e-9,
+                   double sorFactor = 1.5,
+                   bool useRedBlackOrdering = false);
 
     //! Solves the given linear system.
-    bool solve(FdmMgLinearSystem3 *system) override;
+    bool solve(FdmMgLinearSystem<T, 3> *system) override;
 
     //! Returns the max number of Jacobi iterations.
     [[nodiscard]] unsigned int maxNumberOfIterations() const;
@@ -58,12 +64,85 @@ public:
 
 private:
     struct Preconditioner final {
-        FdmMgLinearSystem3 *system;
-        MgParameters<FdmBlas3> mgParams;
+        FdmMgLinearSystem<T, 3> *system;
+        MgParameters<FdmBlas<T, 3>> mgParams;
+
+        void build(FdmMgLinearSystem<T, 3> *system, MgParameters<FdmBlas<T, 3>> mgParams);
+
+        void solve(const Array3<T> &b, Array3<T> *x) const;
+    };
+
+    unsigned int _maxNumberOfIterations;
+    unsigned int _lastNumberOfIterations;
+    double _tolerance;
+    double _lastResidualNorm;
+
+    Array3<T> _r;
+    Array3<T> _d;
+    Array3<T> _q;
+    Array3<T> _s;
+    Preconditioner _precond;
+};
+
+//! Double-precision 3-D MGPCG solver.
+typedef FdmMgpcgSolver<double, 3> FdmMgpcgSolver3;
+
+//! Single-precision 3-D MGPCG solver.
+typedef FdmMgpcgSolver<float, 3> FdmMgpcgSolver3F;
+
+//! Shared pointer type for the FdmMgpcgSolver3.
+typedef std::shared_ptr<FdmMgpcgSolver3> FdmMgpcgSolver3Ptr;
+
+//! Shared pointer type for the FdmMgpcgSolver3F.
+typedef std::shared_ptr<FdmMgpcgSolver3F> FdmMgpcgSolver3FPtr;
+
+//!
+//! \brief 3-D mixed-precision MGPCG solver.
+//!
+//! The outer conjugate gradient iterates on the double-precision system while
+//! the Multigrid V-cycle preconditioner runs on a single-precision copy of the
+//! matrix hierarchy. Since the preconditioner only needs to approximate the
+//! inverse, this halves its memory traffic without limiting the accuracy of
+//! the solution. The preconditioner uses the Multigrid parameters of the
+//! solver, see params().
+//!
+class FdmMixedMgpcgSolver3 final : public FdmMgSolver3 {
+public:
+    //! Constructs the solver with the same parameters as FdmMgpcgSolver3.
+    FdmMixedMgpcgSolver3(unsigned int numberOfCgIter,
+                         size_t maxNumberOfLevels,
+                         unsigned int numberOfRestrictionIter = 5,
+                         unsigned int numberOfCorrectionIter = 5,
+                         unsigned int numberOfCoarsestIter = 20,
+                         unsigned int numberOfFinalIter = 20,
+                         double maxTolerance = 1e-9,
+                         double sorFactor = 1.5,
+                         bool useRedBlackOrdering = false);
+
+    //! Solves the given linear system.
+    bool solve(FdmMgLinearSystem3 *system) override;
+
+    //! Returns the max number of CG iterations.
+    [[nodiscard]] unsigned int maxNumberOfIterations() const;
+
+    //! Returns the last number of CG iterations the solver made.
+    [[nodiscard]] unsigned int lastNumberOfIterations() const;
+
+    //! Returns the max residual tolerance for the CG method.
+    [[nodiscard]] double tolerance() const;
+
+    //! Returns the last residual after the CG iterations.
+    [[nodiscard]] double lastResidual() const;
+
+private:
+    struct Preconditioner final {
+        FdmMgLinearSystem3F system;
+        FdmMgVector3F buffer;
+        MgParameters<FdmBlas3F> mgParams;
 
-        void build(FdmMgLinearSystem3 *system, MgParameters<FdmBlas3> mgParams);
+        void build(const FdmMgLinearSystem3 &system, MgParameters<FdmBlas3F> mgParams);
 
-        void solve(const FdmVector3 &b, FdmVector3 *x) const;
+        void solve(const FdmVector3 &b, FdmVector3 *x);
     };
 
     unsigned int _maxNumberOfIterations;
@@ -78,7 +157,7 @@ private:
     Preconditioner _precond;
 };
 
-//! Shared pointer type for the FdmMgpcgSolver3.
-typedef std::shared_ptr<FdmMgpcgSolver3> FdmMgpcgSolver3Ptr;
+//! Shared pointer type for the FdmMixedMgpcgSolver3.
+typedef std::shared_ptr<FdmMixedMgpcgSolver3> FdmMixedMgpcgSolver3Ptr;
 
 }  // namespace vox
\ No newline at end of file
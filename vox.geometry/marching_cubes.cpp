@@ -21,8 +21,11 @@
 #include "vox.geometry/marching_cubes.h"
 
 #include <array>
+#include <limits>
 #include <unordered_map>
+#include <vector>
 
+#include "vox.base/parallel.h"
 #include "vox.geometry/level_set_utils.h"
 #include "vox.geometry/marching_cubes_table.h"
 #include "vox.geometry/marching_squares_table.h"
@@ -227,15 +230,42 @@ static void singleSquare(const std::array<double, 4>& data,
     }
 }
 
-static void singleCube(const std::array<double, 8>& data,
-                       const std::array<size_t, 12>& edgeIds,
-                       const std::array<Vector3D, 8>& normals,
-                       const BoundingBox3D& bound,
-                       MarchingCubeVertexMap* vertexMap,
-                       TriangleMesh3* mesh,
-                       double isoValue) {
-    int itrVertex, itrEdge, itrTri;
-    int idxFlagSize = 0, idxEdgeFlags = 0;
+// Vertices and triangles extracted from a slab of cells, indexed locally.
+struct MarchingCubesSlab {
+    std::vector<Point3D> points;
+    std::vector<Vector3D> normals;
+    std::vector<MarchingCubeVertexHashKey> keys;
+    std::vector<Point3UI> triangles;
+
+    // Vertices on the lowest and highest xy planes of the slab, as pairs of
+    // edge slot in the plane and local vertex id. The lowest ones are also
+    // extracted by the slab below.
+    std::vector<std::pair<size_t, uint32_t>> lowerPlane;
+    std::vector<std::pair<size_t, uint32_t>> upperPlane;
+};
+
+constexpr uint32_t kNoVertex = std::numeric_limits<uint32_t>::max();
+
+// Number of layers of cells extracted by the same task.
+constexpr ssize_t kSlabSize = 16;
+
+// Returns the slot of an edge in the cache of its plane, in doubled virtual
+// vertex indices (see globalEdgeId). Planes at grid points hold the x and y
+// edges, the ones in between hold the z edges.
+inline size_t edgeSlot(size_t x2, size_t y2, const Size3& dim) {
+    return 2 * ((x2 >> 1) + dim.x * (y2 >> 1)) + (y2 & 1);
+}
+
+template <typename FindOrAddVertex>
+void singleCube(const std::array<double, 8>& data,
+                const std::array<Vector3D, 8>& normals,
+                const BoundingBox3D& bound,
+                int idxFlagSize,
+                const FindOrAddVertex& findOrAddVertex,
+                std::vector<Point3UI>* triangles,
+                double isoValue) {
+    int itrEdge, itrTri;
+    int idxEdgeFlags = 0;
     int idxVertexOfTheEdge[2];
 
     Point3D pos, pos0, pos1;
@@ -245,21 +275,6 @@ static void singleCube(const std::array<double, 8>& data,
     Point3D e[12];
     Vector3D n[12];
 
-    // Which vertices are inside? If i-th vertex is inside, mark '1' at i-th
-    // bit. of 'idxFlagSize'.
-    for (itrVertex = 0; itrVertex < 8; itrVertex++) {
-        if (data[itrVertex] <= isoValue) {
-            idxFlagSize |= 1 << itrVertex;
-        }
-    }
-
-    // If the cube is entirely inside or outside of the surface, there is no job
-    // to be done in t1his marching-cube cell.
-    if (idxFlagSize == 0 || idxFlagSize == 255) {
-        return;
-    }
-
-    // If there are vertices which is inside the surface...
     // Which edges intersect the surface? If i-th edge intersects the surface,
     // mark '1' at i-th bit of 'itrEdgeFlags'
     idxEdgeFlags = cubeEdgeFlags[idxFlagSize];
@@ -312,50 +327,59 @@ static void singleCube(const std::array<double, 8>& data,
         Point3UI face;
 
         for (int j = 0; j < 3; j++) {
-            int k = 3 * itrTri + j;
-            MarchingCubeVertexHashKey vKey = edgeIds[triangleConnectionTable3D[idxFlagSize][k]];
-            MarchingCubeVertexId vId;
-            if (queryVertexId(*vertexMap, vKey, &vId)) {
-                face[j] = vId;
-            } else {
-                // If vertex does not exist from the map
-                face[j] = mesh->numberOfPoints();
-                mesh->addNormal(safeNormalize(n[triangleConnectionTable3D[idxFlagSize][k]]));
-                mesh->addPoint(e[triangleConnectionTable3D[idxFlagSize][k]]);
-                mesh->addUv(Vector2D());
-                vertexMap->insert(std::make_pair(vKey, face[j]));
-            }
+            const int edge = triangleConnectionTable3D[idxFlagSize][3 * itrTri + j];
+            face[j] = findOrAddVertex(edge, e[edge], n[edge]);
         }
-        mesh->addPointUvNormalTriangle(face, face, face);
+        triangles->push_back(face);
     }
 }
 
-void marchingCubes(const ConstArrayAccessor3<double>& grid,
-                   const Vector3D& gridSize,
-                   const Point3D& origin,
-                   TriangleMesh3* mesh,
-                   double isoValue,
-                   int bndClose,
-                   int bndConnectivity) {
-    MarchingCubeVertexMap vertexMap;
+// Extracts the cells of layers [kBegin, kEnd). Vertices are deduplicated with
+// caches indexed by edge, for the xy plane below the current layer of cells,
+// the one above it, and the z edges in between.
+void extractSlab(const ConstArrayAccessor3<double>& grid,
+                 const Vector3D& gridSize,
+                 const Point3D& origin,
+                 double isoValue,
+                 ssize_t kBegin,
+                 ssize_t kEnd,
+                 MarchingCubesSlab* slab) {
+    // See edgeConnection in marching_cubes_table.h for the edge ordering.
+    static const int edgeOffset3D[12][3] = {{1, 0, 0}, {2, 0, 1}, {1, 0, 2}, {0, 0, 1}, {1, 2, 0}, {2, 2, 1},
+                                            {1, 2, 2}, {0, 2, 1}, {0, 1, 0}, {2, 1, 0}, {2, 1, 2}, {0, 1, 2}};
 
     const Size3 dim = grid.size();
     const Vector3D invGridSize = 1.0 / gridSize;
+    const ssize_t dimx = static_cast<ssize_t>(dim.x);
+    const ssize_t dimy = static_cast<ssize_t>(dim.y);
 
     auto pos = [origin, gridSize](ssize_t i, ssize_t j, ssize_t k) { return origin + gridSize * Vector3D({i, j, k}); };
 
-    ssize_t dimx = static_cast<ssize_t>(dim.x);
-    ssize_t dimy = static_cast<ssize_t>(dim.y);
-    ssize_t dimz = static_cast<ssize_t>(dim.z);
+    const auto collectPlane = [](const std::vector<uint32_t>& cache, std::vector<std::pair<size_t, uint32_t>>* plane) {
+        for (size_t slot = 0; slot < cache.size(); ++slot) {
+            if (cache[slot] != kNoVertex) {
+                plane->emplace_back(slot, cache[slot]);
+            }
+        }
+    };
+
+    // caches[0] and caches[1] alternate as the planes below and above the
+    // current layer, caches[2] holds the z edges.
+    std::array<std::vector<uint32_t>, 3> caches;
+    for (auto& cache : caches) {
+        cache.resize(2 * dim.x * dim.y, kNoVertex);
+    }
+
+    for (ssize_t k = kBegin; k < kEnd; ++k) {
+        std::vector<uint32_t>* planeCaches[3] = {&caches[(k - kBegin) % 2], &caches[2], &caches[(k - kBegin + 1) % 2]};
+        if (k > kBegin) {
+            std::fill(planeCaches[1]->begin(), planeCaches[1]->end(), kNoVertex);
+            std::fill(planeCaches[2]->begin(), planeCaches[2]->end(), kNoVertex);
+        }
 
-    for (ssize_t k = 0; k < dimz - 1; ++k) {
         for (ssize_t j = 0; j < dimy - 1; ++j) {
             for (ssize_t i = 0; i < dimx - 1; ++i) {
                 std::array<double, 8> data;
-                std::array<size_t, 12> edgeIds;
-                std::array<Vector3D, 8> normals;
-                BoundingBox3D bound;
-
                 data[0] = grid(i, j, k);
                 data[1] = grid(i + 1, j, k);
                 data[4] = grid(i, j + 1, k);
@@ -365,6 +389,22 @@ void marchingCubes(const ConstArrayAccessor3<double>& grid,
                 data[7] = grid(i, j + 1, k + 1);
                 data[6] = grid(i + 1, j + 1, k + 1);
 
+                // Which vertices are inside? If i-th vertex is inside, mark '1'
+                // at i-th bit. of 'idxFlagSize'.
+                int idxFlagSize = 0;
+                for (int itrVertex = 0; itrVertex < 8; itrVertex++) {
+                    if (data[itrVertex] <= isoValue) {
+                        idxFlagSize |= 1 << itrVertex;
+                    }
+                }
+
+                // If the cube is entirely inside or outside of the surface,
+                // there is no job to be done in this marching-cube cell.
+                if (idxFlagSize == 0 || idxFlagSize == 255) {
+                    continue;
+                }
+
+                std::array<Vector3D, 8> normals;
                 normals[0] = grad(grid, i, j, k, invGridSize);
                 normals[1] = grad(grid, i + 1, j, k, invGridSize);
                 normals[4] = grad(grid, i, j + 1, k, invGridSize);
@@ -374,17 +414,111 @@ void marchingCubes(const ConstArrayAccessor3<double>& grid,
                 normals[7] = grad(grid, i, j + 1, k + 1, invGridSize);
                 normals[6] = grad(grid, i + 1, j + 1, k + 1, invGridSize);
 
-                for (int e = 0; e < 12; e++) {
-                    edgeIds[e] = globalEdgeId(i, j, k, dim, e);
-                }
-
+                BoundingBox3D bound;
                 bound.lower_corner = pos(i, j, k);
                 bound.upper_corner = pos(i + 1, j + 1, k + 1);
 
-                singleCube(data, edgeIds, normals, bound, &vertexMap, mesh, isoValue);
+                const auto findOrAddVertex = [&](int edge, const Point3D& point, const Vector3D& normal) {
+                    const int* offset = edgeOffset3D[edge];
+                    uint32_t& id =
+                            (*planeCaches[offset[2]])[edgeSlot(2 * i + offset[0], 2 * j + offset[1], dim)];
+                    if (id == kNoVertex) {
+                        id = static_cast<uint32_t>(slab->points.size());
+                        slab->points.push_back(point);
+                        slab->normals.push_back(safeNormalize(normal));
+                        slab->keys.push_back(globalEdgeId(i, j, k, dim, edge));
+                    }
+                    return id;
+                };
+                singleCube(data, normals, bound, idxFlagSize, findOrAddVertex, &slab->triangles, isoValue);
             }  // i
         }      // j
-    }          // k
+
+        if (k == kBegin) {
+            collectPlane(*planeCaches[0], &slab->lowerPlane);
+        }
+        if (k == kEnd - 1) {
+            collectPlane(*planeCaches[2], &slab->upperPlane);
+        }
+    }  // k
+}
+
+// Returns true if the edge of key lies on a face of the grid.
+inline bool isBoundaryEdge(MarchingCubeVertexHashKey key, const Size3& dim) {
+    const size_t x2 = key % (2 * dim.x);
+    const size_t y2 = (key / (2 * dim.x)) % (2 * dim.y);
+    const size_t z2 = key / (4 * dim.x * dim.y);
+    return x2 == 0 || y2 == 0 || z2 == 0 || x2 == 2 * (dim.x - 1) || y2 == 2 * (dim.y - 1) || z2 == 2 * (dim.z - 1);
+}
+
+void marchingCubes(const ConstArrayAccessor3<double>& grid,
+                   const Vector3D& gridSize,
+                   const Point3D& origin,
+                   TriangleMesh3* mesh,
+                   double isoValue,
+                   int bndClose,
+                   int bndConnectivity) {
+    MarchingCubeVertexMap vertexMap;
+
+    const Size3 dim = grid.size();
+
+    auto pos = [origin, gridSize](ssize_t i, ssize_t j, ssize_t k) { return origin + gridSize * Vector3D({i, j, k}); };
+
+    ssize_t dimx = static_cast<ssize_t>(dim.x);
+    ssize_t dimy = static_cast<ssize_t>(dim.y);
+    ssize_t dimz = static_cast<ssize_t>(dim.z);
+
+    // Slabs of layers are extracted in parallel, then appended in order. A
+    // vertex shared by two slabs belongs to the lower one, so that the mesh is
+    // the same as if cells were visited one after another.
+    const ssize_t numSlabs = dimx > 1 && dimy > 1 && dimz > 1 ? (dimz - 1 + kSlabSize - 1) / kSlabSize : 0;
+    std::vector<MarchingCubesSlab> slabs(numSlabs);
+    parallelFor(ssize_t(0), numSlabs, [&](ssize_t s) {
+        extractSlab(grid, gridSize, origin, isoValue, s * kSlabSize, std::min((s + 1) * kSlabSize, dimz - 1),
+                    &slabs[s]);
+    });
+
+    // Ids of the vertices on the plane between the last appended slab and
+    // the next one, by edge slot.
+    std::vector<size_t> planeIds(numSlabs > 1 ? 2 * dim.x * dim.y : 0, kMaxSize);
+    const bool hasBoundaryConnectivity = (bndClose & bndConnectivity) != 0;
+    for (ssize_t s = 0; s < numSlabs; ++s) {
+        const MarchingCubesSlab& slab = slabs[s];
+
+        std::vector<size_t> ids(slab.points.size(), kMaxSize);
+        if (s > 0) {
+            for (const auto& [slot, id] : slab.lowerPlane) {
+                ids[id] = planeIds[slot];
+            }
+            for (const auto& [slot, id] : slabs[s - 1].upperPlane) {
+                planeIds[slot] = kMaxSize;
+            }
+        }
+
+        for (size_t v = 0; v < slab.points.size(); ++v) {
+            if (ids[v] != kMaxSize) {
+                continue;
+            }
+            ids[v] = mesh->numberOfPoints();
+            mesh->addNormal(slab.normals[v]);
+            mesh->addPoint(slab.points[v]);
+            mesh->addUv(Vector2D());
+            if (hasBoundaryConnectivity && isBoundaryEdge(slab.keys[v], dim)) {
+                vertexMap.insert(std::make_pair(slab.keys[v], ids[v]));
+            }
+        }
+
+        for (const Point3UI& triangle : slab.triangles) {
+            const Point3UI face(ids[triangle.x], ids[triangle.y], ids[triangle.z]);
+            mesh->addPointUvNormalTriangle(face, face, face);
+        }
+
+        if (s + 1 < numSlabs) {
+            for (const auto& [slot, id] : slab.upperPlane) {
+                planeIds[slot] = ids[id];
+            }
+        }
+    }
 
     // Construct boundaries parallel to x-y plane
     if (bndClose & (kDirectionBack | kDirectionFront)) {
@@ -21,6 +21,9 @@ namespace vox {
 //! specified whether to close or open with \p bndClose (default: close all).
 //! Another boundary flag \p bndConnectivity can be used for specifying
 //! topological connectivity of the boundary meshes (default: disconnect all).
+//! Slabs of cells are extracted in parallel, with vertex caches indexed by
+//! edge, and appended in order, so the mesh doesn't depend on the number of
+//! threads.
 //!
 //! \param[in]  grid            The grid.
 //! \param[in]  gridSize        The grid size.
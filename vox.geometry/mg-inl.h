@@ -12,13 +12,17 @@ namespace vox {
 
 namespace internal {
 
+//! Multigrid cycle shapes.
+enum class MgCycleType { kV, kW, kF };
+
 template <typename BlasType>
-MgResult mgVCycle(const MgMatrix<BlasType> &A,
-                  MgParameters<BlasType> params,
-                  unsigned int currentLevel,
-                  MgVector<BlasType> *x,
-                  MgVector<BlasType> *b,
-                  MgVector<BlasType> *buffer) {
+MgResult mgCycle(const MgMatrix<BlasType> &A,
+                 MgParameters<BlasType> params,
+                 MgCycleType cycleType,
+                 unsigned int currentLevel,
+                 MgVector<BlasType> *x,
+                 MgVector<BlasType> *b,
+                 MgVector<BlasType> *buffer) {
     // 1) Relax a few times on Ax = b, with arbitrary x
     params.relaxFunc(A[currentLevel], (*b)[currentLevel], params.numberOfRestrictionIter, params.maxTolerance,
                      &((*x)[currentLevel]), &((*buffer)[currentLevel]));
@@ -32,8 +36,14 @@ MgResult mgVCycle(const MgMatrix<BlasType> &A,
         BlasType::set(0.0, &(*x)[currentLevel + 1]);
 
         params.maxTolerance *= 0.5;
-        // Solve Ae = r
-        mgVCycle(A, params, currentLevel + 1, x, b, buffer);
+        // Solve Ae = r; W-cycle visits the coarser level twice, and F-cycle
+        // follows its F-cycle with a V-cycle.
+        mgCycle(A, params, cycleType, currentLevel + 1, x, b, buffer);
+        if (cycleType == MgCycleType::kW) {
+            mgCycle(A, params, MgCycleType::kW, currentLevel + 1, x, b, buffer);
+        } else if (cycleType == MgCycleType::kF) {
+            mgCycle(A, params, MgCycleType::kV, currentLevel + 1, x, b, buffer);
+        }
         params.maxTolerance *= 2.0;
 
         // 3) correct
@@ -110,6 +120,24 @@ MgResult mgVCycle(const MgMatrix<BlasType> &A,
                   MgVector<BlasType> *x,
                   MgVector<BlasType> *b,
                   MgVector<BlasType> *buffer) {
-    return internal::mgVCycle<BlasType>(A, params, 0u, x, b, buffer);
+    return internal::mgCycle<BlasType>(A, params, internal::MgCycleType::kV, 0u, x, b, buffer);
+}
+
+template <typename BlasType>
+MgResult mgWCycle(const MgMatrix<BlasType> &A,
+                  MgParameters<BlasType> params,
+                  MgVector<BlasType> *x,
+                  MgVector<BlasType> *b,
+                  MgVector<BlasType> *buffer) {
+    return internal::mgCycle<BlasType>(A, params, internal::MgCycleType::kW, 0u, x, b, buffer);
+}
+
+template <typename BlasType>
+MgResult mgFCycle(const MgMatrix<BlasType> &A,
+                  MgParameters<BlasType> params,
+                  MgVector<BlasType> *x,
+                  MgVector<BlasType> *b,
+                  MgVector<BlasType> *buffer) {
+    return internal::mgCycle<BlasType>(A, params, internal::MgCycleType::kF, 0u, x, b, buffer);
 }
 }  // namespace vox
\ No newline at end of file
@@ -109,6 +109,32 @@ MgResult mgVCycle(const MgMatrix<BlasType> &A,
                   MgVector<BlasType> *x,
                   MgVector<BlasType> *b,
                   MgVector<BlasType> *buffer);
+
+//!
+//! \brief Performs Multigrid with W-cycle.
+//!
+//! Same as mgVCycle, but each coarser level is visited twice per visit of
+//! its finer level, which costs more per cycle and converges in fewer cycles.
+//!
+template <typename BlasType>
+MgResult mgWCycle(const MgMatrix<BlasType> &A,
+                  MgParameters<BlasType> params,
+                  MgVector<BlasType> *x,
+                  MgVector<BlasType> *b,
+                  MgVector<BlasType> *buffer);
+
+//!
+//! \brief Performs Multigrid with F-cycle.
+//!
+//! Same as mgVCycle, but each coarser level is solved with an F-cycle
+//! followed by a V-cycle, which costs between the V- and W-cycles.
+//!
+template <typename BlasType>
+MgResult mgFCycle(const MgMatrix<BlasType> &A,
+                  MgParameters<BlasType> params,
+                  MgVector<BlasType> *x,
+                  MgVector<BlasType> *b,
+                  MgVector<BlasType> *buffer);
 }  // namespace vox
 
 #include "vox.geometry/mg-inl.h"
\ No newline at end of file
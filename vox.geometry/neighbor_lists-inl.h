@@ -0,0 +1,123 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include "vox.base/constants.h"
+#include "vox.base/macros.h"
+#include "vox.base/parallel.h"
+#include "vox.geometry/neighbor_lists.h"
+
+namespace vox {
+
+template <typename IndexType>
+NeighborLists<IndexType>::View::View(const IndexType *begin, const IndexType *end) : _begin(begin), _end(end) {}
+
+template <typename IndexType>
+const IndexType *NeighborLists<IndexType>::View::begin() const {
+    return _begin;
+}
+
+template <typename IndexType>
+const IndexType *NeighborLists<IndexType>::View::end() const {
+    return _end;
+}
+
+template <typename IndexType>
+size_t NeighborLists<IndexType>::View::size() const {
+    return static_cast<size_t>(_end - _begin);
+}
+
+template <typename IndexType>
+bool NeighborLists<IndexType>::View::empty() const {
+    return _begin == _end;
+}
+
+template <typename IndexType>
+IndexType NeighborLists<IndexType>::View::operator[](size_t i) const {
+    return _begin[i];
+}
+
+template <typename IndexType>
+NeighborLists<IndexType>::NeighborLists() : _offsets(1, 0) {}
+
+template <typename IndexType>
+size_t NeighborLists<IndexType>::size() const {
+    return _offsets.size() - 1;
+}
+
+template <typename IndexType>
+bool NeighborLists<IndexType>::empty() const {
+    return size() == 0;
+}
+
+template <typename IndexType>
+typename NeighborLists<IndexType>::View NeighborLists<IndexType>::operator[](size_t i) const {
+    const IndexType *data = _indices.data();
+    return View(data + _offsets[i], data + _offsets[i + 1]);
+}
+
+template <typename IndexType>
+const std::vector<size_t> &NeighborLists<IndexType>::offsets() const {
+    return _offsets;
+}
+
+template <typename IndexType>
+const std::vector<IndexType> &NeighborLists<IndexType>::indices() const {
+    return _indices;
+}
+
+template <typename IndexType>
+void NeighborLists<IndexType>::clear() {
+    _offsets.assign(1, 0);
+    _indices.clear();
+}
+
+template <typename IndexType>
+template <typename Searcher, typename Points>
+void NeighborLists<IndexType>::build(const Searcher &searcher, const Points &points, double radius) {
+    const size_t numberOfPoints = points.size();
+    const size_t numberOfChunks = (numberOfPoints + kChunkSize - 1) / kChunkSize;
+    VOX_ASSERT(numberOfPoints == 0 || numberOfPoints - 1 <= std::numeric_limits<IndexType>::max());
+
+    // First pass: each chunk of points searches its neighbors into its own
+    // buffer and counts them into the offset slot after each point.
+    _offsets.resize(numberOfPoints + 1);
+    _offsets[0] = 0;
+    _chunkIndices.resize(numberOfChunks);
+    parallelFor(kZeroSize, numberOfChunks, [&](size_t c) {
+        std::vector<IndexType> &buffer = _chunkIndices[c];
+        buffer.clear();
+
+        const size_t end = std::min(numberOfPoints, (c + 1) * kChunkSize);
+        for (size_t i = c * kChunkSize; i < end; ++i) {
+            const size_t count = buffer.size();
+            searcher.forEachNearbyPoint(points[i], radius, [&](size_t j, const auto &) {
+                if (i != j) {
+                    buffer.push_back(static_cast<IndexType>(j));
+                }
+            });
+            _offsets[i + 1] = buffer.size() - count;
+        }
+    });
+
+    for (size_t i = 0; i < numberOfPoints; ++i) {
+        _offsets[i + 1] += _offsets[i];
+    }
+
+    // Second pass: the chunks are in point order, so each buffer is copied to
+    // the offset of its first point.
+    _indices.resize(_offsets[numberOfPoints]);
+    parallelFor(kZeroSize, numberOfChunks, [&](size_t c) {
+        const std::vector<IndexType> &buffer = _chunkIndices[c];
+        std::copy(buffer.begin(), buffer.end(), _indices.begin() + _offsets[c * kChunkSize]);
+    });
+}
+
+}  // namespace vox
@@ -0,0 +1,99 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace vox {
+
+//!
+//! \brief Neighbor lists of points in compressed-row (CSR) storage.
+//!
+//! The neighbors of all points are stored in a single flat index array, and
+//! the neighbors of point i are at [offsets()[i], offsets()[i + 1]). Rebuilding
+//! the lists doesn't allocate per point, and reuses the storage once it is
+//! large enough. \p IndexType can be a 32-bit integer to halve the memory
+//! traffic of the lists when there are fewer than 2^32 points.
+//!
+template <typename IndexType>
+class NeighborLists {
+public:
+    //! Read-only view of the neighbor indices of a single point.
+    class View {
+    public:
+        //! Constructs a view of the indices in [begin, end).
+        View(const IndexType *begin, const IndexType *end);
+
+        //! Returns the begin iterator of the indices.
+        [[nodiscard]] const IndexType *begin() const;
+
+        //! Returns the end iterator of the indices.
+        [[nodiscard]] const IndexType *end() const;
+
+        //! Returns the number of neighbors.
+        [[nodiscard]] size_t size() const;
+
+        //! Returns true if there is no neighbor.
+        [[nodiscard]] bool empty() const;
+
+        //! Returns the index of i-th neighbor.
+        IndexType operator[](size_t i) const;
+
+    private:
+        const IndexType *_begin;
+        const IndexType *_end;
+    };
+
+    //! Constructs empty lists.
+    NeighborLists();
+
+    //! Returns the number of points, i.e. the number of lists.
+    [[nodiscard]] size_t size() const;
+
+    //! Returns true if there is no list.
+    [[nodiscard]] bool empty() const;
+
+    //! Returns the neighbors of i-th point.
+    View operator[](size_t i) const;
+
+    //! Returns the offsets of the lists, which has size() + 1 elements.
+    [[nodiscard]] const std::vector<size_t> &offsets() const;
+
+    //! Returns the flat array of neighbor indices.
+    [[nodiscard]] const std::vector<IndexType> &indices() const;
+
+    //! Clears the lists.
+    void clear();
+
+    //!
+    //! \brief Builds the lists of the \p points within \p radius.
+    //!
+    //! The lists are built in parallel with two passes. The first pass searches
+    //! the neighbors of each chunk of points into a per-chunk buffer and
+    //! counts them, which gives the offsets by a prefix sum, and the second
+    //! pass copies the buffers in place. A point is not listed as its own
+    //! neighbor. \p searcher should be built with \p points, which
+    //! can be any array accessor of points.
+    //!
+    template <typename Searcher, typename Points>
+    void build(const Searcher &searcher, const Points &points, double radius);
+
+private:
+    //! Number of points searched by a single task.
+    static constexpr size_t kChunkSize = 1024;
+
+    std::vector<size_t> _offsets;
+    std::vector<IndexType> _indices;
+
+    // Per-chunk search results, kept to reuse their storage across builds.
+    std::vector<std::vector<IndexType>> _chunkIndices;
+};
+
+}  // namespace vox
+
+#include "vox.geometry/neighbor_lists-inl.h"
@@ -141,7 +141,7 @@ void ParticleSystemData3::setNeighborSearcher(const PointNeighborSearcher3Ptr& n
     _neighborSearcher = newNeighborSearcher;
 }
 
-const std::vector<std::vector<size_t>>& ParticleSystemData3::neighborLists() const { return _neighborLists; }
+const NeighborLists<size_t>& ParticleSystemData3::neighborLists() const { return _neighborLists; }
 
 void ParticleSystemData3::buildNeighborSearcher(double maxSearchRadius) {
     utility::Timer timer;
@@ -158,19 +158,7 @@ void ParticleSystemData3::buildNeighborSearcher(double maxSearchRadius) {
 void ParticleSystemData3::buildNeighborLists(double maxSearchRadius) {
     utility::Timer timer;
 
-    _neighborLists.resize(numberOfParticles());
-
-    auto points = positions();
-    for (size_t i = 0; i < numberOfParticles(); ++i) {
-        Point3D origin = points[i];
-        _neighborLists[i].clear();
-
-        _neighborSearcher->forEachNearbyPoint(origin, maxSearchRadius, [&](size_t j, const Point3D&) {
-            if (i != j) {
-                _neighborLists[i].push_back(j);
-            }
-        });
-    }
+    _neighborLists.build(*_neighborSearcher, positions(), maxSearchRadius);
 
     LOGI("Building neighbor list took: {} seconds", timer.Elapsed())
 }
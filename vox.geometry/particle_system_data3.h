@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "vox.geometry/array1.h"
+#include "vox.geometry/neighbor_lists.h"
 #include "vox.geometry/point_neighbor_searcher3.h"
 
 namespace vox {
@@ -172,11 +173,13 @@ public:
     //!
     //! This function returns neighbor lists which is available after calling
     //! PointParallelHashGridSearcher3::buildNeighborLists. Each list stores
-    //! indices of the neighbors.
+    //! indices of the neighbors. The lists are stored in compressed rows, and
+    //! neighborLists()[i] is a view with begin(), end(), size() and
+    //! operator[] like the former per-particle vector.
     //!
     //! \return     Neighbor lists.
     //!
-    [[nodiscard]] const std::vector<std::vector<size_t>>& neighborLists() const;
+    [[nodiscard]] const NeighborLists<size_t>& neighborLists() const;
 
     //! Builds neighbor searcher with given search radius.
     void buildNeighborSearcher(double maxSearchRadius);
@@ -202,7 +205,7 @@ private:
     Array1<Point3D> _positionData;
 
     PointNeighborSearcher3Ptr _neighborSearcher;
-    std::vector<std::vector<size_t>> _neighborLists;
+    NeighborLists<size_t> _neighborLists;
 };
 
 //! Shared pointer type of ParticleSystemData3.
@@ -0,0 +1,376 @@
+// Copyright (c) 2022 Feng Yang
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#include "vox.geometry/sparse_scalar_grid3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "vox.base/private_helpers.h"
+
+using namespace vox;
+
+namespace {
+
+size_t cellInBlock(size_t i, size_t j, size_t k) {
+    constexpr size_t kMask = SparseScalarGrid3::kBlockSize - 1;
+    return (i & kMask) + SparseScalarGrid3::kBlockSize * ((j & kMask) + SparseScalarGrid3::kBlockSize * (k & kMask));
+}
+
+size_t numberOfBlocks(size_t n) { return (n + SparseScalarGrid3::kBlockSize - 1) / SparseScalarGrid3::kBlockSize; }
+
+}  // namespace
+
+SparseScalarGrid3::SparseScalarGrid3()
+    : _linearSampler(LinearArraySampler3<double, double>(ConstArrayAccessor3<double>(), Vector3D(1, 1, 1),
+                                                         Point3D(0.5, 0.5, 0.5))) {}
+
+SparseScalarGrid3::SparseScalarGrid3(const Size3 &resolution,
+                                     const Vector3D &gridSpacing,
+                                     const Point3D &origin,
+                                     double background)
+    : SparseScalarGrid3() {
+    resize(resolution, gridSpacing, origin, background);
+}
+
+SparseScalarGrid3::SparseScalarGrid3(const SparseScalarGrid3 &other) : SparseScalarGrid3() { set(other); }
+
+Size3 SparseScalarGrid3::dataSize() const { return resolution(); }
+
+Point3D SparseScalarGrid3::dataOrigin() const { return origin() + 0.5 * gridSpacing(); }
+
+double SparseScalarGrid3::background() const { return _background; }
+
+std::shared_ptr<SparseScalarGrid3> SparseScalarGrid3::clone() const {
+    return CLONE_W_CUSTOM_DELETER(SparseScalarGrid3)
+}
+
+void SparseScalarGrid3::swap(Grid3 *other) {
+    auto *sameType = dynamic_cast<SparseScalarGrid3 *>(other);
+    if (sameType != nullptr) {
+        swapGrid(sameType);
+        std::swap(_background, sameType->_background);
+        std::swap(_blockResolution, sameType->_blockResolution);
+        _blocks.swap(sameType->_blocks);
+        _blockIndices.swap(sameType->_blockIndices);
+        resetSampler();
+        sameType->resetSampler();
+    }
+}
+
+void SparseScalarGrid3::set(const SparseScalarGrid3 &other) {
+    setGrid(other);
+    _background = other._background;
+    _blockResolution = other._blockResolution;
+    _blocks = other._blocks;
+    _blockIndices = other._blockIndices;
+    resetSampler();
+}
+
+SparseScalarGrid3 &SparseScalarGrid3::operator=(const SparseScalarGrid3 &other) {
+    set(other);
+    return *this;
+}
+
+void SparseScalarGrid3::resize(const Size3 &resolution,
+                               const Vector3D &gridSpacing,
+                               const Point3D &origin,
+                               double background) {
+    setSizeParameters(resolution, gridSpacing, origin);
+    _background = background;
+    _blockResolution = Size3(numberOfBlocks(resolution.x), numberOfBlocks(resolution.y), numberOfBlocks(resolution.z));
+    clear();
+    resetSampler();
+}
+
+void SparseScalarGrid3::clear() {
+    _blocks.clear();
+    _blockIndices.clear();
+}
+
+size_t SparseScalarGrid3::numberOfActiveBlocks() const { return _blocks.size(); }
+
+const SparseScalarGrid3::Block &SparseScalarGrid3::activeBlock(size_t idx) const { return _blocks[idx]; }
+
+bool SparseScalarGrid3::isActive(size_t i, size_t j, size_t k) const { return findBlock(i, j, k) != nullptr; }
+
+double SparseScalarGrid3::operator()(size_t i, size_t j, size_t k) const {
+    const Block *block = findBlock(i, j, k);
+    return (block != nullptr) ? block->data[cellInBlock(i, j, k)] : _background;
+}
+
+void SparseScalarGrid3::setValue(size_t i, size_t j, size_t k, double value) {
+    findOrAddBlock(i, j, k).data[cellInBlock(i, j, k)] = value;
+}
+
+void SparseScalarGrid3::activate(size_t i, size_t j, size_t k) { findOrAddBlock(i, j, k); }
+
+void SparseScalarGrid3::prune(double tolerance) {
+    size_t count = 0;
+    for (size_t b = 0; b < _blocks.size(); ++b) {
+        const auto &data = _blocks[b].data;
+        const bool keep = std::any_of(data.begin(), data.end(),
+                                      [&](double v) { return std::fabs(v - _background) > tolerance; });
+        if (keep) {
+            if (count != b) {
+                _blocks[count] = _blocks[b];
+            }
+            ++count;
+        }
+    }
+    _blocks.resize(count);
+
+    _blockIndices.clear();
+    for (size_t b = 0; b < _blocks.size(); ++b) {
+        const Point3UI &c = _blocks[b].coordinate;
+        _blockIndices[c.x + _blockResolution.x * (c.y + _blockResolution.y * c.z)] = b;
+    }
+}
+
+Vector3D SparseScalarGrid3::gradientAtDataPoint(size_t i, size_t j, size_t k) const {
+    const Size3 ds = dataSize();
+
+    VOX_ASSERT(i < ds.x && j < ds.y && k < ds.z);
+
+    double left = (*this)((i > 0) ? i - 1 : i, j, k);
+    double right = (*this)((i + 1 < ds.x) ? i + 1 : i, j, k);
+    double down = (*this)(i, (j > 0) ? j - 1 : j, k);
+    double up = (*this)(i, (j + 1 < ds.y) ? j + 1 : j, k);
+    double back = (*this)(i, j, (k > 0) ? k - 1 : k);
+    double front = (*this)(i, j, (k + 1 < ds.z) ? k + 1 : k);
+
+    return 0.5 * Vector3D(right - left, up - down, front - back) / gridSpacing();
+}
+
+double SparseScalarGrid3::laplacianAtDataPoint(size_t i, size_t j, size_t k) const {
+    const double center = (*this)(i, j, k);
+    const Size3 ds = dataSize();
+
+    VOX_ASSERT(i < ds.x && j < ds.y && k < ds.z);
+
+    double dleft = (i > 0) ? center - (*this)(i - 1, j, k) : 0.0;
+    double dright = (i + 1 < ds.x) ? (*this)(i + 1, j, k) - center : 0.0;
+    double ddown = (j > 0) ? center - (*this)(i, j - 1, k) : 0.0;
+    double dup = (j + 1 < ds.y) ? (*this)(i, j + 1, k) - center : 0.0;
+    double dback = (k > 0) ? center - (*this)(i, j, k - 1) : 0.0;
+    double dfront = (k + 1 < ds.z) ? (*this)(i, j, k + 1) - center : 0.0;
+
+    const Vector3D &h = gridSpacing();
+    return (dright - dleft) / square(h.x) + (dup - ddown) / square(h.y) + (dfront - dback) / square(h.z);
+}
+
+SparseScalarGrid3::DataPositionFunc SparseScalarGrid3::dataPosition() const {
+    Point3D o = dataOrigin();
+    return [this, o](size_t i, size_t j, size_t k) -> Point3D { return o + gridSpacing() * Vector3D({i, j, k}); };
+}
+
+void SparseScalarGrid3::fill(const std::function<double(const Point3D &)> &func, ExecutionPolicy policy) {
+    DataPositionFunc pos = dataPosition();
+    const Size3 ds = dataSize();
+    parallelForEachActiveBlock(
+            [&](Block &block) {
+                const Point3UI first = block.coordinate * kBlockSize;
+                for (size_t k = 0; k < kBlockSize && first.z + k < ds.z; ++k) {
+                    for (size_t j = 0; j < kBlockSize && first.y + j < ds.y; ++j) {
+                        for (size_t i = 0; i < kBlockSize && first.x + i < ds.x; ++i) {
+                            block.data[cellInBlock(i, j, k)] = func(pos(first.x + i, first.y + j, first.z + k));
+                        }
+                    }
+                }
+            },
+            policy);
+}
+
+void SparseScalarGrid3::fill(const ConstArrayAccessor3<double> &data, double tolerance, ExecutionPolicy policy) {
+    const Size3 ds = dataSize();
+    VOX_ASSERT(data.size() == ds);
+
+    // Find the blocks to activate in parallel, then allocate them in order.
+    const size_t numBlocks = _blockResolution.x * _blockResolution.y * _blockResolution.z;
+    std::vector<char> needed(numBlocks, 0);
+    parallelFor(
+            kZeroSize, numBlocks,
+            [&](size_t b) {
+                const size_t bi = b % _blockResolution.x;
+                const size_t bj = (b / _blockResolution.x) % _blockResolution.y;
+                const size_t bk = b / (_blockResolution.x * _blockResolution.y);
+                const size_t iEnd = std::min((bi + 1) * kBlockSize, ds.x);
+                const size_t jEnd = std::min((bj + 1) * kBlockSize, ds.y);
+                const size_t kEnd = std::min((bk + 1) * kBlockSize, ds.z);
+                for (size_t k = bk * kBlockSize; k < kEnd; ++k) {
+                    for (size_t j = bj * kBlockSize; j < jEnd; ++j) {
+                        for (size_t i = bi * kBlockSize; i < iEnd; ++i) {
+                            if (std::fabs(data(i, j, k) - _background) > tolerance) {
+                                needed[b] = 1;
+                                return;
+                            }
+                        }
+                    }
+                }
+            },
+            policy);
+
+    clear();
+    for (size_t b = 0; b < numBlocks; ++b) {
+        if (needed[b]) {
+            findOrAddBlock((b % _blockResolution.x) * kBlockSize,
+                           ((b / _blockResolution.x) % _blockResolution.y) * kBlockSize,
+                           (b / (_blockResolution.x * _blockResolution.y)) * kBlockSize);
+        }
+    }
+
+    parallelForEachActiveBlock(
+            [&](Block &block) {
+                const Point3UI first = block.coordinate * kBlockSize;
+                for (size_t k = 0; k < kBlockSize && first.z + k < ds.z; ++k) {
+                    for (size_t j = 0; j < kBlockSize && first.y + j < ds.y; ++j) {
+                        for (size_t i = 0; i < kBlockSize && first.x + i < ds.x; ++i) {
+                            block.data[cellInBlock(i, j, k)] = data(first.x + i, first.y + j, first.z + k);
+                        }
+                    }
+                }
+            },
+            policy);
+}
+
+void SparseScalarGrid3::getDenseData(ArrayAccessor3<double> data, ExecutionPolicy policy) const {
+    const Size3 ds = dataSize();
+    VOX_ASSERT(data.size() == ds);
+
+    parallelFor(
+            kZeroSize, ds.x, kZeroSize, ds.y, kZeroSize, ds.z,
+            [&](size_t i, size_t j, size_t k) { data(i, j, k) = (*this)(i, j, k); }, policy);
+}
+
+void SparseScalarGrid3::forEachActiveDataPointIndex(const std::function<void(size_t, size_t, size_t)> &func) const {
+    const Size3 ds = dataSize();
+    for (const Block &block : _blocks) {
+        const Point3UI first = block.coordinate * kBlockSize;
+        for (size_t k = first.z; k < std::min(first.z + kBlockSize, ds.z); ++k) {
+            for (size_t j = first.y; j < std::min(first.y + kBlockSize, ds.y); ++j) {
+                for (size_t i = first.x; i < std::min(first.x + kBlockSize, ds.x); ++i) {
+                    func(i, j, k);
+                }
+            }
+        }
+    }
+}
+
+void SparseScalarGrid3::parallelForEachActiveDataPointIndex(
+        const std::function<void(size_t, size_t, size_t)> &func) const {
+    const Size3 ds = dataSize();
+    parallelFor(kZeroSize, _blocks.size(), [&](size_t b) {
+        const Point3UI first = _blocks[b].coordinate * kBlockSize;
+        for (size_t k = first.z; k < std::min(first.z + kBlockSize, ds.z); ++k) {
+            for (size_t j = first.y; j < std::min(first.y + kBlockSize, ds.y); ++j) {
+                for (size_t i = first.x; i < std::min(first.x + kBlockSize, ds.x); ++i) {
+                    func(i, j, k);
+                }
+            }
+        }
+    });
+}
+
+void SparseScalarGrid3::parallelForEachActiveBlock(const std::function<void(Block &)> &func, ExecutionPolicy policy) {
+    parallelFor(
+            kZeroSize, _blocks.size(), [&](size_t b) { func(_blocks[b]); }, policy);
+}
+
+double SparseScalarGrid3::sample(const Point3D &x) const {
+    std::array<Point3UI, 8> indices;
+    std::array<double, 8> weights{};
+    _linearSampler.getCoordinatesAndWeights(x, &indices, &weights);
+
+    // Neighboring corners usually share a block, so reuse the last lookup.
+    double result = 0.0;
+    size_t lastKey = kMaxSize;
+    const Block *block = nullptr;
+    for (int n = 0; n < 8; ++n) {
+        const Point3UI &idx = indices[n];
+        const size_t key = blockKey(idx.x, idx.y, idx.z);
+        if (key != lastKey) {
+            auto iter = _blockIndices.find(key);
+            block = (iter != _blockIndices.end()) ? &_blocks[iter->second] : nullptr;
+            lastKey = key;
+        }
+        result += weights[n] * ((block != nullptr) ? block->data[cellInBlock(idx.x, idx.y, idx.z)] : _background);
+    }
+
+    return result;
+}
+
+std::function<double(const Point3D &)> SparseScalarGrid3::sampler() const {
+    return [this](const Point3D &x) -> double { return sample(x); };
+}
+
+Vector3D SparseScalarGrid3::gradient(const Point3D &x) const {
+    std::array<Point3UI, 8> indices;
+    std::array<double, 8> weights{};
+    _linearSampler.getCoordinatesAndWeights(x, &indices, &weights);
+
+    Vector3D result;
+
+    for (int i = 0; i < 8; ++i) {
+        result += weights[i] * gradientAtDataPoint(indices[i].x, indices[i].y, indices[i].z);
+    }
+
+    return result;
+}
+
+double SparseScalarGrid3::laplacian(const Point3D &x) const {
+    std::array<Point3UI, 8> indices;
+    std::array<double, 8> weights{};
+    _linearSampler.getCoordinatesAndWeights(x, &indices, &weights);
+
+    double result = 0.0;
+
+    for (int i = 0; i < 8; ++i) {
+        result += weights[i] * laplacianAtDataPoint(indices[i].x, indices[i].y, indices[i].z);
+    }
+
+    return result;
+}
+
+void SparseScalarGrid3::getData(std::vector<double> *data) const {
+    const Size3 ds = dataSize();
+    data->resize(ds.x * ds.y * ds.z);
+    getDenseData(ArrayAccessor3<double>(ds, data->data()));
+}
+
+void SparseScalarGrid3::setData(const std::vector<double> &data) {
+    const Size3 ds = dataSize();
+    VOX_ASSERT(ds.x * ds.y * ds.z == data.size());
+
+    fill(ConstArrayAccessor3<double>(ds, data.data()));
+}
+
+size_t SparseScalarGrid3::blockKey(size_t i, size_t j, size_t k) const {
+    return i / kBlockSize + _blockResolution.x * (j / kBlockSize + _blockResolution.y * (k / kBlockSize));
+}
+
+const SparseScalarGrid3::Block *SparseScalarGrid3::findBlock(size_t i, size_t j, size_t k) const {
+    auto iter = _blockIndices.find(blockKey(i, j, k));
+    return (iter != _blockIndices.end()) ? &_blocks[iter->second] : nullptr;
+}
+
+SparseScalarGrid3::Block &SparseScalarGrid3::findOrAddBlock(size_t i, size_t j, size_t k) {
+    VOX_ASSERT(i < resolution().x && j < resolution().y && k < resolution().z);
+
+    auto result = _blockIndices.emplace(blockKey(i, j, k), _blocks.size());
+    if (result.second) {
+        Block block;
+        block.coordinate = Point3UI(i / kBlockSize, j / kBlockSize, k / kBlockSize);
+        block.data.fill(_background);
+        _blocks.push_back(block);
+    }
+    return _blocks[result.first->second];
+}
+
+void SparseScalarGrid3::resetSampler() {
+    _linearSampler = LinearArraySampler3<double, double>(ConstArrayAccessor3<double>(dataSize(), nullptr),
+                                                         gridSpacing(), dataOrigin());
+}
@@ -0,0 +1,217 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "vox.base/parallel.h"
+#include "vox.geometry/array_accessor3.h"
+#include "vox.geometry/array_samplers3.h"
+#include "vox.geometry/grid3.h"
+#include "vox.geometry/scalar_field3.h"
+
+namespace vox {
+
+//!
+//! \brief 3-D sparse cell-centered scalar grid structure.
+//!
+//! This class stores cell-centered scalar values in 8x8x8 blocks that are only
+//! allocated where the data differs from the background value, which suits
+//! narrow-band level sets whose interesting values live near the surface.
+//! Inactive cells read as the background value. Sampling uses the same linear
+//! interpolation weights as LinearArraySampler3, so sampling a sparse grid
+//! gives the same result as sampling its dense copy.
+//!
+class SparseScalarGrid3 final : public ScalarField3, public Grid3 {
+public:
+    JET_GRID3_TYPE_NAME(SparseScalarGrid3)
+
+    //! Number of cells along each axis of a block.
+    static constexpr size_t kBlockSize = 8;
+
+    //! Number of cells in a block.
+    static constexpr size_t kBlockVolume = kBlockSize * kBlockSize * kBlockSize;
+
+    //! Sparse storage unit; data is stored i-first, j-next, k-last.
+    struct Block {
+        //! Index of the block, i.e. the index of its first cell / kBlockSize.
+        Point3UI coordinate;
+
+        //! Cell values of the block.
+        std::array<double, kBlockVolume> data;
+    };
+
+    //! Constructs an empty grid.
+    SparseScalarGrid3();
+
+    //! Resizes the grid using given parameters.
+    SparseScalarGrid3(const Size3 &resolution,
+                      const Vector3D &gridSpacing = Vector3D(1, 1, 1),
+                      const Point3D &origin = Point3D(),
+                      double background = 0.0);
+
+    //! Copy constructor.
+    SparseScalarGrid3(const SparseScalarGrid3 &other);
+
+    //! Returns the size of the grid data, which is the grid resolution.
+    [[nodiscard]] Size3 dataSize() const;
+
+    //! Returns the position of the data point at (0, 0, 0).
+    [[nodiscard]] Point3D dataOrigin() const;
+
+    //! Returns the value of the inactive cells.
+    [[nodiscard]] double background() const;
+
+    //! Returns the copy of the grid instance.
+    [[nodiscard]] std::shared_ptr<SparseScalarGrid3> clone() const;
+
+    //!
+    //! \brief Swaps the contents with the given \p other grid.
+    //!
+    //! This function swaps the contents of the grid instance with the given
+    //! grid object \p other only if \p other has the same type with this grid.
+    //!
+    void swap(Grid3 *other) override;
+
+    //! Sets the contents with the given \p other grid.
+    void set(const SparseScalarGrid3 &other);
+
+    //! Sets the contents with the given \p other grid.
+    SparseScalarGrid3 &operator=(const SparseScalarGrid3 &other);
+
+    //! Resizes the grid and deactivates all the blocks.
+    void resize(const Size3 &resolution,
+                const Vector3D &gridSpacing = Vector3D(1, 1, 1),
+                const Point3D &origin = Point3D(),
+                double background = 0.0);
+
+    //! Deactivates all the blocks.
+    void clear();
+
+    //! Returns the number of allocated blocks.
+    [[nodiscard]] size_t numberOfActiveBlocks() const;
+
+    //! Returns the block at given index in [0, numberOfActiveBlocks()).
+    [[nodiscard]] const Block &activeBlock(size_t idx) const;
+
+    //! Returns true if the block containing the data point is allocated.
+    [[nodiscard]] bool isActive(size_t i, size_t j, size_t k) const;
+
+    //! Returns the grid data at given data point, or the background value.
+    double operator()(size_t i, size_t j, size_t k) const;
+
+    //! Sets the grid data at given data point, activating its block if needed.
+    void setValue(size_t i, size_t j, size_t k, double value);
+
+    //! Activates the block containing the data point filled with background.
+    void activate(size_t i, size_t j, size_t k);
+
+    //!
+    //! \brief Deactivates the blocks whose values are all within \p tolerance
+    //! of the background value.
+    //!
+    void prune(double tolerance = 0.0);
+
+    //! Returns the gradient vector at given data point.
+    [[nodiscard]] Vector3D gradientAtDataPoint(size_t i, size_t j, size_t k) const;
+
+    //! Returns the Laplacian at given data point.
+    [[nodiscard]] double laplacianAtDataPoint(size_t i, size_t j, size_t k) const;
+
+    //! Returns the function that maps data point to its position.
+    [[nodiscard]] DataPositionFunc dataPosition() const;
+
+    //! Fills the active cells with given position-to-value mapping function.
+    void fill(const std::function<double(const Point3D &)> &func, ExecutionPolicy policy = ExecutionPolicy::kParallel);
+
+    //!
+    //! \brief Builds the sparse blocks from the dense \p data.
+    //!
+    //! The grid keeps its shape and background value, and only the blocks
+    //! with a value further than \p tolerance from the background are
+    //! activated. The size of \p data must match dataSize().
+    //!
+    void fill(const ConstArrayAccessor3<double> &data,
+              double tolerance = 0.0,
+              ExecutionPolicy policy = ExecutionPolicy::kParallel);
+
+    //! Writes the values, including the background, to the dense \p data.
+    void getDenseData(ArrayAccessor3<double> data, ExecutionPolicy policy = ExecutionPolicy::kParallel) const;
+
+    //!
+    //! \brief Invokes the given function \p func for each active data point.
+    //!
+    //! The data points are visited block by block in serial manner. The input
+    //! parameters are i, j, and k indices of a data point.
+    //!
+    void forEachActiveDataPointIndex(const std::function<void(size_t, size_t, size_t)> &func) const;
+
+    //!
+    //! \brief Invokes the given function \p func for each active data point
+    //! parallelly.
+    //!
+    //! Each block is processed by a single thread, and the order of execution
+    //! can be arbitrary since it's multi-threaded.
+    //!
+    void parallelForEachActiveDataPointIndex(const std::function<void(size_t, size_t, size_t)> &func) const;
+
+    //!
+    //! \brief Invokes the given function \p func for each active block
+    //! parallelly.
+    //!
+    //! This is the cheapest way to update the values in place since \p func
+    //! gets the whole block at once.
+    //!
+    void parallelForEachActiveBlock(const std::function<void(Block &)> &func,
+                                    ExecutionPolicy policy = ExecutionPolicy::kParallel);
+
+    // ScalarField3 implementations
+
+    //! Returns the linearly sampled value at given position \p x.
+    [[nodiscard]] double sample(const Point3D &x) const override;
+
+    //! Returns the linear sampler function.
+    [[nodiscard]] std::function<double(const Point3D &)> sampler() const override;
+
+    //! Returns the gradient vector at given position \p x.
+    [[nodiscard]] Vector3D gradient(const Point3D &x) const override;
+
+    //! Returns the Laplacian at given position \p x.
+    [[nodiscard]] double laplacian(const Point3D &x) const override;
+
+protected:
+    //! Fetches the data into a continuous linear array.
+    void getData(std::vector<double> *data) const override;
+
+    //! Sets the data from a continuous linear array.
+    void setData(const std::vector<double> &data) override;
+
+private:
+    double _background = 0.0;
+    Size3 _blockResolution;
+    std::vector<Block> _blocks;
+    std::unordered_map<size_t, size_t> _blockIndices;
+
+    // The accessor only carries the data size; it is used for the weights.
+    LinearArraySampler3<double, double> _linearSampler;
+
+    [[nodiscard]] size_t blockKey(size_t i, size_t j, size_t k) const;
+
+    [[nodiscard]] const Block *findBlock(size_t i, size_t j, size_t k) const;
+
+    Block &findOrAddBlock(size_t i, size_t j, size_t k);
+
+    void resetSampler();
+};
+
+//! Shared pointer for the SparseScalarGrid3 type.
+typedef std::shared_ptr<SparseScalarGrid3> SparseScalarGrid3Ptr;
+
+}  // namespace vox
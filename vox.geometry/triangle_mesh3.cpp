@@ -14,7 +14,10 @@
 
 #include <tiny_obj_loader.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include <utility>
 
 using namespace vox;
@@ -23,6 +26,52 @@ namespace {
 
 constexpr double kDefaultFastWindingNumberAccuracy = 2.0;
 
+// Direction of the rays cast by isInsideBatch. It is neither aligned with the
+// axes nor with the diagonals, so that rays from grid points rarely go through
+// edges of axis-aligned meshes.
+const Vector3D kInsideRayDirection = Vector3D(0.267261, 0.534522, 0.801784).normalized();
+
+// Barycentric coordinate, or cosine between the ray and the triangle, below
+// which a hit is too close to an edge or too grazing to tell the side of the
+// triangle the ray comes from.
+constexpr double kInsideRayEpsilon = 1e-6;
+
+// Intersects \p ray with \p tri from either side, see Moller and Trumbore,
+// Fast, Minimum Storage Ray/Triangle Intersection. Returns the distance along
+// the ray, or kMaxD if it misses, and sets the barycentric coordinates of the
+// hit if requested. The ray direction should be normalized.
+double rayTriangleDistance(const Ray3D &ray, const Triangle3 &tri, double *b1 = nullptr, double *b2 = nullptr) {
+    const Vector3D e1 = tri.points[1] - tri.points[0];
+    const Vector3D e2 = tri.points[2] - tri.points[0];
+    const Vector3D p = ray.direction.cross(e2);
+    const double det = e1.dot(p);
+    // The determinant scales with the area of the triangle, so is the
+    // tolerance rejecting rays parallel to its plane.
+    if (std::abs(det) <= std::numeric_limits<double>::epsilon() * e1.length() * e2.length()) {
+        return kMaxD;
+    }
+
+    const double invDet = 1.0 / det;
+    const Vector3D s = ray.origin - tri.points[0];
+    const double u = s.dot(p) * invDet;
+    if (u < 0.0 || u > 1.0) {
+        return kMaxD;
+    }
+    const Vector3D q = s.cross(e1);
+    const double v = ray.direction.dot(q) * invDet;
+    if (v < 0.0 || u + v > 1.0) {
+        return kMaxD;
+    }
+    const double t = e2.dot(q) * invDet;
+    if (t < 0.0) {
+        return kMaxD;
+    }
+
+    if (b1 != nullptr) *b1 = u;
+    if (b2 != nullptr) *b2 = v;
+    return t;
+}
+
 struct WindingNumberGatherData {
     double areaSums = 0;
     Vector3D areaWeightedNormalSums;
@@ -157,6 +206,49 @@ bool TriangleMesh3::isInsideLocal(const Point3D &otherPoint) const {
     return fastWindingNumber(otherPoint, kDefaultFastWindingNumberAccuracy) > 0.5;
 }
 
+void TriangleMesh3::isInsideBatch(const ConstArrayAccessor1<Point3D> &points, ArrayAccessor1<char> results) const {
+    // Both are built before the parallel loops, which may fall back to
+    // winding numbers.
+    buildBvh();
+    buildWindingNumbers();
+
+    std::vector<Ray3D> rays(points.size());
+    parallelFor(kZeroSize, points.size(),
+                [&](size_t i) { rays[i] = Ray3D(transform.toLocal(points[i]), kInsideRayDirection); });
+
+    // Rays share their direction and neighboring points start close to each
+    // other, so packets mostly visit the same nodes.
+    const auto testFunc = [this](const size_t &triIdx, const Ray3D &ray) {
+        return rayTriangleDistance(ray, triangle(triIdx));
+    };
+    std::vector<ClosestIntersectionQueryResult3<size_t>> hits(rays.size());
+    _bvh.closestIntersectionBatch(ConstArrayAccessor1<Ray3D>(rays.size(), rays.data()), testFunc,
+                                  ArrayAccessor1<ClosestIntersectionQueryResult3<size_t>>(hits.size(), hits.data()));
+
+    parallelFor(kZeroSize, points.size(), [&](size_t i) {
+        // Rays that miss may come out of a hole of an open mesh, so only rays
+        // clearly crossing a triangle skip the winding number. The point is
+        // then inside if the ray leaves through the back of the triangle.
+        bool inside = false;
+        bool isClearHit = false;
+        if (hits[i].item != nullptr) {
+            const Triangle3 tri = triangle(*hits[i].item);
+            double b1 = 0.0;
+            double b2 = 0.0;
+            rayTriangleDistance(rays[i], tri, &b1, &b2);
+            const Vector3D normal = (tri.points[1] - tri.points[0]).cross(tri.points[2] - tri.points[0]);
+            const double cosine = normal.dot(kInsideRayDirection) / normal.length();
+            isClearHit = std::min({b1, b2, 1.0 - b1 - b2}) >= kInsideRayEpsilon &&
+                         std::abs(cosine) >= kInsideRayEpsilon;
+            inside = cosine > 0.0;
+        }
+        if (!isClearHit) {
+            inside = isInsideLocal(rays[i].origin);
+        }
+        results[i] = isNormalFlipped == !inside;
+    });
+}
+
 BoundingBox3D TriangleMesh3::boundingBoxLocal() const {
     buildBvh();
 
@@ -204,6 +296,7 @@ void TriangleMesh3::set(const TriangleMesh3 &other) {
     _pointIndices.set(other._pointIndices);
     _normalIndices.set(other._normalIndices);
     _uvIndices.set(other._uvIndices);
+    _bvhBuildMethod = other._bvhBuildMethod;
 
     invalidateCache();
 }
@@ -215,6 +308,7 @@ void TriangleMesh3::swap(TriangleMesh3 &other) {
     _pointIndices.swap(other._pointIndices);
     _normalIndices.swap(other._normalIndices);
     _uvIndices.swap(other._uvIndices);
+    std::swap(_bvhBuildMethod, other._bvhBuildMethod);
 }
 
 double TriangleMesh3::area() const {
@@ -292,6 +386,15 @@ size_t TriangleMesh3::numberOfUvs() const { return _uvs.size(); }
 
 size_t TriangleMesh3::numberOfTriangles() const { return _pointIndices.size(); }
 
+BvhBuildMethod TriangleMesh3::bvhBuildMethod() const { return _bvhBuildMethod; }
+
+void TriangleMesh3::setBvhBuildMethod(BvhBuildMethod method) {
+    if (method != _bvhBuildMethod) {
+        _bvhBuildMethod = method;
+        invalidateCache();
+    }
+}
+
 bool TriangleMesh3::hasNormals() const { return _normals.size() > 0; }
 
 bool TriangleMesh3::hasUvs() const { return _uvs.size() > 0; }
@@ -633,7 +736,7 @@ void TriangleMesh3::buildBvh() const {
             ids[i] = i;
             bounds[i] = triangle(i).boundingBox();
         }
-        _bvh.build(ids, bounds);
+        _bvh.build(ids, bounds, _bvhBuildMethod);
         _bvhInvalidated = false;
     }
 }
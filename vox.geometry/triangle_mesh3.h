@@ -124,6 +124,23 @@ public:
     //! Returns number of triangles.
     size_t numberOfTriangles() const;
 
+    //! Returns the split method of the bounding volume hierarchy used by the
+    //! queries.
+    BvhBuildMethod bvhBuildMethod() const;
+
+    //! Sets the split method of the bounding volume hierarchy used by the
+    //! queries, BvhBuildMethod::kMidpoint by default. The binned SAH builds
+    //! slower and only speeds up queries for some triangle distributions.
+    void setBvhBuildMethod(BvhBuildMethod method);
+
+    //! Sets \p results[i] to true if \p points[i] is inside the mesh. Each
+    //! point casts a ray, and the rays are traversed by packets (see
+    //! Bvh3::closestIntersectionBatch). A point is inside if its ray leaves
+    //! through the back of the closest triangle. Rays that miss the mesh, or
+    //! hit it close to an edge, fall back to the winding number of isInside.
+    //! Both agree on closed meshes, isInside should be preferred otherwise.
+    void isInsideBatch(const ConstArrayAccessor1<Point3D> &points, ArrayAccessor1<char> results) const;
+
     //! Returns true if the mesh has normals.
     bool hasNormals() const;
 
@@ -218,6 +235,7 @@ private:
     IndexArray _normalIndices;
     IndexArray _uvIndices;
 
+    BvhBuildMethod _bvhBuildMethod = BvhBuildMethod::kMidpoint;
     mutable Bvh3<size_t> _bvh;
     mutable bool _bvhInvalidated = true;
 
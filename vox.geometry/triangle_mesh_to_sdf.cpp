@@ -7,26 +7,334 @@
 #include "vox.geometry/triangle_mesh_to_sdf.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
 
+#include "vox.base/parallel.h"
 #include "vox.geometry/array3.h"
 
 using namespace vox;
 
 namespace vox {
 
-void triangleMeshToSdf(const TriangleMesh3& mesh, ScalarGrid3* sdf, const unsigned int) {
+namespace {
+
+constexpr uint32_t kNoTriangle = std::numeric_limits<uint32_t>::max();
+
+// Number of z layers whose cells are rasterized by the same task.
+constexpr size_t kSlabSize = 4;
+
+using TrianglePoints = std::array<Point3D, 3>;
+
+// Returns the squared distance from p to segment ab.
+double distanceSquaredToSegment(const Point3D& p, const Point3D& a, const Point3D& b) {
+    const Vector3D ab = b - a;
+    const Vector3D ap = p - a;
+    const double lengthSquared = ab.lengthSquared();
+    const double t = lengthSquared > 0.0 ? std::clamp(ab.dot(ap) / lengthSquared, 0.0, 1.0) : 0.0;
+    return (ap - t * ab).lengthSquared();
+}
+
+// Returns the squared distance from p to triangle abc. See Ericson, Real-Time
+// Collision Detection, 5.1.5.
+double distanceSquaredToTriangle(const Point3D& p, const TrianglePoints& tri) {
+    const Point3D& a = tri[0];
+    const Point3D& b = tri[1];
+    const Point3D& c = tri[2];
+    const Vector3D ab = b - a;
+    const Vector3D ac = c - a;
+    const Vector3D ap = p - a;
+
+    const double d1 = ab.dot(ap);
+    const double d2 = ac.dot(ap);
+    if (d1 <= 0.0 && d2 <= 0.0) {
+        return ap.lengthSquared();
+    }
+
+    const Vector3D bp = p - b;
+    const double d3 = ab.dot(bp);
+    const double d4 = ac.dot(bp);
+    if (d3 >= 0.0 && d4 <= d3) {
+        return bp.lengthSquared();
+    }
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+        const double v = d1 / (d1 - d3);
+        return (ap - v * ab).lengthSquared();
+    }
+
+    const Vector3D cp = p - c;
+    const double d5 = ab.dot(cp);
+    const double d6 = ac.dot(cp);
+    if (d6 >= 0.0 && d5 <= d6) {
+        return cp.lengthSquared();
+    }
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+        const double w = d2 / (d2 - d6);
+        return (ap - w * ac).lengthSquared();
+    }
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+        const double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return (bp - w * (c - b)).lengthSquared();
+    }
+
+    const double denom = va + vb + vc;
+    if (denom <= 0.0) {
+        // Degenerate triangle, which collapses to one of its edges.
+        return std::min({distanceSquaredToSegment(p, a, b), distanceSquaredToSegment(p, b, c),
+                         distanceSquaredToSegment(p, c, a)});
+    }
+    const double v = vb / denom;
+    const double w = vc / denom;
+    return (ap - v * ab - w * ac).lengthSquared();
+}
+
+// Calls update(cell, previous, n) for every cell and the n cells preceding
+// it along each axis, sweeping forward then backward. Cells are preceded by
+// their neighbor along x, by the 3 neighbors of the previous row along y and by
+// the 9 neighbors of the previous layer along z, so that diagonal directions
+// propagate too. The first preceding cell is always the neighbor along the
+// axis. Rows and layers which don't depend on each other are swept in
+// parallel. Returns true if any update returned true.
+template <typename Update>
+bool sweep(const Size3& size, const Update& update) {
+    std::atomic<bool> changed{false};
+    const size_t strideY = size.x;
+    const size_t strideZ = size.x * size.y;
+
+    for (int direction : {1, -1}) {
+        // Along x, rows of each layer are swept by the same task.
+        parallelFor(kZeroSize, size.z, [&](size_t k) {
+            bool layerChanged = false;
+            for (size_t j = 0; j < size.y; ++j) {
+                const size_t row = j * strideY + k * strideZ;
+                for (size_t n = 1; n < size.x; ++n) {
+                    const size_t i = direction > 0 ? n : size.x - 1 - n;
+                    const size_t previous = direction > 0 ? row + i - 1 : row + i + 1;
+                    layerChanged |= update(row + i, &previous, 1);
+                }
+            }
+            if (layerChanged) changed = true;
+        });
+
+        // Along y, layers are swept by separate tasks.
+        parallelFor(kZeroSize, size.z, [&](size_t k) {
+            bool layerChanged = false;
+            size_t previous[3];
+            for (size_t n = 1; n < size.y; ++n) {
+                const size_t j = direction > 0 ? n : size.y - 1 - n;
+                const size_t row = j * strideY + k * strideZ;
+                const size_t previousRow = direction > 0 ? row - strideY : row + strideY;
+                for (size_t i = 0; i < size.x; ++i) {
+                    size_t count = 1;
+                    previous[0] = previousRow + i;
+                    for (size_t pi = i > 0 ? i - 1 : 0; pi <= std::min(i + 1, size.x - 1); ++pi) {
+                        if (pi != i) previous[count++] = previousRow + pi;
+                    }
+                    layerChanged |= update(row + i, previous, count);
+                }
+            }
+            if (layerChanged) changed = true;
+        });
+
+        // Along z, each layer depends on the whole previous one, so its rows
+        // are swept in parallel.
+        for (size_t n = 1; n < size.z; ++n) {
+            const size_t k = direction > 0 ? n : size.z - 1 - n;
+            const size_t layer = k * strideZ;
+            const size_t previousLayer = direction > 0 ? layer - strideZ : layer + strideZ;
+            parallelFor(kZeroSize, size.y, [&](size_t j) {
+                bool rowChanged = false;
+                size_t previous[9];
+                const size_t row = layer + j * strideY;
+                for (size_t i = 0; i < size.x; ++i) {
+                    size_t count = 1;
+                    previous[0] = previousLayer + j * strideY + i;
+                    for (size_t pj = j > 0 ? j - 1 : 0; pj <= std::min(j + 1, size.y - 1); ++pj) {
+                        const size_t previousRow = previousLayer + pj * strideY;
+                        for (size_t pi = i > 0 ? i - 1 : 0; pi <= std::min(i + 1, size.x - 1); ++pi) {
+                            if (pi != i || pj != j) previous[count++] = previousRow + pi;
+                        }
+                    }
+                    rowChanged |= update(row + i, previous, count);
+                }
+                if (rowChanged) changed = true;
+            });
+        }
+    }
+
+    return changed;
+}
+
+}  // namespace
+
+void triangleMeshToSdf(const TriangleMesh3& mesh, ScalarGrid3* sdf, const unsigned int exactBand) {
     Size3 size = sdf->dataSize();
     if (size.x * size.y * size.z == 0) {
         return;
     }
 
-    const auto pos = sdf->dataPosition();
+    auto sdfData = sdf->dataAccessor();
+    const size_t numTriangles = mesh.numberOfTriangles();
+    if (numTriangles == 0) {
+        sdf->fill(kMaxD);
+        return;
+    }
+
     mesh.updateQueryEngine();
-    sdf->parallelForEachDataPointIndex([&](size_t i, size_t j, size_t k) {
-        const Point3D p = pos(i, j, k);
-        const double d = mesh.closestDistance(p);
-        const double sd = mesh.isInside(p) ? -d : d;
-        (*sdf)(i, j, k) = sd;
+
+    std::vector<TrianglePoints> triangles(numTriangles);
+    parallelFor(kZeroSize, numTriangles, [&](size_t t) {
+        const Point3UI& indices = mesh.pointIndex(t);
+        for (size_t v = 0; v < 3; ++v) {
+            triangles[t][v] = mesh.transform.toWorld(mesh.point(indices[v]));
+        }
+    });
+
+    // Cells of the grid hold the distance to their closest triangle found so
+    // far, which is exact within the band once triangles are rasterized.
+    Array3<uint32_t> closest(size, kNoTriangle);
+    sdf->fill(kMaxD);
+
+    // Finds the range of cells within the band of each triangle, and buckets
+    // triangles by the z slabs they overlap. The band is measured in cells of
+    // the coarsest axis, so that cells beyond it are further from the surface
+    // than from any of their neighbors along an axis.
+    const Point3D origin = sdf->dataOrigin();
+    const Vector3D& spacing = sdf->gridSpacing();
+    const auto cellPosition = [&](size_t i, size_t j, size_t k) {
+        return Point3D(origin.x + spacing.x * i, origin.y + spacing.y * j, origin.z + spacing.z * k);
+    };
+    const double band = std::max(exactBand, 1u) * spacing.max();
+    const size_t numSlabs = (size.z + kSlabSize - 1) / kSlabSize;
+    std::vector<std::array<size_t, 6>> cellRanges(numTriangles);
+    std::vector<std::vector<uint32_t>> slabs(numSlabs);
+    for (size_t t = 0; t < numTriangles; ++t) {
+        BoundingBox3D bound(triangles[t][0], triangles[t][1]);
+        bound.merge(triangles[t][2]);
+
+        std::array<size_t, 6>& range = cellRanges[t];
+        bool isInGrid = true;
+        for (size_t axis = 0; axis < 3; ++axis) {
+            const double lower = std::ceil((bound.lower_corner[axis] - band - origin[axis]) / spacing[axis]);
+            const double upper = std::floor((bound.upper_corner[axis] + band - origin[axis]) / spacing[axis]);
+            const auto n = static_cast<double>(size[axis]);
+            if (upper < 0.0 || lower >= n) {
+                isInGrid = false;
+                break;
+            }
+            range[axis] = static_cast<size_t>(std::max(lower, 0.0));
+            range[axis + 3] = static_cast<size_t>(std::min(upper, n - 1.0)) + 1;
+        }
+        if (isInGrid) {
+            for (size_t s = range[2] / kSlabSize; s * kSlabSize < range[5]; ++s) {
+                slabs[s].push_back(static_cast<uint32_t>(t));
+            }
+        }
+    }
+
+    // Computes exact distances within the band. Each task owns the cells of a
+    // slab, so that triangles spanning several slabs don't race.
+    std::atomic<bool> hasBand{false};
+    parallelFor(kZeroSize, numSlabs, [&](size_t s) {
+        const size_t slabBegin = s * kSlabSize;
+        const size_t slabEnd = std::min(slabBegin + kSlabSize, size.z);
+        for (uint32_t t : slabs[s]) {
+            const std::array<size_t, 6>& range = cellRanges[t];
+            for (size_t k = std::max(range[2], slabBegin); k < std::min(range[5], slabEnd); ++k) {
+                for (size_t j = range[1]; j < range[4]; ++j) {
+                    for (size_t i = range[0]; i < range[3]; ++i) {
+                        const double d = distanceSquaredToTriangle(cellPosition(i, j, k), triangles[t]);
+                        if (d < sdfData(i, j, k)) {
+                            sdfData(i, j, k) = d;
+                            closest(i, j, k) = t;
+                        }
+                    }
+                }
+            }
+        }
+        if (!slabs[s].empty()) hasBand = true;
+    });
+
+    // Without any triangle near the grid, the closest triangle of a corner is
+    // searched so that sweeps have something to propagate.
+    if (!hasBand) {
+        for (size_t t = 0; t < numTriangles; ++t) {
+            const double d = distanceSquaredToTriangle(origin, triangles[t]);
+            if (d < sdfData[0]) {
+                sdfData[0] = d;
+                closest[0] = static_cast<uint32_t>(t);
+            }
+        }
+    }
+
+    // Band cells are known before sweeps spread distances everywhere.
+    Array3<char> sign(size, 0);
+    parallelFor(kZeroSize, size.x * size.y * size.z, [&](size_t c) {
+        if (closest[c] != kNoTriangle) sign[c] = 2;
+    });
+
+    // Fast sweeping: cells try the closest triangle of their neighbors. Two
+    // rounds of sweeps along the three axes carry triangles over the grid.
+    const size_t strideY = size.x;
+    const size_t strideZ = size.x * size.y;
+    const auto position = [&](size_t c) { return cellPosition(c % strideY, (c / strideY) % size.y, c / strideZ); };
+    for (size_t round = 0; round < 2; ++round) {
+        sweep(size, [&](size_t c, const size_t* previous, size_t count) {
+            // Neighbors mostly share their closest triangles, which are only
+            // tried once.
+            uint32_t tried[9];
+            size_t numTried = 0;
+            for (size_t n = 0; n < count; ++n) {
+                const uint32_t t = closest[previous[n]];
+                if (t == kNoTriangle || t == closest[c] || std::find(tried, tried + numTried, t) != tried + numTried) {
+                    continue;
+                }
+                tried[numTried++] = t;
+                const double d = distanceSquaredToTriangle(position(c), triangles[t]);
+                if (d < sdfData[c]) {
+                    sdfData[c] = d;
+                    closest[c] = t;
+                }
+            }
+            return false;
+        });
+    }
+
+    // Signs are computed with winding numbers within the band. Cells beyond
+    // the band are further from the surface than from their neighbors along
+    // the axes, which can't be across it: signs spread from the band to them by
+    // sweeping along the axes.
+    parallelFor(kZeroSize, size.x * size.y * size.z, [&](size_t c) {
+        sdfData[c] = std::sqrt(sdfData[c]);
+        if (sign[c] != 0) {
+            sign[c] = mesh.isInside(position(c)) ? -1 : 1;
+        }
+    });
+    if (!hasBand) {
+        // The whole grid is on the same side of the surface.
+        sign[0] = mesh.isInside(origin) ? -1 : 1;
+    }
+    bool hasSpread = true;
+    while (hasSpread) {
+        hasSpread = sweep(size, [&](size_t c, const size_t* previous, size_t) {
+            if (sign[c] != 0 || sign[previous[0]] == 0) {
+                return false;
+            }
+            sign[c] = sign[previous[0]];
+            return true;
+        });
+    }
+
+    parallelFor(kZeroSize, size.x * size.y * size.z, [&](size_t c) {
+        if (sign[c] < 0) sdfData[c] = -sdfData[c];
     });
 }
 
@@ -14,15 +14,17 @@ namespace vox {
 //!
 //! \brief Generates signed-distance field out of given triangle mesh.
 //!
-//! This function generates signed-distance field from a triangle mesh. The sign
-//! is determined by TriangleMesh3::isInside (negative means inside).
-//!
-//! \warning Parameter \p exactBand is no longer used and will be deprecated in
-//! next release (v2.x).
+//! This function generates signed-distance field from a triangle mesh.
+//! Triangles are rasterized into the cells within \p exactBand cells of them,
+//! which get exact distances. The closest triangles are then propagated to the
+//! rest of the grid by parallel fast sweeping. The sign is determined by
+//! TriangleMesh3::isInside (negative means inside) within the band, and spread
+//! from it to the other cells.
 //!
 //! \param[in]      mesh      The mesh.
 //! \param[in,out]  sdf       The output signed-distance field.
-//! \param[in]      exactBand This parameter is no longer used.
+//! \param[in]      exactBand The width of the exact band, in cells of the
+//!                           coarsest axis (at least 1).
 //!
 void triangleMeshToSdf(const TriangleMesh3& mesh, ScalarGrid3* sdf, unsigned int exactBand = 1);
 
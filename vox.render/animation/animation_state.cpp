@@ -26,6 +26,13 @@ void AnimationState::removeChild(const std::shared_ptr<AnimationState>& state) {
     }
 }
 
+void AnimationState::setSampledSoaJoints(span<const uint8_t> joints) {
+    _sampled_soa_joints = joints;
+    for (auto& state : _states) {
+        state->setSampledSoaJoints(joints);
+    }
+}
+
 vox::vector<vox::simd_math::SimdFloat4>& AnimationState::jointMasks() { return _joint_masks; }
 
 void AnimationState::setJointMasks(float mask, const char* root) {
@@ -26,6 +26,11 @@ public:
 
     void removeChild(const std::shared_ptr<AnimationState>& state);
 
+    // Sets the soa joints sampled by this state and its children, one bit per
+    // soa joint, see SamplingJob::sampled_soa_tracks. All joints are sampled if
+    // empty. The buffer must outlive the next updates.
+    virtual void setSampledSoaJoints(span<const uint8_t> joints);
+
 public:
     virtual void update(float dt) = 0;
 
@@ -41,6 +46,9 @@ protected:
     // weight_setting.
     vox::vector<vox::simd_math::SimdFloat4> _joint_masks;
 
+    // Soa joints sampled by clips, all of them if empty.
+    span<const uint8_t> _sampled_soa_joints;
+
     vox::vector<std::shared_ptr<AnimationState>> _states{};
 };
 }  // namespace vox
\ No newline at end of file
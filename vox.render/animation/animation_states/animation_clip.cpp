@@ -58,7 +58,11 @@ const vox::vector<simd_math::SoaTransform>& AnimationClip::locals() const { retu
 void AnimationClip::loadSkeleton(animation::Skeleton* skeleton) {
     AnimationState::loadSkeleton(skeleton);
 
-    _context.Resize(skeleton->num_joints());
+    // Animator reloads the skeleton every frame. Resizing invalidates the context, which would throw away the
+    // cached keyframe cursors and reallocate, so only do it when the number of joints changes.
+    if (_context.max_soa_tracks() != skeleton->num_soa_joints()) {
+        _context.Resize(skeleton->num_joints());
+    }
     _locals.resize(skeleton->num_soa_joints());
     _sampling_job.output = make_span(_locals);
 
@@ -83,6 +87,7 @@ void AnimationClip::update(float dt) {
     // mode).
     setTimeRatio(new_time);
     _sampling_job.ratio = timeRatio();
+    _sampling_job.sampled_soa_tracks = _sampled_soa_joints;
     if (_sampling_job.animation) {
         (void)_sampling_job.Run();
     }
@@ -17,6 +17,13 @@ void AnimationCrossFade::loadSkeleton( animation::Skeleton* skeleton) {
     _blend_job.rest_pose = skeleton->joint_rest_poses();
 }
 
+void AnimationCrossFade::setSampledSoaJoints(span<const uint8_t> joints) {
+    AnimationState::setSampledSoaJoints(joints);
+    for (auto& clip : _clips) {
+        clip.setSampledSoaJoints(joints);
+    }
+}
+
 void AnimationCrossFade::update(float dt) {
     // todo
 }
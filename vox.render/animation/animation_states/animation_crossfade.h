@@ -18,6 +18,8 @@ public:
 
     void update(float dt) override;
 
+    void setSampledSoaJoints(span<const uint8_t> joints) override;
+
     [[nodiscard]] const vox::vector<simd_math::SoaTransform>& locals() const override;
 
 private:
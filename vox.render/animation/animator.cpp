@@ -6,10 +6,12 @@
 
 #include "vox.render/animation/animator.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "vox.base/io/archive.h"
 #include "vox.base/logging.h"
+#include "vox.base/profiler.h"
 #include "vox.render/components_manager.h"
 #include "vox.render/entity.h"
 #include "vox.render/platform/filesystem.h"
@@ -42,6 +44,8 @@ bool Animator::loadSkeleton(const std::string& filename) {
     _models.resize(_skeleton.num_joints());
     _ltm_job.output = make_span(_models);
     _ltm_job.skeleton = &_skeleton;
+    _ltm_tracker.Resize(_skeleton);
+    _resetLod();
     return true;
 }
 
@@ -50,29 +54,66 @@ void Animator::loadSkeleton(const vox::unique_ptr<animation::Skeleton>& skeleton
     _models.resize(_skeleton.num_joints());
     _ltm_job.output = make_span(_models);
     _ltm_job.skeleton = &_skeleton;
+    _ltm_tracker.Resize(_skeleton);
+    _resetLod();
 }
 
 void Animator::update(float dt) {
-    if (_rootState) {
-        _rootState->loadSkeleton(&_skeleton);
-        _rootState->update(dt);
-        _locals = _rootState->locals();
-    } else {
-        _locals.resize(_skeleton.num_soa_joints());
-        // Initialize locals from skeleton rest pose
-        for (size_t i = 0; i < _locals.size(); ++i) {
-            _locals[i] = _skeleton.joint_rest_poses()[i];
+    evaluate(dt);
+    apply();
+}
+
+void Animator::evaluate(float dt) {
+    VOX_PROFILE_ZONE("Animator::evaluate");
+    const LodLevel* level = _lodLevels.empty() ? nullptr : &_lodLevels[_lodLevel];
+    const uint32_t interval = level ? std::max(level->sampling_interval, 1u) : 1u;
+
+    _lodElapsedTime += dt;
+    if (_lodNeedsSample || ++_lodFrame >= interval) {
+        // Culled joints aren't sampled, they are selected before sampling.
+        _cullJoints(level ? level->max_joint_depth : -1);
+        // States are updated by the time elapsed since their last sampling.
+        _sample(_lodElapsedTime);
+        _lodElapsedTime = 0.f;
+        _lodFrame = 0;
+
+        if (interval > 1) {
+            // The new sample is reached at the end of the interval, starting from
+            // the previous one.
+            if (!_lodNeedsSample && _lodTargetModels.size() == _models.size() &&
+                _lodTargetLocals.size() == _locals.size()) {
+                std::swap(_lodSourceModels, _lodTargetModels);
+                std::swap(_lodSourceLocals, _lodTargetLocals);
+            } else {
+                _lodSourceModels = _models;
+                _lodSourceLocals = _locals;
+            }
+            _lodTargetModels = _models;
+            _lodTargetLocals = _locals;
+            _models = _lodSourceModels;
+            _locals = _lodSourceLocals;
+        } else {
+            _lodTargetModels.clear();
+            _lodTargetLocals.clear();
         }
+        _lodNeedsSample = false;
+    } else {
+        _interpolate(static_cast<float>(_lodFrame) / static_cast<float>(interval));
     }
-    _ltm_job.input = make_span(_locals);
-    (void)_ltm_job.Run();
+}
 
+void Animator::apply() {
+    VOX_PROFILE_ZONE("Animator::apply");
     // post-sample schedule work
     for (const auto& functor : _scheduleFunctor) {
         functor();
     }
     _scheduleFunctor.clear();
 
+    // Model-space matrices of the joints modified by the post-sample work are
+    // updated once, whatever the number of passes that modified them.
+    _updateModels();
+
     // sync to attach entity
     Matrix4x4F localMatrix;
     for (const auto& entities : _entityBindingMap) {
@@ -84,6 +125,156 @@ void Animator::update(float dt) {
     }
 }
 
+void Animator::_sample(float dt) {
+    if (_rootState) {
+        _rootState->loadSkeleton(&_skeleton);
+        _rootState->setSampledSoaJoints(make_span(_lodSampledSoaJoints));
+        _rootState->update(dt);
+        _locals = _rootState->locals();
+    } else {
+        _locals.resize(_skeleton.num_soa_joints());
+        // Initialize locals from skeleton rest pose
+        for (size_t i = 0; i < _locals.size(); ++i) {
+            _locals[i] = _skeleton.joint_rest_poses()[i];
+        }
+    }
+
+    // Culled joints take their rest pose, so they follow their ancestor.
+    const span<const simd_math::SoaTransform> rest_poses = _skeleton.joint_rest_poses();
+    for (size_t i = 0; i < _lodCulledJoints.size() && i < _locals.size(); ++i) {
+        const simd_math::SimdInt4 culled = _lodCulledJoints[i];
+        const simd_math::SoaTransform& rest = rest_poses[i];
+        simd_math::SoaTransform& local = _locals[i];
+        local.translation.x = simd_math::Select(culled, rest.translation.x, local.translation.x);
+        local.translation.y = simd_math::Select(culled, rest.translation.y, local.translation.y);
+        local.translation.z = simd_math::Select(culled, rest.translation.z, local.translation.z);
+        local.rotation.x = simd_math::Select(culled, rest.rotation.x, local.rotation.x);
+        local.rotation.y = simd_math::Select(culled, rest.rotation.y, local.rotation.y);
+        local.rotation.z = simd_math::Select(culled, rest.rotation.z, local.rotation.z);
+        local.rotation.w = simd_math::Select(culled, rest.rotation.w, local.rotation.w);
+        local.scale.x = simd_math::Select(culled, rest.scale.x, local.scale.x);
+        local.scale.y = simd_math::Select(culled, rest.scale.y, local.scale.y);
+        local.scale.z = simd_math::Select(culled, rest.scale.z, local.scale.z);
+    }
+
+    _ltm_job.input = make_span(_locals);
+    (void)_ltm_job.Run();
+    _ltm_tracker.Clear();
+}
+
+void Animator::_updateModels(int joint) { (void)_ltm_tracker.Update(_ltm_job, joint); }
+
+void Animator::_updateModels() { (void)_ltm_tracker.Update(_ltm_job); }
+
+void Animator::setLodLevels(std::vector<LodLevel> levels) {
+    std::stable_sort(levels.begin(), levels.end(),
+                     [](const LodLevel& a, const LodLevel& b) { return a.distance < b.distance; });
+    _lodLevels = std::move(levels);
+    _lodLevel = 0;
+    _lodNeedsSample = true;
+}
+
+const std::vector<Animator::LodLevel>& Animator::lodLevels() const { return _lodLevels; }
+
+void Animator::setLodDistance(float distance) {
+    // Last level whose distance is reached, the first one otherwise.
+    size_t level = 0;
+    while (level + 1 < _lodLevels.size() && _lodLevels[level + 1].distance <= distance) {
+        ++level;
+    }
+    _lodLevel = level;
+}
+
+size_t Animator::lodLevel() const { return _lodLevel; }
+
+void Animator::_resetLod() {
+    _lodNeedsSample = true;
+    _lodSourceModels.clear();
+    _lodTargetModels.clear();
+    _lodSourceLocals.clear();
+    _lodTargetLocals.clear();
+    _lodCulledDepth = -1;
+    _lodCulledJoints.clear();
+    _lodSampledSoaJoints.clear();
+}
+
+void Animator::_cullJoints(int max_depth) {
+    if (max_depth == _lodCulledDepth) {
+        return;
+    }
+    _lodCulledDepth = max_depth;
+    _lodCulledJoints.clear();
+    _lodSampledSoaJoints.clear();
+
+    const int num_joints = _skeleton.num_joints();
+    if (max_depth < 0 || !num_joints) {
+        return;
+    }
+
+    // Parents are always stored before their children, so depths are known when
+    // a joint is reached. Joints are stored depth first, so culled joints are
+    // spread across soa joints: a soa joint is sampled as long as one of its
+    // joints isn't culled.
+    const span<const int16_t> parents = _skeleton.joint_parents();
+    const int num_soa_joints = _skeleton.num_soa_joints();
+    vox::vector<int> depths(num_joints);
+    _lodCulledJoints.resize(num_soa_joints);
+    _lodSampledSoaJoints.assign((num_soa_joints + 7) / 8, 0);
+    for (int i = 0; i < num_soa_joints; ++i) {
+        int culled[4];
+        for (int j = 0; j < 4; ++j) {
+            const int joint = i * 4 + j;
+            if (joint >= num_joints) {
+                culled[j] = -1;
+                continue;
+            }
+            const int parent = parents[joint];
+            depths[joint] = parent == animation::Skeleton::kNoParent ? 0 : depths[parent] + 1;
+            culled[j] = depths[joint] > max_depth ? -1 : 0;
+            if (!culled[j]) {
+                _lodSampledSoaJoints[i / 8] |= 1 << (i & 7);
+            }
+        }
+        _lodCulledJoints[i] = simd_math::simd_int4::Load(culled[0], culled[1], culled[2], culled[3]);
+    }
+}
+
+void Animator::_interpolate(float alpha) {
+    if (_lodSourceModels.size() != _models.size() || _lodTargetModels.size() != _models.size() ||
+        _lodSourceLocals.size() != _locals.size() || _lodTargetLocals.size() != _locals.size()) {
+        return;
+    }
+
+    const simd_math::SimdFloat4 simd_alpha = simd_math::simd_float4::Load1(alpha);
+    for (size_t i = 0; i < _models.size(); ++i) {
+        const simd_math::Float4x4& source = _lodSourceModels[i];
+        const simd_math::Float4x4& target = _lodTargetModels[i];
+        simd_math::Float4x4& model = _models[i];
+        model.cols[0] = simd_math::Lerp(source.cols[0], target.cols[0], simd_alpha);
+        model.cols[1] = simd_math::Lerp(source.cols[1], target.cols[1], simd_alpha);
+        model.cols[2] = simd_math::Lerp(source.cols[2], target.cols[2], simd_alpha);
+        model.cols[3] = simd_math::Lerp(source.cols[3], target.cols[3], simd_alpha);
+    }
+
+    // Local transforms are restored from the samples too, as the previous frame
+    // post-sample work corrected them. IK is then applied to the uncorrected
+    // pose instead of compounding corrections.
+    for (size_t i = 0; i < _locals.size(); ++i) {
+        const simd_math::SoaTransform& source = _lodSourceLocals[i];
+        const simd_math::SoaTransform& target = _lodTargetLocals[i];
+        simd_math::SoaTransform& local = _locals[i];
+        // Interpolates rotations along the shortest path.
+        const simd_math::SimdInt4 sign = simd_math::Sign(Dot(source.rotation, target.rotation));
+        const simd_math::SoaQuaternion rotation = {
+                simd_math::Xor(target.rotation.x, sign), simd_math::Xor(target.rotation.y, sign),
+                simd_math::Xor(target.rotation.z, sign), simd_math::Xor(target.rotation.w, sign)};
+        local.translation = Lerp(source.translation, target.translation, simd_alpha);
+        local.rotation = NLerpEst(source.rotation, rotation, simd_alpha);
+        local.scale = Lerp(source.scale, target.scale, simd_alpha);
+    }
+    _ltm_tracker.Clear();
+}
+
 bool Animator::localToModelFromExcluded() const { return _ltm_job.from_excluded; }
 
 void Animator::setLocalToModelFromExcluded(bool value) { _ltm_job.from_excluded = value; }
@@ -100,14 +291,12 @@ const vox::vector<simd_math::Float4x4>& Animator::models() const { return _model
 
 const animation::Skeleton& Animator::skeleton() const { return _skeleton; }
 
-void Animator::_multiplySoATransformQuaternion(int index,
-                                               const simd_math::SimdQuaternion& quat,
-                                               const span<simd_math::SoaTransform>& transforms) {
-    assert(index >= 0 && static_cast<size_t>(index) < transforms.size() * 4 && "joint index out of bound.");
+void Animator::_multiplySoATransformQuaternion(int index, const simd_math::SimdQuaternion& quat) {
+    assert(index >= 0 && static_cast<size_t>(index) < _locals.size() * 4 && "joint index out of bound.");
 
     // Convert soa to aos in order to perform quaternion multiplication, and gets
     // back to soa.
-    vox::simd_math::SoaTransform& soa_transform_ref = transforms[index / 4];
+    vox::simd_math::SoaTransform& soa_transform_ref = _locals[index / 4];
     vox::simd_math::SimdQuaternion aos_quaternions[4];
     vox::simd_math::Transpose4x4(&soa_transform_ref.rotation.x, &aos_quaternions->xyzw);
 
@@ -115,6 +304,9 @@ void Animator::_multiplySoATransformQuaternion(int index,
     aos_quat_ref = aos_quat_ref * quat;
 
     vox::simd_math::Transpose4x4(&aos_quaternions->xyzw, &soa_transform_ref.rotation.x);
+
+    // Model-space matrices of the joint hierarchy are outdated.
+    _ltm_tracker.SetDirty(index);
 }
 
 void Animator::computeSkeletonBounds(BoundingBox3F& bound) {
@@ -204,6 +396,9 @@ void Animator::encodeHandIKData(const HandIKData& data) {
         const simd_math::SimdFloat4 pole_vector_ms =
                 TransformVector(invert_root, simd_math::simd_float4::Load3PtrU(&data.pole_vector.x));
 
+        // Previous passes might have modified the chain or its parents.
+        _updateModels(data.end_joint);
+
         // Setup IK job.
         animation::IKTwoBoneJob ik_job;
         ik_job.target = target_ms;
@@ -232,26 +427,17 @@ void Animator::encodeHandIKData(const HandIKData& data) {
         }
 
         // Apply IK quaternions to their respective local-space transforms.
-        _multiplySoATransformQuaternion(data.start_joint, start_correction, make_span(_locals));
-        _multiplySoATransformQuaternion(data.mid_joint, mid_correction, make_span(_locals));
-
-        // Updates model-space matrices now IK has been applied to local transforms.
-        // All the ancestors of the start of the IK chain must be computed.
-        animation::LocalToModelJob ltm_job;
-        ltm_job.skeleton = &_skeleton;
-        ltm_job.input = make_span(_locals);
-        ltm_job.output = make_span(_models);
-        ltm_job.from = data.start_joint;  // Local transforms haven't changed before start_joint_.
-        ltm_job.to = animation::Skeleton::kMaxJoints;
-
-        if (!ltm_job.Run()) {
-            return;
-        }
+        // Model-space matrices of the chain are updated when they are needed.
+        _multiplySoATransformQuaternion(data.start_joint, start_correction);
+        _multiplySoATransformQuaternion(data.mid_joint, mid_correction);
     });
 }
 
 void Animator::encodeLookAtIK(const LookAtIKData& data) {
     _scheduleFunctor.emplace_back([this, data]() {
+        // Previous passes might have modified the chain or its parents.
+        _updateModels(data.joints_chain[0]);
+
         // IK aim job setup.
         animation::IKAimJob ik_job;
 
@@ -321,14 +507,12 @@ void Animator::encodeLookAtIK(const LookAtIKData& data) {
             }
 
             // Apply IK quaternion to its respective local-space transforms.
-            _multiplySoATransformQuaternion(joint, correction, make_span(_locals));
+            _multiplySoATransformQuaternion(joint, correction);
         }
 
-        // Skeleton model-space matrices need to be updated again. This re-uses the
-        // already setup job, but limits the update to childs of the last joint (the
-        // parent-iest of the chain).
-        _ltm_job.from = previous_joint;
-        (void)_ltm_job.Run();
+        // Skeleton model-space matrices need to be updated again, which is limited
+        // to the hierarchy of the last joint (the parent-iest of the chain) and done
+        // when they are needed.
     });
 }
 
@@ -385,7 +569,9 @@ void Animator::_raycastLegs(const FloorIKData& data) {
         const FloorIKData::LegSetup& leg = data.legs[l];
         LegRayInfo& ray = _rays_info[l];
 
-        // Finds ankle initial world space position
+        // Finds ankle initial world space position, once previous passes
+        // modifications are applied.
+        _updateModels(leg.ankle);
         simd_math::Store3PtrU(TransformPoint(root, _models[leg.ankle].cols[3]), &_ankles_initial_ws[l].x);
 
         // Builds ray, from above ankle (kFootRayHeightOffset) and going downward.
@@ -478,11 +664,6 @@ bool Animator::_updateFootIK(const FloorIKData& data) {
     memcpy(&root.cols[0], worldMat.data(), 64);
     const simd_math::Float4x4 inv_root = Invert(root);
 
-    animation::LocalToModelJob ltm_job;
-    ltm_job.skeleton = &_skeleton;
-    ltm_job.input = make_span(_locals);
-    ltm_job.output = make_span(_models);
-
     // Perform IK
     for (size_t l = 0; l < data.legs.size(); ++l) {
         const LegRayInfo& ray = _rays_info[l];
@@ -491,19 +672,17 @@ bool Animator::_updateFootIK(const FloorIKData& data) {
         }
         const FloorIKData::LegSetup& leg = data.legs[l];
 
+        // Previous legs might share parents with this one.
+        _updateModels(leg.ankle);
+
         // Updates leg joint chain so ankle reaches its targeted position.
         if (!_applyLegTwoBoneIK(data, leg, _ankles_target_ws[l], inv_root)) {
             return false;
         }
 
         // Updates leg joints model-space transforms.
-        // Update will go from hip to ankle. Ankle's siblings might not be updated
-        // as local-to-model will stop as soon as ankle joint is reached.
-        ltm_job.from = leg.hip;
-        ltm_job.to = leg.ankle;
-        if (!ltm_job.Run()) {
-            return false;
-        }
+        // Only the hip hierarchy is updated, as hip and knee were modified.
+        _updateModels(leg.ankle);
 
         // Computes ankle orientation, so it's aligned to the floor normal.
         const Vector3F aim_ik_target(_ankles_target_ws[l] + ray.hit_normal);
@@ -511,15 +690,8 @@ bool Animator::_updateFootIK(const FloorIKData& data) {
             return false;
         }
 
-        // Updates model-space transformation now ankle local changes is done.
-        // Ankle rotation has already been updated, but its siblings (or it's
-        // parent siblings) might are not. So we local-to-model update must
-        // be complete starting from hip.
-        ltm_job.from = leg.hip;
-        ltm_job.to = animation::Skeleton::kMaxJoints;
-        if (!ltm_job.Run()) {
-            return false;
-        }
+        // Ankle model-space transformation and its hierarchy are updated when
+        // they are needed, at the latest at the end of the frame update.
     }
     return true;
 }
@@ -554,8 +726,8 @@ bool Animator::_applyLegTwoBoneIK(const FloorIKData& data,
     // Apply IK quaternions to their respective local-space transforms.
     // Model-space transformations needs to be updated after a call to this
     // function.
-    _multiplySoATransformQuaternion(_leg.hip, start_correction, make_span(_locals));
-    _multiplySoATransformQuaternion(_leg.knee, mid_correction, make_span(_locals));
+    _multiplySoATransformQuaternion(_leg.hip, start_correction);
+    _multiplySoATransformQuaternion(_leg.knee, mid_correction);
 
     return true;
 }
@@ -590,7 +762,7 @@ bool Animator::_applyAnkleAimIK(const FloorIKData& data,
     // Apply IK quaternions to their respective local-space transforms.
     // Model-space transformations needs to be updated after a call to this
     // function.
-    _multiplySoATransformQuaternion(_leg.ankle, correction, make_span(_locals));
+    _multiplySoATransformQuaternion(_leg.ankle, correction);
 
     return true;
 }
@@ -11,6 +11,7 @@
 #include "vox.animation/runtime/ik_aim_job.h"
 #include "vox.animation/runtime/ik_two_bone_job.h"
 #include "vox.animation/runtime/local_to_model_job.h"
+#include "vox.animation/runtime/local_to_model_tracker.h"
 #include "vox.base/memory/unique_ptr.h"
 #include "vox.math/bounding_box3.h"
 #include "vox.render/animation/animation_state.h"
@@ -38,8 +39,23 @@ public:
     [[nodiscard]] const animation::Skeleton& skeleton() const;
 
 public:
+    /**
+     * Evaluates the animation then applies it, see evaluate() and apply().
+     */
     void update(float dt);
 
+    /**
+     * Samples, blends and computes the model-space matrices. Only touches data owned by this animator, so
+     * different animators can be evaluated concurrently.
+     */
+    void evaluate(float dt);
+
+    /**
+     * Runs the IK passes and writes the bound entity transforms. It reads and writes the entity hierarchy and
+     * calls user raycasts, so animators are applied serially on the main thread.
+     */
+    void apply();
+
     [[nodiscard]] bool localToModelFromExcluded() const;
 
     void setLocalToModelFromExcluded(bool value);
@@ -125,6 +141,39 @@ public:
     };
     void encodeFloorIK(const FloorIKData& data);
 
+public:
+    // Level of detail of the animator, selected from the camera distance.
+    struct LodLevel {
+        // Camera distance from which this level is used.
+        float distance = 0.f;
+        // Number of frames between two samplings of the animation. Model-space
+        // matrices of the frames in between are interpolated from the last two
+        // samples, so the pose is displayed one interval late.
+        uint32_t sampling_interval = 1;
+        // Joints deeper than this in the hierarchy aren't sampled, they follow
+        // their ancestor at this depth with their rest pose. Negative values
+        // animate all joints.
+        int max_joint_depth = -1;
+    };
+
+    /**
+     * Sets the levels of detail, the first one is used below the distance of the others.
+     */
+    void setLodLevels(std::vector<LodLevel> levels);
+
+    [[nodiscard]] const std::vector<LodLevel>& lodLevels() const;
+
+    /**
+     * Selects the level of detail used by the next updates.
+     * @param distance Camera distance of the animated character
+     */
+    void setLodDistance(float distance);
+
+    /**
+     * Index of the current level of detail, 0 if there's no level.
+     */
+    [[nodiscard]] size_t lodLevel() const;
+
 public:
     /**
      * Serialize the component
@@ -146,10 +195,30 @@ private:
 
     void _onDisable() override;
 
-    // Multiplies a single quaternion at a specific index in a SoA transform range.
-    static void _multiplySoATransformQuaternion(int _index,
-                                                const simd_math::SimdQuaternion& _quat,
-                                                const span<simd_math::SoaTransform>& _transforms);
+    // Multiplies a single quaternion at a specific index in the local transforms,
+    // and flags the joint model-space matrix as outdated.
+    void _multiplySoATransformQuaternion(int _index, const simd_math::SimdQuaternion& _quat);
+
+    // Updates the outdated model-space matrices of _joint and its parents, so they
+    // can be read by IK jobs.
+    void _updateModels(int _joint);
+
+    // Updates all outdated model-space matrices.
+    void _updateModels();
+
+    // Updates animation states by dt and computes model-space matrices.
+    void _sample(float dt);
+
+    // Forgets the samples and joint culling tables of the previous skeleton.
+    void _resetLod();
+
+    // Culls the joints deeper than max_depth from the next samplings: their
+    // tracks aren't sampled and they take their rest pose.
+    void _cullJoints(int max_depth);
+
+    // Interpolates model-space matrices and local transforms between the last
+    // two samples.
+    void _interpolate(float alpha);
 
     // Computes the bounding box of posture defines be _matrices range.
     // _bound must be a valid math::Box instance.
@@ -199,6 +268,9 @@ private:
 private:
     animation::Skeleton _skeleton;
     animation::LocalToModelJob _ltm_job;
+    // Joints whose local transform changed since model-space matrices were
+    // computed. IK passes only recompute the hierarchies they modified, once.
+    animation::LocalToModelTracker _ltm_tracker;
     // Buffer of local transforms as sampled from animation_.
     vox::vector<simd_math::SoaTransform> _locals;
     // Buffer of model space matrices.
@@ -207,6 +279,26 @@ private:
     std::vector<std::function<void()>> _scheduleFunctor{};
     std::unordered_map<size_t, std::unordered_set<Entity*>> _entityBindingMap{};
 
+    // Levels of detail, sorted by distance.
+    std::vector<LodLevel> _lodLevels{};
+    size_t _lodLevel{0};
+    // Frames and time elapsed since the last sampling.
+    uint32_t _lodFrame{0};
+    float _lodElapsedTime{0.f};
+    bool _lodNeedsSample{true};
+    // Model-space matrices and local transforms of the last two samples, used by
+    // interpolated frames. Local transforms are kept before post-sample work.
+    vox::vector<simd_math::Float4x4> _lodSourceModels;
+    vox::vector<simd_math::Float4x4> _lodTargetModels;
+    vox::vector<simd_math::SoaTransform> _lodSourceLocals;
+    vox::vector<simd_math::SoaTransform> _lodTargetLocals;
+    // Culled joint lanes of every soa joint, and the soa joints that are still
+    // sampled, one bit each, built for _lodCulledDepth. Empty if no joint is
+    // culled.
+    int _lodCulledDepth{-1};
+    vox::vector<simd_math::SimdInt4> _lodCulledJoints;
+    vox::vector<uint8_t> _lodSampledSoaJoints;
+
     struct LegRayInfo {
         Vector3F start{};
         Vector3F dir{};
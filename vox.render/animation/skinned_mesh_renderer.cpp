@@ -6,10 +6,16 @@
 
 #include "vox.render/animation/skinned_mesh_renderer.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "vox.render/animation/animator.h"
+#include "vox.render/camera.h"
 #include "vox.render/entity.h"
 #include "vox.render/mesh/mesh_manager.h"
+#include "vox.render/scene.h"
 #include "vox.render/shader/internal_variant_name.h"
+#include "vox.simd_math/simd_skinning.h"
 
 namespace vox {
 const std::string SkinnedMeshRenderer::_skinningMatrixProperty = "u_jointMatrix";
@@ -26,31 +32,81 @@ void SkinnedMeshRenderer::setSkinnedMesh(const std::shared_ptr<Skin>& skin) {
     // Mesh::joint_remaps is used to know how to order skinning matrices. So
     // the number of matrices required is the size of joint_remaps.
     size_t num_skinning_matrices = skin->joint_remaps.size();
-    // Allocates skinning matrices.
-    _skinning_matrices.resize(num_skinning_matrices);
+    // Allocates skinning matrices, uploaded as 3x4 matrices.
+    _skinning_matrices.resize(num_skinning_matrices * simd_math::kSkinningMatrix3x4Floats);
+    // Inverse bind poses are constant, they are packed once for the skinning kernel.
+    _soa_inverse_bind_poses.resize(simd_math::SoaInverseBindPosesCount(skin->inverse_bind_poses.size()));
+    (void)simd_math::PackInverseBindPoses(make_span(skin->inverse_bind_poses), make_span(_soa_inverse_bind_poses));
     _createMesh();
     _meshUpdateFlag = _mesh->registerUpdateFlag();
 }
 
-void SkinnedMeshRenderer::update(float deltaTime) {
+void SkinnedMeshRenderer::buildSkinningMatrices() {
     if (!_animator) {
         _animator = entity()->getComponent<Animator>();
     }
 
-    if (_animator && _skin) {
-        // Builds skinning matrices, based on the output of the animation stage.
-        // The mesh might not use (aka be skinned by) all skeleton joints. We
-        // use the joint remapping table (available from the mesh object) to
-        // reorder model-space matrices and build skinning ones.
-        for (size_t i = 0; i < _skin->joint_remaps.size(); ++i) {
-            _skinning_matrices[i] = _animator->models()[_skin->joint_remaps[i]] * _skin->inverse_bind_poses[i];
-        }
+    // Builds skinning matrices, based on the output of the animation stage.
+    // The mesh might not use (aka be skinned by) all skeleton joints. We
+    // use the joint remapping table (available from the mesh object) to
+    // reorder model-space matrices and build skinning ones.
+    _skinningMatricesValid = _animator && _skin &&
+                             simd_math::BuildSkinningMatrices3x4(
+                                     make_span(_animator->models()), make_span(_skin->joint_remaps),
+                                     make_span(_soa_inverse_bind_poses), make_span(_skinning_matrices));
+    _skinningMatricesBuilt = true;
+}
+
+void SkinnedMeshRenderer::update(float deltaTime) {
+    if (!_skinningMatricesBuilt) {
+        buildSkinningMatrices();
+    }
+    _skinningMatricesBuilt = false;
+
+    if (_animator) {
+        // Selects the level of detail of the next animator update from the
+        // camera distance. Culled renderers use the coarsest level.
+        _animator->setLodDistance(isCulled ? std::numeric_limits<float>::max() : _cameraDistance());
+    }
+
+    if (_skinningMatricesValid) {
         shaderData.setData(_skinningMatrixProperty, _skinning_matrices);
-        shaderData.addDefine(JOINTS_COUNT + std::to_string(_skinning_matrices.size()));
-        shaderData.addDefine(HAS_SKIN);
+        _updateSkinDefines(_skin->joint_remaps.size());
+    } else {
+        _updateSkinDefines(0);
+    }
+}
+
+float SkinnedMeshRenderer::_cameraDistance() {
+    const auto center = bounds().midPoint();
+    float distance = std::numeric_limits<float>::max();
+    for (const Camera* camera : entity()->scene()->activeCameras()) {
+        distance = std::min(distance, center.distanceTo(camera->entity()->transform->worldPosition()));
+    }
+    return distance;
+}
+
+void SkinnedMeshRenderer::_updateSkinDefines(size_t jointsCount) {
+    // Defines are only touched on change, each of them rebuilds the shader
+    // variant strings and hash.
+    if (jointsCount == _jointsCount) {
+        return;
+    }
+
+    if (!_jointsCountDefine.empty()) {
+        shaderData.removeDefine(_jointsCountDefine);
+        _jointsCountDefine.clear();
+    }
+    if (jointsCount > 0) {
+        _jointsCountDefine = JOINTS_COUNT + std::to_string(jointsCount);
+        shaderData.addDefine(_jointsCountDefine);
+        if (_jointsCount == 0) {
+            shaderData.addDefine(HAS_SKIN);
+        }
     } else {
         shaderData.removeDefine(HAS_SKIN);
     }
+    _jointsCount = jointsCount;
 }
 
 void SkinnedMeshRenderer::_updateBounds(BoundingBox3F& worldBounds) {
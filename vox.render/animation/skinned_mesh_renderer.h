@@ -8,6 +8,7 @@
 
 #include "vox.render/animation/skin.h"
 #include "vox.render/mesh/mesh_renderer.h"
+#include "vox.simd_math/soa_float4x4.h"
 
 namespace vox {
 class Animator;
@@ -23,6 +24,13 @@ public:
 
     void setSkinnedMesh(const std::shared_ptr<Skin> &skin);
 
+    /**
+     * Builds the skinning matrices from the output of the animator. It only writes buffers owned by the renderer,
+     * so renderers can be prepared concurrently before their update, which uploads the matrices. Matrices not built
+     * since the last update are built by the update itself.
+     */
+    void buildSkinningMatrices();
+
     void update(float deltaTime) override;
 
 private:
@@ -30,12 +38,32 @@ private:
 
     void _createMesh();
 
+    /**
+     * Updates the skinning defines, only when the number of joints changes.
+     * @param jointsCount Number of skinning matrices, 0 if the mesh isn't skinned
+     */
+    void _updateSkinDefines(size_t jointsCount);
+
+    /**
+     * Distance from the bounds center to the nearest camera rendering the scene, used to select the animator level
+     * of detail.
+     */
+    float _cameraDistance();
+
 private:
     std::shared_ptr<Skin> _skin{nullptr};
     // Buffer of skinning matrices, result of the joint multiplication of the
-    // inverse bind pose with the model space matrix.
-    std::vector<vox::simd_math::Float4x4> _skinning_matrices;
+    // inverse bind pose with the model space matrix. Each one is stored as its
+    // 3 first rows, the layout of the mat3x4 joint uniforms.
+    std::vector<float> _skinning_matrices;
+    bool _skinningMatricesBuilt{false};
+    bool _skinningMatricesValid{false};
+    // Inverse bind poses of the skin, packed for the skinning kernel.
+    std::vector<vox::simd_math::SoaFloat4x4> _soa_inverse_bind_poses;
     static const std::string _skinningMatrixProperty;
+    // Joint count and define currently set on the shader data.
+    size_t _jointsCount{0};
+    std::string _jointsCountDefine;
 
     Animator *_animator{nullptr};
 };
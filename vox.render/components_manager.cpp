@@ -7,7 +7,9 @@
 #include "vox.render/components_manager.h"
 
 #include "vox.base/logging.h"
+#include "vox.base/parallel.h"
 #include "vox.render/animation/animator.h"
+#include "vox.render/animation/skinned_mesh_renderer.h"
 #include "vox.render/camera.h"
 #include "vox.render/entity.h"
 #include "vox.render/renderer.h"
@@ -187,10 +189,53 @@ void ComponentsManager::removeOnUpdateAnimators(Animator *animator) {
 }
 
 void ComponentsManager::callAnimatorUpdate(float deltaTime) {
+    callAnimatorEvaluate(deltaTime);
+    callAnimatorApply();
+}
+
+void ComponentsManager::callAnimatorEvaluate(float deltaTime) {
+    // Sampling, blending and local-to-model only write buffers owned by each animator, so batches of animators
+    // are evaluated concurrently.
     const auto &elements = _onUpdateAnimators;
-    for (size_t i = 0; i < _onUpdateAnimators.size(); i++) {
-        elements[i]->update(deltaTime);
-    }
+    parallelRangeFor(kZeroSize, elements.size(), [&elements, deltaTime](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            elements[i]->evaluate(deltaTime);
+        }
+    });
+}
+
+void ComponentsManager::callAnimatorApply() {
+    // IK and bound entities write transforms which may share ancestors between animators, and lazily update the
+    // cached world matrices of their parents, so they run serially.
+    for (auto &animator : _onUpdateAnimators) {
+        animator->apply();
+    }
+}
+
+TaskGraph::TaskId ComponentsManager::addAnimatorUpdateTask(TaskGraph &graph,
+                                                           float deltaTime,
+                                                           TaskGraph::TaskId dependency) {
+    // The list is read when the tasks run, since scripts of the previous tasks may add or remove animators.
+    auto evaluate = graph.addTask([this, deltaTime]() { callAnimatorEvaluate(deltaTime); }, {dependency});
+    return graph.addTask([this]() { callAnimatorApply(); }, {evaluate}, TaskAffinity::kMainThread);
+}
+
+TaskGraph::TaskId ComponentsManager::addSkinningTask(TaskGraph &graph, TaskGraph::TaskId dependency) {
+    return graph.addTask(
+            [this]() {
+                _skinnedMeshRenderers.clear();
+                for (auto &renderer : _renderers) {
+                    if (auto skinnedMeshRenderer = dynamic_cast<SkinnedMeshRenderer *>(renderer)) {
+                        _skinnedMeshRenderers.push_back(skinnedMeshRenderer);
+                    }
+                }
+                parallelRangeFor(kZeroSize, _skinnedMeshRenderers.size(), [this](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        _skinnedMeshRenderers[i]->buildSkinningMatrices();
+                    }
+                });
+            },
+            {dependency});
 }
 
 }  // namespace vox
@@ -9,6 +9,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "vox.base/task_graph.h"
 #include "vox.math/bounding_frustum.h"
 #include "vox.math/matrix4x4.h"
 #include "vox.render/platform/input_events.h"
@@ -67,6 +68,36 @@ public:
 
     void callAnimatorUpdate(float deltaTime);
 
+    /**
+     * Evaluates all the animators concurrently.
+     */
+    void callAnimatorEvaluate(float deltaTime);
+
+    /**
+     * Applies IK and entity bindings of all the animators, serially.
+     */
+    void callAnimatorApply();
+
+    /**
+     * Adds the tasks updating the animators to the graph: a task evaluating them concurrently, followed by a
+     * main thread task applying them.
+     * @param graph The frame task graph
+     * @param deltaTime The frame delta time
+     * @param dependency Task the animator update depends on
+     * @return The task applying the animators
+     */
+    TaskGraph::TaskId addAnimatorUpdateTask(TaskGraph &graph, float deltaTime, TaskGraph::TaskId dependency);
+
+    /**
+     * Adds the task building concurrently the skinning matrices of the skinned mesh renderers, which only reads the
+     * animators. It can run next to main thread tasks that don't touch renderers and animators, the renderer update
+     * uploading the matrices must depend on it.
+     * @param graph The frame task graph
+     * @param dependency Task the skinning depends on
+     * @return The task building the skinning matrices
+     */
+    TaskGraph::TaskId addSkinningTask(TaskGraph &graph, TaskGraph::TaskId dependency);
+
 public:
     void callCameraOnBeginRender(Camera *camera);
 
@@ -91,6 +122,7 @@ private:
 
     // Animator
     std::vector<Animator *> _onUpdateAnimators;
+    std::vector<SkinnedMeshRenderer *> _skinnedMeshRenderers;
 };
 
 template <>
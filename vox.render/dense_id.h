@@ -0,0 +1,65 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vox {
+/**
+ * @brief Small integer id of an object, unique among the live objects of the same tag.
+ *
+ * Ids are handed out by a registry per tag, which reuses the ids of destroyed objects, so they stay as small as the
+ * number of live objects and can be packed into a few bits of a sort key. Copies share the id of their original.
+ */
+template <typename Tag>
+class DenseId {
+public:
+    DenseId() : _value(acquire()) {}
+
+    [[nodiscard]] uint32_t value() const { return *_value; }
+
+private:
+    struct Registry {
+        std::mutex mutex;
+        std::vector<uint32_t> freeIds;
+        uint32_t numIds = 0;
+    };
+
+    static Registry &registry() {
+        static Registry registry;
+        return registry;
+    }
+
+    static std::shared_ptr<const uint32_t> acquire() {
+        Registry &ids = registry();
+        uint32_t id;
+        {
+            std::lock_guard<std::mutex> lock(ids.mutex);
+            if (ids.freeIds.empty()) {
+                id = ids.numIds++;
+            } else {
+                id = ids.freeIds.back();
+                ids.freeIds.pop_back();
+            }
+        }
+        return {new uint32_t(id), [](const uint32_t *value) {
+                    Registry &ids = registry();
+                    {
+                        std::lock_guard<std::mutex> lock(ids.mutex);
+                        ids.freeIds.push_back(*value);
+                    }
+                    delete value;
+                }};
+    }
+
+    std::shared_ptr<const uint32_t> _value;
+};
+
+}  // namespace vox
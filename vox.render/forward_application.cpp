@@ -6,6 +6,7 @@
 
 #include "vox.render/forward_application.h"
 
+#include "vox.base/profiler.h"
 #include "vox.render/camera.h"
 #include "vox.render/platform/platform.h"
 #include "vox.render/rendering/subpasses/geometry_subpass.h"
@@ -92,19 +93,31 @@ bool ForwardApplication::prepare(Platform& platform) {
 }
 
 void ForwardApplication::update(float deltaTime) {
+    VOX_PROFILE_ZONE("ForwardApplication::update");
     GraphicsApplication::update(deltaTime);
     {
-        _componentsManager->callScriptOnStart();
-
-        _physicsManager->update(deltaTime);
-        _physxManager->update(deltaTime);
-
-        _componentsManager->callScriptOnUpdate(deltaTime);
-        _componentsManager->callAnimatorUpdate(deltaTime);
-        _componentsManager->callScriptOnLateUpdate(deltaTime);
-
-        _componentsManager->callRendererOnUpdate(deltaTime);
-        _sceneManager->currentScene()->updateShaderData();
+        VOX_PROFILE_ZONE("Update graph");
+        // Scripts, collider syncs and renderer uploads stay on the main thread. Jolt and PhysX step side by side,
+        // and the scripts only update once both are done. Jolt queues the contacts and reports them from its last
+        // main thread task. Animators are evaluated after the scripts, which may drive them, and the skinning
+        // matrices are built on workers while the cameras update.
+        constexpr auto kMainThread = TaskAffinity::kMainThread;
+        _updateGraph.clear();
+        auto start = _updateGraph.addTask([&]() { _componentsManager->callScriptOnStart(); }, kMainThread);
+        auto physics = _physicsManager->addUpdateTasks(_updateGraph, deltaTime, start);
+        auto physx = _physxManager->addUpdateTasks(_updateGraph, deltaTime, start);
+        auto simulation = _updateGraph.addFence({physics, physx});
+        auto scriptUpdate = _updateGraph.addTask([&]() { _componentsManager->callScriptOnUpdate(deltaTime); },
+                                                 {simulation}, kMainThread);
+        auto animators = _componentsManager->addAnimatorUpdateTask(_updateGraph, deltaTime, scriptUpdate);
+        auto lateUpdate = _updateGraph.addTask([&]() { _componentsManager->callScriptOnLateUpdate(deltaTime); },
+                                               {animators}, kMainThread);
+        auto skinning = _componentsManager->addSkinningTask(_updateGraph, lateUpdate);
+        _updateGraph.addTask([&]() { _sceneManager->currentScene()->updateShaderData(); }, {lateUpdate},
+                             kMainThread);
+        _updateGraph.addTask([&]() { _componentsManager->callRendererOnUpdate(deltaTime); }, {skinning},
+                             kMainThread);
+        _updateGraph.run();
     }
 
     wgpu::CommandEncoder commandEncoder = _device.CreateCommandEncoder();
@@ -77,6 +77,11 @@ protected:
     std::unique_ptr<PhysicsManager> _physicsManager{nullptr};
     std::unique_ptr<PhysxManager> _physxManager{nullptr};
 
+    /**
+     * @brief Per-frame update work, rebuilt every frame
+     */
+    TaskGraph _updateGraph;
+
 protected:
     wgpu::TextureView _depthStencilTexture;
     wgpu::TextureFormat _depthStencilTextureFormat = wgpu::TextureFormat::Depth24PlusStencil8;
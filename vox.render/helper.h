@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -41,6 +42,27 @@ inline void hash_combine(std::size_t &seed, T const &v) {
     seed ^= std::hash<T>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+/// 64-bit FNV-1a hash of a string. Unlike std::hash, the value is the same on
+/// every platform and every run, so it can identify shader sources and variants.
+inline uint64_t hash_fnv1a(const std::string &str, uint64_t seed = 0xcbf29ce484222325ULL) {
+    for (const char c : str) {
+        seed ^= static_cast<uint8_t>(c);
+        seed *= 0x100000001b3ULL;
+    }
+    return seed;
+}
+
+/// Finalizer of splitmix64; spreads the bits of a hash so that sums of mixed
+/// hashes stay well distributed.
+inline uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
 template <typename TT>
 struct hash_tuple {
     size_t operator()(TT const &tt) const { return std::hash<TT>()(tt); }
@@ -10,4 +10,6 @@ namespace vox {
 Material::Material(wgpu::Device &device, std::string name)
     : device_(device), shaderData(device), name{std::move(name)} {}
 
+uint32_t Material::id() const { return id_.value(); }
+
 }  // namespace vox
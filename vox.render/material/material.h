@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "vox.render/dense_id.h"
 #include "vox.render/material/enums/render_queue_type.h"
 #include "vox.render/shader/shader_data.h"
 #include "vox.render/shader/shader_source.h"
@@ -38,8 +39,16 @@ public:
      */
     explicit Material(wgpu::Device &device, std::string name = "");
 
+    /**
+     * Dense id of the material, used to sort draws.
+     */
+    [[nodiscard]] uint32_t id() const;
+
 protected:
     wgpu::Device &device_;
+
+private:
+    DenseId<Material> id_;
 };
 using MaterialPtr = std::shared_ptr<Material>;
 
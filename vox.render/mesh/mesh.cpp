@@ -7,6 +7,8 @@
 #include "vox.render/mesh/mesh.h"
 
 namespace vox {
+uint32_t Mesh::id() const { return _id.value(); }
+
 uint32_t Mesh::instanceCount() const { return _instanceCount; }
 
 SubMesh* Mesh::subMesh() {
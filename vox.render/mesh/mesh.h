@@ -10,6 +10,7 @@
 #include <string>
 
 #include "vox.math/bounding_box3.h"
+#include "vox.render/dense_id.h"
 #include "vox.render/mesh/index_buffer_binding.h"
 #include "vox.render/mesh/sub_mesh.h"
 #include "vox.render/update_flag_manager.h"
@@ -22,6 +23,11 @@ public:
     /** The bounding volume of the mesh. */
     BoundingBox3F bounds = BoundingBox3F();
 
+    /**
+     * Dense id of the mesh, used to sort draws.
+     */
+    [[nodiscard]] uint32_t id() const;
+
     /**
      * Instanced count, disable instanced drawing when set zero.
      */
@@ -93,6 +99,7 @@ protected:
 
     std::vector<SubMesh> _subMeshes{};
     UpdateFlagManager _updateFlagManager;
+    DenseId<Mesh> _id;
 
 private:
     void _clearVertexLayouts();
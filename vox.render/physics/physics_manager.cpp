@@ -177,63 +177,27 @@ PhysicsManager::PhysicsManager() {
     _physics_system->Init(cMaxBodies, cNumBodyMutexes, cMaxBodyPairs, cMaxContactConstraints,
                           *_broadPhaseLayerInterface, MyBroadPhaseCanCollide, MyObjectCanCollide);
 
+    // Jolt reports contacts from its jobs while it simulates, so they are queued and the scripts are called
+    // afterwards on the main thread, see callScriptOnContact.
     _on_contact_enter = [&](const JPH::Body &inBody1, const JPH::Body &inBody2,
                             const JPH::ContactManifold &inManifold) {
-        const auto kShape1 = reinterpret_cast<Collider *>(inBody1.GetUserData());
-        const auto kShape2 = reinterpret_cast<Collider *>(inBody2.GetUserData());
-
-        if (kShape1) {
-            const auto &scripts = kShape1->entity()->scripts();
-            for (const auto &script : scripts) {
-                script->onContactEnter(*kShape2, inManifold);
-            }
-        }
-
-        if (kShape2) {
-            const auto &scripts = kShape2->entity()->scripts();
-            for (const auto &script : scripts) {
-                script->onContactEnter(*kShape1, inManifold.SwapShapes());
-            }
-        }
+        std::lock_guard<std::mutex> lock(_contact_events_mutex);
+        _contact_events.push_back({ContactEvent::Type::kEnter, reinterpret_cast<Collider *>(inBody1.GetUserData()),
+                                   reinterpret_cast<Collider *>(inBody2.GetUserData()), inManifold, {}});
     };
 
     _on_contact_stay = [&](const JPH::Body &inBody1, const JPH::Body &inBody2, const JPH::ContactManifold &inManifold) {
-        const auto kShape1 = reinterpret_cast<Collider *>(inBody1.GetUserData());
-        const auto kShape2 = reinterpret_cast<Collider *>(inBody2.GetUserData());
-
-        if (kShape1) {
-            const auto &scripts = kShape1->entity()->scripts();
-            for (const auto &script : scripts) {
-                script->onContactStay(*kShape2, inManifold);
-            }
-        }
-
-        if (kShape2) {
-            const auto &scripts = kShape2->entity()->scripts();
-            for (const auto &script : scripts) {
-                script->onContactStay(*kShape1, inManifold.SwapShapes());
-            }
-        }
+        std::lock_guard<std::mutex> lock(_contact_events_mutex);
+        _contact_events.push_back({ContactEvent::Type::kStay, reinterpret_cast<Collider *>(inBody1.GetUserData()),
+                                   reinterpret_cast<Collider *>(inBody2.GetUserData()), inManifold, {}});
     };
 
     _on_contact_exit = [&](const JPH::SubShapeIDPair &inSubShapePair) {
         const JPH::BodyInterface &interface = _physics_system->GetBodyInterfaceNoLock();
         const auto kShape1 = reinterpret_cast<Collider *>(interface.GetUserData(inSubShapePair.GetBody1ID()));
         const auto kShape2 = reinterpret_cast<Collider *>(interface.GetUserData(inSubShapePair.GetBody2ID()));
-
-        if (kShape1) {
-            const auto &scripts = kShape1->entity()->scripts();
-            for (const auto &script : scripts) {
-                script->onContactExit(*kShape2, inSubShapePair.GetSubShapeID2());
-            }
-        }
-
-        if (kShape2) {
-            const auto &scripts = kShape2->entity()->scripts();
-            for (const auto &script : scripts) {
-                script->onContactExit(*kShape1, inSubShapePair.GetSubShapeID1());
-            }
-        }
+        std::lock_guard<std::mutex> lock(_contact_events_mutex);
+        _contact_events.push_back({ContactEvent::Type::kExit, kShape1, kShape2, {}, inSubShapePair});
     };
 
     _contactListener = std::make_unique<ContactListenerWrapper>(_on_contact_enter, _on_contact_stay, _on_contact_exit);
@@ -294,20 +258,100 @@ void PhysicsManager::removeCollider(Collider *collider) {
 }
 
 void PhysicsManager::update(float delta_time) {
+    auto step = consumeFixedSteps(delta_time);
+    for (uint32_t i = 0; i < step; i++) {
+        callScriptOnPhysicsUpdate();
+        callColliderOnUpdate();
+        simulate();
+        callColliderOnLateUpdate();
+        callScriptOnContact();
+    }
+}
+
+TaskGraph::TaskId PhysicsManager::addUpdateTasks(TaskGraph &graph, float delta_time, TaskGraph::TaskId dependency) {
+    constexpr auto kMainThread = TaskAffinity::kMainThread;
+    auto step = consumeFixedSteps(delta_time);
+    auto last = dependency;
+    for (uint32_t i = 0; i < step; i++) {
+        auto pre = graph.addTask(
+                [this]() {
+                    callScriptOnPhysicsUpdate();
+                    callColliderOnUpdate();
+                },
+                {last}, kMainThread);
+        auto simulation = graph.addTask([this]() { simulate(); }, {pre});
+        last = graph.addTask(
+                [this]() {
+                    callColliderOnLateUpdate();
+                    callScriptOnContact();
+                },
+                {simulation}, kMainThread);
+    }
+    return last;
+}
+
+uint32_t PhysicsManager::consumeFixedSteps(float delta_time) {
     auto simulate_time = delta_time + rest_time_;
     auto step = static_cast<uint32_t>(std::floor(std::min(max_sum_time_step_, simulate_time) / fixed_time_step_));
     rest_time_ = simulate_time - static_cast<float>(step) * fixed_time_step_;
-    for (uint32_t i = 0; i < step; i++) {
-        for (auto &script : _on_physics_update_scripts) {
-            script->onPhysicsUpdate();
+    return step;
+}
+
+void PhysicsManager::callScriptOnPhysicsUpdate() {
+    for (auto &script : _on_physics_update_scripts) {
+        script->onPhysicsUpdate();
+    }
+}
+
+void PhysicsManager::callScriptOnContact() {
+    std::vector<ContactEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(_contact_events_mutex);
+        std::swap(events, _contact_events);
+    }
+
+    for (const auto &event : events) {
+        if (event.collider1) {
+            const auto &scripts = event.collider1->entity()->scripts();
+            for (const auto &script : scripts) {
+                switch (event.type) {
+                    case ContactEvent::Type::kEnter:
+                        script->onContactEnter(*event.collider2, event.manifold);
+                        break;
+                    case ContactEvent::Type::kStay:
+                        script->onContactStay(*event.collider2, event.manifold);
+                        break;
+                    case ContactEvent::Type::kExit:
+                        script->onContactExit(*event.collider2, event.sub_shape_pair.GetSubShapeID2());
+                        break;
+                }
+            }
+        }
+
+        if (event.collider2) {
+            const auto &scripts = event.collider2->entity()->scripts();
+            for (const auto &script : scripts) {
+                switch (event.type) {
+                    case ContactEvent::Type::kEnter:
+                        script->onContactEnter(*event.collider1, event.manifold.SwapShapes());
+                        break;
+                    case ContactEvent::Type::kStay:
+                        script->onContactStay(*event.collider1, event.manifold.SwapShapes());
+                        break;
+                    case ContactEvent::Type::kExit:
+                        script->onContactExit(*event.collider1, event.sub_shape_pair.GetSubShapeID1());
+                        break;
+                }
+            }
         }
-        callColliderOnUpdate();
-        _physics_system->Update(fixed_time_step_, collision_steps, integration_sub_steps, _temp_allocator.get(),
-                                _job_system.get());
-        callColliderOnLateUpdate();
     }
 }
 
+void PhysicsManager::simulate() {
+    _physics_system->Update(fixed_time_step_, collision_steps, integration_sub_steps, _temp_allocator.get(),
+                            _job_system.get());
+}
+
 void PhysicsManager::callColliderOnUpdate() {
     for (auto &collider : _colliders) {
         collider->onUpdate();
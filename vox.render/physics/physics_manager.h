@@ -13,6 +13,10 @@
 #include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 
+#include <mutex>
+#include <vector>
+
+#include "vox.base/task_graph.h"
 #include "vox.math/matrix4x4.h"
 #include "vox.render/singleton.h"
 
@@ -248,6 +252,17 @@ public:
      */
     void update(float delta_time);
 
+    /**
+     * Adds the fixed steps of this frame to the graph. Scripts, collider syncs and contact callbacks run on the main
+     * thread, the simulation itself on a worker, so it overlaps with the tasks that don't depend on the returned one.
+     * The simulation only touches Jolt bodies, contacts are queued and reported to scripts once it is done.
+     * @param graph The frame task graph
+     * @param delta_time The frame delta time
+     * @param dependency Task the first step depends on
+     * @return The task finishing the last step
+     */
+    TaskGraph::TaskId addUpdateTasks(TaskGraph &graph, float delta_time, TaskGraph::TaskId dependency);
+
     void callColliderOnUpdate();
 
     void callColliderOnLateUpdate();
@@ -257,6 +272,27 @@ public:
     void removeOnPhysicsUpdateScript(Script *script);
 
 private:
+    uint32_t consumeFixedSteps(float delta_time);
+
+    void callScriptOnPhysicsUpdate();
+
+    /**
+     * Reports the contacts queued by the last simulation to the scripts.
+     */
+    void callScriptOnContact();
+
+    void simulate();
+
+    struct ContactEvent {
+        enum class Type { kEnter, kStay, kExit };
+
+        Type type;
+        Collider *collider1;
+        Collider *collider2;
+        JPH::ContactManifold manifold;
+        JPH::SubShapeIDPair sub_shape_pair;
+    };
+
     float rest_time_ = 0;
     std::vector<Script *> _on_physics_update_scripts{};
     std::vector<Collider *> _colliders{};
@@ -267,6 +303,8 @@ private:
             _on_contact_stay{};
     std::function<void(const JPH::SubShapeIDPair &inSubShapePair)> _on_contact_exit{};
     std::unique_ptr<JPH::ContactListener> _contactListener{nullptr};
+    std::mutex _contact_events_mutex;
+    std::vector<ContactEvent> _contact_events;
     std::unique_ptr<JPH::BroadPhaseLayerInterface> _broadPhaseLayerInterface{nullptr};
 
     std::unique_ptr<JPH::PhysicsSystem> _physics_system{nullptr};
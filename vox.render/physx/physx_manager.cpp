@@ -39,20 +39,50 @@ PhysxManager::PhysxManager() {
 PhysxManager::~PhysxManager() { physics->release(); }
 
 void PhysxManager::update(float delta_time) {
-    float simulate_time = delta_time + rest_time_;
-    auto step = static_cast<uint32_t>(std::floor(std::min(max_sum_time_step_, simulate_time) / fixed_time_step_));
-    rest_time_ = simulate_time - static_cast<float>(step) * fixed_time_step_;
+    auto step = consumeFixedSteps(delta_time);
     for (uint32_t i = 0; i < step; i++) {
-        for (auto &script : on_physics_update_scripts_) {
-            script->onPhysicsUpdate();
-        }
+        callScriptOnPhysicsUpdate();
         callColliderOnUpdate();
-        physics_manager->simulate(fixed_time_step_);
-        physics_manager->fetchResults(true);
+        simulate();
         callColliderOnLateUpdate();
     }
 }
 
+TaskGraph::TaskId PhysxManager::addUpdateTasks(TaskGraph &graph, float delta_time, TaskGraph::TaskId dependency) {
+    constexpr auto kMainThread = TaskAffinity::kMainThread;
+    auto step = consumeFixedSteps(delta_time);
+    auto last = dependency;
+    for (uint32_t i = 0; i < step; i++) {
+        auto pre = graph.addTask(
+                [this]() {
+                    callScriptOnPhysicsUpdate();
+                    callColliderOnUpdate();
+                },
+                {last}, kMainThread);
+        auto simulation = graph.addTask([this]() { simulate(); }, {pre});
+        last = graph.addTask([this]() { callColliderOnLateUpdate(); }, {simulation}, kMainThread);
+    }
+    return last;
+}
+
+uint32_t PhysxManager::consumeFixedSteps(float delta_time) {
+    float simulate_time = delta_time + rest_time_;
+    auto step = static_cast<uint32_t>(std::floor(std::min(max_sum_time_step_, simulate_time) / fixed_time_step_));
+    rest_time_ = simulate_time - static_cast<float>(step) * fixed_time_step_;
+    return step;
+}
+
+void PhysxManager::callScriptOnPhysicsUpdate() {
+    for (auto &script : on_physics_update_scripts_) {
+        script->onPhysicsUpdate();
+    }
+}
+
+void PhysxManager::simulate() {
+    physics_manager->simulate(fixed_time_step_);
+    physics_manager->fetchResults(true);
+}
+
 //MARK: - Sync Transform
 void PhysxManager::callColliderOnUpdate() {
     for (auto &collider : colliders_) {
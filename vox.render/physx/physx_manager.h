@@ -10,6 +10,7 @@
 
 #include <vector>
 
+#include "vox.base/task_graph.h"
 #include "vox.render/singleton.h"
 #include "vox.render/script.h"
 
@@ -42,6 +43,18 @@ public:
      */
     void update(float delta_time);
 
+    /**
+     * Adds the fixed steps of this frame to the graph. Scripts and collider syncs run on the main thread, the
+     * simulation itself on a worker. No simulation event callback is installed, so the simulation only touches the
+     * PhysX scene and can run next to the Jolt steps, as long as the physics update scripts of each engine leave the
+     * bodies of the other one alone.
+     * @param graph The frame task graph
+     * @param delta_time The frame delta time
+     * @param dependency Task the first step depends on
+     * @return The task finishing the last step
+     */
+    TaskGraph::TaskId addUpdateTasks(TaskGraph &graph, float delta_time, TaskGraph::TaskId dependency);
+
     void callColliderOnUpdate();
 
     void callColliderOnLateUpdate();
@@ -63,6 +76,12 @@ public:
     void removeOnPhysicsUpdateScript(Script *script);
 
 private:
+    uint32_t consumeFixedSteps(float delta_time);
+
+    void callScriptOnPhysicsUpdate();
+
+    void simulate();
+
     physx::PxDefaultAllocator g_allocator_;
     physx::PxDefaultErrorCallback g_error_callback_;
     std::vector<PhysxCollider *> colliders_;
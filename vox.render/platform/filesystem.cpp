@@ -17,7 +17,8 @@ namespace path {
 const std::unordered_map<Type, std::string> kRelativePaths = {
         {Type::ASSETS, "assets/"},    {Type::SHADERS, "shaders/"},
         {Type::STORAGE, "output/"},   {Type::SCREENSHOTS, "output/images/"},
-        {Type::LOGS, "output/logs/"}, {Type::GRAPHS, "output/graphs/"}};
+        {Type::LOGS, "output/logs/"}, {Type::GRAPHS, "output/graphs/"},
+        {Type::SHADER_CACHE, "output/shader_cache/"}};
 
 std::string Get(const Type type, const std::string &file) {
     assert(kRelativePaths.size() == Type::TOTAL_RELATIVE_PATH_TYPES &&
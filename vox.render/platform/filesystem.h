@@ -26,6 +26,7 @@ enum Type {
     SCREENSHOTS,
     LOGS,
     GRAPHS,
+    SHADER_CACHE,
     /* NewFolder */
     TOTAL_RELATIVE_PATH_TYPES,
 
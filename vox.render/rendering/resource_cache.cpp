@@ -6,8 +6,11 @@
 
 #include "vox.render/rendering/resource_cache.h"
 
+#include <algorithm>
+#include <thread>
 #include <utility>
 
+#include "vox.base/logging.h"
 #include "vox.render/std_helpers.h"
 
 namespace std {
@@ -345,6 +348,12 @@ struct hash<wgpu::SamplerDescriptor> {
 
 // MARK: - ResourceCache
 namespace vox {
+std::size_t ShaderModuleKeyHash::operator()(const ShaderModuleKey &key) const {
+    std::size_t hash = utility::hash_mix(key.sourceId ^ utility::hash_mix(key.variantId));
+    hash_combine(hash, static_cast<uint32_t>(key.stage));
+    return hash;
+}
+
 ResourceCache *ResourceCache::GetSingletonPtr() { return ms_singleton; }
 
 ResourceCache &ResourceCache::GetSingleton() {
@@ -352,7 +361,11 @@ ResourceCache &ResourceCache::GetSingleton() {
     return (*ms_singleton);
 }
 
-ResourceCache::ResourceCache(wgpu::Device &device) : _device{device} {}
+ResourceCache::ResourceCache(wgpu::Device &device) : _device{device} {
+    // Leave most of the cores to the frame; a compilation only delays the switch from the fallback variant.
+    unsigned int numWorkers = std::max(1u, std::thread::hardware_concurrency() / 4);
+    _compilePool = std::make_unique<ThreadPool>(numWorkers);
+}
 
 wgpu::BindGroupLayout &ResourceCache::requestBindGroupLayout(const wgpu::BindGroupLayoutDescriptor &descriptor) {
     std::hash<wgpu::BindGroupLayoutDescriptor> hasher;
@@ -435,17 +448,125 @@ wgpu::Sampler &ResourceCache::requestSampler(const wgpu::SamplerDescriptor &desc
 ShaderModule &ResourceCache::requestShaderModule(wgpu::ShaderStage stage,
                                                  const ShaderSource &glsl_source,
                                                  const ShaderVariant &shader_variant) {
-    std::size_t hash{0U};
-    hash_combine(hash, std::hash<std::string>{}(glsl_source.GetSource()));
-    hash_combine(hash, std::hash<std::string>{}(shader_variant.GetPreamble()));
-
-    auto iter = _state.shaderModules.find(hash);
-    if (iter == _state.shaderModules.end()) {
-        _state.shaderModules[hash] =
-                std::make_unique<ShaderModule>(_device, stage, glsl_source, "main", shader_variant);
-        return *_state.shaderModules[hash];
-    } else {
-        return *iter->second;
+    ShaderModuleKey key{glsl_source.GetId(), shader_variant.GetId(), stage};
+
+    if (auto module = _findShaderModule(key, glsl_source, shader_variant)) {
+        return *module;
+    }
+
+    // Don't compile twice a module that is compiling in the background. If no worker picked it up yet, it is compiled
+    // here instead, otherwise only this compilation is waited for, not the rest of the queue.
+    if (auto pending = _findPendingShaderModule(key, glsl_source, shader_variant)) {
+        _runShaderModuleCompilation(*pending);
+        {
+            std::unique_lock<std::mutex> lock(pending->mutex);
+            pending->finished.wait(lock, [&] { return pending->isFinished.load(std::memory_order_acquire); });
+        }
+        _collectShaderModules();
+        return *_findShaderModule(key, glsl_source, shader_variant);
+    }
+
+    auto iter = _state.shaderModules.emplace(
+            key, ShaderModuleEntry{glsl_source, shader_variant,
+                                   std::make_unique<ShaderModule>(_device, stage, glsl_source, "main", shader_variant)});
+    return *iter->second.module;
+}
+
+bool ResourceCache::prepareShaderModule(wgpu::ShaderStage stage,
+                                        const ShaderSource &glsl_source,
+                                        const ShaderVariant &shader_variant) {
+    if (_numFinishedShaderModules.load(std::memory_order_acquire) > 0) {
+        _collectShaderModules();
+    }
+
+    ShaderModuleKey key{glsl_source.GetId(), shader_variant.GetId(), stage};
+    if (_findShaderModule(key, glsl_source, shader_variant)) {
+        return true;
+    }
+    if (_findPendingShaderModule(key, glsl_source, shader_variant)) {
+        return false;
+    }
+
+    // The compilation owns copies of its inputs, which may change or be destroyed before it finishes.
+    auto compilation = std::make_shared<ShaderModuleCompilation>();
+    compilation->stage = stage;
+    compilation->source = glsl_source;
+    compilation->variant = shader_variant;
+    compilation->debugName = ShaderModule::MakeDebugName(glsl_source, "main", shader_variant);
+    _pendingShaderModules.emplace(key, compilation);
+
+    _compilePool->submit([this, compilation] { _runShaderModuleCompilation(*compilation); });
+    return false;
+}
+
+void ResourceCache::_runShaderModuleCompilation(ShaderModuleCompilation &compilation) {
+    if (compilation.isStarted.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // A throwing compilation must still finish, or the module would stay pending and requests for it would hang.
+    try {
+        ShaderModule::Compile(compilation.stage, compilation.source, "main", compilation.variant, compilation.spirv,
+                              compilation.resources, compilation.infoLog);
+    } catch (const std::exception &e) {
+        compilation.infoLog += e.what();
+        LOGE("Shader compilation threw for shader \"{}\": {}", compilation.debugName, e.what())
+    } catch (...) {
+        compilation.infoLog += "Unknown exception";
+        LOGE("Shader compilation threw for shader \"{}\"", compilation.debugName)
+    }
+
+    _numFinishedShaderModules.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(compilation.mutex);
+        compilation.isFinished.store(true, std::memory_order_release);
+    }
+    compilation.finished.notify_all();
+}
+
+ShaderModule *ResourceCache::_findShaderModule(const ShaderModuleKey &key,
+                                               const ShaderSource &glsl_source,
+                                               const ShaderVariant &shader_variant) {
+    auto range = _state.shaderModules.equal_range(key);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        const ShaderModuleEntry &entry = iter->second;
+        if (entry.source.HasSameSource(glsl_source) && entry.variant.HasSameDefines(shader_variant)) {
+            return entry.module.get();
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<ResourceCache::ShaderModuleCompilation> ResourceCache::_findPendingShaderModule(
+        const ShaderModuleKey &key, const ShaderSource &glsl_source, const ShaderVariant &shader_variant) {
+    auto range = _pendingShaderModules.equal_range(key);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        const ShaderModuleCompilation &compilation = *iter->second;
+        if (compilation.source.HasSameSource(glsl_source) && compilation.variant.HasSameDefines(shader_variant)) {
+            return iter->second;
+        }
+    }
+    return nullptr;
+}
+
+void ResourceCache::_collectShaderModules() {
+    for (auto iter = _pendingShaderModules.begin(); iter != _pendingShaderModules.end();) {
+        auto &compilation = *iter->second;
+        if (!compilation.isFinished.load(std::memory_order_acquire)) {
+            ++iter;
+            continue;
+        }
+
+        // The WebGPU module is created on the calling thread, only the compilation runs on the workers.
+        _state.shaderModules.emplace(
+                iter->first,
+                ShaderModuleEntry{compilation.source, compilation.variant,
+                                  std::make_unique<ShaderModule>(_device, compilation.stage, "main",
+                                                                 compilation.debugName, std::move(compilation.spirv),
+                                                                 std::move(compilation.resources),
+                                                                 std::move(compilation.infoLog))});
+        _numFinishedShaderModules.fetch_sub(1, std::memory_order_relaxed);
+        iter = _pendingShaderModules.erase(iter);
     }
 }
 
@@ -8,11 +8,47 @@
 
 #include <webgpu/webgpu_cpp.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <unordered_map>
+
+#include "vox.base/thread_pool.h"
 #include "vox.render/singleton.h"
 #include "vox.render/shader/shader_module.h"
 
 namespace vox {
+/**
+ * @brief Key of a cached shader module, built from the precomputed ids of its source and variant
+ */
+struct ShaderModuleKey {
+    uint64_t sourceId{};
+
+    uint64_t variantId{};
+
+    wgpu::ShaderStage stage{};
+
+    bool operator==(const ShaderModuleKey &other) const {
+        return sourceId == other.sourceId && variantId == other.variantId && stage == other.stage;
+    }
+};
+
+struct ShaderModuleKeyHash {
+    std::size_t operator()(const ShaderModuleKey &key) const;
+};
+
+/**
+ * @brief Cached shader module with the source and defines it was compiled from. Different sources or variants may
+ *        have the same ids, so they are compared on a hit.
+ */
+struct ShaderModuleEntry {
+    ShaderSource source;
+
+    ShaderVariant variant;
+
+    std::unique_ptr<ShaderModule> module;
+};
+
 /**
  * @brief Struct to hold the internal state of the Resource Cache
  *
@@ -30,7 +66,7 @@ struct ResourceCacheState {
 
     std::unordered_map<std::size_t, wgpu::Sampler> samplers;
 
-    std::unordered_map<std::size_t, std::unique_ptr<ShaderModule>> shaderModules;
+    std::unordered_multimap<ShaderModuleKey, ShaderModuleEntry, ShaderModuleKeyHash> shaderModules;
 };
 
 /**
@@ -74,14 +110,71 @@ public:
 
     wgpu::Sampler &requestSampler(const wgpu::SamplerDescriptor &descriptor);
 
+    /**
+     * @brief Returns the module compiled from the source with the variant for the stage, compiling it on a miss.
+     *        Modules are looked up by the ids precomputed by ShaderSource and ShaderVariant, then the source text and
+     *        defines of the candidates are compared, so that sources or variants with colliding ids are never mixed
+     *        up.
+     */
     ShaderModule &requestShaderModule(wgpu::ShaderStage stage,
                                       const ShaderSource &glsl_source,
                                       const ShaderVariant &shader_variant);
 
+    /**
+     * @brief Returns true if the module of the source with the variant is compiled. Otherwise it is compiled on a
+     *        worker thread, and the caller is expected to draw with a ready fallback variant, or skip the draw, until
+     *        this returns true, so a new define combination doesn't stall the frame.
+     */
+    bool prepareShaderModule(wgpu::ShaderStage stage,
+                             const ShaderSource &glsl_source,
+                             const ShaderVariant &shader_variant);
+
 private:
+    /// Shader module compiled on a worker thread
+    struct ShaderModuleCompilation {
+        wgpu::ShaderStage stage{};
+        ShaderSource source;
+        ShaderVariant variant;
+        std::string debugName;
+
+        std::vector<uint32_t> spirv;
+        std::unordered_map<std::string, ShaderResource> resources;
+        std::string infoLog;
+
+        /// Set by the first thread that runs the compilation, so that it runs only once
+        std::atomic<bool> isStarted{false};
+        std::atomic<bool> isFinished{false};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    /// Runs the compilation unless another thread started it already, and flags it as finished even if it throws
+    void _runShaderModuleCompilation(ShaderModuleCompilation &compilation);
+
+    /// Returns the cached module of the source with the variant, or null
+    ShaderModule *_findShaderModule(const ShaderModuleKey &key,
+                                    const ShaderSource &glsl_source,
+                                    const ShaderVariant &shader_variant);
+
+    /// Returns the compilation of the source with the variant, or null
+    std::shared_ptr<ShaderModuleCompilation> _findPendingShaderModule(const ShaderModuleKey &key,
+                                                                      const ShaderSource &glsl_source,
+                                                                      const ShaderVariant &shader_variant);
+
+    /// Moves the finished compilations into the cache
+    void _collectShaderModules();
+
     wgpu::Device &_device;
 
     ResourceCacheState _state;
+
+    std::unordered_multimap<ShaderModuleKey, std::shared_ptr<ShaderModuleCompilation>, ShaderModuleKeyHash>
+            _pendingShaderModules;
+
+    std::atomic<size_t> _numFinishedShaderModules{0};
+
+    // Declared last so that the workers are joined before the rest of the cache is destroyed.
+    std::unique_ptr<ThreadPool> _compilePool;
 };
 template <>
 inline ResourceCache *Singleton<ResourceCache>::ms_singleton{nullptr};
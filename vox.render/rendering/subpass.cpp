@@ -6,21 +6,78 @@
 
 #include "vox.render/rendering/subpass.h"
 
+#include "vox.base/parallel.h"
 #include "vox.render/material/material.h"
 #include "vox.render/renderer.h"
 
 namespace vox {
+namespace {
+constexpr uint32_t kQueueBits = 12;
+constexpr uint32_t kStateBits = 12;
+constexpr uint32_t kDepthBits = 16;
+static_assert(kQueueBits + 3 * kStateBits + kDepthBits == 64, "The draw key fields must fill 64 bits");
+
+/**
+ * @brief Dense id clamped to a field of the key. Ids past the field share its last value, which only loosens the
+ *        grouping of their draws.
+ */
+uint64_t IdBits(uint32_t id, uint32_t bits) { return std::min<uint64_t>(id, (uint64_t{1} << bits) - 1); }
+
+}  // namespace
+
 Subpass::Subpass(RenderContext* renderContext, Scene* scene, Camera* camera)
     : _renderContext(renderContext), _scene(scene), _camera(camera) {}
 
-bool Subpass::_compareFromNearToFar(const RenderElement& a, const RenderElement& b) {
-    return (a.material->renderQueueType < b.material->renderQueueType) ||
-           (a.renderer->distanceForSort() < b.renderer->distanceForSort());
-}
+void Subpass::_sortElements(std::vector<RenderElement>& queue, bool isTransparent) {
+    const size_t count = queue.size();
+    if (count < 2) {
+        return;
+    }
+
+    // Depths are quantised over the range of the queue
+    float minDistance = queue[0].renderer->distanceForSort();
+    float maxDistance = minDistance;
+    for (const auto& element : queue) {
+        minDistance = std::min(minDistance, element.renderer->distanceForSort());
+        maxDistance = std::max(maxDistance, element.renderer->distanceForSort());
+    }
+    constexpr uint64_t kMaxDepth = (uint64_t{1} << kDepthBits) - 1;
+    const float depthScale = maxDistance > minDistance ? float(kMaxDepth) / (maxDistance - minDistance) : 0.f;
+
+    _sortKeys.resize(count);
+    _sortOrder.resize(count);
+    parallelFor(kZeroSize, count, [&](size_t i) {
+        const auto& element = queue[i];
+        const auto& material = element.material;
+
+        uint64_t queueBits = std::min<uint64_t>(material->renderQueueType, (uint64_t{1} << kQueueBits) - 1);
+        // The shader field holds the vertex and the fragment shader ids, 0 standing for no fragment shader
+        constexpr uint32_t kShaderIdBits = kStateBits / 2;
+        uint64_t shaderBits = IdBits(material->vertex_source_->GetDenseId(), kShaderIdBits) << kShaderIdBits;
+        if (material->fragment_source_) {
+            shaderBits |= IdBits(material->fragment_source_->GetDenseId() + 1, kShaderIdBits);
+        }
+        uint64_t stateBits = shaderBits << (2 * kStateBits) | IdBits(material->id(), kStateBits) << kStateBits |
+                             IdBits(element.mesh->id(), kStateBits);
+        auto depthBits = static_cast<uint64_t>((element.renderer->distanceForSort() - minDistance) * depthScale);
+        depthBits = std::min(depthBits, kMaxDepth);
+
+        if (isTransparent) {
+            _sortKeys[i] = queueBits << (64 - kQueueBits) | (kMaxDepth - depthBits) << (3 * kStateBits) | stateBits;
+        } else {
+            _sortKeys[i] = queueBits << (64 - kQueueBits) | stateBits << kDepthBits | depthBits;
+        }
+        _sortOrder[i] = static_cast<uint32_t>(i);
+    });
+
+    parallelRadixSort(_sortKeys, _sortOrder);
 
-bool Subpass::_compareFromFarToNear(const RenderElement& a, const RenderElement& b) {
-    return (a.material->renderQueueType < b.material->renderQueueType) ||
-           (b.renderer->distanceForSort() < a.renderer->distanceForSort());
+    _sortedElements.clear();
+    _sortedElements.reserve(count);
+    for (uint32_t index : _sortOrder) {
+        _sortedElements.emplace_back(std::move(queue[index]));
+    }
+    queue.swap(_sortedElements);
 }
 
 }  // namespace vox
@@ -39,13 +39,26 @@ public:
     virtual void prepare() = 0;
 
 protected:
-    static bool _compareFromNearToFar(const RenderElement &a, const RenderElement &b);
-
-    static bool _compareFromFarToNear(const RenderElement &a, const RenderElement &b);
+    /**
+     * @brief Sorts a render queue by a 64-bit draw key.
+     *
+     * Opaque and alpha test elements are grouped by render queue, shaders, material and mesh, and drawn from near to
+     * far inside a group, so that consecutive draws share as much state as possible. Transparent elements are drawn
+     * from far to near first and grouped by state only when their depths are equal. States are identified by the
+     * dense ids of the shaders, materials and meshes, so the order is the same from run to run.
+     * @param queue Render elements to sort in place
+     * @param isTransparent Whether the queue is drawn from far to near
+     */
+    void _sortElements(std::vector<RenderElement> &queue, bool isTransparent);
 
     RenderContext *_renderContext{nullptr};
     Scene *_scene{nullptr};
     Camera *_camera{nullptr};
+
+private:
+    std::vector<uint64_t> _sortKeys;
+    std::vector<uint32_t> _sortOrder;
+    std::vector<RenderElement> _sortedElements;
 };
 
 }  // namespace vox
\ No newline at end of file
@@ -20,6 +20,8 @@ ColorPickerSubpass::ColorPickerSubpass(RenderContext *renderContext,
     : GeometrySubpass(renderContext, depthStencilTextureFormat, scene, camera),
       _bufferPool(renderContext->device(), 16 * 1024, wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst) {
     _material = std::make_shared<UnlitMaterial>(renderContext->device());
+    // Every element must be drawn with its pick color, or it can't be picked
+    _isShaderCompileAsync = false;
 }
 
 void ColorPickerSubpass::_drawElement(wgpu::RenderPassEncoder &passEncoder, ShaderVariant &variant) {
@@ -27,9 +29,9 @@ void ColorPickerSubpass::_drawElement(wgpu::RenderPassEncoder &passEncoder, Shad
     _primitivesMap.clear();
 
     _callRender(_camera);
-    std::sort(opaqueQueue.begin(), opaqueQueue.end(), _compareFromNearToFar);
-    std::sort(alphaTestQueue.begin(), alphaTestQueue.end(), _compareFromNearToFar);
-    std::sort(transparentQueue.begin(), transparentQueue.end(), _compareFromFarToNear);
+    _sortElements(opaqueQueue, false);
+    _sortElements(alphaTestQueue, false);
+    _sortElements(transparentQueue, true);
 
     for (auto &element : opaqueQueue) {
         auto exclusive = std::find(_exclusive_list.begin(), _exclusive_list.end(), element.renderer);
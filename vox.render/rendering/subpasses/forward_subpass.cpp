@@ -43,6 +43,7 @@ void ForwardSubpass::draw(wgpu::RenderPassEncoder &passEncoder) {
     }
 
     passEncoder.PushDebugGroup("Draw Element");
+    _resetEncoderState();
     _drawElement(passEncoder, compile_variant);
     passEncoder.PopDebugGroup();
 }
@@ -58,6 +59,30 @@ void ForwardSubpass::_drawElement(wgpu::RenderPassEncoder &passEncoder,
     auto &material = element.material;
     material->shaderData.mergeVariants(macros, macros);
 
+    // With async compilation, a new define combination is compiled in the background. Until both of its stages are
+    // ready, the element is drawn with its base variant, which leaves out the scene and camera defines that change
+    // with lights and shadows. The base variant is compiled in the background too, and the element is skipped until
+    // one of them is ready, so no shader is ever compiled on the render thread.
+    if (_isShaderCompileAsync) {
+        auto &resourceCache = ResourceCache::GetSingleton();
+        const auto isVariantReady = [&](const ShaderVariant &variant) {
+            bool isVertexReady =
+                    resourceCache.prepareShaderModule(wgpu::ShaderStage::Vertex, *material->vertex_source_, variant);
+            bool isFragmentReady = !material->fragment_source_ ||
+                                   resourceCache.prepareShaderModule(wgpu::ShaderStage::Fragment,
+                                                                     *material->fragment_source_, variant);
+            return isVertexReady && isFragmentReady;
+        };
+        if (!isVariantReady(macros)) {
+            macros.Clear();
+            renderer->shaderData.mergeVariants(macros, macros);
+            material->shaderData.mergeVariants(macros, macros);
+            if (!isVariantReady(macros)) {
+                return;
+            }
+        }
+    }
+
     auto &mesh = element.mesh;
     auto &subMesh = element.subMesh;
 
@@ -103,8 +128,14 @@ void ForwardSubpass::_drawElement(wgpu::RenderPassEncoder &passEncoder,
             _bindGroupDescriptor.layout = bindGroupLayout;
             _bindGroupDescriptor.entryCount = static_cast<uint32_t>(bindGroupEntryVec.size());
             _bindGroupDescriptor.entries = bindGroupEntryVec.data();
-            auto uniformBindGroup = ResourceCache::GetSingleton().requestBindGroup(_bindGroupDescriptor);
-            passEncoder.SetBindGroup(group, uniformBindGroup);
+            auto &uniformBindGroup = ResourceCache::GetSingleton().requestBindGroup(_bindGroupDescriptor);
+            if (group >= _currentBindGroups.size()) {
+                _currentBindGroups.resize(group + 1, nullptr);
+            }
+            if (_currentBindGroups[group] != uniformBindGroup.Get()) {
+                passEncoder.SetBindGroup(group, uniformBindGroup);
+                _currentBindGroups[group] = uniformBindGroup.Get();
+            }
             bindGroupLayouts.emplace_back(std::move(bindGroupLayout));
         }
 
@@ -119,24 +150,45 @@ void ForwardSubpass::_drawElement(wgpu::RenderPassEncoder &passEncoder,
         _forwardPipelineDescriptor.vertex.buffers = mesh->vertexBufferLayouts().data();
         _forwardPipelineDescriptor.primitive.topology = subMesh->topology();
 
-        auto renderPipeline = ResourceCache::GetSingleton().requestPipeline(_forwardPipelineDescriptor);
-        passEncoder.SetPipeline(renderPipeline);
+        auto &renderPipeline = ResourceCache::GetSingleton().requestPipeline(_forwardPipelineDescriptor);
+        if (_currentPipeline != renderPipeline.Get()) {
+            passEncoder.SetPipeline(renderPipeline);
+            _currentPipeline = renderPipeline.Get();
+        }
     }
 
     // Draw Call
-    for (uint32_t j = 0; j < mesh->vertexBufferBindings().size(); j++) {
-        auto vertexBufferBinding = mesh->vertexBufferBindings()[j];
-        if (vertexBufferBinding) {
-            passEncoder.SetVertexBuffer(j, mesh->vertexBufferBindings()[j]->handle());
+    const auto &vertexBufferBindings = mesh->vertexBufferBindings();
+    if (vertexBufferBindings.size() > _currentVertexBuffers.size()) {
+        _currentVertexBuffers.resize(vertexBufferBindings.size(), nullptr);
+    }
+    for (uint32_t j = 0; j < vertexBufferBindings.size(); j++) {
+        const auto &vertexBufferBinding = vertexBufferBindings[j];
+        if (vertexBufferBinding && _currentVertexBuffers[j] != vertexBufferBinding->handle().Get()) {
+            passEncoder.SetVertexBuffer(j, vertexBufferBinding->handle());
+            _currentVertexBuffers[j] = vertexBufferBinding->handle().Get();
         }
     }
-    auto indexBufferBinding = mesh->indexBufferBinding();
+    const auto &indexBufferBinding = mesh->indexBufferBinding();
     if (indexBufferBinding) {
-        passEncoder.SetIndexBuffer(mesh->indexBufferBinding()->buffer(), mesh->indexBufferBinding()->format());
+        if (_currentIndexBuffer != indexBufferBinding->buffer().Get() ||
+            _currentIndexFormat != indexBufferBinding->format()) {
+            passEncoder.SetIndexBuffer(indexBufferBinding->buffer(), indexBufferBinding->format());
+            _currentIndexBuffer = indexBufferBinding->buffer().Get();
+            _currentIndexFormat = indexBufferBinding->format();
+        }
         passEncoder.DrawIndexed(subMesh->count(), mesh->instanceCount(), subMesh->start(), 0, 0);
     } else {
         passEncoder.Draw(subMesh->count(), mesh->instanceCount());
     }
 }
 
+void ForwardSubpass::_resetEncoderState() {
+    _currentPipeline = nullptr;
+    _currentBindGroups.clear();
+    _currentVertexBuffers.clear();
+    _currentIndexBuffer = nullptr;
+    _currentIndexFormat = wgpu::IndexFormat::Undefined;
+}
+
 }  // namespace vox
@@ -25,6 +25,11 @@ public:
 protected:
     void _drawElement(wgpu::RenderPassEncoder& passEncoder, const RenderElement& items, const ShaderVariant& variant);
 
+    /**
+     * @brief Forgets the state bound to the encoder, which must be called whenever a new pass encoder is used
+     */
+    void _resetEncoderState();
+
     wgpu::RenderPipelineDescriptor _forwardPipelineDescriptor;
     wgpu::DepthStencilState _depthStencil;
     wgpu::FragmentState _fragment;
@@ -39,5 +44,19 @@ protected:
     wgpu::PipelineLayout _pipelineLayout;
 
     wgpu::TextureFormat _depthStencilTextureFormat;
+
+    /**
+     * @brief Compiles new define combinations in the background and draws the elements with their base variant until
+     *        they are ready. Passes whose output must match the full variant, e.g. picking or shadows, keep it off and
+     *        compile on the render thread.
+     */
+    bool _isShaderCompileAsync{false};
+
+    /// State bound to the pass encoder, so that sorted draws sharing it skip the redundant set calls
+    WGPURenderPipeline _currentPipeline{nullptr};
+    std::vector<WGPUBindGroup> _currentBindGroups;
+    std::vector<WGPUBuffer> _currentVertexBuffers;
+    WGPUBuffer _currentIndexBuffer{nullptr};
+    wgpu::IndexFormat _currentIndexFormat{wgpu::IndexFormat::Undefined};
 };
 }  // namespace vox
\ No newline at end of file
@@ -19,16 +19,18 @@ GeometrySubpass::GeometrySubpass(RenderContext *renderContext,
                                  wgpu::TextureFormat depthStencilTextureFormat,
                                  Scene *scene,
                                  Camera *camera)
-    : ForwardSubpass(renderContext, depthStencilTextureFormat, scene, camera) {}
+    : ForwardSubpass(renderContext, depthStencilTextureFormat, scene, camera) {
+    _isShaderCompileAsync = true;
+}
 
 void GeometrySubpass::_drawElement(wgpu::RenderPassEncoder &passEncoder, ShaderVariant &variant) {
     opaqueQueue.clear();
     alphaTestQueue.clear();
     transparentQueue.clear();
     _callRender(_camera);
-    std::sort(opaqueQueue.begin(), opaqueQueue.end(), _compareFromNearToFar);
-    std::sort(alphaTestQueue.begin(), alphaTestQueue.end(), _compareFromNearToFar);
-    std::sort(transparentQueue.begin(), transparentQueue.end(), _compareFromFarToNear);
+    _sortElements(opaqueQueue, false);
+    _sortElements(alphaTestQueue, false);
+    _sortElements(transparentQueue, true);
 
     for (const auto &element : opaqueQueue) {
         ForwardSubpass::_drawElement(passEncoder, element, variant);
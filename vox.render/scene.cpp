@@ -130,6 +130,8 @@ void Scene::detachRenderCamera(Camera *camera) {
     }
 }
 
+const std::vector<Camera *> &Scene::activeCameras() const { return _activeCameras; }
+
 void Scene::_processActive(bool active) {
     _isActiveInEngine = active;
     const auto &rootEntities = _rootEntities;
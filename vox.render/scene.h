@@ -110,6 +110,11 @@ public:
 
     void detachRenderCamera(Camera *camera);
 
+    /**
+     * Cameras rendering the scene.
+     */
+    [[nodiscard]] const std::vector<Camera *> &activeCameras() const;
+
 public:
     void updateShaderData();
 
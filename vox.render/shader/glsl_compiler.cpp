@@ -27,6 +27,16 @@ inline EShLanguage FindShaderLanguage(wgpu::ShaderStage stage) {
             return EShLangVertex;
     }
 }
+
+/// glslang keeps process-wide state that must not be torn down while another thread compiles, so the library is
+/// initialized once by every compiling thread and is never finalized.
+void InitializeGlslang() {
+    thread_local bool initialized = false;
+    if (!initialized) {
+        glslang::InitializeProcess();
+        initialized = true;
+    }
+}
 }  // namespace
 
 glslang::EShTargetLanguage GLSLCompiler::env_target_language_ = glslang::EShTargetLanguage::EShTargetNone;
@@ -43,6 +53,14 @@ void GLSLCompiler::ResetTargetEnvironment() {
     GLSLCompiler::env_target_language_version_ = (glslang::EShTargetLanguageVersion)0;
 }
 
+glslang::EShTargetLanguage GLSLCompiler::GetTargetLanguage() { return GLSLCompiler::env_target_language_; }
+
+glslang::EShTargetLanguageVersion GLSLCompiler::GetTargetLanguageVersion() {
+    return GLSLCompiler::env_target_language_version_;
+}
+
+uint32_t GLSLCompiler::GetVersion() { return static_cast<uint32_t>(glslang::GetSpirvGeneratorVersion()); }
+
 bool GLSLCompiler::CompileToSpirv(wgpu::ShaderStage stage,
                                   const std::vector<uint8_t> &glsl_source,
                                   const std::string &entry_point,
@@ -50,7 +68,7 @@ bool GLSLCompiler::CompileToSpirv(wgpu::ShaderStage stage,
                                   std::vector<std::uint32_t> &spirv,
                                   std::string &info_log) {
     // Initialize glslang library.
-    glslang::InitializeProcess();
+    InitializeGlslang();
 
     auto messages = static_cast<EShMessages>(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules);
 
@@ -109,9 +127,6 @@ bool GLSLCompiler::CompileToSpirv(wgpu::ShaderStage stage,
 
     info_log += logger.getAllMessages() + "\n";
 
-    // Shutdown glslang library.
-    glslang::FinalizeProcess();
-
     return true;
 }
 
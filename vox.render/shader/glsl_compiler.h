@@ -35,6 +35,15 @@ public:
      */
     static void ResetTargetEnvironment();
 
+    static glslang::EShTargetLanguage GetTargetLanguage();
+
+    static glslang::EShTargetLanguageVersion GetTargetLanguageVersion();
+
+    /**
+     * @brief Version of the SPIR-V generator, which changes whenever glslang generates different code
+     */
+    static uint32_t GetVersion();
+
     /**
      * @brief Compiles GLSL to SPIRV code
      * @param stage The Vulkan shader stage flag
@@ -0,0 +1,182 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.render/shader/shader_cache.h"
+
+#include <cstdio>
+#include <thread>
+
+#include "vox.base/logging.h"
+#include "vox.render/platform/filesystem.h"
+#include "vox.render/shader/glsl_compiler.h"
+#include "vox.render/std_helpers.h"
+
+namespace vox {
+namespace {
+/// Magic number of an entry, "VXSC"
+constexpr uint32_t kShaderCacheMagic = 0x43535856;
+
+/// Bumped whenever the layout of an entry changes
+constexpr uint32_t kShaderCacheFormatVersion = 2;
+
+std::string EntryPath(const ShaderCacheKey &key) {
+    return fs::path::Get(fs::path::Type::SHADER_CACHE) + fmt::format("{:016x}.spv", key.Hash());
+}
+
+void WriteResource(std::ostringstream &os, const ShaderResource &resource) {
+    write(os, resource.stages, resource.type, resource.mode, resource.set, resource.binding, resource.location,
+          resource.input_attachment_index, resource.vec_size, resource.columns, resource.array_size, resource.offset,
+          resource.size, resource.constant_id, resource.qualifiers, resource.name);
+}
+
+void ReadResource(std::istringstream &is, ShaderResource &resource) {
+    read(is, resource.stages, resource.type, resource.mode, resource.set, resource.binding, resource.location,
+         resource.input_attachment_index, resource.vec_size, resource.columns, resource.array_size, resource.offset,
+         resource.size, resource.constant_id, resource.qualifiers, resource.name);
+}
+
+}  // namespace
+
+std::atomic<bool> ShaderCache::enabled_{true};
+
+std::mutex ShaderCache::manifest_mutex_;
+
+std::string ShaderCacheKey::Serialize() const {
+    std::ostringstream os;
+    write(os, stage, entry_point, source, preamble, runtime_array_sizes.size());
+    for (const auto &runtime_array_size : runtime_array_sizes) {
+        write(os, runtime_array_size.first, runtime_array_size.second);
+    }
+    write(os, target_language, target_language_version, compiler_version);
+    return os.str();
+}
+
+uint64_t ShaderCacheKey::Hash() const { return utility::hash_fnv1a(Serialize()); }
+
+void ShaderCache::SetEnabled(bool enabled) { enabled_ = enabled; }
+
+bool ShaderCache::IsEnabled() { return enabled_; }
+
+ShaderCacheKey ShaderCache::MakeKey(wgpu::ShaderStage stage,
+                                    const std::vector<uint8_t> &glsl_source,
+                                    const std::string &entry_point,
+                                    const ShaderVariant &shader_variant) {
+    ShaderCacheKey key;
+    key.stage = stage;
+    key.entry_point = entry_point;
+    key.source = std::string{glsl_source.begin(), glsl_source.end()};
+    key.preamble = shader_variant.GetPreamble();
+    key.runtime_array_sizes = {shader_variant.GetRuntimeArraySizes().begin(),
+                               shader_variant.GetRuntimeArraySizes().end()};
+    std::sort(key.runtime_array_sizes.begin(), key.runtime_array_sizes.end());
+    key.target_language = static_cast<uint32_t>(GLSLCompiler::GetTargetLanguage());
+    key.target_language_version = static_cast<uint32_t>(GLSLCompiler::GetTargetLanguageVersion());
+    key.compiler_version = GLSLCompiler::GetVersion();
+    return key;
+}
+
+bool ShaderCache::Load(const ShaderCacheKey &key,
+                       std::vector<uint32_t> &spirv,
+                       std::unordered_map<std::string, ShaderResource> &resources) {
+    if (!enabled_) {
+        return false;
+    }
+
+    std::ifstream file(EntryPath(key), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::istringstream is{std::string{(std::istreambuf_iterator<char>(file)), (std::istreambuf_iterator<char>())}};
+
+    uint32_t magic{};
+    uint32_t format_version{};
+    std::string stored_key;
+    read(is, magic, format_version);
+    if (!is || magic != kShaderCacheMagic || format_version != kShaderCacheFormatVersion) {
+        return false;
+    }
+    read(is, stored_key);
+    if (!is || stored_key != key.Serialize()) {
+        return false;
+    }
+
+    std::vector<uint32_t> entry_spirv;
+    std::size_t resource_count{};
+    read(is, entry_spirv, resource_count);
+    std::unordered_map<std::string, ShaderResource> entry_resources;
+    for (std::size_t i = 0; i < resource_count && is; ++i) {
+        ShaderResource resource{};
+        ReadResource(is, resource);
+        entry_resources.emplace(resource.name, std::move(resource));
+    }
+    if (!is || entry_spirv.empty()) {
+        LOGW("Ignoring truncated shader cache entry {:016x}", key.Hash())
+        return false;
+    }
+
+    spirv = std::move(entry_spirv);
+    resources = std::move(entry_resources);
+    return true;
+}
+
+void ShaderCache::Store(const ShaderCacheKey &key,
+                        const std::vector<uint32_t> &spirv,
+                        const std::unordered_map<std::string, ShaderResource> &resources) {
+    if (!enabled_ || spirv.empty()) {
+        return;
+    }
+
+    std::ostringstream os;
+    write(os, kShaderCacheMagic, kShaderCacheFormatVersion, key.Serialize(), spirv, resources.size());
+    for (const auto &resource : resources) {
+        WriteResource(os, resource.second);
+    }
+
+    // Entries are written aside and renamed, so a reader never sees a partially written file
+    const std::string path = EntryPath(key);
+    const std::string temp_path = fmt::format("{}.{}", path, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            LOGW("Failed to write shader cache entry {}", temp_path)
+            return;
+        }
+        const std::string data = os.str();
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    std::remove(path.c_str());
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+    }
+}
+
+void ShaderCache::Record(wgpu::ShaderStage stage,
+                         const std::string &filename,
+                         const std::string &entry_point,
+                         const ShaderVariant &shader_variant) {
+    if (!enabled_ || filename.empty()) {
+        return;
+    }
+
+    // One line per variant: the stage, the file name and the entry point, followed by the defines as "D<define>"
+    // and the runtime array sizes as "R<name>=<size>"
+    std::string line = fmt::format("{}\t{}\t{}", static_cast<uint32_t>(stage), filename, entry_point);
+    for (const std::string &process : shader_variant.GetProcesses()) {
+        line += "\t" + process;
+    }
+    for (const auto &runtime_array_size : shader_variant.GetRuntimeArraySizes()) {
+        line += fmt::format("\tR{}={}", runtime_array_size.first, runtime_array_size.second);
+    }
+    line += "\n";
+
+    std::lock_guard<std::mutex> lock(manifest_mutex_);
+    std::ofstream file(GetManifestPath(), std::ios::out | std::ios::app);
+    file << line;
+}
+
+std::string ShaderCache::GetManifestPath() { return fs::path::Get(fs::path::Type::SHADER_CACHE) + "manifest.txt"; }
+
+}  // namespace vox
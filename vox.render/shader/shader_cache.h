@@ -0,0 +1,105 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "vox.render/shader/shader_module.h"
+
+namespace vox {
+/**
+ * @brief Everything the SPIR-V and the reflection of a shader depend on
+ */
+struct ShaderCacheKey {
+    wgpu::ShaderStage stage{};
+
+    std::string entry_point;
+
+    /// GLSL source after the includes are expanded, compared in full on a load
+    std::string source;
+
+    /// Preamble of the variant, one define per line sorted by name
+    std::string preamble;
+
+    /// Runtime array sizes of the variant, sorted by name
+    std::vector<std::pair<std::string, size_t>> runtime_array_sizes;
+
+    uint32_t target_language{};
+
+    uint32_t target_language_version{};
+
+    uint32_t compiler_version{};
+
+    /**
+     * @brief Serialized key, stored in the entry to detect collisions
+     */
+    [[nodiscard]] std::string Serialize() const;
+
+    /**
+     * @brief Content address of the entry, used as its file name
+     */
+    [[nodiscard]] uint64_t Hash() const;
+};
+
+/**
+ * @brief Persistent content-addressed cache of compiled SPIR-V and its reflected resources.
+ *
+ * Each entry is a file in the shader cache directory named by the hash of its key, and stores the whole key so that
+ * a hash collision or a stale file reads as a miss. Every newly compiled variant is also appended to a manifest,
+ * from which the variants used by a scene can be compiled offline to pre-warm the cache.
+ */
+class ShaderCache {
+public:
+    /**
+     * @brief Enables or disables the cache; it is enabled by default
+     */
+    static void SetEnabled(bool enabled);
+
+    [[nodiscard]] static bool IsEnabled();
+
+    static ShaderCacheKey MakeKey(wgpu::ShaderStage stage,
+                                  const std::vector<uint8_t> &glsl_source,
+                                  const std::string &entry_point,
+                                  const ShaderVariant &shader_variant);
+
+    /**
+     * @brief Reads the entry of the key
+     * @return false if there is no entry for the key
+     */
+    static bool Load(const ShaderCacheKey &key,
+                     std::vector<uint32_t> &spirv,
+                     std::unordered_map<std::string, ShaderResource> &resources);
+
+    /**
+     * @brief Writes the entry of the key, replacing any previous one
+     */
+    static void Store(const ShaderCacheKey &key,
+                      const std::vector<uint32_t> &spirv,
+                      const std::unordered_map<std::string, ShaderResource> &resources);
+
+    /**
+     * @brief Appends a compiled variant to the manifest, with everything needed to compile it again
+     */
+    static void Record(wgpu::ShaderStage stage,
+                       const std::string &filename,
+                       const std::string &entry_point,
+                       const ShaderVariant &shader_variant);
+
+    /**
+     * @brief Path of the manifest of the compiled variants
+     */
+    static std::string GetManifestPath();
+
+private:
+    /// Written by the main thread, read by the background compile workers
+    static std::atomic<bool> enabled_;
+
+    static std::mutex manifest_mutex_;
+};
+
+}  // namespace vox
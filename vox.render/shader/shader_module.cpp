@@ -9,6 +9,7 @@
 #include "vox.base/logging.h"
 #include "vox.render/platform/filesystem.h"
 #include "vox.render/shader/glsl_compiler.h"
+#include "vox.render/shader/shader_cache.h"
 #include "vox.render/shader/spirv_reflection.h"
 #include "vox.render/strings.h"
 
@@ -61,15 +62,65 @@ ShaderModule::ShaderModule(wgpu::Device &device,
                            const ShaderSource &glsl_source,
                            const std::string &entry_point,
                            const ShaderVariant &shader_variant)
-    : device_{device}, stage_{stage}, entry_point_{entry_point} {
-    debug_name_ = fmt::format("{} [variant {:X}] [entrypoint {}]", glsl_source.GetFilename(), shader_variant.GetId(),
-                              entry_point);
-
+    : device_{device},
+      stage_{stage},
+      entry_point_{entry_point},
+      debug_name_{MakeDebugName(glsl_source, entry_point, shader_variant)} {
     // Compiling from GLSL source requires the entry point
     if (entry_point.empty()) {
         LOGE("GLSL source requires the entry point")
     }
 
+    Compile(stage, glsl_source, entry_point, shader_variant, spirv_, resources_, info_log_);
+    CreateHandle();
+}
+
+ShaderModule::ShaderModule(wgpu::Device &device,
+                           wgpu::ShaderStage stage,
+                           const std::string &entry_point,
+                           const std::string &debug_name,
+                           std::vector<uint32_t> &&spirv,
+                           std::unordered_map<std::string, ShaderResource> &&resources,
+                           std::string &&info_log)
+    : device_{device},
+      stage_{stage},
+      entry_point_{entry_point},
+      debug_name_{debug_name},
+      spirv_{std::move(spirv)},
+      resources_{std::move(resources)},
+      info_log_{std::move(info_log)} {
+    CreateHandle();
+}
+
+std::string ShaderModule::MakeDebugName(const ShaderSource &glsl_source,
+                                        const std::string &entry_point,
+                                        const ShaderVariant &shader_variant) {
+    return fmt::format("{} [variant {:X}] [entrypoint {}]", glsl_source.GetFilename(), shader_variant.GetId(),
+                       entry_point);
+}
+
+void ShaderModule::CreateHandle() {
+    // Generate a unique id, determined by source and variant
+    std::hash<std::string> hasher{};
+    id_ = hasher(std::string{reinterpret_cast<const char *>(spirv_.data()),
+                             reinterpret_cast<const char *>(spirv_.data() + spirv_.size())});
+
+    // create WebGPU shader module
+    wgpu::ShaderModuleDescriptor desc;
+    wgpu::ShaderModuleSPIRVDescriptor spirvDesc;
+    desc.nextInChain = &spirvDesc;
+    spirvDesc.code = spirv_.data();
+    spirvDesc.codeSize = static_cast<uint32_t>(spirv_.size());
+    shader_module_ = device_.CreateShaderModule(&desc);
+}
+
+bool ShaderModule::Compile(wgpu::ShaderStage stage,
+                           const ShaderSource &glsl_source,
+                           const std::string &entry_point,
+                           const ShaderVariant &shader_variant,
+                           std::vector<uint32_t> &spirv,
+                           std::unordered_map<std::string, ShaderResource> &resources,
+                           std::string &info_log) {
     auto &source = glsl_source.GetSource();
 
     // Check if application is passing in GLSL source code to compile to SPIR-V
@@ -79,31 +130,29 @@ ShaderModule::ShaderModule(wgpu::Device &device,
 
     // Precompile source into the final spirv bytecode
     auto glsl_final_source = PrecompileShader(source);
+    auto glsl_bytes = ConvertToBytes(glsl_final_source);
+
+    auto cache_key = ShaderCache::MakeKey(stage, glsl_bytes, entry_point, shader_variant);
+    if (ShaderCache::Load(cache_key, spirv, resources)) {
+        return true;
+    }
 
     // Compile the GLSL source
-    if (!GLSLCompiler::CompileToSpirv(stage, ConvertToBytes(glsl_final_source), entry_point, shader_variant, spirv_,
-                                      info_log_)) {
+    if (!GLSLCompiler::CompileToSpirv(stage, glsl_bytes, entry_point, shader_variant, spirv, info_log)) {
         LOGE("Shader compilation failed for shader \"{}\"", glsl_source.GetFilename())
-        LOGE("{}", info_log_)
+        LOGE("{}", info_log)
+        return false;
     }
 
     // Reflect all shader resources
-    if (!SpirvReflection::ReflectShaderResources(stage, spirv_, resources_, shader_variant)) {
+    if (!SpirvReflection::ReflectShaderResources(stage, spirv, resources, shader_variant)) {
         LOGE("Reflect all shader resources")
+        return false;
     }
 
-    // Generate a unique id, determined by source and variant
-    std::hash<std::string> hasher{};
-    id_ = hasher(std::string{reinterpret_cast<const char *>(spirv_.data()),
-                             reinterpret_cast<const char *>(spirv_.data() + spirv_.size())});
-
-    // create WebGPU shader module
-    wgpu::ShaderModuleDescriptor desc;
-    wgpu::ShaderModuleSPIRVDescriptor spirvDesc;
-    desc.nextInChain = &spirvDesc;
-    spirvDesc.code = spirv_.data();
-    spirvDesc.codeSize = static_cast<uint32_t>(spirv_.size());
-    shader_module_ = device.CreateShaderModule(&desc);
+    ShaderCache::Store(cache_key, spirv, resources);
+    ShaderCache::Record(stage, glsl_source.GetFilename(), entry_point, shader_variant);
+    return true;
 }
 
 ShaderModule::ShaderModule(ShaderModule &&other) noexcept
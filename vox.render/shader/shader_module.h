@@ -96,6 +96,17 @@ public:
                  const std::string &entry_point,
                  const ShaderVariant &shader_variant);
 
+    /**
+     * @brief Creates the module from the output of Compile, e.g. when it was compiled on another thread
+     */
+    ShaderModule(wgpu::Device &device,
+                 wgpu::ShaderStage stage,
+                 const std::string &entry_point,
+                 const std::string &debug_name,
+                 std::vector<uint32_t> &&spirv,
+                 std::unordered_map<std::string, ShaderResource> &&resources,
+                 std::string &&info_log);
+
     ShaderModule(const ShaderModule &) = delete;
 
     ShaderModule(ShaderModule &&other) noexcept;
@@ -104,6 +115,19 @@ public:
 
     ShaderModule &operator=(ShaderModule &&) = delete;
 
+    /**
+     * @brief Compiles the GLSL source with the variant to SPIR-V and reflects its resources. The result is read from
+     *        the shader cache when possible, and stored in it otherwise.
+     * @return false if the compilation or the reflection failed
+     */
+    static bool Compile(wgpu::ShaderStage stage,
+                        const ShaderSource &glsl_source,
+                        const std::string &entry_point,
+                        const ShaderVariant &shader_variant,
+                        std::vector<uint32_t> &spirv,
+                        std::unordered_map<std::string, ShaderResource> &resources,
+                        std::string &info_log);
+
     [[nodiscard]] size_t GetId() const;
 
     [[nodiscard]] wgpu::ShaderStage GetStage() const;
@@ -129,6 +153,13 @@ public:
      */
     void SetResourceMode(const std::string &resource_name, const ShaderResourceMode &resource_mode);
 
+    /**
+     * @brief Human-readable name of the module of the source and variant
+     */
+    static std::string MakeDebugName(const ShaderSource &glsl_source,
+                                     const std::string &entry_point,
+                                     const ShaderVariant &shader_variant);
+
 private:
     wgpu::Device &device_;
     wgpu::ShaderModule shader_module_;
@@ -151,6 +182,8 @@ private:
     std::unordered_map<std::string, ShaderResource> resources_;
 
     std::string info_log_;
+
+    void CreateHandle();
 };
 
 }  // namespace vox
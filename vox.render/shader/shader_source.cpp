@@ -9,21 +9,26 @@
 #include "vox.render/platform/filesystem.h"
 
 namespace vox {
-ShaderSource::ShaderSource(const std::string &filename) : filename_{filename}, source_{fs::ReadShader(filename)} {
-    std::hash<std::string> hasher{};
-    id_ = hasher(std::string{source_.cbegin(), source_.cend()});
+ShaderSource::ShaderSource(const std::string &filename)
+    : filename_{filename}, source_{std::make_shared<const std::string>(fs::ReadShader(filename))} {
+    id_ = utility::hash_fnv1a(*source_);
 }
 
-size_t ShaderSource::GetId() const { return id_; }
+uint64_t ShaderSource::GetId() const { return id_; }
+
+uint32_t ShaderSource::GetDenseId() const { return dense_id_.value(); }
 
 const std::string &ShaderSource::GetFilename() const { return filename_; }
 
 void ShaderSource::SetSource(const std::string &source) {
-    source_ = source;
-    std::hash<std::string> hasher{};
-    id_ = hasher(std::string{source_.cbegin(), source_.cend()});
+    source_ = std::make_shared<const std::string>(source);
+    id_ = utility::hash_fnv1a(*source_);
 }
 
-const std::string &ShaderSource::GetSource() const { return source_; }
+const std::string &ShaderSource::GetSource() const { return *source_; }
+
+bool ShaderSource::HasSameSource(const ShaderSource &other) const {
+    return source_ == other.source_ || (id_ == other.id_ && *source_ == *other.source_);
+}
 
 }  // namespace vox
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "vox.render/dense_id.h"
 #include "vox.render/helper.h"
 
 namespace vox {
@@ -15,7 +16,15 @@ public:
 
     explicit ShaderSource(const std::string &filename);
 
-    [[nodiscard]] size_t GetId() const;
+    /**
+     * @brief Stable 64-bit id of the source text, computed when the source is set
+     */
+    [[nodiscard]] uint64_t GetId() const;
+
+    /**
+     * @brief Small id of this source object, used to sort draws. Unlike GetId(), it is not derived from the text.
+     */
+    [[nodiscard]] uint32_t GetDenseId() const;
 
     [[nodiscard]] const std::string &GetFilename() const;
 
@@ -23,12 +32,20 @@ public:
 
     [[nodiscard]] const std::string &GetSource() const;
 
+    /**
+     * @brief Returns true if both sources have the same text. Copies share their text, so comparing them doesn't
+     *        read it.
+     */
+    [[nodiscard]] bool HasSameSource(const ShaderSource &other) const;
+
 private:
-    size_t id_{};
+    uint64_t id_{};
+
+    DenseId<ShaderSource> dense_id_;
 
     std::string filename_;
 
-    std::string source_;
+    std::shared_ptr<const std::string> source_{std::make_shared<const std::string>()};
 };
 
 }  // namespace vox
@@ -6,73 +6,217 @@
 
 #include "vox.render/shader/shader_variant.h"
 
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#include "vox.base/logging.h"
 #include "vox.render/strings.h"
 
 namespace vox {
-ShaderVariant::ShaderVariant(std::string &&preamble, std::vector<std::string> &&processes)
-    : processes_{std::move(processes)} {
-    auto splits = Split(preamble, "\n");
-    for (const std::string &split : splits) {
-        preambles_.insert(split);
+namespace {
+constexpr size_t kMaxMacroValues = 4096;
+
+/**
+ * @brief Interned macro names and values shared by all variants. Entries are only ever added, so an index stays valid
+ *        for the lifetime of the program. The hashes are written before their index is handed out and never change,
+ *        so they are read without locking.
+ */
+class MacroRegistry {
+public:
+    static MacroRegistry &Get() {
+        static MacroRegistry registry;
+        return registry;
     }
 
-    UpdateId();
-}
+    MacroRegistry() {
+        values_.emplace_back();
+        value_hashes_[0] = utility::hash_fnv1a(values_[0]);
+    }
 
-size_t ShaderVariant::GetId() const { return id_; }
+    /**
+     * @brief Returns the index of the name. Throws if the name is new and the registry is full, since dropping the
+     *        define would silently compile a different shader.
+     */
+    size_t InternName(const std::string &name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = name_indices_.find(name);
+        if (iter != name_indices_.end()) {
+            return iter->second;
+        }
+        if (names_.size() == ShaderVariant::kMaxMacros) {
+            throw std::runtime_error(fmt::format("Too many shader macros, can't define \"{}\"", name));
+        }
+        size_t index = names_.size();
+        name_hashes_[index] = utility::hash_fnv1a(name);
+        names_.push_back(name);
+        name_indices_.emplace(name, index);
+        return index;
+    }
 
-void ShaderVariant::UnionCollection(const ShaderVariant &left, const ShaderVariant &right, ShaderVariant &result) {
-    std::set<std::string> collect;
-    for (const std::string &def : left.GetProcesses()) {
-        collect.insert(def);
+    /**
+     * @brief Returns the index of the name, or kMaxMacros if the name was never interned
+     */
+    size_t FindName(const std::string &name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = name_indices_.find(name);
+        return iter == name_indices_.end() ? ShaderVariant::kMaxMacros : iter->second;
+    }
+
+    /**
+     * @brief Returns the index of the value; the empty value is always 0. Throws if the value is new and the registry
+     *        is full.
+     */
+    uint16_t InternValue(const std::string &value) {
+        if (value.empty()) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = value_indices_.find(value);
+        if (iter != value_indices_.end()) {
+            return iter->second;
+        }
+        if (values_.size() == kMaxMacroValues) {
+            throw std::runtime_error(fmt::format("Too many shader macro values, can't define \"{}\"", value));
+        }
+        auto index = static_cast<uint16_t>(values_.size());
+        value_hashes_[index] = utility::hash_fnv1a(value);
+        values_.push_back(value);
+        value_indices_.emplace(value, index);
+        return index;
+    }
+
+    [[nodiscard]] uint64_t DefineHash(size_t macro, uint16_t value) const {
+        return utility::hash_mix(name_hashes_[macro] + utility::hash_mix(value_hashes_[value]));
     }
 
-    for (const std::string &def : right.GetProcesses()) {
-        collect.insert(def);
+    /**
+     * @brief Returns the (name, value) pairs of the defined macros sorted by name. Interning order depends on which
+     *        shaders were built first, so sorting keeps the text a function of the defines alone.
+     */
+    [[nodiscard]] std::vector<std::pair<std::string, std::string>> SortedDefines(
+            const std::bitset<ShaderVariant::kMaxMacros> &macros,
+            const std::array<uint16_t, ShaderVariant::kMaxMacros> &values) const {
+        std::vector<std::pair<std::string, std::string>> defines;
+        defines.reserve(macros.count());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < ShaderVariant::kMaxMacros; ++i) {
+                if (macros[i]) {
+                    defines.emplace_back(names_[i], values_[values[i]]);
+                }
+            }
+        }
+        std::sort(defines.begin(), defines.end());
+        return defines;
     }
 
-    for (const std::string &def : collect) {
-        std::string tmp_def(def, 1);
-        result.AddDefine(tmp_def);
+private:
+    mutable std::mutex mutex_;
+
+    std::vector<std::string> names_;
+
+    std::unordered_map<std::string, size_t> name_indices_;
+
+    std::array<uint64_t, ShaderVariant::kMaxMacros> name_hashes_{};
+
+    std::vector<std::string> values_;
+
+    std::unordered_map<std::string, uint16_t> value_indices_;
+
+    std::array<uint64_t, kMaxMacroValues> value_hashes_{};
+};
+
+/**
+ * @brief Splits "NAME", "NAME VALUE" or "NAME=VALUE" into its name and value
+ */
+void SplitDefine(const std::string &def, std::string &name, std::string &value) {
+    size_t pos = def.find_first_of("= ");
+    name = def.substr(0, pos);
+    value.clear();
+    if (pos != std::string::npos) {
+        size_t begin = def.find_first_not_of(' ', pos + 1);
+        size_t end = def.find_last_not_of(' ');
+        if (begin != std::string::npos) {
+            value = def.substr(begin, end - begin + 1);
+        }
     }
 }
 
-void ShaderVariant::AddDefine(const std::string &def) {
-    auto iter = std::find(processes_.begin(), processes_.end(), "D" + def);
-    if (iter == processes_.end()) {
-        processes_.push_back("D" + def);
+}  // namespace
+
+ShaderVariant::ShaderVariant(const std::string &preamble) {
+    const std::string directive = "#define ";
+    auto splits = Split(preamble, "\n");
+    for (const std::string &split : splits) {
+        if (split.compare(0, directive.size(), directive) == 0) {
+            AddDefine(split.substr(directive.size()));
+        }
     }
+}
+
+uint64_t ShaderVariant::GetId() const { return id_; }
 
-    std::string tmp_def = def;
+bool ShaderVariant::HasSameDefines(const ShaderVariant &other) const {
+    return id_ == other.id_ && macros_ == other.macros_ && values_ == other.values_;
+}
+
+void ShaderVariant::UnionCollection(const ShaderVariant &left, const ShaderVariant &right, ShaderVariant &result) {
+    result.Merge(left);
+    result.Merge(right);
+}
+
+void ShaderVariant::Merge(const ShaderVariant &other) {
+    if (&other == this || other.macros_.none()) {
+        return;
+    }
+
+    macros_ |= other.macros_;
+    for (size_t i = 0; i < kMaxMacros; ++i) {
+        values_[i] = other.macros_[i] ? other.values_[i] : values_[i];
+    }
 
-    // The "=" needs to turn into a space
-    size_t pos_equal = tmp_def.find_first_of('=');
-    if (pos_equal != std::string::npos) {
-        tmp_def[pos_equal] = ' ';
+    auto &registry = MacroRegistry::Get();
+    id_ = 0;
+    for (size_t i = 0; i < kMaxMacros; ++i) {
+        if (macros_[i]) {
+            id_ += registry.DefineHash(i, values_[i]);
+        }
     }
+}
 
-    preambles_.insert("#define " + tmp_def + "\n");
+void ShaderVariant::AddDefine(const std::string &def) {
+    std::string name;
+    std::string value;
+    SplitDefine(def, name, value);
 
-    UpdateId();
+    auto &registry = MacroRegistry::Get();
+    size_t macro = registry.InternName(name);
+    SetMacro(macro, registry.InternValue(value));
 }
 
 void ShaderVariant::RemoveDefine(const std::string &def) {
-    std::string process = "D" + def;
-    processes_.erase(std::remove(processes_.begin(), processes_.end(), process), processes_.end());
+    std::string name;
+    std::string value;
+    SplitDefine(def, name, value);
 
-    std::string tmp_def = def;
-    // The "=" needs to turn into a space
-    size_t pos_equal = tmp_def.find_first_of('=');
-    if (pos_equal != std::string::npos) {
-        tmp_def[pos_equal] = ' ';
-    }
-    tmp_def = "#define " + tmp_def + "\n";
-    auto iter = preambles_.find(tmp_def);
-    if (iter != preambles_.end()) {
-        preambles_.erase(iter);
+    auto &registry = MacroRegistry::Get();
+    size_t macro = registry.FindName(name);
+    if (macro != kMaxMacros && macros_[macro]) {
+        id_ -= registry.DefineHash(macro, values_[macro]);
+        macros_.reset(macro);
+        values_[macro] = 0;
     }
+}
 
-    UpdateId();
+void ShaderVariant::SetMacro(size_t macro, uint16_t value) {
+    auto &registry = MacroRegistry::Get();
+    if (macros_[macro]) {
+        id_ -= registry.DefineHash(macro, values_[macro]);
+    }
+    macros_.set(macro);
+    values_[macro] = value;
+    id_ += registry.DefineHash(macro, value);
 }
 
 void ShaderVariant::AddRuntimeArraySize(const std::string &runtime_array_name, size_t size) {
@@ -89,27 +233,37 @@ void ShaderVariant::SetRuntimeArraySizes(const std::unordered_map<std::string, s
 
 std::string ShaderVariant::GetPreamble() const {
     std::string preamble;
-    std::for_each(preambles_.begin(), preambles_.end(), [&](const std::string &p) { preamble += p; });
+    for (const auto &[name, value] : MacroRegistry::Get().SortedDefines(macros_, values_)) {
+        preamble += "#define " + name;
+        if (!value.empty()) {
+            preamble += " " + value;
+        }
+        preamble += "\n";
+    }
     return preamble;
 }
 
-const std::vector<std::string> &ShaderVariant::GetProcesses() const { return processes_; }
+std::vector<std::string> ShaderVariant::GetProcesses() const {
+    std::vector<std::string> processes;
+    for (const auto &[name, value] : MacroRegistry::Get().SortedDefines(macros_, values_)) {
+        std::string process = "D" + name;
+        if (!value.empty()) {
+            process += "=" + value;
+        }
+        processes.push_back(std::move(process));
+    }
+    return processes;
+}
 
 const std::unordered_map<std::string, size_t> &ShaderVariant::GetRuntimeArraySizes() const {
     return runtime_array_sizes_;
 }
 
 void ShaderVariant::Clear() {
-    preambles_.clear();
-    processes_.clear();
+    macros_.reset();
+    values_.fill(0);
     runtime_array_sizes_.clear();
-    UpdateId();
-}
-
-void ShaderVariant::UpdateId() {
     id_ = 0;
-    std::for_each(preambles_.begin(), preambles_.end(),
-                  [&](const std::string &preamble) { utility::hash_combine(id_, preamble); });
 }
 
 }  // namespace vox
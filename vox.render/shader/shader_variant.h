@@ -6,20 +6,42 @@
 
 #pragma once
 
+#include <bitset>
+
 #include "vox.render/helper.h"
 
 namespace vox {
 /**
  * @brief Adds support for C style preprocessor macros to glsl shaders
  *        enabling you to define or undefine certain symbols
+ *
+ * Macro names are interned in a registry shared by all variants, so a variant is a fixed-size bitset of the defined
+ * names plus one interned value slot per name. Copying and merging variants never allocates, and the preamble string
+ * is only built when a shader is compiled.
  */
 class ShaderVariant {
 public:
+    /**
+     * @brief Maximum number of distinct macro names in the program
+     */
+    static constexpr size_t kMaxMacros = 256;
+
     ShaderVariant() = default;
 
-    ShaderVariant(std::string &&preamble, std::vector<std::string> &&processes);
+    /**
+     * @brief Defines every "#define" line of the preamble
+     */
+    explicit ShaderVariant(const std::string &preamble);
+
+    /**
+     * @brief Stable 64-bit id of the defines, kept up to date as defines are added, removed and merged
+     */
+    [[nodiscard]] uint64_t GetId() const;
 
-    [[nodiscard]] size_t GetId() const;
+    /**
+     * @brief Returns true if both variants define the same macros with the same values
+     */
+    [[nodiscard]] bool HasSameDefines(const ShaderVariant &other) const;
 
     /**
      * Union of two variant collection.
@@ -30,14 +52,20 @@ public:
     static void UnionCollection(const ShaderVariant &left, const ShaderVariant &right, ShaderVariant &result);
 
     /**
-     * @brief Adds a define macro to the shader
-     * @param def String which should go to the right of a define directive
+     * @brief Adds the defines of the other variant. A macro defined in both takes the value of the other variant.
+     */
+    void Merge(const ShaderVariant &other);
+
+    /**
+     * @brief Adds a define macro to the shader, replacing the value of the macro if it is already defined. Throws
+     *        std::runtime_error if the program runs out of macro names or values.
+     * @param def String which should go to the right of a define directive, as "NAME", "NAME VALUE" or "NAME=VALUE"
      */
     void AddDefine(const std::string &def);
 
     /**
-     * @brief Remove a def macro to the shader
-     * @param def String which should go to the right of a define directive
+     * @brief Remove a def macro to the shader, whatever its value
+     * @param def String which should go to the right of a define directive; only the name is used
      */
     void RemoveDefine(const std::string &def);
 
@@ -52,24 +80,30 @@ public:
 
     void SetRuntimeArraySizes(const std::unordered_map<std::string, size_t> &sizes);
 
+    /**
+     * @brief Returns one "#define" line per macro, sorted by name
+     */
     [[nodiscard]] std::string GetPreamble() const;
 
-    [[nodiscard]] const std::vector<std::string> &GetProcesses() const;
+    /**
+     * @brief Returns one "DNAME" or "DNAME=VALUE" process per macro, sorted by name
+     */
+    [[nodiscard]] std::vector<std::string> GetProcesses() const;
 
     [[nodiscard]] const std::unordered_map<std::string, size_t> &GetRuntimeArraySizes() const;
 
     void Clear();
 
 private:
-    size_t id_{};
+    uint64_t id_{};
 
-    std::set<std::string> preambles_;
+    std::bitset<kMaxMacros> macros_;
 
-    std::vector<std::string> processes_;
+    std::array<uint16_t, kMaxMacros> values_{};
 
     std::unordered_map<std::string, size_t> runtime_array_sizes_;
 
-    void UpdateId();
+    void SetMacro(size_t macro, uint16_t value);
 };
 
 }  // namespace vox
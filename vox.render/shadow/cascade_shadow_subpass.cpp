@@ -110,8 +110,8 @@ void CascadedShadowSubpass::_renderDirectShadowMap(wgpu::RenderPassEncoder& pass
                     ShadowUtils::shadowCullFrustum(renderer, _shadowSliceData, opaqueQueue, alphaTestQueue,
                                                    transparentQueue);
                 }
-                std::sort(opaqueQueue.begin(), opaqueQueue.end(), _compareFromNearToFar);
-                std::sort(alphaTestQueue.begin(), alphaTestQueue.end(), _compareFromNearToFar);
+                _sortElements(opaqueQueue, false);
+                _sortElements(alphaTestQueue, false);
 
                 for (auto& element : opaqueQueue) {
                     element.material = _shadowMaterial;
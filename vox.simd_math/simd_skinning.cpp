@@ -0,0 +1,129 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "vox.simd_math/simd_skinning.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace vox::simd_math {
+
+namespace {
+// 4 affine matrices in soa form, the constant last row is omitted.
+struct SoaAffine {
+    SoaFloat3 cols[4];
+};
+
+// Gathers the columns of 4 aos matrices in soa form. Only the 3 first rows are
+// kept if Column is a SoaFloat3.
+template <typename Column>
+VOX_INLINE void LoadSoaColumns(
+        const Float4x4& _m0, const Float4x4& _m1, const Float4x4& _m2, const Float4x4& _m3, Column _cols[4]) {
+    for (int c = 0; c < 4; ++c) {
+        const SimdFloat4 in[4] = {_m0.cols[c], _m1.cols[c], _m2.cols[c], _m3.cols[c]};
+        if constexpr (std::is_same_v<Column, SoaFloat3>) {
+            Transpose4x3(in, &_cols[c].x);
+        } else {
+            Transpose4x4(in, &_cols[c].x);
+        }
+    }
+}
+
+// Computes _a.cols[0] * _b.x + _a.cols[1] * _b.y + _a.cols[2] * _b.z + _w.
+VOX_INLINE SoaFloat3 MulAddColumn(const SoaAffine& _a, const SoaFloat4& _b, const SoaFloat3& _w) {
+    return {MAdd(_a.cols[0].x, _b.x, MAdd(_a.cols[1].x, _b.y, MAdd(_a.cols[2].x, _b.z, _w.x))),
+            MAdd(_a.cols[0].y, _b.x, MAdd(_a.cols[1].y, _b.y, MAdd(_a.cols[2].y, _b.z, _w.y))),
+            MAdd(_a.cols[0].z, _b.x, MAdd(_a.cols[1].z, _b.y, MAdd(_a.cols[2].z, _b.z, _w.z)))};
+}
+
+// Multiplies 4 pairs of affine matrices. The last row of _b is ignored.
+VOX_INLINE SoaAffine MulSoaAffine(const SoaAffine& _a, const SoaFloat4x4& _b) {
+    const SimdFloat4 zero = simd_float4::zero();
+    const SoaFloat3 no_translation = {zero, zero, zero};
+    SoaAffine ret;
+    ret.cols[0] = MulAddColumn(_a, _b.cols[0], no_translation);
+    ret.cols[1] = MulAddColumn(_a, _b.cols[1], no_translation);
+    ret.cols[2] = MulAddColumn(_a, _b.cols[2], no_translation);
+    ret.cols[3] = MulAddColumn(_a, _b.cols[3], _a.cols[3]);
+    return ret;
+}
+
+// Stores the 3 rows of the first _count matrices of _m, 12 floats each.
+VOX_INLINE void StoreRows3x4(const SoaAffine& _m, size_t _count, float* _output) {
+    // Row r of the 4 matrices is made of the r components of the 4 soa columns.
+    const SimdFloat4 x[4] = {_m.cols[0].x, _m.cols[1].x, _m.cols[2].x, _m.cols[3].x};
+    const SimdFloat4 y[4] = {_m.cols[0].y, _m.cols[1].y, _m.cols[2].y, _m.cols[3].y};
+    const SimdFloat4 z[4] = {_m.cols[0].z, _m.cols[1].z, _m.cols[2].z, _m.cols[3].z};
+    SimdFloat4 rows[3][4];
+    Transpose4x4(x, rows[0]);
+    Transpose4x4(y, rows[1]);
+    Transpose4x4(z, rows[2]);
+    for (size_t i = 0; i < _count; ++i, _output += kSkinningMatrix3x4Floats) {
+        StorePtrU(rows[0][i], _output + 0);
+        StorePtrU(rows[1][i], _output + 4);
+        StorePtrU(rows[2][i], _output + 8);
+    }
+}
+}  // namespace
+
+bool PackInverseBindPoses(span<const Float4x4> _inverse_bind_poses, span<SoaFloat4x4> _output) {
+    const size_t count = _inverse_bind_poses.size();
+    if (_output.size() < SoaInverseBindPosesCount(count)) {
+        return false;
+    }
+
+    const Float4x4 identity = Float4x4::identity();
+    for (size_t i = 0; i < count; i += 4) {
+        const Float4x4* m[4];
+        for (size_t j = 0; j < 4; ++j) {
+            m[j] = i + j < count ? &_inverse_bind_poses[i + j] : &identity;
+        }
+        LoadSoaColumns(*m[0], *m[1], *m[2], *m[3], _output[i / 4].cols);
+    }
+    return true;
+}
+
+bool BuildSkinningMatrices3x4(span<const Float4x4> _models,
+                              span<const uint16_t> _joint_remaps,
+                              span<const SoaFloat4x4> _inverse_bind_poses,
+                              span<float> _output) {
+    const size_t count = _joint_remaps.size();
+    if (_inverse_bind_poses.size() != SoaInverseBindPosesCount(count) ||
+        _output.size() < count * kSkinningMatrix3x4Floats) {
+        return false;
+    }
+    // Remaps are usually sorted, but it isn't required here.
+    const size_t num_models = _models.size();
+    for (const uint16_t remap : _joint_remaps) {
+        if (remap >= num_models) {
+            return false;
+        }
+    }
+
+    const Float4x4* models = _models.data();
+    const uint16_t* remaps = _joint_remaps.data();
+    const SoaFloat4x4* inverse_bind_poses = _inverse_bind_poses.data();
+    float* output = _output.data();
+
+    SoaAffine models4;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, output += 4 * kSkinningMatrix3x4Floats) {
+        LoadSoaColumns(models[remaps[i]], models[remaps[i + 1]], models[remaps[i + 2]], models[remaps[i + 3]],
+                       models4.cols);
+        StoreRows3x4(MulSoaAffine(models4, inverse_bind_poses[i / 4]), 4, output);
+    }
+
+    // Remaining matrices, the missing lanes repeat the last one and aren't stored.
+    if (i < count) {
+        const size_t last = count - 1;
+        LoadSoaColumns(models[remaps[i]], models[remaps[std::min(i + 1, last)]], models[remaps[std::min(i + 2, last)]],
+                       models[remaps[last]], models4.cols);
+        StoreRows3x4(MulSoaAffine(models4, inverse_bind_poses[i / 4]), count - i, output);
+    }
+    return true;
+}
+
+}  // namespace vox::simd_math
@@ -0,0 +1,45 @@
+//  Copyright (c) 2022 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstdint>
+
+#include "vox.base/span.h"
+#include "vox.simd_math/simd_math.h"
+#include "vox.simd_math/soa_float4x4.h"
+
+namespace vox::simd_math {
+
+// Number of floats of a skinning matrix packed by BuildSkinningMatrices3x4.
+constexpr size_t kSkinningMatrix3x4Floats = 12;
+
+// Returns the number of soa matrices needed to pack _count inverse bind poses.
+inline size_t SoaInverseBindPosesCount(size_t _count) { return (_count + 3) / 4; }
+
+// Packs the inverse bind poses of a skin by groups of 4 in soa form, once for
+// all, as expected by BuildSkinningMatrices3x4. The last group is padded with
+// identity matrices. _output must hold at least
+// SoaInverseBindPosesCount(_inverse_bind_poses.size()) matrices, otherwise
+// false is returned without writing anything.
+VOX_BASE_DLL bool PackInverseBindPoses(span<const Float4x4> _inverse_bind_poses, span<SoaFloat4x4> _output);
+
+// Builds the skinning matrices of a mesh influenced by a subset of the joints of
+// a skeleton, in a single pass:
+// skinning[i] = _models[_joint_remaps[i]] * inverse_bind_poses[i]
+// Matrices are processed by groups of 4 in soa form, using the inverse bind
+// poses packed by PackInverseBindPoses. They are affine, so only the 3 first
+// rows of each one are computed and stored to _output (row major, 12 floats).
+// This is the layout of the mat3x4 joint uniforms of the skinning shaders, and
+// saves a quarter of the upload bandwidth.
+// _inverse_bind_poses must hold SoaInverseBindPosesCount(_joint_remaps.size())
+// matrices, every remap index must be in _models range and _output must hold at
+// least _joint_remaps.size() * kSkinningMatrix3x4Floats floats. Returns false,
+// without writing anything, if any of these conditions isn't met.
+VOX_BASE_DLL bool BuildSkinningMatrices3x4(span<const Float4x4> _models, span<const uint16_t> _joint_remaps,
+                                           span<const SoaFloat4x4> _inverse_bind_poses, span<float> _output);
+
+}  // namespace vox::simd_math